@@ -0,0 +1,1159 @@
+/*
+  ==============================================================================
+
+    leaf-benchmark.c
+    Host-side benchmark for LEAF objects.
+
+    Build and run with the Makefile in this folder:
+
+        make
+        ./leaf-benchmark [numSamples]
+        ./leaf-benchmark accuracy
+
+    Every object is run over numSamples samples (default: 10 seconds of audio),
+    in blocks of BENCH_BLOCK_SIZE samples to match the drumbox's audio frame.
+    Results are printed as one comma-separated line per object so they can be
+    diffed or loaded into a spreadsheet:
+
+        object,mode,ns_per_sample,samples_per_sec,pct_of_realtime,block_min_pct,block_avg_pct,block_max_pct,mempool_bytes
+
+    pct_of_realtime is how much of one host core the object would use running
+    at BENCH_SAMPLE_RATE. The block_*_pct columns come from the firmware's
+    profiler (Src/profiler.c), timing each block on its own against the time
+    one block lasts, so a max far above the average points at an object with
+    occasional expensive blocks. mempool_bytes is the peak mempool usage of the object,
+    headers included, which is what it will take out of mediumMemory or smallPool. Numbers from the host are only useful relative to
+    each other; multiply by the ratio to a measured target object to estimate
+    what something costs on the STM32H7.
+
+    accuracy compares the fast float approximations against the double
+    precision code they replace, and the packed sample formats against float,
+    one line per input signal:
+
+        check,input,max_abs_error,reference_peak,error_db
+
+    where error_db is the worst error relative to the reference's peak.
+
+  ==============================================================================
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "leaf.h"
+#include "Externals/d_fft_mayer.h"
+#include "profiler.h"
+
+#define BENCH_SAMPLE_RATE 48000.0f
+#define BENCH_BLOCK_SIZE 32
+#define BENCH_DEFAULT_SECONDS 10
+#define BENCH_MEM_SIZE 67108864 // 64 MB, leaves room for delay lines and reverb tanks
+#define BENCH_RETRIGGER 12000 // samples between hits for the drum voices and envelopes
+
+static char benchMemory[BENCH_MEM_SIZE];
+
+static float benchIn[BENCH_BLOCK_SIZE];
+static float benchOut[BENCH_BLOCK_SIZE];
+static volatile float benchSink;
+static uint32_t benchCounter;
+
+typedef struct BenchCase
+{
+    const char* name;
+    const char* mode; // "tick" or "process"
+    void (*setup)(void);
+    void (*run)(const float* in, float* out, int n);
+} BenchCase;
+
+//==============================================================================
+
+// Fixed-seed LCG so every run sees the same noise and input signal.
+static uint32_t benchSeed = 22222;
+
+static float benchRandom(void)
+{
+    benchSeed = benchSeed * 1664525u + 1013904223u;
+    return (float)(benchSeed >> 8) * (1.0f / 16777216.0f);
+}
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1.0e-9;
+}
+
+// Returns nonzero once every BENCH_RETRIGGER samples, for objects that need to be re-excited.
+static int benchRetrigger(int n)
+{
+    benchCounter += n;
+    if (benchCounter >= BENCH_RETRIGGER)
+    {
+        benchCounter -= BENCH_RETRIGGER;
+        return 1;
+    }
+    return 0;
+}
+
+//==============================================================================
+// Each object gets a setup and a run function. The GENERATOR/EFFECT macros cover
+// the common cases of a tick with no input or a tick with one input.
+
+#define BENCH_GENERATOR(T, SETUP) \
+    static T bench_##T; \
+    static void setup_##T(void) { SETUP; } \
+    static void run_##T(const float* in, float* out, int n) \
+    { for (int i = 0; i < n; i++) out[i] = T##_tick(&bench_##T); }
+
+#define BENCH_EFFECT(T, SETUP) \
+    static T bench_##T; \
+    static void setup_##T(void) { SETUP; } \
+    static void run_##T(const float* in, float* out, int n) \
+    { for (int i = 0; i < n; i++) out[i] = T##_tick(&bench_##T, in[i]); }
+
+#define BENCH_GENERATOR_PROCESS(T) \
+    static void runProcess_##T(const float* in, float* out, int n) { T##_process(&bench_##T, out, n); }
+
+#define BENCH_EFFECT_PROCESS(T) \
+    static void runProcess_##T(const float* in, float* out, int n) { T##_process(&bench_##T, in, out, n); }
+
+#define BENCH_TICK(T)       { #T, "tick", setup_##T, run_##T }
+#define BENCH_PROCESS(T)    { #T, "process", setup_##T, runProcess_##T }
+
+// Oscillators
+BENCH_GENERATOR(tCycle,      tCycle_init(&bench_tCycle); tCycle_setFreq(&bench_tCycle, 440.0f))
+BENCH_GENERATOR(tTriangle,   tTriangle_init(&bench_tTriangle); tTriangle_setFreq(&bench_tTriangle, 440.0f))
+BENCH_GENERATOR(tSquare,     tSquare_init(&bench_tSquare); tSquare_setFreq(&bench_tSquare, 440.0f))
+BENCH_GENERATOR(tSawtooth,   tSawtooth_init(&bench_tSawtooth); tSawtooth_setFreq(&bench_tSawtooth, 440.0f))
+BENCH_GENERATOR(tSine,       tSine_init(&bench_tSine, 2048); tSine_setFreq(&bench_tSine, 440.0f))
+BENCH_GENERATOR(tTri,        tTri_init(&bench_tTri); tTri_setFreq(&bench_tTri, 440.0f))
+BENCH_GENERATOR(tPulse,      tPulse_init(&bench_tPulse); tPulse_setFreq(&bench_tPulse, 440.0f))
+BENCH_GENERATOR(tSaw,        tSaw_init(&bench_tSaw); tSaw_setFreq(&bench_tSaw, 440.0f))
+BENCH_GENERATOR(tPhasor,     tPhasor_init(&bench_tPhasor); tPhasor_setFreq(&bench_tPhasor, 440.0f))
+BENCH_GENERATOR(tNoise,      tNoise_init(&bench_tNoise, PinkNoise))
+BENCH_GENERATOR(tMBPulse,    tMBPulse_init(&bench_tMBPulse); tMBPulse_setFreq(&bench_tMBPulse, 440.0f))
+BENCH_GENERATOR(tMBTriangle, tMBTriangle_init(&bench_tMBTriangle); tMBTriangle_setFreq(&bench_tMBTriangle, 440.0f))
+BENCH_GENERATOR(tMBSaw,      tMBSaw_init(&bench_tMBSaw); tMBSaw_setFreq(&bench_tMBSaw, 440.0f))
+BENCH_GENERATOR(tNeuron,     tNeuron_init(&bench_tNeuron))
+
+// Eight voices in one bank, against eight separate oscillators
+#define BENCH_NUM_VOICES 8
+
+static tOscBank benchOscBank;
+static void setupOscBank(OscBankWaveform waveform)
+{
+    tOscBank_init(&benchOscBank, BENCH_NUM_VOICES, waveform);
+    for (int v = 0; v < BENCH_NUM_VOICES; v++) tOscBank_setFreq(&benchOscBank, v, 110.0f * (v + 1));
+}
+static void setup_tOscBankSine(void) { setupOscBank(OscBankSine); }
+static void setup_tOscBankSawtooth(void) { setupOscBank(OscBankSawtooth); }
+static void run_tOscBank(const float* in, float* out, int n) { tOscBank_process(&benchOscBank, out, n); }
+
+static tCycle benchCycles[BENCH_NUM_VOICES];
+static void setup_tCycleVoices(void)
+{
+    for (int v = 0; v < BENCH_NUM_VOICES; v++)
+    {
+        tCycle_init(&benchCycles[v]);
+        tCycle_setFreq(&benchCycles[v], 110.0f * (v + 1));
+    }
+}
+static void run_tCycleVoices(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        float sum = 0.0f;
+        for (int v = 0; v < BENCH_NUM_VOICES; v++) sum += tCycle_tick(&benchCycles[v]);
+        out[i] = sum;
+    }
+}
+
+static tSawtooth benchSawtooths[BENCH_NUM_VOICES];
+static void setup_tSawtoothVoices(void)
+{
+    for (int v = 0; v < BENCH_NUM_VOICES; v++)
+    {
+        tSawtooth_init(&benchSawtooths[v]);
+        tSawtooth_setFreq(&benchSawtooths[v], 110.0f * (v + 1));
+    }
+}
+static void run_tSawtoothVoices(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        float sum = 0.0f;
+        for (int v = 0; v < BENCH_NUM_VOICES; v++) sum += tSawtooth_tick(&benchSawtooths[v]);
+        out[i] = sum;
+    }
+}
+
+BENCH_GENERATOR_PROCESS(tCycle)
+BENCH_GENERATOR_PROCESS(tTriangle)
+BENCH_GENERATOR_PROCESS(tSquare)
+BENCH_GENERATOR_PROCESS(tSawtooth)
+BENCH_GENERATOR_PROCESS(tPhasor)
+BENCH_GENERATOR_PROCESS(tSine)
+BENCH_GENERATOR_PROCESS(tNoise)
+
+// A 16 frame table of pulses narrowing across the frames, scanned halfway between two frames
+static float benchWaveFrames[16 * 2048];
+static tWaveTable bench_tWaveTable;
+static void setup_tWaveTable(void)
+{
+    for (int f = 0; f < 16; f++)
+        for (int i = 0; i < 2048; i++)
+            benchWaveFrames[(f * 2048) + i] = (i < (1024 - (f * 60))) ? 1.0f : -1.0f;
+    tWaveTable_init(&bench_tWaveTable, benchWaveFrames, 2048, 16);
+    tWaveTable_setFreq(&bench_tWaveTable, 440.0f);
+    tWaveTable_setIndex(&bench_tWaveTable, 0.3f);
+}
+static void run_tWaveTable(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tWaveTable_tick(&bench_tWaveTable);
+}
+BENCH_GENERATOR_PROCESS(tWaveTable)
+
+// Filters
+BENCH_EFFECT(tOnePole,      tOnePole_init(&bench_tOnePole, 1000.0f))
+BENCH_EFFECT(tTwoPole,      tTwoPole_init(&bench_tTwoPole); tTwoPole_setResonance(&bench_tTwoPole, 1000.0f, 0.99f, 1))
+BENCH_EFFECT(tBiQuad,       tBiQuad_init(&bench_tBiQuad); tBiQuad_setResonance(&bench_tBiQuad, 1000.0f, 0.99f, 1))
+BENCH_EFFECT(tSVF,          tSVF_init(&bench_tSVF, SVFTypeLowpass, 1000.0f, 0.7f))
+BENCH_EFFECT(tEfficientSVF, tEfficientSVF_init(&bench_tEfficientSVF, SVFTypeLowpass, 2000, 0.7f))
+BENCH_EFFECT(tHighpass,     tHighpass_init(&bench_tHighpass, 30.0f))
+BENCH_EFFECT(tButterworth,  tButterworth_init(&bench_tButterworth, 4, 200.0f, 2000.0f))
+BENCH_EFFECT(tVZFilter,     tVZFilter_init(&bench_tVZFilter, Bell, 1000.0f, 1.9f))
+BENCH_EFFECT(tDiodeFilter,  tDiodeFilter_init(&bench_tDiodeFilter, 1000.0f, 0.5f))
+BENCH_EFFECT(tMedianFilter, tMedianFilter_init(&bench_tMedianFilter, 5))
+
+BENCH_EFFECT_PROCESS(tOnePole)
+BENCH_EFFECT_PROCESS(tTwoPole)
+BENCH_EFFECT_PROCESS(tBiQuad)
+BENCH_EFFECT_PROCESS(tSVF)
+BENCH_EFFECT_PROCESS(tHighpass)
+BENCH_EFFECT_PROCESS(tVZFilter)
+BENCH_EFFECT_PROCESS(tDiodeFilter)
+
+// Four band EQ on the three piezo channels, as a chain of tBiQuad ticks per channel and as one
+// cascade. The tVZFilters only calculate the coefficients, so both run exactly the same sections.
+#define BENCH_NUM_CHANNELS 3
+
+static tVZFilter benchEQ[BENCH_NUM_CHANNELS][4];
+static void setup_tVZFilterEQ(void)
+{
+    for (int ch = 0; ch < BENCH_NUM_CHANNELS; ch++)
+    {
+        tVZFilter_init(&benchEQ[ch][0], Lowshelf, 80.0f, 4.0f);
+        tVZFilter_init(&benchEQ[ch][1], Highshelf, 12000.0f, 4.0f);
+        tVZFilter_init(&benchEQ[ch][2], Bell, 1000.0f, 1.9f);
+        tVZFilter_init(&benchEQ[ch][3], Bell, 6000.0f, 1.9f);
+    }
+}
+
+static tFilterCascade benchCascade;
+static float benchInterleaved[BENCH_BLOCK_SIZE * BENCH_NUM_CHANNELS];
+static void setup_tFilterCascadeEQ(void)
+{
+    setup_tVZFilterEQ();
+    tFilterCascade_init(&benchCascade, 4, BENCH_NUM_CHANNELS);
+    for (int b = 0; b < 4; b++) tFilterCascade_setSectionFromVZFilter(&benchCascade, b, &benchEQ[0][b]);
+    for (int i = 0; i < BENCH_BLOCK_SIZE * BENCH_NUM_CHANNELS; i++) benchInterleaved[i] = benchIn[i / BENCH_NUM_CHANNELS];
+}
+
+static tBiQuad benchBiQuads[BENCH_NUM_CHANNELS][4];
+static void setup_tBiQuadEQ(void)
+{
+    setup_tFilterCascadeEQ();
+    const float* c = benchCascade->coeffs;
+    for (int ch = 0; ch < BENCH_NUM_CHANNELS; ch++)
+    {
+        for (int b = 0; b < 4; b++)
+        {
+            tBiQuad_init(&benchBiQuads[ch][b]);
+            tBiQuad_setCoefficients(&benchBiQuads[ch][b], c[5*b], c[5*b+1], c[5*b+2], c[5*b+3], c[5*b+4]);
+        }
+    }
+}
+static void run_tBiQuadEQ(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        for (int ch = 0; ch < BENCH_NUM_CHANNELS; ch++)
+        {
+            float x = benchInterleaved[(i * BENCH_NUM_CHANNELS) + ch];
+            for (int b = 0; b < 4; b++) x = tBiQuad_tick(&benchBiQuads[ch][b], x);
+            benchInterleaved[(i * BENCH_NUM_CHANNELS) + ch] = x;
+        }
+    }
+    out[0] = benchInterleaved[0];
+}
+static void run_tFilterCascadeEQ(const float* in, float* out, int n)
+{
+    tFilterCascade_processInterleaved(&benchCascade, benchInterleaved, benchInterleaved, n);
+    out[0] = benchInterleaved[0];
+}
+
+static tFIR bench_tFIR;
+static float benchFIRCoeffs[64];
+static void setup_tFIR(void)
+{
+    for (int i = 0; i < 64; i++) benchFIRCoeffs[i] = 1.0f / 64.0f;
+    tFIR_init(&bench_tFIR, benchFIRCoeffs, 64);
+}
+static void run_tFIR(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tFIR_tick(&bench_tFIR, in[i]);
+}
+
+// A decaying noise IR, like a short drum shell body, direct against partitioned
+#define BENCH_IR_MAX 4096
+static float benchIR[BENCH_IR_MAX];
+static void setupBenchIR(int length)
+{
+    for (int i = 0; i < length; i++) benchIR[i] = ((benchRandom() * 2.0f) - 1.0f) * expf(-6.0f * i / length);
+}
+static void setup_tFIR1024(void) { setupBenchIR(1024); tFIR_init(&bench_tFIR, benchIR, 1024); }
+
+static tConvolver benchConvolver;
+static void setup_tConvolver1024(void) { setupBenchIR(1024); tConvolver_init(&benchConvolver, benchIR, 1024, BENCH_BLOCK_SIZE); }
+static void setup_tConvolver4096(void) { setupBenchIR(4096); tConvolver_init(&benchConvolver, benchIR, 4096, BENCH_BLOCK_SIZE); }
+static void run_tConvolver(const float* in, float* out, int n) { tConvolver_process(&benchConvolver, in, out, n); }
+
+// FFTs, one 1024 point forward and inverse transform per block, as a spectral
+// process hopping every block would do. The Mayer FFT is what tSNAC used before tFFT.
+#define BENCH_FFT_SIZE 1024
+static float benchFFTBuffer[BENCH_FFT_SIZE];
+static tFFT benchFFT;
+static void setup_FFTBuffer(void) { for (int i = 0; i < BENCH_FFT_SIZE; i++) benchFFTBuffer[i] = (benchRandom() * 2.0f) - 1.0f; }
+static void setup_tFFT(void) { setup_FFTBuffer(); tFFT_init(&benchFFT, BENCH_FFT_SIZE, FFTReal); }
+static void run_tFFT(const float* in, float* out, int n)
+{
+    benchFFTBuffer[0] = in[0];
+    tFFT_forward(&benchFFT, benchFFTBuffer, benchFFTBuffer);
+    tFFT_inverse(&benchFFT, benchFFTBuffer, benchFFTBuffer);
+    for (int i = 0; i < n; i++) out[i] = benchFFTBuffer[i] * (1.0f / BENCH_FFT_SIZE);
+}
+static void run_mayerFFT(const float* in, float* out, int n)
+{
+    benchFFTBuffer[0] = in[0];
+    mayer_realfft(BENCH_FFT_SIZE, benchFFTBuffer);
+    mayer_realifft(BENCH_FFT_SIZE, benchFFTBuffer);
+    for (int i = 0; i < n; i++) out[i] = benchFFTBuffer[i] * (1.0f / BENCH_FFT_SIZE);
+}
+
+// Delays
+BENCH_EFFECT(tDelay,        tDelay_init(&bench_tDelay, 4800, 9600); tDelay_clear(&bench_tDelay))
+BENCH_EFFECT(tLinearDelay,  tLinearDelay_init(&bench_tLinearDelay, 4800.5f, 9600); tLinearDelay_clear(&bench_tLinearDelay))
+BENCH_EFFECT(tHermiteDelay, tHermiteDelay_init(&bench_tHermiteDelay, 4800.5f, 9600); tHermiteDelay_clear(&bench_tHermiteDelay))
+BENCH_EFFECT(tTapeDelay,    tTapeDelay_init(&bench_tTapeDelay, 4800.5f, 9600))
+
+BENCH_EFFECT_PROCESS(tDelay)
+BENCH_EFFECT_PROCESS(tLinearDelay)
+
+// Envelopes
+BENCH_GENERATOR(tRamp,      tRamp_init(&bench_tRamp, 7.0f, 1))
+BENCH_GENERATOR(tExpSmooth, tExpSmooth_init(&bench_tExpSmooth, 0.0f, 0.01f))
+
+BENCH_GENERATOR_PROCESS(tRamp)
+BENCH_GENERATOR_PROCESS(tExpSmooth)
+
+#define BENCH_ENVELOPE(T, INIT, ON) \
+    static T bench_##T; \
+    static void setup_##T(void) { INIT; } \
+    static void run_##T(const float* in, float* out, int n) \
+    { \
+        if (benchRetrigger(n)) ON; \
+        for (int i = 0; i < n; i++) out[i] = T##_tick(&bench_##T); \
+    }
+
+BENCH_ENVELOPE(tEnvelope, tEnvelope_init(&bench_tEnvelope, 5.0f, 200.0f, 0), tEnvelope_on(&bench_tEnvelope, 1.0f))
+BENCH_ENVELOPE(tADSR,     tADSR_init(&bench_tADSR, 5.0f, 50.0f, 0.5f, 100.0f), tADSR_on(&bench_tADSR, 1.0f))
+BENCH_ENVELOPE(tADSR2,    tADSR2_init(&bench_tADSR2, 5.0f, 50.0f, 0.5f, 100.0f), tADSR2_on(&bench_tADSR2, 1.0f))
+BENCH_ENVELOPE(tADSR3,    tADSR3_init(&bench_tADSR3, 5.0f, 50.0f, 0.5f, 100.0f), tADSR3_on(&bench_tADSR3, 1.0f))
+
+static void runProcess_tEnvelope(const float* in, float* out, int n)
+{
+    if (benchRetrigger(n)) tEnvelope_on(&bench_tEnvelope, 1.0f);
+    tEnvelope_process(&bench_tEnvelope, out, n);
+}
+
+// Reverbs
+BENCH_EFFECT(tPRCReverb,      tPRCReverb_init(&bench_tPRCReverb, 1.0f))
+BENCH_EFFECT(tNReverb,        tNReverb_init(&bench_tNReverb, 1.0f))
+BENCH_EFFECT(tDattorroReverb, tDattorroReverb_init(&bench_tDattorroReverb))
+
+BENCH_EFFECT_PROCESS(tPRCReverb)
+BENCH_EFFECT_PROCESS(tNReverb)
+BENCH_EFFECT_PROCESS(tDattorroReverb)
+
+// Distortion, dynamics, electrical
+BENCH_EFFECT(tLockhartWavefolder, tLockhartWavefolder_init(&bench_tLockhartWavefolder))
+BENCH_EFFECT_PROCESS(tLockhartWavefolder)
+static void runFast_tLockhartWavefolder(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tLockhartWavefolder_tickFast(&bench_tLockhartWavefolder, in[i]);
+}
+BENCH_EFFECT(tCrusher,            tCrusher_init(&bench_tCrusher))
+BENCH_EFFECT(tSampleReducer,      tSampleReducer_init(&bench_tSampleReducer))
+BENCH_EFFECT(tCompressor,         tCompressor_init(&bench_tCompressor))
+BENCH_EFFECT(tEnvelopeFollower,   tEnvelopeFollower_init(&bench_tEnvelopeFollower, 0.001f, 0.999f))
+
+// The per-block check on a clean block, which is the cost it adds nearly all the time
+static tNumericGuard bench_tNumericGuard;
+static void setup_tNumericGuard(void)
+{
+    tNumericGuard_init(&bench_tNumericGuard, NULL, NULL);
+}
+static void runProcess_tNumericGuard(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = in[i];
+    tNumericGuard_check(&bench_tNumericGuard, out, n);
+}
+
+// Diode clippers, walking the tWDF tree every sample and compiled to a tWDFFlat.
+// The single stage is a resistive source and capacitor in parallel into a diode pair,
+// the two stage one puts an RC in front of that.
+static tWDF benchClipperNodes[8];
+static tWDF* benchClipperRoot;
+static tWDF* benchClipperOut;
+static tWDFFlat bench_tWDFFlat;
+
+static void setupClipper(int stages)
+{
+    tWDF* n = benchClipperNodes;
+    tWDF_init(&n[0], ResistiveSource, 2200.0f, NULL, NULL);
+    tWDF_init(&n[1], Capacitor, 47.0e-9f, NULL, NULL);
+    tWDF_init(&n[2], ParallelAdaptor, 0.0f, &n[0], &n[1]);
+    if (stages == 1)
+    {
+        tWDF_init(&n[3], DiodePair, 0.0f, &n[2], NULL);
+        benchClipperRoot = &n[3];
+        benchClipperOut = &n[1];
+        return;
+    }
+    tWDF_init(&n[3], Resistor, 4700.0f, NULL, NULL);
+    tWDF_init(&n[4], SeriesAdaptor, 0.0f, &n[2], &n[3]);
+    tWDF_init(&n[5], Capacitor, 10.0e-9f, NULL, NULL);
+    tWDF_init(&n[6], ParallelAdaptor, 0.0f, &n[4], &n[5]);
+    tWDF_init(&n[7], DiodePair, 0.0f, &n[6], NULL);
+    benchClipperRoot = &n[7];
+    benchClipperOut = &n[5];
+}
+static void setup_tWDF(void)            { setupClipper(1); }
+static void setup_tWDF2(void)           { setupClipper(2); }
+static void setup_tWDFFlat(void)        { setupClipper(1); tWDFFlat_init(&bench_tWDFFlat, benchClipperRoot, benchClipperOut); }
+static void setup_tWDFFlat2(void)       { setupClipper(2); tWDFFlat_init(&bench_tWDFFlat, benchClipperRoot, benchClipperOut); }
+static void run_tWDF(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tWDF_tick(benchClipperRoot, in[i], benchClipperOut, 0);
+}
+BENCH_EFFECT_PROCESS(tWDFFlat)
+static void run_tWDFFlat(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tWDFFlat_tick(&bench_tWDFFlat, in[i]);
+}
+
+// Effects
+static tTalkbox bench_tTalkbox;
+static void setup_tTalkbox(void)
+{
+    tTalkbox_init(&bench_tTalkbox, 1024);
+}
+static void run_tTalkbox(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tTalkbox_tick(&bench_tTalkbox, in[i], in[n-1-i]);
+}
+
+static tRetune bench_tRetune;
+static void setup_tRetune(void)
+{
+    tRetune_init(&bench_tRetune, 1, 2048, 1024);
+    tRetune_setPitchFactor(&bench_tRetune, 1.5f, 0);
+}
+static void run_tRetune(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tRetune_tick(&bench_tRetune, in[i])[0];
+}
+
+// Instruments
+#define BENCH_DRUM(T, INIT) \
+    static T bench_##T; \
+    static void setup_##T(void) { INIT; } \
+    static void run_##T(const float* in, float* out, int n) \
+    { \
+        if (benchRetrigger(n)) T##_on(&bench_##T, 1.0f); \
+        for (int i = 0; i < n; i++) out[i] = T##_tick(&bench_##T); \
+    }
+
+BENCH_DRUM(t808Kick,    t808Kick_init(&bench_t808Kick))
+BENCH_DRUM(t808Snare,   t808Snare_init(&bench_t808Snare))
+BENCH_DRUM(t808Hihat,   t808Hihat_init(&bench_t808Hihat))
+BENCH_DRUM(t808Cowbell, t808Cowbell_init(&bench_t808Cowbell, 0))
+
+// A kit that isn't being played and a reverb with nothing going in, what sleeping saves
+static void setup_t808Idle(void)
+{
+    t808Kick_init(&bench_t808Kick);
+    t808Snare_init(&bench_t808Snare);
+    t808Hihat_init(&bench_t808Hihat);
+    t808Cowbell_init(&bench_t808Cowbell, 0);
+}
+static void run_t808Idle(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = t808Kick_tick(&bench_t808Kick) + t808Snare_tick(&bench_t808Snare) +
+                 t808Hihat_tick(&bench_t808Hihat) + t808Cowbell_tick(&bench_t808Cowbell);
+}
+
+static float benchSilence[BENCH_BLOCK_SIZE];
+static void runSilent_tDattorroReverb(const float* in, float* out, int n)
+{
+    tDattorroReverb_process(&bench_tDattorroReverb, benchSilence, out, n);
+}
+
+// Physical models
+static tKarplusStrong bench_tKarplusStrong;
+static void setup_tKarplusStrong(void)
+{
+    tKarplusStrong_init(&bench_tKarplusStrong, 50.0f);
+    tKarplusStrong_setFrequency(&bench_tKarplusStrong, 220.0f);
+}
+static void run_tKarplusStrong(const float* in, float* out, int n)
+{
+    if (benchRetrigger(n)) tKarplusStrong_pluck(&bench_tKarplusStrong, 1.0f);
+    for (int i = 0; i < n; i++) out[i] = tKarplusStrong_tick(&bench_tKarplusStrong);
+}
+
+// 64 modes of a rectangular plate, as a tModalBank and as separate tTwoPoles
+#define BENCH_NUM_MODES 64
+
+static float benchModeFreq(int mode)
+{
+    int m = (mode % 8) + 1, k = (mode / 8) + 1;
+    return 80.0f * ((float)(m * m) + (1.9f * (float)(k * k)));
+}
+
+static tModalBank bench_tModalBank;
+static void setup_tModalBank(void)
+{
+    tModalBank_init(&bench_tModalBank, BENCH_NUM_MODES);
+    for (int i = 0; i < BENCH_NUM_MODES; i++)
+        tModalBank_setMode(&bench_tModalBank, i, benchModeFreq(i), 1.0f, 1.0f / (float)(i + 1));
+}
+static void run_tModalBank(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tModalBank_tick(&bench_tModalBank, in[i]);
+}
+BENCH_EFFECT_PROCESS(tModalBank)
+
+static tTwoPole benchTwoPoles[BENCH_NUM_MODES];
+static void setup_tTwoPoleModes(void)
+{
+    for (int i = 0; i < BENCH_NUM_MODES; i++)
+    {
+        tTwoPole_init(&benchTwoPoles[i]);
+        tTwoPole_setResonance(&benchTwoPoles[i], benchModeFreq(i), 0.99986f, 1);
+    }
+}
+static void run_tTwoPoleModes(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        float sum = 0.0f;
+        for (int k = 0; k < BENCH_NUM_MODES; k++) sum += tTwoPole_tick(&benchTwoPoles[k], in[i]);
+        out[i] = sum;
+    }
+}
+
+// Samplers, one looping through a two second hit stored in each buffer format. mempool_bytes shows
+// what each format costs.
+#define BENCH_SAMPLE_LENGTH 96000
+
+static void benchFillSample(float* sample)
+{
+    for (int i = 0; i < BENCH_SAMPLE_LENGTH; i++)
+    {
+        float t = (float)i / BENCH_SAMPLE_RATE;
+        float tone = sinf(TWO_PI * 110.0f * t) + (0.5f * sinf(TWO_PI * 1870.0f * t));
+        sample[i] = expf(-3.0f * t) * ((0.5f * tone) + (0.2f * ((benchRandom() * 2.0f) - 1.0f)));
+    }
+}
+
+static tBuffer benchSampleBuffer;
+static tSampler bench_tSampler;
+static void setupSampler(BufferFormat format, float rate)
+{
+    static float sample[BENCH_SAMPLE_LENGTH];
+    benchFillSample(sample);
+    tBuffer_initWithFormat(&benchSampleBuffer, BENCH_SAMPLE_LENGTH, format);
+    tBuffer_read(&benchSampleBuffer, sample, BENCH_SAMPLE_LENGTH);
+    tSampler_init(&bench_tSampler, &benchSampleBuffer);
+    tSampler_setSample(&bench_tSampler, &benchSampleBuffer);
+    tSampler_setMode(&bench_tSampler, PlayLoop);
+    tSampler_setRate(&bench_tSampler, rate);
+    tSampler_play(&bench_tSampler);
+}
+static void setup_tSamplerFloat(void) { setupSampler(BufferFloat, 1.37f); }
+static void setup_tSamplerInt16(void) { setupSampler(BufferInt16, 1.37f); }
+static void setup_tSamplerInt24(void) { setupSampler(BufferInt24, 1.37f); }
+static void run_tSampler(const float* in, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = tSampler_tick(&bench_tSampler);
+}
+static void runProcess_tSampler(const float* in, float* out, int n)
+{
+    tSampler_process(&bench_tSampler, out, n);
+}
+static void setup_tSamplerLinear(void)
+{
+    setupSampler(BufferFloat, 1.37f);
+    tSampler_setQuality(&bench_tSampler, InterpolationLinear);
+}
+static void setup_tSamplerSinc(void)
+{
+    setupSampler(BufferFloat, 1.37f);
+    tSampler_setQuality(&bench_tSampler, InterpolationSinc);
+}
+
+// A kit of 3 pads with two velocity layers and two round robin samples in each, hit every 1000
+// samples with a changing pad and velocity so about 16 voices overlap
+#define BENCH_KIT_ZONES 12
+#define BENCH_KIT_VOICES 16
+
+static tMultiSampler bench_tMultiSampler;
+static tBuffer benchKitBuffers[BENCH_KIT_ZONES];
+static uint32_t benchKitCounter;
+static int benchKitHits;
+static void setup_tMultiSampler(void)
+{
+    static float sample[BENCH_SAMPLE_LENGTH];
+    tMultiSampler_init(&bench_tMultiSampler, 3, BENCH_KIT_ZONES, BENCH_KIT_VOICES);
+    for (int z = 0; z < BENCH_KIT_ZONES; z++)
+    {
+        benchFillSample(sample);
+        tBuffer_initWithFormat(&benchKitBuffers[z], BENCH_SAMPLE_LENGTH, BufferInt16);
+        tBuffer_read(&benchKitBuffers[z], sample, BENCH_SAMPLE_LENGTH);
+        int layer = (z / 2) % 2;
+        tMultiSampler_addZone(&bench_tMultiSampler, &benchKitBuffers[z], z / 4, layer * 0.5f, 0.5f + (layer * 0.5f));
+        tMultiSampler_setZoneTuning(&bench_tMultiSampler, z, (float)(z % 5) - 2.0f);
+    }
+    benchKitCounter = 0;
+    benchKitHits = 0;
+}
+static void benchKitRetrigger(int n)
+{
+    benchKitCounter += n;
+    if (benchKitCounter >= 1000)
+    {
+        benchKitCounter -= 1000;
+        benchKitHits++;
+        tMultiSampler_trigger(&bench_tMultiSampler, benchKitHits % 3, (float)((benchKitHits * 7) % 10) * 0.1f + 0.05f);
+    }
+}
+static void run_tMultiSampler(const float* in, float* out, int n)
+{
+    benchKitRetrigger(n);
+    for (int i = 0; i < n; i++) out[i] = tMultiSampler_tick(&bench_tMultiSampler);
+}
+static void runProcess_tMultiSampler(const float* in, float* out, int n)
+{
+    benchKitRetrigger(n);
+    tMultiSampler_process(&bench_tMultiSampler, out, n);
+}
+
+//==============================================================================
+
+static const BenchCase benchCases[] =
+{
+    BENCH_TICK(tCycle),         BENCH_PROCESS(tCycle),
+    BENCH_TICK(tTriangle),      BENCH_PROCESS(tTriangle),
+    BENCH_TICK(tSquare),        BENCH_PROCESS(tSquare),
+    BENCH_TICK(tSawtooth),      BENCH_PROCESS(tSawtooth),
+    BENCH_TICK(tSine),          BENCH_PROCESS(tSine),
+    BENCH_TICK(tTri),
+    BENCH_TICK(tPulse),
+    BENCH_TICK(tSaw),
+    BENCH_TICK(tPhasor),        BENCH_PROCESS(tPhasor),
+    BENCH_TICK(tNoise),         BENCH_PROCESS(tNoise),
+    BENCH_TICK(tMBPulse),
+    BENCH_TICK(tMBTriangle),
+    BENCH_TICK(tMBSaw),
+    BENCH_TICK(tNeuron),
+    BENCH_TICK(tWaveTable),     BENCH_PROCESS(tWaveTable),
+    { "tCycle x8", "tick", setup_tCycleVoices, run_tCycleVoices },
+    { "tOscBank sine x8", "process", setup_tOscBankSine, run_tOscBank },
+    { "tSawtooth x8", "tick", setup_tSawtoothVoices, run_tSawtoothVoices },
+    { "tOscBank sawtooth x8", "process", setup_tOscBankSawtooth, run_tOscBank },
+
+    BENCH_TICK(tOnePole),       BENCH_PROCESS(tOnePole),
+    BENCH_TICK(tTwoPole),       BENCH_PROCESS(tTwoPole),
+    BENCH_TICK(tBiQuad),        BENCH_PROCESS(tBiQuad),
+    BENCH_TICK(tSVF),           BENCH_PROCESS(tSVF),
+    BENCH_TICK(tEfficientSVF),
+    BENCH_TICK(tHighpass),      BENCH_PROCESS(tHighpass),
+    BENCH_TICK(tButterworth),
+    BENCH_TICK(tVZFilter),      BENCH_PROCESS(tVZFilter),
+    BENCH_TICK(tDiodeFilter),   BENCH_PROCESS(tDiodeFilter),
+    BENCH_TICK(tMedianFilter),
+    BENCH_TICK(tFIR),
+    { "tFIR 1024 taps", "tick", setup_tFIR1024, run_tFIR },
+    { "tConvolver 1024 taps", "process", setup_tConvolver1024, run_tConvolver },
+    { "tConvolver 4096 taps", "process", setup_tConvolver4096, run_tConvolver },
+    { "mayer_realfft 1024 per block", "process", setup_FFTBuffer, run_mayerFFT },
+    { "tFFT real 1024 per block", "process", setup_tFFT, run_tFFT },
+    { "tBiQuad EQ x3ch", "tick", setup_tBiQuadEQ, run_tBiQuadEQ },
+    { "tFilterCascade EQ x3ch", "process", setup_tFilterCascadeEQ, run_tFilterCascadeEQ },
+
+    BENCH_TICK(tDelay),         BENCH_PROCESS(tDelay),
+    BENCH_TICK(tLinearDelay),   BENCH_PROCESS(tLinearDelay),
+    BENCH_TICK(tHermiteDelay),
+    BENCH_TICK(tTapeDelay),
+
+    BENCH_TICK(tRamp),          BENCH_PROCESS(tRamp),
+    BENCH_TICK(tExpSmooth),     BENCH_PROCESS(tExpSmooth),
+    BENCH_TICK(tEnvelope),      BENCH_PROCESS(tEnvelope),
+    BENCH_TICK(tADSR),
+    BENCH_TICK(tADSR2),
+    BENCH_TICK(tADSR3),
+
+    BENCH_TICK(tPRCReverb),     BENCH_PROCESS(tPRCReverb),
+    BENCH_TICK(tNReverb),       BENCH_PROCESS(tNReverb),
+    BENCH_TICK(tDattorroReverb), BENCH_PROCESS(tDattorroReverb),
+
+    BENCH_TICK(tLockhartWavefolder),
+    { "tLockhartWavefolder", "tickFast", setup_tLockhartWavefolder, runFast_tLockhartWavefolder },
+    BENCH_PROCESS(tLockhartWavefolder),
+    BENCH_TICK(tCrusher),
+    BENCH_TICK(tSampleReducer),
+    BENCH_TICK(tCompressor),
+    BENCH_TICK(tEnvelopeFollower),
+    BENCH_PROCESS(tNumericGuard),
+    { "tWDF diode clipper", "tick", setup_tWDF, run_tWDF },
+    { "tWDFFlat diode clipper", "tick", setup_tWDFFlat, run_tWDFFlat },
+    { "tWDFFlat diode clipper", "process", setup_tWDFFlat, runProcess_tWDFFlat },
+    { "tWDF 2 stage clipper", "tick", setup_tWDF2, run_tWDF },
+    { "tWDFFlat 2 stage clipper", "tick", setup_tWDFFlat2, run_tWDFFlat },
+    { "tWDFFlat 2 stage clipper", "process", setup_tWDFFlat2, runProcess_tWDFFlat },
+
+    BENCH_TICK(tTalkbox),
+    BENCH_TICK(tRetune),
+
+    BENCH_TICK(t808Kick),
+    BENCH_TICK(t808Snare),
+    BENCH_TICK(t808Hihat),
+    BENCH_TICK(t808Cowbell),
+    { "t808 kit idle", "tick", setup_t808Idle, run_t808Idle },
+    { "tDattorroReverb silent input", "process", setup_tDattorroReverb, runSilent_tDattorroReverb },
+
+    BENCH_TICK(tKarplusStrong),
+    BENCH_TICK(tModalBank),     BENCH_PROCESS(tModalBank),
+    { "tTwoPole x64 modes", "tick", setup_tTwoPoleModes, run_tTwoPoleModes },
+
+    { "tSampler float", "tick", setup_tSamplerFloat, run_tSampler },
+    { "tSampler float", "process", setup_tSamplerFloat, runProcess_tSampler },
+    { "tSampler int16", "tick", setup_tSamplerInt16, run_tSampler },
+    { "tSampler int16", "process", setup_tSamplerInt16, runProcess_tSampler },
+    { "tSampler int24", "tick", setup_tSamplerInt24, run_tSampler },
+    { "tSampler int24", "process", setup_tSamplerInt24, runProcess_tSampler },
+    { "tSampler linear", "process", setup_tSamplerLinear, runProcess_tSampler },
+    { "tSampler sinc", "tick", setup_tSamplerSinc, run_tSampler },
+    { "tSampler sinc", "process", setup_tSamplerSinc, runProcess_tSampler },
+    { "tMultiSampler 16 voices", "tick", setup_tMultiSampler, run_tMultiSampler },
+    { "tMultiSampler 16 voices", "process", setup_tMultiSampler, runProcess_tMultiSampler },
+};
+
+static void benchRun(const BenchCase* bc, long numSamples)
+{
+    // Start every object from a fresh default mempool so earlier cases can't run it out of space.
+    LEAF_init(BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE, benchMemory, BENCH_MEM_SIZE, &benchRandom);
+    benchSeed = 22222;
+    benchCounter = BENCH_RETRIGGER;
+
+    bc->setup();
+
+    // One block to warm the caches before timing.
+    bc->run(benchIn, benchOut, BENCH_BLOCK_SIZE);
+
+    long numBlocks = numSamples / BENCH_BLOCK_SIZE;
+    float sink = 0.0f;
+
+    Profiler profiler;
+    profilerInit(&profiler, BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE);
+
+    double start = benchNow();
+    for (long b = 0; b < numBlocks; b++)
+    {
+        profilerBegin(&profiler, PROFILER_CALLBACK);
+        bc->run(benchIn, benchOut, BENCH_BLOCK_SIZE);
+        profilerEnd(&profiler, PROFILER_CALLBACK);
+        sink += benchOut[b & (BENCH_BLOCK_SIZE - 1)];
+    }
+    double elapsed = benchNow() - start;
+    benchSink = sink;
+
+    double samples = (double)numBlocks * BENCH_BLOCK_SIZE;
+    double nsPerSample = elapsed * 1.0e9 / samples;
+    double samplesPerSec = samples / elapsed;
+    double pctOfRealtime = 100.0 * BENCH_SAMPLE_RATE / samplesPerSec;
+
+    tMempoolStats stats;
+    tMempool_getStats(&leaf.mempool, &stats);
+
+    ProfilerReport block;
+    profilerGetReport(&profiler, PROFILER_CALLBACK, &block);
+
+    printf("%s,%s,%.3f,%.0f,%.4f,%.4f,%.4f,%.4f,%lu\n", bc->name, bc->mode, nsPerSample, samplesPerSec, pctOfRealtime,
+           block.minPercent, block.avgPercent, block.maxPercent, (unsigned long)stats.peakUsed);
+    fflush(stdout);
+}
+
+//==============================================================================
+// Accuracy of the float paths against the double precision code
+
+static void accuracyReport(const char* check, const char* input, double maxError, double peak)
+{
+    double db = (maxError > 0.0 && peak > 0.0) ? 20.0 * log10(maxError / peak) : -999.0;
+    printf("%s,%s,%.3g,%.4g,%.1f\n", check, input, maxError, peak, db);
+    fflush(stdout);
+}
+
+// Newton's method in double on w + ln(w) = x
+static double accuracyWrightOmega(double x)
+{
+    double w = (x < 1.0) ? exp(x) : x - log(x);
+    for (int i = 0; i < 50; i++) w -= (w + log(w) - x) * w / (1.0 + w);
+    return w;
+}
+
+// tick and process from the same starting state, on bursts of noise with silence between so the
+// reverbs fall asleep and wake back up
+static void accuracyProcessVsTick(const char* check, void (*setup)(void),
+                                  void (*tick)(const float* in, float* out, int n),
+                                  void (*process)(const float* in, float* out, int n))
+{
+    static float ref[(int)BENCH_SAMPLE_RATE * 4];
+    const int numBlocks = (int)(BENCH_SAMPLE_RATE * 4) / BENCH_BLOCK_SIZE;
+    double worst = 0.0, peak = 0.0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        // not every delay line clears its buffer on init, so don't let the second pass see the first
+        memset(benchMemory, 0, BENCH_MEM_SIZE);
+        LEAF_init(BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE, benchMemory, BENCH_MEM_SIZE, &benchRandom);
+        benchSeed = 22222;
+        benchCounter = BENCH_RETRIGGER;
+        setup();
+        float in[BENCH_BLOCK_SIZE];
+        float out[BENCH_BLOCK_SIZE];
+        for (int b = 0; b < numBlocks; b++)
+        {
+            // a quarter second of noise at the top of every second
+            int loud = ((b * BENCH_BLOCK_SIZE) % (int)BENCH_SAMPLE_RATE) < ((int)BENCH_SAMPLE_RATE / 4);
+            for (int i = 0; i < BENCH_BLOCK_SIZE; i++) in[i] = loud ? (benchRandom() - 0.5f) : 0.0f;
+            if (pass == 0)
+            {
+                tick(in, &ref[b * BENCH_BLOCK_SIZE], BENCH_BLOCK_SIZE);
+                continue;
+            }
+            process(in, out, BENCH_BLOCK_SIZE);
+            for (int i = 0; i < BENCH_BLOCK_SIZE; i++)
+            {
+                double y = ref[(b * BENCH_BLOCK_SIZE) + i];
+                if (fabs(y - out[i]) > worst) worst = fabs(y - out[i]);
+                if (fabs(y) > peak) peak = fabs(y);
+            }
+        }
+    }
+    accuracyReport(check, "noise bursts", worst, peak);
+}
+
+// ticks until every voice, the spare included, has gone idle
+static void accuracyKitSettle(tMultiSampler* kit)
+{
+    for (int n = 0; n < (int)BENCH_SAMPLE_RATE * 2; n++)
+    {
+        int busy = 0;
+        for (int i = 0; i <= (*kit)->numVoices; i++) busy |= ((*kit)->voices[i].sampler->active != 0);
+        if (!busy) return;
+        tMultiSampler_tick(kit);
+    }
+}
+
+// Which zone a tMultiSampler hit lands on, how loud it starts, and what happens when it runs out of
+// voices. The zones hold a constant so the level says which one is playing. Wrong results are
+// reported as the error, out of the number of checks.
+static void accuracyMultiSampler(void)
+{
+    LEAF_init(BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE, benchMemory, BENCH_MEM_SIZE, &benchRandom);
+    
+    // key 0 has a soft layer of 2 round robin zones and a hard one of 3, key 1 a single zone
+    static float level[4800];
+    tBuffer buffers[6];
+    tMultiSampler kit;
+    tMultiSampler_init(&kit, 2, 8, 4);
+    for (int z = 0; z < 6; z++)
+    {
+        for (int i = 0; i < 4800; i++) level[i] = (float)(z + 1) * 0.125f;
+        tBuffer_init(&buffers[z], 4800);
+        tBuffer_read(&buffers[z], level, 4800);
+    }
+    tMultiSampler_addZone(&kit, &buffers[0], 0, 0.0f, 0.5f);
+    tMultiSampler_addZone(&kit, &buffers[1], 0, 0.0f, 0.5f);
+    tMultiSampler_addZone(&kit, &buffers[2], 0, 0.5f, 1.0f);
+    tMultiSampler_addZone(&kit, &buffers[3], 0, 0.5f, 1.0f);
+    tMultiSampler_addZone(&kit, &buffers[4], 0, 0.5f, 1.0f);
+    tMultiSampler_addZone(&kit, &buffers[5], 1, 0.0f, 1.0f);
+    
+    int wrong = 0, soft = 0, hard = 0;
+    for (int h = 0; h < 12; h++)
+    {
+        int loud = (h % 3) != 0;
+        tMultiSampler_trigger(&kit, 0, loud ? 0.9f : 0.3f);
+        int expected = loud ? 2 + (hard++ % 3) : (soft++ % 2);
+        for (int i = 0; i < kit->numVoices; i++)
+        {
+            tMultiSamplerVoice* v = &kit->voices[i];
+            if ((v->sampler->active > 0) && (v->startTime == kit->time - 1) && (v->zone != expected)) wrong++;
+        }
+        for (int i = 0; i < 100; i++) tMultiSampler_tick(&kit);
+    }
+    accuracyReport("tMultiSampler layer and round robin", "12 hits over 2 layers", wrong, 12);
+    
+    // the first sample of a hit is at full level, with nothing else playing
+    accuracyKitSettle(&kit);
+    tMultiSampler_trigger(&kit, 1, 0.8f);
+    accuracyReport("tMultiSampler onset", "first sample of a hit", fabs(tMultiSampler_tick(&kit) - (0.75 * 0.8)), 0.75 * 0.8);
+    accuracyKitSettle(&kit);
+    
+    // fill the 4 voices, fade one out, then hit twice more
+    wrong = 0;
+    uint32_t steals = kit->numSteals;
+    tMultiSampler_trigger(&kit, 0, 0.9f);
+    for (int h = 0; h < 3; h++) tMultiSampler_trigger(&kit, 1, 1.0f);
+    uint32_t oldestKey1 = kit->time - 3;
+    tMultiSampler_stop(&kit, 0);
+    for (int i = 0; i < 10; i++) tMultiSampler_tick(&kit);
+    
+    // takes the voice fading out, which carries on fading in the spare
+    tMultiSamplerVoice* tail = &kit->voices[kit->numVoices];
+    tMultiSampler_trigger(&kit, 1, 1.0f);
+    if ((tail->key != 0) || (tail->sampler->active >= 0) || (kit->numSteals != steals + 1)) wrong++;
+    for (int i = 0; i < 400; i++) tMultiSampler_tick(&kit);
+    
+    // takes the oldest, which fades out instead of stopping dead, so the only jump is the new hit
+    float before = tMultiSampler_tick(&kit);
+    tMultiSampler_trigger(&kit, 1, 1.0f);
+    float after = tMultiSampler_tick(&kit);
+    if ((tail->startTime != oldestKey1) || (tail->sampler->active >= 0) || (kit->numSteals != steals + 2)) wrong++;
+    if (fabsf((after - before) - 0.75f) > 0.01f) wrong++;
+    for (int i = 0; i < 1000; i++) tMultiSampler_tick(&kit);
+    if (tail->sampler->active != 0) wrong++;
+    accuracyReport("tMultiSampler stealing", "a fading voice first then the oldest", wrong, 4);
+    
+    tMultiSampler_free(&kit);
+    for (int z = 0; z < 6; z++) tBuffer_free(&buffers[z]);
+    
+    accuracyProcessVsTick("tMultiSampler process vs tick", setup_tMultiSampler, run_tMultiSampler, runProcess_tMultiSampler);
+}
+
+static void accuracyChecks(void)
+{
+    printf("check,input,max_abs_error,reference_peak,error_db\n");
+    
+    const float ranges[][2] = { { -30.0f, -3.0f }, { -3.0f, 2.0f }, { 2.0f, 900.0f } };
+    const char* omegas[] = { "LEAF_wrightOmega4", "LEAF_wrightOmega" };
+    for (int k = 0; k < 2; k++)
+    {
+        for (int r = 0; r < 3; r++)
+        {
+            // Relative error, so the peak is 1
+            double worst = 0.0;
+            for (int i = 0; i <= 100000; i++)
+            {
+                float x = ranges[r][0] + ((ranges[r][1] - ranges[r][0]) * (float)i / 100000.0f);
+                double ref = accuracyWrightOmega(x);
+                double w = (k == 0) ? LEAF_wrightOmega4(x) : LEAF_wrightOmega(x);
+                double e = fabs(w - ref) / ref;
+                if (e > worst) worst = e;
+            }
+            char input[64];
+            snprintf(input, sizeof(input), "x from %g to %g (relative)", ranges[r][0], ranges[r][1]);
+            accuracyReport(omegas[k], input, worst, 1.0);
+        }
+    }
+    
+    // Amplitudes above about 9 overflow the double version's exp(), so stop short of that
+    const float freqs[] = { 20.0f, 200.0f, 2000.0f, 8000.0f };
+    const float amps[] = { 0.1f, 1.0f, 4.0f, 8.0f };
+    for (int f = 0; f < 4; f++)
+    {
+        for (int a = 0; a < 4; a++)
+        {
+            LEAF_init(BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE, benchMemory, BENCH_MEM_SIZE, &benchRandom);
+            tLockhartWavefolder ref, fast;
+            tLockhartWavefolder_init(&ref);
+            tLockhartWavefolder_init(&fast);
+            
+            double worst = 0.0, peak = 0.0;
+            float block[BENCH_BLOCK_SIZE];
+            float out[BENCH_BLOCK_SIZE];
+            for (int b = 0; b < (int)BENCH_SAMPLE_RATE / BENCH_BLOCK_SIZE; b++)
+            {
+                for (int i = 0; i < BENCH_BLOCK_SIZE; i++)
+                    block[i] = amps[a] * sinf(TWO_PI * freqs[f] * (float)((b * BENCH_BLOCK_SIZE) + i) / BENCH_SAMPLE_RATE);
+                tLockhartWavefolder_process(&fast, block, out, BENCH_BLOCK_SIZE);
+                for (int i = 0; i < BENCH_BLOCK_SIZE; i++)
+                {
+                    double y = tLockhartWavefolder_tick(&ref, block[i]);
+                    if (fabs(y - out[i]) > worst) worst = fabs(y - out[i]);
+                    if (fabs(y) > peak) peak = fabs(y);
+                }
+            }
+            char input[64];
+            snprintf(input, sizeof(input), "sine %g Hz amplitude %g", freqs[f], amps[a]);
+            accuracyReport("tLockhartWavefolder process vs tick", input, worst, peak);
+        }
+    }
+    
+    accuracyProcessVsTick("tNReverb process vs tick", setup_tNReverb, run_tNReverb, runProcess_tNReverb);
+    accuracyProcessVsTick("tDattorroReverb process vs tick", setup_tDattorroReverb, run_tDattorroReverb, runProcess_tDattorroReverb);
+    accuracyProcessVsTick("tDiodeFilter process vs tick", setup_tDiodeFilter, run_tDiodeFilter, runProcess_tDiodeFilter);
+    accuracyProcessVsTick("tEnvelope process vs tick", setup_tEnvelope, run_tEnvelope, runProcess_tEnvelope);
+    accuracyMultiSampler();
+    
+    // A sine voice of the bank runs the same phase accumulator as tCycle, so they should agree exactly
+    const float bankFreqs[] = { 110.0f, 4000.0f, -330.0f };
+    for (int f = 0; f < 3; f++)
+    {
+        LEAF_init(BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE, benchMemory, BENCH_MEM_SIZE, &benchRandom);
+        tOscBank bank;
+        tCycle cycle;
+        tOscBank_init(&bank, 1, OscBankSine);
+        tCycle_init(&cycle);
+        tOscBank_setFreq(&bank, 0, bankFreqs[f]);
+        tCycle_setFreq(&cycle, bankFreqs[f]);
+        
+        double worst = 0.0, peak = 0.0;
+        float ref[BENCH_BLOCK_SIZE];
+        float out[BENCH_BLOCK_SIZE];
+        for (int b = 0; b < (int)BENCH_SAMPLE_RATE / BENCH_BLOCK_SIZE; b++)
+        {
+            tCycle_process(&cycle, ref, BENCH_BLOCK_SIZE);
+            tOscBank_process(&bank, out, BENCH_BLOCK_SIZE);
+            for (int i = 0; i < BENCH_BLOCK_SIZE; i++)
+            {
+                if (fabs((double)ref[i] - out[i]) > worst) worst = fabs((double)ref[i] - out[i]);
+                if (fabs(ref[i]) > peak) peak = fabs(ref[i]);
+            }
+        }
+        char input[64];
+        snprintf(input, sizeof(input), "%g Hz", bankFreqs[f]);
+        accuracyReport("tOscBank sine vs tCycle", input, worst, peak);
+    }
+    
+    // The packed buffer formats against the float one, with the sampler interpolating between samples
+    const BufferFormat formats[] = { BufferInt16, BufferInt24 };
+    const char* formatNames[] = { "tSampler int16 vs float", "tSampler int24 vs float" };
+    const float rates[] = { 1.0f, 1.37f, 0.5f, -0.81f };
+    for (int k = 0; k < 2; k++)
+    {
+        for (int r = 0; r < 4; r++)
+        {
+            static float ref[BENCH_SAMPLE_LENGTH / 2];
+            LEAF_init(BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE, benchMemory, BENCH_MEM_SIZE, &benchRandom);
+            benchSeed = 22222;
+            setupSampler(BufferFloat, rates[r]);
+            for (int i = 0; i < BENCH_SAMPLE_LENGTH / 2; i++) ref[i] = tSampler_tick(&bench_tSampler);
+            
+            benchSeed = 22222;
+            setupSampler(formats[k], rates[r]);
+            double worst = 0.0, peak = 0.0;
+            for (int i = 0; i < BENCH_SAMPLE_LENGTH / 2; i++)
+            {
+                double y = tSampler_tick(&bench_tSampler);
+                if (fabs(y - ref[i]) > worst) worst = fabs(y - ref[i]);
+                if (fabs(ref[i]) > peak) peak = fabs(ref[i]);
+            }
+            char input[64];
+            snprintf(input, sizeof(input), "decaying hit at rate %g", rates[r]);
+            accuracyReport(formatNames[k], input, worst, peak);
+        }
+    }
+    
+    // process has to match tick exactly, through loop crossfades, retriggers, the end fade and a
+    // start point moved while playing
+    const PlayMode modes[] = { PlayNormal, PlayLoop, PlayBackAndForth };
+    const char* modeNames[] = { "normal", "loop", "back and forth" };
+    const InterpolationQuality qualities[] = { InterpolationLinear, InterpolationCubic, InterpolationSinc };
+    const char* qualityNames[] = { "linear", "cubic", "sinc" };
+    for (int m = 0; m < 3; m++)
+    {
+        for (int q = 0; q < 3; q++)
+        {
+            for (int r = 0; r < 4; r++)
+            {
+                static float ref[BENCH_SAMPLE_LENGTH];
+                double worst = 0.0, peak = 0.0;
+                for (int pass = 0; pass < 2; pass++)
+                {
+                    LEAF_init(BENCH_SAMPLE_RATE, BENCH_BLOCK_SIZE, benchMemory, BENCH_MEM_SIZE, &benchRandom);
+                    benchSeed = 22222;
+                    setupSampler(BufferInt16, rates[r]);
+                    tSampler_setMode(&bench_tSampler, modes[m]);
+                    tSampler_setQuality(&bench_tSampler, qualities[q]);
+                    tSampler_setStart(&bench_tSampler, 2000);
+                    tSampler_setEnd(&bench_tSampler, 30000);
+                    tSampler_setCrossfadeLength(&bench_tSampler, 1000);
+                    float block[BENCH_BLOCK_SIZE];
+                    for (int b = 0; b < BENCH_SAMPLE_LENGTH / BENCH_BLOCK_SIZE; b++)
+                    {
+                        if ((b % 700) == 350) tSampler_play(&bench_tSampler);
+                        if (b == 1000) tSampler_setStart(&bench_tSampler, 5000);
+                        if (pass == 0)
+                        {
+                            for (int i = 0; i < BENCH_BLOCK_SIZE; i++) ref[(b * BENCH_BLOCK_SIZE) + i] = tSampler_tick(&bench_tSampler);
+                            continue;
+                        }
+                        tSampler_process(&bench_tSampler, block, BENCH_BLOCK_SIZE);
+                        for (int i = 0; i < BENCH_BLOCK_SIZE; i++)
+                        {
+                            double y = ref[(b * BENCH_BLOCK_SIZE) + i];
+                            if (fabs(y - block[i]) > worst) worst = fabs(y - block[i]);
+                            if (fabs(y) > peak) peak = fabs(y);
+                        }
+                    }
+                }
+                char check[64], input[64];
+                snprintf(check, sizeof(check), "tSampler process vs tick %s", qualityNames[q]);
+                snprintf(input, sizeof(input), "%s at rate %g", modeNames[m], rates[r]);
+                accuracyReport(check, input, worst, peak);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "accuracy"))
+    {
+        accuracyChecks();
+        return 0;
+    }
+    
+    long numSamples = (long)BENCH_SAMPLE_RATE * BENCH_DEFAULT_SECONDS;
+    if (argc > 1) numSamples = atol(argv[1]);
+    if (numSamples < BENCH_BLOCK_SIZE) numSamples = BENCH_BLOCK_SIZE;
+
+    // A fixed, full-scale input block; the same one is fed to every effect.
+    for (int i = 0; i < BENCH_BLOCK_SIZE; i++) benchIn[i] = (benchRandom() * 2.0f) - 1.0f;
+
+    printf("object,mode,ns_per_sample,samples_per_sec,pct_of_realtime,block_min_pct,block_avg_pct,block_max_pct,mempool_bytes\n");
+
+    int numCases = sizeof(benchCases) / sizeof(benchCases[0]);
+    for (int i = 0; i < numCases; i++)
+    {
+        benchRun(&benchCases[i], numSamples);
+    }
+
+    return 0;
+}
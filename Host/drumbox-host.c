@@ -0,0 +1,1299 @@
+/*
+ * drumbox-host.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Runs the HAL-free firmware modules on the host, with threads standing in for the interrupts.
+ *
+ *      ./drumbox-host all
+ *      ./drumbox-host ringbuffer [numFrames]
+ *      ./drumbox-host eventqueue [numEvents]
+ *      ./drumbox-host triggers [piezo.wav [onsets.txt]]
+ *      ./drumbox-host drumvoices [seconds]
+ *      ./drumbox-host diskqueue [megabytes]
+ *      ./drumbox-host streamsampler [seconds]
+ *
+ *  Each test prints what it measured and exits nonzero if something it checks goes wrong.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ringbuffer.h"
+#include "triggers.h"
+#include "eventqueue.h"
+#include "profiler.h"
+#include "drumvoices.h"
+#include "diskqueue.h"
+#include "streamsampler.h"
+#include "leaf.h"
+
+#define NUM_CHANNELS 3
+#define FRAME_SIZE 32 //matches AUDIO_FRAME_SIZE
+#define RING_SIZE 2048 //matches ADC_RING_BUFFER_SIZE
+#define SAMPLE_RATE 48000.0f
+
+/**********************************************/
+//ringbuffer: a producer thread plays the ADC DMA interrupt, writing half a frame at a time,
+//and the main thread plays the audio callback reading whole frames. Every sample carries its frame
+//number so the consumer can tell if it ever sees a torn, repeated or out-of-order frame.
+
+static RingBuffer ring;
+static float ringMemory[NUM_CHANNELS * RING_SIZE];
+static _Atomic int producerDone = 0;
+static long ringNumFrames = 1000000;
+
+static void* ringProducer(void* arg)
+{
+	float frames[NUM_CHANNELS * (FRAME_SIZE / 2)];
+	long next = 0;
+	while (next < ringNumFrames)
+	{
+		int n = FRAME_SIZE / 2;
+		if (next + n > ringNumFrames) n = (int)(ringNumFrames - next);
+		for (int i = 0; i < n; i++)
+		{
+			for (int ch = 0; ch < NUM_CHANNELS; ch++)
+			{
+				frames[(i * NUM_CHANNELS) + ch] = (float)(next + i) + (0.25f * ch);
+			}
+		}
+		//a full ring drops frames, and the consumer sees a jump it accounts for with the overrun count
+		ringBufferWrite(&ring, frames, (uint32_t)n);
+		next += n;
+		if ((next & 1023) == 0) sched_yield();
+	}
+	producerDone = 1;
+	return NULL;
+}
+
+static int testRingBuffer(void)
+{
+	ringBufferInit(&ring, ringMemory, NUM_CHANNELS, RING_SIZE);
+	producerDone = 0;
+
+	pthread_t producer;
+	pthread_create(&producer, NULL, ringProducer, NULL);
+
+	float block[NUM_CHANNELS][FRAME_SIZE];
+	float* channels[NUM_CHANNELS] = {block[0], block[1], block[2]};
+	long received = 0, skipped = 0, errors = 0;
+	float expected = 0.0f;
+
+	while (!producerDone || ringBufferAvailable(&ring) > 0)
+	{
+		//like the audio callback, mostly come back once there's a whole frame waiting
+		if (!producerDone && ringBufferAvailable(&ring) < FRAME_SIZE && (rand() & 7) != 0)
+		{
+			sched_yield();
+			continue;
+		}
+		uint32_t n = ringBufferRead(&ring, channels, FRAME_SIZE);
+		for (uint32_t i = 0; i < n; i++)
+		{
+			float frame = block[0][i];
+			for (int ch = 1; ch < NUM_CHANNELS; ch++)
+			{
+				if (block[ch][i] != frame + (0.25f * ch)) errors++; //torn frame
+			}
+			if (frame < expected) errors++; //repeated or out of order
+			else skipped += (long)(frame - expected);
+			expected = frame + 1.0f;
+		}
+		received += n;
+	}
+	pthread_join(producer, NULL);
+
+	uint32_t overruns = ringBufferGetOverruns(&ring);
+	printf("ringbuffer: %ld frames written, %ld read, %u overruns, %u underrun frames, %ld errors\n",
+			ringNumFrames, received, overruns, ringBufferGetUnderruns(&ring), errors);
+
+	//every frame the consumer didn't see must have been reported as an overrun
+	if (skipped != (long)overruns || received + (long)overruns != ringNumFrames) errors++;
+	return errors == 0 ? 0 : 1;
+}
+
+/**********************************************/
+
+/**********************************************/
+//eventqueue: two threads play the audio interrupt and the main loop, each sending numbered events
+//to the other while draining the queue coming back, the way audioToMain and mainToAudio are used.
+//Each side checks it receives every event in order, except the ones the sender counted as dropped.
+
+static EventQueue toMain;
+static EventQueue toAudio;
+static long eventNumEvents = 1000000;
+
+typedef struct
+{
+	EventQueue* out;
+	EventQueue* in;
+	long received;
+	long skipped;
+	long errors;
+} EventSide;
+
+static void* eventSide(void* arg)
+{
+	EventSide* side = (EventSide*)arg;
+	long sent = 0, expected = 0;
+	int done = 0;
+	while (!done)
+	{
+		//send in bursts, like a block's worth of reports
+		int burst = 1 + (rand() & 7);
+		for (int i = 0; i < burst && sent < eventNumEvents; i++)
+		{
+			//the id, channel and value all carry pieces of the number, so a torn event shows up
+			eventQueueSend(side->out, EventMeter, (uint8_t)(sent & 0xFF), (uint8_t)((sent >> 8) & 0xFF), (uint32_t)sent, (float)(sent & 0xFFFF), (void*)(intptr_t)sent);
+			sent++;
+		}
+
+		Event event;
+		while (eventQueuePop(side->in, &event))
+		{
+			long n = (long)event.time;
+			if (event.id != (uint8_t)(n & 0xFF) || event.channel != (uint8_t)((n >> 8) & 0xFF)
+					|| event.value != (float)(n & 0xFFFF) || (long)(intptr_t)event.data != n)
+			{
+				side->errors++; //torn
+			}
+			if (n < expected) side->errors++; //repeated or out of order
+			else side->skipped += n - expected;
+			expected = n + 1;
+			side->received++;
+		}
+		if ((rand() & 15) == 0) sched_yield();
+
+		//finished once everything this side sent is out and the other side's last event has arrived or been dropped
+		done = (sent == eventNumEvents) && (side->received + (long)eventQueueGetDropped(side->in) == eventNumEvents);
+	}
+	//drops after the last event that got through don't leave a gap, count them too
+	side->skipped += eventNumEvents - expected;
+	return NULL;
+}
+
+static int testEventQueue(void)
+{
+	eventQueueInit(&toMain);
+	eventQueueInit(&toAudio);
+	EventSide audio = {&toMain, &toAudio, 0, 0, 0};
+	EventSide mainLoop = {&toAudio, &toMain, 0, 0, 0};
+
+	pthread_t audioThread;
+	pthread_create(&audioThread, NULL, eventSide, &audio);
+	eventSide(&mainLoop);
+	pthread_join(audioThread, NULL);
+
+	int errors = 0;
+	EventSide* sides[2] = {&mainLoop, &audio};
+	EventQueue* queues[2] = {&toMain, &toAudio};
+	const char* names[2] = {"audio to main", "main to audio"};
+	for (int i = 0; i < 2; i++)
+	{
+		uint32_t dropped = eventQueueGetDropped(queues[i]);
+		printf("eventqueue: %s, %ld sent, %ld received, %u dropped, %ld errors\n",
+				names[i], eventNumEvents, sides[i]->received, dropped, sides[i]->errors);
+		if (sides[i]->errors != 0 || sides[i]->skipped != (long)dropped) errors++;
+	}
+	return errors == 0 ? 0 : 1;
+}
+
+/**********************************************/
+//triggers: runs the piezo trigger detector a frame at a time over either a recording or a
+//synthesized take, and scores the events against the known onsets.
+//
+//A recording is a WAV file with one channel per piezo (16, 24 or 32 bit int, or 32 bit float). The
+//onsets file has one "frame channel" pair per line for every real hit; without it only the
+//detector's own numbers are reported. With no arguments, hits are synthesized as decaying piezo
+//rings with bleed into the other two mics, so crosstalk rejection gets exercised too.
+
+#define TRIGGER_MAX_ONSETS 4096
+#define TRIGGER_MATCH_MS 5.0f //a detection this close to a real onset on the same channel counts as a hit
+
+typedef struct
+{
+	long frame;
+	int channel;
+	float velocity; //expected velocity for synthesized hits, negative if unknown
+} Onset;
+
+static float* piezoTake[NUM_CHANNELS];
+static long piezoTakeFrames = 0;
+static Onset onsets[TRIGGER_MAX_ONSETS];
+static int numOnsets = 0;
+
+static uint32_t readLE(const unsigned char* b, int bytes)
+{
+	uint32_t v = 0;
+	for (int i = 0; i < bytes; i++) v |= (uint32_t)b[i] << (8 * i);
+	return v;
+}
+
+static int loadWav(const char* path)
+{
+	FILE* f = fopen(path, "rb");
+	if (f == NULL)
+	{
+		printf("triggers: can't open %s\n", path);
+		return 1;
+	}
+	unsigned char header[12];
+	if (fread(header, 1, 12, f) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0)
+	{
+		printf("triggers: %s isn't a WAV file\n", path);
+		fclose(f);
+		return 1;
+	}
+
+	int format = 0, channels = 0, bits = 0;
+	unsigned char chunk[8];
+	while (fread(chunk, 1, 8, f) == 8)
+	{
+		uint32_t size = readLE(chunk + 4, 4);
+		if (memcmp(chunk, "fmt ", 4) == 0)
+		{
+			unsigned char fmt[40] = {0};
+			if (fread(fmt, 1, size < 40 ? size : 40, f) == 0) break;
+			if (size > 40) fseek(f, size - 40, SEEK_CUR);
+			format = (int)readLE(fmt, 2);
+			channels = (int)readLE(fmt + 2, 2);
+			bits = (int)readLE(fmt + 14, 2);
+			if (format == 0xFFFE) format = (int)readLE(fmt + 24, 2); //extensible, the subformat GUID starts with the real tag
+			if (readLE(fmt + 4, 4) != (uint32_t)SAMPLE_RATE)
+			{
+				printf("triggers: %s is %u Hz, the detector is set up for %d Hz\n", path, readLE(fmt + 4, 4), (int)SAMPLE_RATE);
+			}
+		}
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			if ((format != 1 && format != 3) || channels < 1 || (format == 3 && bits != 32) || (format == 1 && bits != 16 && bits != 24 && bits != 32))
+			{
+				printf("triggers: %s has a sample format this can't read\n", path);
+				break;
+			}
+			int bytes = bits / 8;
+			piezoTakeFrames = size / (bytes * channels);
+			unsigned char* raw = malloc(size);
+			piezoTakeFrames = (long)fread(raw, (size_t)(bytes * channels), (size_t)piezoTakeFrames, f);
+			for (int ch = 0; ch < NUM_CHANNELS; ch++)
+			{
+				piezoTake[ch] = calloc((size_t)piezoTakeFrames, sizeof(float));
+			}
+			//a file with fewer than three channels leaves the missing piezos silent
+			for (long i = 0; i < piezoTakeFrames; i++)
+			{
+				for (int ch = 0; ch < NUM_CHANNELS && ch < channels; ch++)
+				{
+					const unsigned char* b = raw + ((i * channels) + ch) * bytes;
+					uint32_t v = readLE(b, bytes);
+					float x;
+					if (format == 3)
+					{
+						memcpy(&x, &v, 4);
+					}
+					else
+					{
+						int32_t iv = (int32_t)(v << (32 - bits)); //sign extend from the top
+						x = (float)iv * (1.0f / 2147483648.0f);
+					}
+					piezoTake[ch][i] = x;
+				}
+			}
+			free(raw);
+			fclose(f);
+			return 0;
+		}
+		else
+		{
+			fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+		}
+	}
+	fclose(f);
+	if (piezoTakeFrames == 0) printf("triggers: no audio in %s\n", path);
+	return 1;
+}
+
+static int loadOnsets(const char* path)
+{
+	FILE* f = fopen(path, "r");
+	if (f == NULL)
+	{
+		printf("triggers: can't open %s\n", path);
+		return 1;
+	}
+	long frame;
+	int channel;
+	while (numOnsets < TRIGGER_MAX_ONSETS && fscanf(f, "%ld %d", &frame, &channel) == 2)
+	{
+		onsets[numOnsets].frame = frame;
+		onsets[numOnsets].channel = channel;
+		onsets[numOnsets].velocity = -1.0f;
+		numOnsets++;
+	}
+	fclose(f);
+	return 0;
+}
+
+static float randomFloat(void)
+{
+	return (float)rand() / (float)RAND_MAX;
+}
+
+static void synthesizeTake(float seconds)
+{
+	piezoTakeFrames = (long)(seconds * SAMPLE_RATE);
+	for (int ch = 0; ch < NUM_CHANNELS; ch++)
+	{
+		piezoTake[ch] = calloc((size_t)piezoTakeFrames, sizeof(float));
+	}
+
+	long frame = (long)(0.1f * SAMPLE_RATE);
+	while (numOnsets < TRIGGER_MAX_ONSETS - 1 && frame < piezoTakeFrames - (long)SAMPLE_RATE)
+	{
+		int channel = rand() % NUM_CHANNELS;
+		float amplitude = 0.15f + (0.85f * randomFloat());
+		float freq = 150.0f + (250.0f * randomFloat());
+		float bleed = 0.15f + (0.2f * randomFloat());
+
+		onsets[numOnsets].frame = frame;
+		onsets[numOnsets].channel = channel;
+		onsets[numOnsets].velocity = (amplitude - 0.1f) / 0.9f; //default threshold
+		numOnsets++;
+
+		//the peak comes a quarter cycle after the onset, so the detector can only find it by scanning
+		for (long i = 0; i < (long)(0.2f * SAMPLE_RATE) && frame + i < piezoTakeFrames; i++)
+		{
+			float t = (float)i / SAMPLE_RATE;
+			float x = amplitude * sinf(2.0f * 3.14159265f * freq * t) * expf(-t / 0.03f);
+			piezoTake[channel][frame + i] += x;
+			for (int other = 0; other < NUM_CHANNELS; other++)
+			{
+				//the shell carries the hit to the other mics a little later and much quieter
+				long at = frame + i + (long)(0.0003f * SAMPLE_RATE);
+				if (other != channel && at < piezoTakeFrames) piezoTake[other][at] += bleed * x;
+			}
+		}
+
+		//every so often hit two pads at once, which shouldn't be mistaken for crosstalk
+		if ((rand() % 6) == 0)
+		{
+			int second = (channel + 1 + (rand() % (NUM_CHANNELS - 1))) % NUM_CHANNELS;
+			long at = frame + (long)(0.001f * SAMPLE_RATE);
+			float secondAmplitude = amplitude * (0.8f + (0.4f * randomFloat()));
+			if (secondAmplitude > 1.0f) secondAmplitude = 1.0f;
+			onsets[numOnsets].frame = at;
+			onsets[numOnsets].channel = second;
+			onsets[numOnsets].velocity = (secondAmplitude - 0.1f) / 0.9f;
+			numOnsets++;
+			for (long i = 0; i < (long)(0.2f * SAMPLE_RATE) && at + i < piezoTakeFrames; i++)
+			{
+				float t = (float)i / SAMPLE_RATE;
+				float x = secondAmplitude * sinf(2.0f * 3.14159265f * freq * 1.3f * t) * expf(-t / 0.03f);
+				piezoTake[second][at + i] += x;
+			}
+		}
+
+		frame += (long)((0.06f + (0.3f * randomFloat())) * SAMPLE_RATE);
+	}
+
+	for (int ch = 0; ch < NUM_CHANNELS; ch++)
+	{
+		for (long i = 0; i < piezoTakeFrames; i++)
+		{
+			piezoTake[ch][i] += 0.005f * ((2.0f * randomFloat()) - 1.0f);
+		}
+	}
+}
+
+static int testTriggers(const char* wavPath, const char* onsetPath)
+{
+	srand(1);
+	numOnsets = 0;
+	if (wavPath != NULL)
+	{
+		if (loadWav(wavPath) != 0) return 1;
+		if (onsetPath != NULL && loadOnsets(onsetPath) != 0) return 1;
+		printf("triggers: %s, %ld frames, %d labelled onsets\n", wavPath, piezoTakeFrames, numOnsets);
+	}
+	else
+	{
+		synthesizeTake(60.0f);
+		printf("triggers: synthesized %ld frames, %d onsets\n", piezoTakeFrames, numOnsets);
+	}
+
+	static TriggerDetector td;
+	triggerDetectorInit(&td, NUM_CHANNELS, SAMPLE_RATE);
+	Profiler profiler;
+	profilerInit(&profiler, SAMPLE_RATE, FRAME_SIZE);
+	int detectScope = profilerAddScope(&profiler, "detector");
+
+	float block[NUM_CHANNELS][FRAME_SIZE];
+	float* channels[NUM_CHANNELS] = {block[0], block[1], block[2]};
+	float dcState[NUM_CHANNELS] = {0.0f};
+	float dcCoeff = 1.0f - (2.0f * 3.14159265f * 30.0f / SAMPLE_RATE); //like the firmware's 30 Hz dcBlock
+
+	int matched[TRIGGER_MAX_ONSETS] = {0};
+	long detections = 0, hits = 0, falseTriggers = 0;
+	double latencySum = 0.0, velocityErrorSum = 0.0;
+	long maxLatency = 0, velocityCount = 0;
+	long matchFrames = (long)(TRIGGER_MATCH_MS * 0.001f * SAMPLE_RATE);
+
+	for (long start = 0; start < piezoTakeFrames; start += FRAME_SIZE)
+	{
+		int n = FRAME_SIZE;
+		if (start + n > piezoTakeFrames) n = (int)(piezoTakeFrames - start);
+		for (int ch = 0; ch < NUM_CHANNELS; ch++)
+		{
+			for (int i = 0; i < n; i++)
+			{
+				float x = piezoTake[ch][start + i];
+				block[ch][i] = x - dcState[ch];
+				dcState[ch] += (1.0f - dcCoeff) * (x - dcState[ch]);
+			}
+		}
+		profilerBegin(&profiler, detectScope);
+		triggerDetectorProcess(&td, channels, n);
+		profilerEnd(&profiler, detectScope);
+
+		TriggerEvent event;
+		while (triggerDetectorPopEvent(&td, &event))
+		{
+			detections++;
+			//the event is acted on at the end of the block it was queued in
+			long heard = start + n;
+			int best = -1;
+			for (int k = 0; k < numOnsets; k++)
+			{
+				if (!matched[k] && onsets[k].channel == event.channel && labs((long)event.time - onsets[k].frame) <= matchFrames)
+				{
+					best = k;
+					break;
+				}
+			}
+			if (best < 0)
+			{
+				falseTriggers++;
+				if (numOnsets == 0)
+				{
+					//nothing to score against, report latency from the threshold crossing instead
+					latencySum += (double)(heard - (long)event.time);
+					if (heard - (long)event.time > maxLatency) maxLatency = heard - (long)event.time;
+				}
+				continue;
+			}
+			matched[best] = 1;
+			hits++;
+			long latency = heard - onsets[best].frame;
+			latencySum += (double)latency;
+			if (latency > maxLatency) maxLatency = latency;
+			if (onsets[best].velocity >= 0.0f)
+			{
+				velocityErrorSum += fabs((double)(event.velocity - onsets[best].velocity));
+				velocityCount++;
+			}
+		}
+	}
+
+	double msPerFrame = 1000.0 / SAMPLE_RATE;
+	printf("triggers: %ld detections, %u rejected as crosstalk, %u dropped from the queue\n",
+			detections, td.numRejected, (unsigned)atomic_load(&td.dropped));
+	int failed = 0;
+	if (numOnsets > 0)
+	{
+		long misses = numOnsets - hits;
+		printf("triggers: %ld of %d onsets found, %ld missed, %ld false triggers\n", hits, numOnsets, misses, falseTriggers);
+		if (hits > 0)
+		{
+			printf("triggers: latency from onset to the end of the block that reports it: mean %.2f ms, max %.2f ms\n",
+					(latencySum / hits) * msPerFrame, maxLatency * msPerFrame);
+		}
+		if (velocityCount > 0)
+		{
+			printf("triggers: mean velocity error %.3f\n", velocityErrorSum / velocityCount);
+		}
+		//the synthesized take has nothing in it the detector shouldn't get right
+		if (wavPath == NULL && (misses > 0 || falseTriggers > 0)) failed = 1;
+	}
+	else if (detections > 0)
+	{
+		printf("triggers: latency from threshold crossing to the end of the block that reports it: mean %.2f ms, max %.2f ms\n",
+				(latencySum / detections) * msPerFrame, maxLatency * msPerFrame);
+	}
+
+	ProfilerReport cost;
+	profilerGetReport(&profiler, detectScope, &cost);
+	printf("triggers: detector takes %.0f ns per block on average, %.3f%% of the block\n", cost.avgTicks, cost.avgPercent);
+
+	for (int ch = 0; ch < NUM_CHANNELS; ch++)
+	{
+		free(piezoTake[ch]);
+		piezoTake[ch] = NULL;
+	}
+	piezoTakeFrames = 0;
+	return failed;
+}
+
+/**********************************************/
+//drumvoices: a five instrument kit driven as hard as the trigger detector allows, every pad rolling at one hit
+//per mask time, against the same voices ticked every sample.
+//Checks that voices are stolen rather than dropped, that the closed hat chokes the open hat, and that a kit
+//left alone ends up with no voices running.
+
+#define DRUM_ROLL_MS 40.0f //the detector's default mask time, the fastest a pad can retrigger
+#define DRUM_MEM_SIZE 4000000
+#define DRUM_CHOKE_TEST_MS 8.0f //drumvoices.c's default choke time
+
+static char drumMemory[DRUM_MEM_SIZE];
+static float drumSeconds = 20.0f;
+
+enum
+{
+	KitKick = 0,
+	KitSnare,
+	KitClosedHat,
+	KitOpenHat,
+	KitCowbell,
+	KIT_SIZE
+};
+
+static void buildKit(DrumVoices* dv)
+{
+	drumVoicesInit(dv, SAMPLE_RATE);
+	drumVoicesAddInstrument(dv, DrumKick, 2, DrumStealOldest, 0, &leaf.mempool);
+	drumVoicesAddInstrument(dv, DrumSnare, 4, DrumStealQuietest, 0, &leaf.mempool);
+	drumVoicesAddInstrument(dv, DrumHihat, 2, DrumStealOldest, 1, &leaf.mempool);
+	drumVoicesAddInstrument(dv, DrumHihat, 3, DrumStealQuietest, 1, &leaf.mempool);
+	drumVoicesAddInstrument(dv, DrumCowbell, 2, DrumStealOldest, 0, &leaf.mempool);
+
+	for (int inst = KitClosedHat; inst <= KitOpenHat; inst++)
+	{
+		for (int i = 0; i < dv->instruments[inst].numVoices; i++)
+		{
+			t808Hihat* hat = &drumVoicesGetVoice(dv, inst, i)->synth.hihat;
+			t808Hihat_setOscNoiseMix(hat, 0.5f);
+			t808Hihat_setDecay(hat, (inst == KitClosedHat) ? 60.0f : 800.0f);
+		}
+	}
+	for (int i = 0; i < dv->instruments[KitSnare].numVoices; i++)
+	{
+		t808Snare_setNoiseDecay(&drumVoicesGetVoice(dv, KitSnare, i)->synth.snare, 300.0f);
+	}
+}
+
+//every pad hit once per roll period, each a few ms after the last so they don't all land in the same block.
+//with no allocator the hits go round robin through each instrument's voices, unchoked
+static void rollTriggers(DrumVoices* dv, long frame, int n, long rollFrames, int useAllocator)
+{
+	static int nextVoice[KIT_SIZE];
+
+	for (int inst = 0; inst < KIT_SIZE; inst++)
+	{
+		long offset = (inst * rollFrames) / KIT_SIZE;
+		long next = ((frame - offset + rollFrames - 1) / rollFrames) * rollFrames + offset;
+		if (frame <= offset) next = offset;
+		if (next >= frame + n)
+		{
+			continue;
+		}
+		float velocity = 0.3f + (0.7f * randomFloat());
+		if (useAllocator)
+		{
+			drumVoicesTrigger(dv, inst, velocity);
+			continue;
+		}
+		DrumVoice* v = drumVoicesGetVoice(dv, inst, nextVoice[inst]);
+		nextVoice[inst] = (nextVoice[inst] + 1) % dv->instruments[inst].numVoices;
+		switch (dv->instruments[inst].type)
+		{
+			case DrumKick: t808Kick_on(&v->synth.kick, velocity); break;
+			case DrumSnare: t808Snare_on(&v->synth.snare, velocity); break;
+			case DrumHihat: t808Hihat_on(&v->synth.hihat, velocity); break;
+			case DrumCowbell: t808Cowbell_on(&v->synth.cowbell, velocity); break;
+		}
+	}
+}
+
+static int testDrumVoices(void)
+{
+	srand(1);
+	LEAF_init(SAMPLE_RATE, FRAME_SIZE, drumMemory, DRUM_MEM_SIZE, &randomFloat);
+	int failed = 0;
+
+	static DrumVoices dv;
+	buildKit(&dv);
+	Profiler profiler;
+	profilerInit(&profiler, SAMPLE_RATE, FRAME_SIZE);
+	int managedScope = profilerAddScope(&profiler, "managed");
+	int naiveScope = profilerAddScope(&profiler, "every voice");
+
+	float out[FRAME_SIZE];
+	long rollFrames = (long)(DRUM_ROLL_MS * 0.001f * SAMPLE_RATE);
+	long rollTotal = (long)(drumSeconds * SAMPLE_RATE);
+	int nonFinite = 0;
+
+	//worst case: every pad rolling as fast as it can be triggered
+	for (long frame = 0; frame < rollTotal; frame += FRAME_SIZE)
+	{
+		rollTriggers(&dv, frame, FRAME_SIZE, rollFrames, 1);
+		profilerBegin(&profiler, managedScope);
+		drumVoicesProcess(&dv, out, FRAME_SIZE);
+		profilerEnd(&profiler, managedScope);
+		if (frame == 0) profilerReset(&profiler); //first touch of the voices' memory
+		for (int i = 0; i < FRAME_SIZE; i++)
+		{
+			if (!isfinite(out[i])) nonFinite++;
+		}
+	}
+	uint32_t steals = dv.numSteals;
+	printf("drumvoices: %.0f s roll, every pad every %.0f ms: peak %d of %d voices active, %u steals, %u chokes\n",
+			drumSeconds, DRUM_ROLL_MS, dv.maxActive, dv.numVoices, steals, dv.numChokes);
+	if (steals == 0 || dv.maxActive > dv.numVoices || nonFinite > 0) failed = 1;
+
+	//the same roll with every voice ticked every sample, leaving it to the 808s to skip work when they're asleep
+	for (long frame = 0; frame < rollTotal; frame += FRAME_SIZE)
+	{
+		rollTriggers(&dv, frame, FRAME_SIZE, rollFrames, 0);
+		profilerBegin(&profiler, naiveScope);
+		for (int i = 0; i < FRAME_SIZE; i++)
+		{
+			float sum = 0.0f;
+			for (int k = 0; k < dv.numVoices; k++)
+			{
+				DrumVoice* v = &dv.voices[k];
+				switch (dv.instruments[v->instrument].type)
+				{
+					case DrumKick: sum += t808Kick_tick(&v->synth.kick); break;
+					case DrumSnare: sum += t808Snare_tick(&v->synth.snare); break;
+					case DrumHihat: sum += t808Hihat_tick(&v->synth.hihat); break;
+					case DrumCowbell: sum += t808Cowbell_tick(&v->synth.cowbell); break;
+				}
+			}
+			out[i] = sum;
+		}
+		profilerEnd(&profiler, naiveScope);
+	}
+
+	ProfilerReport managed, naive;
+	profilerGetReport(&profiler, managedScope, &managed);
+	profilerGetReport(&profiler, naiveScope, &naive);
+	printf("drumvoices: roll costs %.2f%% of a block on average, %.2f%% max, every voice ticked costs %.2f%%\n",
+			managed.avgPercent, managed.maxPercent, naive.avgPercent);
+
+	//an open hat ringing, then a closed hat has to cut it off within the choke time and a block
+	profilerReset(&profiler);
+	for (int i = 0; i < 2 * SAMPLE_RATE / FRAME_SIZE; i++) drumVoicesProcess(&dv, out, FRAME_SIZE);
+	drumVoicesTrigger(&dv, KitOpenHat, 1.0f);
+	for (int i = 0; i < 4; i++) drumVoicesProcess(&dv, out, FRAME_SIZE);
+	drumVoicesTrigger(&dv, KitClosedHat, 1.0f);
+	int chokeBlocks = (int)(((DRUM_CHOKE_TEST_MS * 0.001f * SAMPLE_RATE) / FRAME_SIZE) + 2);
+	for (int i = 0; i < chokeBlocks; i++) drumVoicesProcess(&dv, out, FRAME_SIZE);
+	int openHats = 0;
+	for (int i = 0; i < dv.instruments[KitOpenHat].numVoices; i++)
+	{
+		openHats += drumVoicesGetVoice(&dv, KitOpenHat, i)->active;
+	}
+	printf("drumvoices: %d open hat voices still running %d blocks after the closed hat\n", openHats, chokeBlocks);
+	if (openHats > 0) failed = 1;
+
+	//left alone, every voice should go quiet and switch itself off
+	long idleFrames = 0;
+	while ((dv.numActive > 0) && (idleFrames < 10 * SAMPLE_RATE))
+	{
+		drumVoicesProcess(&dv, out, FRAME_SIZE);
+		idleFrames += FRAME_SIZE;
+	}
+	profilerReset(&profiler);
+	for (int i = 0; i < 100; i++)
+	{
+		profilerBegin(&profiler, managedScope);
+		drumVoicesProcess(&dv, out, FRAME_SIZE);
+		profilerEnd(&profiler, managedScope);
+	}
+	profilerGetReport(&profiler, managedScope, &managed);
+	printf("drumvoices: all voices off %.0f ms after the last hit, an idle kit costs %.3f%% of a block\n",
+			idleFrames * 1000.0f / SAMPLE_RATE, managed.avgPercent);
+	if (dv.numActive != 0) failed = 1;
+
+	return failed;
+}
+
+/**********************************************/
+//diskqueue: an image file stands in for the card and a thread plays the SDMMC DMA and its interrupt,
+//spending each transfer's command latency plus its size at the card's bus rate before completing it,
+//and staying busy for a while after a write like a card that's still programming.
+//The main thread streams the image through the queue in mixed request sizes with some work to do on
+//each one, then the same stream one blocking request at a time, checking every sector lands intact
+//and every request comes back in the order it went in. Then it writes a region and reads it back,
+//fills the queue past full, and makes a transfer fail both ways a backend can fail one.
+
+#define DISK_LATENCY_US 200.0 //command and access time per transfer
+#define DISK_MB_PER_SECOND 20.0
+#define DISK_PROGRAM_US 1000.0 //after a write
+#define DISK_MAX_SECTORS 16 //per request
+#define DISK_WORK_US 300.0 //what the main loop does with each request that comes back
+#define DISK_WORDS (DISK_SECTOR_SIZE / 4)
+
+static long diskMegabytes = 4;
+
+typedef struct
+{
+	int fd;
+	uint32_t numSectors;
+	DiskQueue* queue;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	int pending;
+	int quit;
+	DiskOp op;
+	uint8_t* buffer;
+	uint32_t sector;
+	uint32_t count;
+	double programmedAt; //when the last write finishes programming
+	double latency; //us, DISK_LATENCY_US unless a test wants a slower card
+	_Atomic uint32_t busyReplies;
+} HostDisk;
+
+static double nowUs(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (t.tv_sec * 1e6) + (t.tv_nsec * 1e-3);
+}
+
+//busy, like the main loop doing real work
+static void waitUntil(double until)
+{
+	while (nowUs() < until)
+	{
+	}
+}
+
+//idle, like a DMA transfer the CPU isn't involved in
+static void sleepUntil(double until)
+{
+	struct timespec t;
+	t.tv_sec = (time_t)(until * 1e-6);
+	t.tv_nsec = (long)((until - (t.tv_sec * 1e6)) * 1e3);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) != 0)
+	{
+	}
+}
+
+static DiskStartResult hostDiskStart(void* context, DiskOp op, uint8_t* buffer, uint32_t sector, uint32_t count)
+{
+	HostDisk* disk = (HostDisk*)context;
+	if (((uintptr_t)buffer & 31) != 0)
+	{
+		return DiskFailed; //same rule as the card, whole cache lines only
+	}
+	pthread_mutex_lock(&disk->lock);
+	if (nowUs() < disk->programmedAt)
+	{
+		pthread_mutex_unlock(&disk->lock);
+		disk->busyReplies++;
+		return DiskBusy;
+	}
+	disk->op = op;
+	disk->buffer = buffer;
+	disk->sector = sector;
+	disk->count = count;
+	disk->pending = 1;
+	pthread_cond_signal(&disk->wake);
+	pthread_mutex_unlock(&disk->lock);
+	return DiskStarted;
+}
+
+static void* hostDiskThread(void* arg)
+{
+	HostDisk* disk = (HostDisk*)arg;
+	pthread_mutex_lock(&disk->lock);
+	while (1)
+	{
+		while (!disk->pending && !disk->quit) pthread_cond_wait(&disk->wake, &disk->lock);
+		if (disk->quit) break;
+		disk->pending = 0;
+		DiskOp op = disk->op;
+		uint8_t* buffer = disk->buffer;
+		size_t bytes = (size_t)disk->count * DISK_SECTOR_SIZE;
+		off_t offset = (off_t)disk->sector * DISK_SECTOR_SIZE;
+		pthread_mutex_unlock(&disk->lock);
+
+		sleepUntil(nowUs() + disk->latency + (bytes / DISK_MB_PER_SECOND));
+		ssize_t moved;
+		if (op == DiskWrite) moved = pwrite(disk->fd, buffer, bytes, offset);
+		else moved = pread(disk->fd, buffer, bytes, offset);
+
+		pthread_mutex_lock(&disk->lock);
+		if (op == DiskWrite) disk->programmedAt = nowUs() + DISK_PROGRAM_US;
+		pthread_mutex_unlock(&disk->lock);
+		//the completion interrupt, which may start the next transfer from here
+		diskQueueComplete(disk->queue, moved == (ssize_t)bytes);
+		pthread_mutex_lock(&disk->lock);
+	}
+	pthread_mutex_unlock(&disk->lock);
+	return NULL;
+}
+
+//fd and numSectors have to be set already
+static void hostDiskOpen(HostDisk* disk, DiskQueue* q)
+{
+	disk->queue = q;
+	disk->pending = 0;
+	disk->quit = 0;
+	disk->programmedAt = 0.0;
+	disk->busyReplies = 0;
+	disk->latency = DISK_LATENCY_US;
+	pthread_mutex_init(&disk->lock, NULL);
+	pthread_cond_init(&disk->wake, NULL);
+	DiskBackend backend = {hostDiskStart, disk};
+	diskQueueInit(q, &backend);
+	pthread_create(&disk->thread, NULL, hostDiskThread, disk);
+}
+
+static void hostDiskClose(HostDisk* disk)
+{
+	pthread_mutex_lock(&disk->lock);
+	disk->quit = 1;
+	pthread_cond_signal(&disk->wake);
+	pthread_mutex_unlock(&disk->lock);
+	pthread_join(disk->thread, NULL);
+}
+
+static uint32_t diskPattern(uint32_t sector, int word, uint32_t salt)
+{
+	return ((sector * DISK_WORDS) + (uint32_t)word) ^ salt;
+}
+
+//counts the words in a request's buffer that aren't what the image holds there
+static long diskCheck(const DiskRequest* r, uint32_t salt)
+{
+	const uint32_t* words = (const uint32_t*)r->buffer;
+	long bad = 0;
+	for (uint32_t s = 0; s < r->count; s++)
+	{
+		for (int w = 0; w < DISK_WORDS; w++)
+		{
+			if (words[(s * DISK_WORDS) + w] != diskPattern(r->sector + s, w, salt)) bad++;
+		}
+	}
+	return bad;
+}
+
+//reads the whole image, DISK_QUEUE_SIZE requests deep if queued, one at a time otherwise,
+//doing DISK_WORK_US of other work on each one that comes back
+static int diskStream(DiskQueue* q, HostDisk* disk, uint8_t** buffers, int queued, const char* name, double* mbPerSecond)
+{
+	int freeSlots[DISK_QUEUE_SIZE];
+	int numFree = DISK_QUEUE_SIZE;
+	for (int i = 0; i < DISK_QUEUE_SIZE; i++) freeSlots[i] = i;
+
+	uint32_t nextSector = 0;
+	uint32_t expectTicket = 0;
+	long bad = 0, outOfOrder = 0, errors = 0, requests = 0;
+	srand(3);
+
+	double start = nowUs();
+	while ((nextSector < disk->numSectors) || (diskQueuePending(q) > 0))
+	{
+		while ((nextSector < disk->numSectors) && (numFree > 0) && (queued || (diskQueuePending(q) == 0)))
+		{
+			uint32_t count = 1 + (rand() % DISK_MAX_SECTORS);
+			if (count > disk->numSectors - nextSector) count = disk->numSectors - nextSector;
+			int slot = freeSlots[--numFree];
+			uint32_t ticket = diskRead(q, buffers[slot], nextSector, count, (void*)(intptr_t)slot);
+			if (ticket == 0)
+			{
+				numFree++;
+				break;
+			}
+			if (expectTicket == 0) expectTicket = ticket;
+			nextSector += count;
+			requests++;
+		}
+
+		DiskRequest r;
+		if (!diskPoll(q, &r))
+		{
+			sched_yield(); //the main loop would get on with something else here
+			continue;
+		}
+		if (r.ticket != expectTicket) outOfOrder++;
+		expectTicket = r.ticket + 1;
+		if (r.status != DiskDone) errors++;
+		else bad += diskCheck(&r, 0);
+		freeSlots[numFree++] = (int)(intptr_t)r.user;
+		waitUntil(nowUs() + DISK_WORK_US);
+	}
+	double seconds = (nowUs() - start) * 1e-6;
+	*mbPerSecond = (disk->numSectors * (double)DISK_SECTOR_SIZE) / (seconds * 1e6);
+
+	printf("diskqueue: %s, %ld requests, %.1f MB/s, %ld bad words, %ld out of order, %ld errors\n",
+			name, requests, *mbPerSecond, bad, outOfOrder, errors);
+	return (bad == 0 && outOfOrder == 0 && errors == 0) ? 0 : 1;
+}
+
+static int diskWaitFor(DiskQueue* q, DiskRequest* r)
+{
+	while (!diskPoll(q, r)) sched_yield();
+	return r->status == DiskDone;
+}
+
+static int testDiskQueue(void)
+{
+	int failed = 0;
+	static HostDisk disk;
+	static DiskQueue q;
+
+	FILE* image = tmpfile();
+	if (image == NULL)
+	{
+		printf("diskqueue: couldn't make an image file\n");
+		return 1;
+	}
+	disk.fd = fileno(image);
+	disk.numSectors = (uint32_t)(diskMegabytes * 1024 * 1024 / DISK_SECTOR_SIZE);
+	uint32_t sectorWords[DISK_WORDS];
+	for (uint32_t s = 0; s < disk.numSectors; s++)
+	{
+		for (int w = 0; w < DISK_WORDS; w++) sectorWords[w] = diskPattern(s, w, 0);
+		if (pwrite(disk.fd, sectorWords, DISK_SECTOR_SIZE, (off_t)s * DISK_SECTOR_SIZE) != DISK_SECTOR_SIZE)
+		{
+			printf("diskqueue: couldn't write the image file\n");
+			fclose(image);
+			return 1;
+		}
+	}
+
+	hostDiskOpen(&disk, &q);
+
+	uint8_t* buffers[DISK_QUEUE_SIZE];
+	for (int i = 0; i < DISK_QUEUE_SIZE; i++)
+	{
+		buffers[i] = aligned_alloc(32, DISK_MAX_SECTORS * DISK_SECTOR_SIZE);
+	}
+
+	//queued, the card works through the next request while the main loop deals with the last one
+	double queuedRate, blockingRate;
+	failed |= diskStream(&q, &disk, buffers, 1, "queued", &queuedRate);
+	failed |= diskStream(&q, &disk, buffers, 0, "one at a time", &blockingRate);
+	if (queuedRate < 1.25 * blockingRate) failed = 1;
+
+	//a burst of writes, the card reporting busy between them, then read back
+	uint32_t writeSector = disk.numSectors / 3;
+	int writes = 4;
+	for (int i = 0; i < writes; i++)
+	{
+		uint32_t* words = (uint32_t*)buffers[i];
+		for (int s = 0; s < DISK_MAX_SECTORS; s++)
+		{
+			for (int w = 0; w < DISK_WORDS; w++)
+			{
+				words[(s * DISK_WORDS) + w] = diskPattern(writeSector + (i * DISK_MAX_SECTORS) + s, w, 0x5A5A5A5A);
+			}
+		}
+		diskWrite(&q, buffers[i], writeSector + (i * DISK_MAX_SECTORS), DISK_MAX_SECTORS, NULL);
+	}
+	DiskRequest r;
+	long writeErrors = 0, readBack = 0;
+	for (int i = 0; i < writes; i++) writeErrors += !diskWaitFor(&q, &r);
+	for (int i = 0; i < writes; i++)
+	{
+		diskRead(&q, buffers[i], writeSector + (i * DISK_MAX_SECTORS), DISK_MAX_SECTORS, NULL);
+	}
+	for (int i = 0; i < writes; i++)
+	{
+		if (!diskWaitFor(&q, &r)) writeErrors++;
+		else readBack += diskCheck(&r, 0x5A5A5A5A);
+	}
+	printf("diskqueue: %d writes, %u busy replies while programming, %ld errors, %ld bad words read back\n",
+			writes, (unsigned)disk.busyReplies, writeErrors, readBack);
+	if (writeErrors != 0 || readBack != 0 || disk.busyReplies == 0) failed = 1;
+
+	//more requests than the queue holds
+	int accepted = 0, refused = 0;
+	for (int i = 0; i < DISK_QUEUE_SIZE + 4; i++)
+	{
+		if (diskRead(&q, buffers[i % DISK_QUEUE_SIZE], 0, 1, NULL) != 0) accepted++;
+		else refused++;
+	}
+	while (diskQueuePending(&q) > 0) diskWaitFor(&q, &r);
+
+	//past the end of the image fails in the transfer, a misaligned buffer fails to start, and the
+	//request after each still works
+	int endFails = !diskWaitFor(&q, (diskRead(&q, buffers[0], disk.numSectors - 2, 4, NULL), &r));
+	int alignFails = !diskWaitFor(&q, (diskRead(&q, buffers[0] + 4, 0, 1, NULL), &r));
+	int stillWorks = diskWaitFor(&q, (diskRead(&q, buffers[0], 0, 1, NULL), &r)) && (diskCheck(&r, 0) == 0);
+
+	DiskQueueStats stats = diskQueueGetStats(&q);
+	printf("diskqueue: %d of %d accepted when full, deepest %u, errors reported %u (past the end %s, misaligned %s, next read %s)\n",
+			accepted, accepted + refused, stats.maxDepth, stats.errors, endFails ? "failed" : "didn't fail",
+			alignFails ? "failed" : "didn't fail", stillWorks ? "fine" : "broken");
+	if (accepted != DISK_QUEUE_SIZE || refused != 4 || stats.maxDepth != DISK_QUEUE_SIZE || !endFails || !alignFails || !stillWorks)
+	{
+		failed = 1;
+	}
+
+	hostDiskClose(&disk);
+	for (int i = 0; i < DISK_QUEUE_SIZE; i++) free(buffers[i]);
+	fclose(image);
+	return failed;
+}
+
+/**********************************************/
+//streamsampler: a handful of 16 and 24 bit samples scattered over an image file a cluster run at a time,
+//like files on a well used card, played by a thread standing in for the audio interrupt in real time
+//while the main thread runs the streamer. Voices are retriggered at random, mostly at the sample's own
+//rate so every frame that comes out can be checked against what the file holds there, and some faster
+//to work the card harder. A frame that's neither the right one nor an underrun's silence means a chunk
+//landed in the wrong place or was played for the wrong hit. It runs twice, once as it should be set up,
+//where nothing may underrun, and once with a card far too slow for an attack far too short, where
+//underruns are the point and retriggers keep catching the last hit's reads still in flight.
+
+#define STREAM_TEST_SAMPLES 6
+#define STREAM_TEST_VOICES 8
+#define STREAM_CLUSTER_SECTORS 64 //32 kB, a FAT32 card's usual cluster
+
+static float streamSeconds = 5.0f;
+
+typedef struct
+{
+	StreamSample sample;
+	uint32_t salt;
+	uint8_t* file;
+} TestStream;
+
+static TestStream testStreams[STREAM_TEST_SAMPLES];
+static StreamVoice testVoices[STREAM_TEST_VOICES];
+static long streamHits, streamRetriggers, streamChecked, streamWrong;
+
+static int32_t streamValue(uint32_t frame, uint32_t salt, int bytesPerSample)
+{
+	uint32_t x = (frame + salt) * 2654435761u;
+	return (bytesPerSample == 2) ? (int32_t)(int16_t)(x >> 16) : ((int32_t)x >> 8);
+}
+
+static float streamExpected(const TestStream* t, uint32_t frame)
+{
+	int32_t x = streamValue(frame, t->salt, t->sample.bytesPerSample);
+	return (t->sample.bytesPerSample == 2) ? (float)x * (1.0f / 32768.0f) : (float)x * (1.0f / 8388608.0f);
+}
+
+static void* streamAudio(void* arg)
+{
+	(void)arg;
+	unsigned int seed = 5;
+	int playing[STREAM_TEST_VOICES];
+	float rates[STREAM_TEST_VOICES];
+	long nextHit[STREAM_TEST_VOICES];
+	for (int v = 0; v < STREAM_TEST_VOICES; v++) nextHit[v] = v * 480;
+
+	float out[FRAME_SIZE];
+	long total = (long)(streamSeconds * SAMPLE_RATE);
+	double next = nowUs();
+	for (long frame = 0; frame < total; frame += FRAME_SIZE)
+	{
+		next += FRAME_SIZE * 1e6 / SAMPLE_RATE;
+		sleepUntil(next);
+		for (int v = 0; v < STREAM_TEST_VOICES; v++)
+		{
+			StreamVoice* voice = &testVoices[v];
+			if (frame >= nextHit[v])
+			{
+				if (voice->active) streamRetriggers++;
+				playing[v] = rand_r(&seed) % STREAM_TEST_SAMPLES;
+				rates[v] = ((rand_r(&seed) & 3) == 0) ? 1.5f : 1.0f;
+				streamVoicePlay(voice, &testStreams[playing[v]].sample, rates[v], 1.0f);
+				nextHit[v] = frame + (long)(SAMPLE_RATE * (0.1f + (1.4f * (rand_r(&seed) / (float)RAND_MAX))));
+				streamHits++;
+			}
+
+			int wasActive = voice->active;
+			uint32_t start = voice->index;
+			streamVoiceProcess(voice, out, FRAME_SIZE);
+			if (!wasActive || (rates[v] != 1.0f))
+			{
+				continue;
+			}
+			const TestStream* t = &testStreams[playing[v]];
+			for (int i = 0; (i < FRAME_SIZE) && (start + i + 1 < t->sample.length); i++)
+			{
+				streamChecked++;
+				if ((out[i] != 0.0f) && (out[i] != streamExpected(t, start + i))) streamWrong++;
+			}
+		}
+	}
+	return NULL;
+}
+
+static int streamRun(const char* name, float attackMs, double latency, int underrunsAllowed)
+{
+	static HostDisk disk;
+	static DiskQueue q;
+	static Streamer streamer;
+	srand(4);
+	streamHits = 0;
+	streamRetriggers = 0;
+	streamChecked = 0;
+	streamWrong = 0;
+
+	//the samples' files, each with a header of a different length so frames sit at every alignment
+	uint32_t fileClusters[STREAM_TEST_SAMPLES];
+	uint32_t numClusters = 16; //the first few stand in for the FAT
+	uint32_t attackBytes = 0, streamedBytes = 0;
+	for (int k = 0; k < STREAM_TEST_SAMPLES; k++)
+	{
+		TestStream* t = &testStreams[k];
+		int bytesPerSample = (k & 1) ? 3 : 2;
+		uint32_t dataOffset = 44 + (uint32_t)(k % 4);
+		uint32_t length = (uint32_t)(SAMPLE_RATE * (1.5f + (0.5f * k)));
+		t->salt = 1000u * (uint32_t)k;
+		uint32_t attack = streamSampleInit(&t->sample, dataOffset, length, bytesPerSample, 1.0f, (uint32_t)(attackMs * 0.001f * SAMPLE_RATE));
+
+		fileClusters[k] = (t->sample.fileBytes + (STREAM_CLUSTER_SECTORS * DISK_SECTOR_SIZE) - 1) / (STREAM_CLUSTER_SECTORS * DISK_SECTOR_SIZE);
+		t->file = calloc(fileClusters[k], STREAM_CLUSTER_SECTORS * DISK_SECTOR_SIZE);
+		for (uint32_t i = 0; i < length; i++)
+		{
+			int32_t x = streamValue(i, t->salt, bytesPerSample);
+			for (int b = 0; b < bytesPerSample; b++) t->file[dataOffset + (i * bytesPerSample) + b] = (uint8_t)(x >> (8 * b));
+		}
+		t->sample.attack = malloc(attack);
+		memcpy(t->sample.attack, t->file + t->sample.attackBase, attack);
+		attackBytes += attack;
+		streamedBytes += t->sample.fileBytes - t->sample.streamStart;
+		numClusters += fileClusters[k];
+	}
+
+	FILE* image = tmpfile();
+	disk.fd = fileno(image);
+	disk.numSectors = numClusters * STREAM_CLUSTER_SECTORS;
+	if (ftruncate(disk.fd, (off_t)disk.numSectors * DISK_SECTOR_SIZE) != 0)
+	{
+		printf("streamsampler: couldn't make an image file\n");
+		return 1;
+	}
+
+	//hand out the clusters in runs of one to three to whichever file comes up
+	uint32_t placed[STREAM_TEST_SAMPLES] = {0};
+	uint32_t cluster = 16;
+	while (cluster < numClusters)
+	{
+		int k = rand() % STREAM_TEST_SAMPLES;
+		uint32_t run = 1 + (rand() % 3);
+		for (uint32_t c = 0; (c < run) && (placed[k] < fileClusters[k]); c++, cluster++)
+		{
+			TestStream* t = &testStreams[k];
+			uint32_t bytes = STREAM_CLUSTER_SECTORS * DISK_SECTOR_SIZE;
+			if (pwrite(disk.fd, t->file + (placed[k] * bytes), bytes, (off_t)cluster * bytes) != (ssize_t)bytes) return 1;
+			streamSampleAddExtent(&t->sample, placed[k] * STREAM_CLUSTER_SECTORS, cluster * STREAM_CLUSTER_SECTORS, STREAM_CLUSTER_SECTORS);
+			placed[k]++;
+		}
+	}
+
+	hostDiskOpen(&disk, &q);
+	disk.latency = latency;
+	streamerInit(&streamer, &q);
+	uint8_t* rings = aligned_alloc(32, STREAM_TEST_VOICES * STREAM_RING_BYTES);
+	for (int v = 0; v < STREAM_TEST_VOICES; v++)
+	{
+		streamVoiceInit(&testVoices[v], rings + (v * STREAM_RING_BYTES));
+		streamerAddVoice(&streamer, &testVoices[v]);
+	}
+
+	pthread_t audioThread;
+	pthread_create(&audioThread, NULL, streamAudio, NULL);
+	//the main loop, with other things to do between ticks
+	double finish = nowUs() + (streamSeconds * 1e6);
+	while (nowUs() < finish)
+	{
+		streamerTick(&streamer);
+		sleepUntil(nowUs() + 200.0);
+	}
+	pthread_join(audioThread, NULL);
+	hostDiskClose(&disk);
+
+	uint32_t underruns = 0;
+	for (int v = 0; v < STREAM_TEST_VOICES; v++) underruns += testVoices[v].underruns;
+	int extents = 0;
+	for (int k = 0; k < STREAM_TEST_SAMPLES; k++) extents += testStreams[k].sample.numExtents;
+	printf("streamsampler: %s, %.0f ms attacks, %.0f us a read, %.0f s, %d voices, %ld hits (%ld retriggers), %u chunks read (%.1f MB), %d extents over %d samples\n",
+			name, attackMs, latency, streamSeconds, STREAM_TEST_VOICES, streamHits, streamRetriggers, streamer.chunksRead,
+			streamer.chunksRead * (double)STREAM_CHUNK_BYTES / 1e6, extents, STREAM_TEST_SAMPLES);
+	printf("streamsampler: %s, %u kB of attacks in memory for %u kB of samples, %ld frames checked, %ld wrong, %u underrun, %u read errors\n",
+			name, attackBytes / 1024, (attackBytes + streamedBytes) / 1024, streamChecked, streamWrong, underruns, streamer.readErrors);
+
+	for (int k = 0; k < STREAM_TEST_SAMPLES; k++)
+	{
+		free(testStreams[k].file);
+		free(testStreams[k].sample.attack);
+	}
+	free(rings);
+	fclose(image);
+	return (streamWrong == 0 && (underrunsAllowed || underruns == 0) && streamer.readErrors == 0 && streamChecked > 0) ? 0 : 1;
+}
+
+static int testStreamSampler(void)
+{
+	int failed = streamRun("normal", 100.0f, DISK_LATENCY_US, 0);
+	failed |= streamRun("starved", 1.0f, 20000.0, 1);
+	return failed;
+}
+
+/**********************************************/
+
+int main(int argc, char** argv)
+{
+	const char* test = argc > 1 ? argv[1] : "all";
+	int all = (strcmp(test, "all") == 0);
+	int failed = 0;
+
+	if (all || strcmp(test, "ringbuffer") == 0)
+	{
+		if (!all && argc > 2) ringNumFrames = atol(argv[2]);
+		//frame numbers are stored in floats with two bits for the channel, so they have to stay exact
+		if (ringNumFrames > (1 << 21)) ringNumFrames = 1 << 21;
+		failed |= testRingBuffer();
+	}
+
+	if (all || strcmp(test, "eventqueue") == 0)
+	{
+		if (!all && argc > 2) eventNumEvents = atol(argv[2]);
+		failed |= testEventQueue();
+	}
+
+	if (all || strcmp(test, "triggers") == 0)
+	{
+		const char* wavPath = (!all && argc > 2) ? argv[2] : NULL;
+		const char* onsetPath = (!all && argc > 3) ? argv[3] : NULL;
+		failed |= testTriggers(wavPath, onsetPath);
+	}
+
+	if (all || strcmp(test, "drumvoices") == 0)
+	{
+		if (!all && argc > 2) drumSeconds = (float)atof(argv[2]);
+		failed |= testDrumVoices();
+	}
+
+	if (all || strcmp(test, "diskqueue") == 0)
+	{
+		if (!all && argc > 2) diskMegabytes = atol(argv[2]);
+		failed |= testDiskQueue();
+	}
+
+	if (all || strcmp(test, "streamsampler") == 0)
+	{
+		if (!all && argc > 2) streamSeconds = (float)atof(argv[2]);
+		failed |= testStreamSampler();
+	}
+
+	return failed;
+}
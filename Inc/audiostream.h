@@ -32,21 +32,33 @@
 #include "stm32h7xx_hal.h"
 #include "leaf.h"
 #include "main.h"
+#include "ringbuffer.h"
+#include "triggers.h"
+#include "eventqueue.h"
+#include "profiler.h"
+#include "drumvoices.h"
+#include "streamsampler.h"
 
 #define AUDIO_FRAME_SIZE      32
 #define HALF_BUFFER_SIZE      AUDIO_FRAME_SIZE * 2 //number of samples per half of the "double-buffer" (twice the audio frame size because there are interleaved samples for both left and right channels)
 #define AUDIO_BUFFER_SIZE     AUDIO_FRAME_SIZE * 4 //number of samples in the whole data structure (four times the audio frame size because of stereo and also double-buffering/ping-ponging)
-#define ADC_RING_BUFFER_SIZE 2048
+#define ADC_RING_BUFFER_SIZE 2048 //frames, must be a power of two
+#define NUM_SAMPLE_SLOTS 8
 
 extern uint16_t ADC3_values[NUM_EXT_ADC_CHANNELS * AUDIO_FRAME_SIZE];
 extern int32_t audioOutBuffer[AUDIO_BUFFER_SIZE];
 extern uint8_t codecReady;
-extern volatile float audioADCInputs[NUM_EXT_ADC_CHANNELS][ADC_RING_BUFFER_SIZE];
+extern RingBuffer adcRing;
+extern float piezoInputs[NUM_EXT_ADC_CHANNELS][AUDIO_FRAME_SIZE];
+extern TriggerDetector triggers;
+extern EventQueue audioToMain;
+extern EventQueue mainToAudio;
+extern Profiler audioProfiler;
+extern DrumVoices drums;
 extern uint64_t frameCounter2;
 extern volatile int tempInt;
 extern volatile int tempInt2;
 extern float tempFloat;
-extern uint64_t currentADC3BufferPos;
 
 /* Exported types ------------------------------------------------------------*/
 typedef enum
@@ -56,6 +68,46 @@ typedef enum
   BUFFER_OFFSET_FULL,
 }BUFFER_StateTypeDef;
 
+//ids for EventParam commands sent to the audio interrupt
+typedef enum
+{
+  ParamTriggerThreshold = 0, //per piezo
+  ParamTriggerScanTime, //ms
+  ParamTriggerMaskTime, //ms
+  ParamTriggerCrosstalkRatio,
+  ParamPadInstrument, //per piezo, value = PadInstrument
+}AudioParam;
+
+//the one instrument each piezo plays, the plate isn't triggered but rung by the piezo's signal
+typedef enum
+{
+  PadDrum = 0,
+  PadKit,
+  PadPlate,
+  NUM_PAD_INSTRUMENTS
+}PadInstrument;
+
+//ids for EventMeter reports, piezo meters carry the channel
+typedef enum
+{
+  MeterOutputL = 0,
+  MeterOutputR,
+  MeterPiezo,
+}AudioMeter;
+
+//ids for EventError reports
+typedef enum
+{
+  ErrorADCOverrun = 0,
+  ErrorADCUnderrun,
+  ErrorTriggersDropped,
+  ErrorEventsDropped,
+  ErrorCallbackOverrun, //audioFrame took longer than a block
+  ErrorNumeric, //blocks muted because they had a NaN or Inf in them
+  ErrorStreamUnderrun, //frames of streamed samples played as silence because the card fell behind
+  NUM_AUDIO_ERRORS
+}AudioError;
+
 #ifdef SAMPLERATE96K
 #define SAMPLE_RATE 96000.f
 #else
@@ -75,6 +127,15 @@ void audioInit(I2C_HandleTypeDef* hi2c, SAI_HandleTypeDef* hsaiOut, SAI_HandleTy
 
 void audioFrame(uint16_t buffer_offset);
 
+//main loop side of the command queue, these return 0 if the queue is full
+int audioSetParam(AudioParam param, int channel, float value);
+int audioLoadSample(int slot, tBuffer buffer);
+#ifdef AUDIO_STREAMS
+int audioPlayStream(const StreamSample* sample, float gain);
+//reads ahead for the stream voices, has to be called often from the main loop
+void audioStreamTick(void);
+#endif
+
 void DMA1_TransferCpltCallback(DMA_HandleTypeDef *hdma);
 void DMA1_HalfTransferCpltCallback(DMA_HandleTypeDef *hdma);
 #endif /* __AUDIOSTREAM_H */
@@ -0,0 +1,104 @@
+/*
+ * diskqueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Asynchronous block I/O. The main loop submits sector reads and writes and gets a ticket straight
+ *  back, a backend runs them one at a time (DMA on the card, a thread on the host) and reports each
+ *  one from its completion interrupt, and the main loop collects finished requests with diskPoll, in
+ *  the order it submitted them. Nothing waits on the card. Doesn't depend on the HAL, so it also
+ *  builds on the host.
+ */
+
+#ifndef DISKQUEUE_H_
+#define DISKQUEUE_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define DISK_QUEUE_SIZE 16 //requests, must be a power of two
+#define DISK_SECTOR_SIZE 512
+
+typedef enum
+{
+	DiskRead = 0,
+	DiskWrite
+} DiskOp;
+
+typedef enum
+{
+	DiskPending = 0,
+	DiskDone,
+	DiskError
+} DiskStatus;
+
+//what a backend's start returns
+typedef enum
+{
+	DiskStarted = 0,
+	DiskBusy, //the card can't take a command yet, the queue tries again on the next submit or poll
+	DiskFailed //the request is finished with DiskError
+} DiskStartResult;
+
+typedef struct
+{
+	//starts one transfer and returns without waiting for it, the backend then calls
+	//diskQueueComplete exactly once when it's done. Can be called from the completion interrupt.
+	DiskStartResult (*start)(void* context, DiskOp op, uint8_t* buffer, uint32_t sector, uint32_t count);
+	void* context;
+} DiskBackend;
+
+typedef struct
+{
+	uint32_t ticket;
+	uint8_t op;
+	uint8_t status;
+	uint8_t* buffer;
+	uint32_t sector;
+	uint32_t count; //sectors
+	void* user; //handed back untouched
+} DiskRequest;
+
+typedef struct
+{
+	uint32_t submitted;
+	uint32_t completed;
+	uint32_t errors;
+	uint32_t rejected; //submits refused because the queue was full
+	uint32_t maxDepth; //most requests waiting or in flight at once
+	uint32_t sectors; //transferred without an error
+} DiskQueueStats;
+
+typedef struct
+{
+	DiskRequest requests[DISK_QUEUE_SIZE];
+	DiskBackend backend;
+	_Atomic uint32_t writeIndex; //main loop, next free slot
+	_Atomic uint32_t startIndex; //whoever holds busy, next request to start
+	_Atomic uint32_t doneIndex; //completion interrupt, next request to finish
+	_Atomic uint32_t readIndex; //main loop, next finished request to hand back
+	_Atomic int busy; //held while starting a transfer, by the main loop or the completion interrupt
+	uint32_t nextTicket;
+	DiskQueueStats stats;
+} DiskQueue;
+
+void diskQueueInit(DiskQueue* q, const DiskBackend* backend);
+
+//main loop side. Returns a nonzero ticket, or 0 if the queue is full. The buffer belongs to the
+//queue until the request comes back from diskPoll.
+uint32_t diskRead(DiskQueue* q, uint8_t* buffer, uint32_t sector, uint32_t count, void* user);
+uint32_t diskWrite(DiskQueue* q, const uint8_t* buffer, uint32_t sector, uint32_t count, void* user);
+
+//main loop side, returns 0 if nothing has finished since the last call
+int diskPoll(DiskQueue* q, DiskRequest* request);
+//submitted and not handed back yet
+uint32_t diskQueuePending(DiskQueue* q);
+//a transfer has been started and hasn't completed yet
+int diskQueueInFlight(DiskQueue* q);
+int diskQueueFull(DiskQueue* q);
+DiskQueueStats diskQueueGetStats(DiskQueue* q);
+
+//backend side, from its completion interrupt
+void diskQueueComplete(DiskQueue* q, int ok);
+
+#endif /* DISKQUEUE_H_ */
@@ -0,0 +1,106 @@
+/*
+ * drumvoices.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Voice management for the drum instruments. Each instrument gets a fixed set of preallocated
+ *  LEAF 808 voices, a new hit takes a free voice or steals one, instruments in the same choke group
+ *  cut each other off, and voices that have gone quiet stop being computed. Doesn't depend on the
+ *  HAL, so it also builds on the host.
+ */
+
+#ifndef DRUMVOICES_H_
+#define DRUMVOICES_H_
+
+#include <stdint.h>
+#include "leaf.h"
+
+#define DRUM_MAX_INSTRUMENTS 8
+#define DRUM_MAX_VOICES 24 //across all instruments
+#define DRUM_BLOCK_SIZE 32 //voices are computed this many frames at a time
+
+typedef enum
+{
+	DrumKick = 0,
+	DrumSnare,
+	DrumHihat,
+	DrumCowbell
+} DrumVoiceType;
+
+//which voice a hit takes when every voice of its instrument is busy
+typedef enum
+{
+	DrumStealOldest = 0,
+	DrumStealQuietest
+} DrumStealMode;
+
+typedef struct
+{
+	union
+	{
+		t808Kick kick;
+		t808Snare snare;
+		t808Hihat hihat;
+		t808Cowbell cowbell;
+	} synth;
+	uint8_t active;
+	uint8_t choking; //fading out, free to be taken before any voice that is still sounding
+	uint8_t instrument;
+	uint32_t startTime; //frame of the hit, for oldest stealing
+	float level; //peak of the last block, for quietest stealing and silence detection
+	uint32_t silentFrames; //frames in a row the voice has been below the silence threshold
+	float gain; //1 while playing, ramps to 0 when choked
+} DrumVoice;
+
+typedef struct
+{
+	DrumVoiceType type;
+	DrumStealMode stealMode;
+	uint8_t firstVoice;
+	uint8_t numVoices;
+	uint8_t chokeGroup; //0 for none, otherwise a hit chokes every other instrument in the same group
+	float gain;
+} DrumInstrument;
+
+typedef struct
+{
+	int numInstruments;
+	DrumInstrument instruments[DRUM_MAX_INSTRUMENTS];
+	int numVoices;
+	DrumVoice voices[DRUM_MAX_VOICES];
+
+	float silenceThreshold;
+	uint32_t silenceFrames; //how long a voice has to stay below the threshold before it's switched off
+	float chokeStep; //per frame gain decrement of a choked voice
+
+	uint32_t time; //frames processed so far
+	int numActive;
+	int maxActive;
+	uint32_t numSteals;
+	uint32_t numChokes;
+} DrumVoices;
+
+void drumVoicesInit(DrumVoices* dv, float sampleRate);
+
+//preallocates numVoices voices of type in pool, returns the instrument number or -1 if there is no room left,
+//call this from init, not from the audio interrupt
+int drumVoicesAddInstrument(DrumVoices* dv, DrumVoiceType type, int numVoices, DrumStealMode stealMode, int chokeGroup, tMempool* pool);
+
+//level below which a voice counts as silent, and how long it has to stay there before it stops being computed
+void drumVoicesSetSilence(DrumVoices* dv, float threshold, float ms, float sampleRate);
+//how long a choked voice takes to fade out
+void drumVoicesSetChokeTime(DrumVoices* dv, float ms, float sampleRate);
+void drumVoicesSetGain(DrumVoices* dv, int instrument, float gain);
+
+//a hit on an instrument, velocity from 0 to 1
+void drumVoicesTrigger(DrumVoices* dv, int instrument, float velocity);
+//fades out every voice of an instrument, like a hand on a cymbal
+void drumVoicesChoke(DrumVoices* dv, int instrument);
+
+//mixes every active voice into out, which is overwritten
+void drumVoicesProcess(DrumVoices* dv, float* out, int numFrames);
+
+//for setting the sound of an instrument, e.g. t808Kick_setToneFreq(&drumVoicesGetVoice(dv, kick, i)->synth.kick, 50.0f) for every voice i
+DrumVoice* drumVoicesGetVoice(DrumVoices* dv, int instrument, int voice);
+
+#endif /* DRUMVOICES_H_ */
@@ -0,0 +1,65 @@
+/*
+ * eventqueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Single-producer, single-consumer lock-free queue of small fixed-size events. The audio interrupt
+ *  uses one to report to the main loop and the main loop uses another to send it commands, so neither
+ *  side waits on the other. Doesn't depend on the HAL, so it also builds on the host.
+ */
+
+#ifndef EVENTQUEUE_H_
+#define EVENTQUEUE_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define EVENT_QUEUE_SIZE 64 //events, must be a power of two
+
+typedef enum
+{
+	EventNone = 0,
+
+	//audio -> main
+	EventTrigger, //channel = piezo, value = velocity, time = onset frame
+	EventMeter, //id = which meter, value = peak level since the last one
+	EventError, //id = which error, value = how many times it has happened so far
+	EventSampleRelease, //data = a buffer the audio side has stopped using and the main loop can free
+
+	//main -> audio
+	EventParam, //id = which parameter, channel = which piezo if it applies to one, value = new value
+	EventSampleLoad, //id = sample slot, data = a loaded buffer to swap in
+	EventStreamPlay //data = a streamed sample to start on a free stream voice, value = gain
+} EventType;
+
+typedef struct
+{
+	uint8_t type;
+	uint8_t id;
+	uint8_t channel;
+	uint32_t time; //audio frames since startup when the event was sent
+	float value;
+	void* data;
+} Event;
+
+typedef struct
+{
+	Event events[EVENT_QUEUE_SIZE];
+	_Atomic uint32_t writeIndex;
+	_Atomic uint32_t readIndex;
+	_Atomic uint32_t dropped; //events the producer couldn't send because the queue was full
+} EventQueue;
+
+void eventQueueInit(EventQueue* q);
+
+//producer side, returns 0 and counts a drop if the queue is full
+int eventQueuePush(EventQueue* q, const Event* event);
+int eventQueueSend(EventQueue* q, EventType type, uint8_t id, uint8_t channel, uint32_t time, float value, void* data);
+
+//consumer side, returns 0 if the queue is empty
+int eventQueuePop(EventQueue* q, Event* event);
+uint32_t eventQueueAvailable(EventQueue* q);
+
+uint32_t eventQueueGetDropped(EventQueue* q);
+
+#endif /* EVENTQUEUE_H_ */
@@ -0,0 +1,117 @@
+/*
+ * profiler.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Timing for the audio callback and anything inside it. On the STM32 it reads the DWT cycle counter
+ *  that CycleCounterInit() starts, on the host it reads a monotonic clock in nanoseconds, so the same
+ *  reports come out of the firmware, drumbox-host and the LEAF benchmark.
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+
+//only the firmware build defines USE_HAL_DRIVER. A host build on 32-bit ARM (a Raspberry Pi) also has __arm__ but no DWT
+#if defined(USE_HAL_DRIVER)
+#include "stm32h7xx.h"
+#else
+#include <time.h>
+#endif
+
+#define PROFILER_MAX_SCOPES 8
+
+//scope 0 is always the whole callback, profilerAddScope hands out the rest
+#define PROFILER_CALLBACK 0
+
+typedef struct
+{
+	const char* name;
+	uint32_t start;
+	uint32_t count;
+	uint32_t minTicks;
+	uint32_t maxTicks;
+	uint64_t totalTicks;
+	uint32_t overruns; //times a single run took longer than a whole block
+} ProfilerScope;
+
+typedef struct
+{
+	ProfilerScope scopes[PROFILER_MAX_SCOPES];
+	int numScopes;
+	uint32_t ticksPerSecond;
+	uint32_t budgetTicks; //ticks in one block at the sample rate, what the callback has to fit in
+	volatile uint8_t inCallback;
+	uint32_t reentries; //times the callback started again before the last one finished
+} Profiler;
+
+typedef struct
+{
+	const char* name;
+	uint32_t count;
+	uint32_t minTicks;
+	uint32_t maxTicks;
+	float avgTicks;
+	//as a percentage of the block budget
+	float minPercent;
+	float avgPercent;
+	float maxPercent;
+	uint32_t overruns;
+} ProfilerReport;
+
+static inline uint32_t profilerNow(void)
+{
+#if defined(USE_HAL_DRIVER)
+	return DWT->CYCCNT;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+void profilerInit(Profiler* p, float sampleRate, int blockSize);
+void profilerReset(Profiler* p);
+//returns the id to pass to profilerBegin/End, or -1 if there's no room
+int profilerAddScope(Profiler* p, const char* name);
+
+void profilerScopeEnd(Profiler* p, int id, uint32_t ticks);
+
+static inline void profilerBegin(Profiler* p, int id)
+{
+	if (id == PROFILER_CALLBACK)
+	{
+		if (p->inCallback)
+		{
+			p->reentries++;
+		}
+		p->inCallback = 1;
+	}
+	p->scopes[id].start = profilerNow();
+}
+
+static inline void profilerEnd(Profiler* p, int id)
+{
+	//unsigned subtraction, so the counter wrapping around in between doesn't matter
+	profilerScopeEnd(p, id, profilerNow() - p->scopes[id].start);
+	if (id == PROFILER_CALLBACK)
+	{
+		p->inCallback = 0;
+	}
+}
+
+void profilerGetReport(Profiler* p, int id, ProfilerReport* report);
+//prints every scope's report with printf, not for use in an interrupt
+void profilerPrint(Profiler* p);
+
+//named scopes inside audioTickL/R cost two counter reads per sample, so they're compiled out unless PROFILER_SCOPES is defined
+#ifdef PROFILER_SCOPES
+#define PROFILER_SCOPE_BEGIN(p, id) profilerBegin((p), (id))
+#define PROFILER_SCOPE_END(p, id) profilerEnd((p), (id))
+#else
+#define PROFILER_SCOPE_BEGIN(p, id)
+#define PROFILER_SCOPE_END(p, id)
+#endif
+
+#endif /* PROFILER_H_ */
@@ -0,0 +1,50 @@
+/*
+ * ringbuffer.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Single-producer, single-consumer lock-free ring buffer for multichannel float frames.
+ *  One side (an interrupt, or a thread on the host) writes, one side reads, and neither
+ *  ever blocks or disables interrupts. Doesn't depend on the HAL, so it also builds on the host.
+ */
+
+#ifndef RINGBUFFER_H_
+#define RINGBUFFER_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+typedef struct
+{
+	float* buffer; //numChannels blocks of size samples, one after the other
+	uint32_t size; //frames, always a power of two
+	uint32_t mask;
+	uint32_t numChannels;
+
+	//free-running frame counters, each only ever written by one side. The ring holds writeIndex - readIndex frames.
+	_Atomic uint32_t writeIndex;
+	_Atomic uint32_t readIndex;
+
+	//frames the producer had to drop because the ring was full, and frames the consumer asked for that weren't there yet
+	_Atomic uint32_t overruns;
+	_Atomic uint32_t underruns;
+} RingBuffer;
+
+//memory must hold numChannels * size floats. size should be a power of two, anything else is rounded down to one
+void ringBufferInit(RingBuffer* rb, float* memory, uint32_t numChannels, uint32_t size);
+void ringBufferReset(RingBuffer* rb);
+
+//producer side
+uint32_t ringBufferSpace(RingBuffer* rb);
+int ringBufferWriteFrame(RingBuffer* rb, const float* frame);
+uint32_t ringBufferWrite(RingBuffer* rb, const float* interleaved, uint32_t numFrames);
+
+//consumer side
+uint32_t ringBufferAvailable(RingBuffer* rb);
+uint32_t ringBufferRead(RingBuffer* rb, float** channels, uint32_t numFrames);
+uint32_t ringBufferSkip(RingBuffer* rb, uint32_t numFrames);
+
+uint32_t ringBufferGetOverruns(RingBuffer* rb);
+uint32_t ringBufferGetUnderruns(RingBuffer* rb);
+
+#endif /* RINGBUFFER_H_ */
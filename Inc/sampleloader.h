@@ -0,0 +1,24 @@
+/*
+ * sampleloader.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Loads WAV files from the card's FAT file system as streamed samples: reads the header and the
+ *  attack with FatFs, and maps where the rest of the file sits on the card so the streamer can read it
+ *  through the disk queue without going through FatFs at all.
+ */
+
+#ifndef SAMPLELOADER_H_
+#define SAMPLELOADER_H_
+
+#include "streamsampler.h"
+#include "leaf.h"
+
+//mono 16 or 24 bit PCM. The attack comes out of pool. Returns 0 if the file can't be opened, isn't a
+//format that can be streamed, is in more than STREAM_MAX_EXTENTS pieces on the card, or comes up short
+//reading the attack. Main loop only. It can run while the streamer is reading, FatFs's driver pauses
+//sdQueue around each of its commands.
+int sampleLoadStream(StreamSample* s, const char* path, uint32_t attackFrames, float outputRate, tMempool* pool);
+void sampleFreeStream(StreamSample* s, tMempool* pool);
+
+#endif /* SAMPLELOADER_H_ */
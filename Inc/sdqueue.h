@@ -0,0 +1,27 @@
+/*
+ * sdqueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  The disk queue's backend on the card: SDMMC1 transfers sectors with its own DMA and the SDMMC1
+ *  interrupt reports each one back. Buffers have to start on a 32 byte cache line and sit in AXI SRAM
+ *  or SDRAM, the SDMMC DMA can't reach the TCMs.
+ */
+
+#ifndef SDQUEUE_H_
+#define SDQUEUE_H_
+
+#include "diskqueue.h"
+
+extern DiskQueue sdQueue;
+
+//brings the card up if FatFs hasn't yet, returns 0 if there's no card or it wouldn't start
+int sdQueueInit(void);
+
+//FatFs's blocking driver shares the card with the queue and takes it for each of its commands. Pause
+//stops new transfers starting and waits for the one in flight to land and for the card to be ready,
+//resume lets the queue carry on from its next submit or poll. Main loop only.
+void sdQueuePause(void);
+void sdQueueResume(void);
+
+#endif /* SDQUEUE_H_ */
@@ -0,0 +1,123 @@
+/*
+ * streamsampler.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Sample playback streamed from the card, so a kit isn't limited to what fits in SDRAM. Each sample
+ *  keeps only its attack in memory. A hit starts playing from the attack straight away while the
+ *  streamer, run from the main loop, reads the rest through the disk queue into the voice's ring a
+ *  few chunks ahead of the play position. Voices are played from the audio interrupt. Samples are
+ *  mono 16 or 24 bit PCM and are read in place, straight from the bytes the card delivered.
+ *  Doesn't depend on the HAL, so it also builds on the host.
+ */
+
+#ifndef STREAMSAMPLER_H_
+#define STREAMSAMPLER_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "diskqueue.h"
+
+#define STREAM_CHUNK_SECTORS 8 //read from the card this many sectors at a time
+#define STREAM_CHUNK_BYTES (STREAM_CHUNK_SECTORS * DISK_SECTOR_SIZE)
+#define STREAM_RING_CHUNKS 8 //per voice, must be a power of two. 32 kB, 340 ms of 16 bit audio at 48 kHz
+#define STREAM_RING_BYTES (STREAM_RING_CHUNKS * STREAM_CHUNK_BYTES)
+#define STREAM_MAX_EXTENTS 32 //contiguous runs of sectors a sample's file can be split into
+#define STREAM_MAX_VOICES 32
+
+//a run of the file's sectors that sit one after the other on the card
+typedef struct
+{
+	uint32_t fileSector;
+	uint32_t diskSector;
+	uint32_t count;
+} StreamExtent;
+
+typedef struct
+{
+	uint8_t bytesPerSample; //2 or 3
+	float rate; //the file's sample rate over the output's
+	uint32_t length; //frames
+	uint32_t dataOffset; //byte offset of the first frame in the file
+	//The attack holds the file from the sector the data starts in up to streamStart, which is on a
+	//sector boundary. Everything after that is streamed.
+	uint8_t* attack;
+	uint32_t attackBase; //file offset of attack[0]
+	uint32_t streamStart;
+	uint32_t fileBytes; //up to the end of the last frame
+	int numExtents;
+	StreamExtent extents[STREAM_MAX_EXTENTS];
+} StreamSample;
+
+typedef struct
+{
+	//audio interrupt side
+	_Atomic(const StreamSample*) sample; //also read by the streamer once it has seen a new generation
+	uint8_t* ring; //STREAM_RING_BYTES, 32 byte aligned
+	int active;
+	uint32_t index; //frame
+	float frac;
+	float rate;
+	float gain;
+	uint32_t underruns; //frames played as silence because their chunk hadn't arrived
+
+	//set by the audio side on every hit, so the streamer can tell a retrigger from the same hit going on
+	_Atomic uint32_t generation;
+	//the chunk the audio side is reading, the streamer may not refill its slot
+	_Atomic uint32_t playChunk;
+	//chunks that have arrived, counted from streamStart, tagged with the generation they belong to
+	//(generation in the top 8 bits) so a retrigger never plays the last hit's data
+	_Atomic uint32_t ready;
+
+	//streamer side
+	uint32_t streamGeneration; //the hit the streamer is reading for
+	uint32_t requested; //chunks asked for so far
+	uint32_t numChunks; //in the whole sample
+	int inFlight; //requests the card hasn't answered yet
+	int failed;
+} StreamVoice;
+
+typedef struct
+{
+	StreamVoice* voice;
+	uint32_t generation;
+	uint32_t chunk;
+	int last; //a chunk split across extents takes a request per piece, this is its final one
+} StreamRead;
+
+typedef struct
+{
+	DiskQueue* queue;
+	StreamVoice* voices[STREAM_MAX_VOICES];
+	int numVoices;
+	StreamRead reads[DISK_QUEUE_SIZE];
+	StreamRead* freeReads[DISK_QUEUE_SIZE];
+	int numFreeReads;
+	uint32_t chunksRead;
+	uint32_t readErrors;
+} Streamer;
+
+//ring must be STREAM_RING_BYTES long and 32 byte aligned
+void streamVoiceInit(StreamVoice* v, uint8_t* ring);
+
+//audio interrupt side
+void streamVoicePlay(StreamVoice* v, const StreamSample* sample, float rate, float gain);
+void streamVoiceStop(StreamVoice* v);
+//renders numFrames into out, silence once the sample has finished
+void streamVoiceProcess(StreamVoice* v, float* out, int numFrames);
+
+//main loop side
+void streamerInit(Streamer* s, DiskQueue* queue);
+int streamerAddVoice(Streamer* s, StreamVoice* v);
+//collects finished reads and asks for more, the emptiest voice first
+void streamerTick(Streamer* s);
+
+//For a loader. Lays out a sample whose frames start dataOffset bytes into its file, keeping at least
+//attackFrames of it in memory, and returns how many bytes of the file from attackBase the attack has
+//to hold. The loader then points attack at that much memory, fills it, and adds the
+//file's extents in order. A longer attack covers a slower card or more voices starting at once.
+uint32_t streamSampleInit(StreamSample* s, uint32_t dataOffset, uint32_t length, int bytesPerSample, float rate, uint32_t attackFrames);
+//returns 0 if the file is in too many pieces
+int streamSampleAddExtent(StreamSample* s, uint32_t fileSector, uint32_t diskSector, uint32_t count);
+
+#endif /* STREAMSAMPLER_H_ */
@@ -0,0 +1,91 @@
+/*
+ * triggers.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Onset detection for the piezo inputs. Runs over a block of samples per channel at a time and
+ *  queues a timestamped event with a velocity for every hit. Doesn't depend on the HAL, so it also
+ *  builds on the host.
+ */
+
+#ifndef TRIGGERS_H_
+#define TRIGGERS_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define TRIGGER_MAX_CHANNELS 4
+#define TRIGGER_QUEUE_SIZE 32 //events, must be a power of two
+
+typedef struct
+{
+	uint32_t time; //frame the hit crossed the threshold, counted from triggerDetectorInit
+	uint16_t latency; //frames between the threshold crossing and the event being queued
+	uint8_t channel;
+	float peak; //largest absolute sample during the scan time
+	float velocity; //0 to 1, from where the peak falls between the threshold and full scale
+} TriggerEvent;
+
+typedef enum
+{
+	TriggerIdle = 0,
+	TriggerScanning, //crossed the threshold, looking for the peak
+	TriggerMasked //ignoring the tail of the last hit
+} TriggerState;
+
+typedef struct
+{
+	float threshold;
+	float retriggerThreshold; //starts at the peak of the last hit and decays, so the tail can't cross it after the mask
+	TriggerState state;
+	uint32_t counter; //frames left in the current scan or mask
+	float peak;
+	uint32_t onset;
+
+	//the most recent hit that was accepted, for rejecting crosstalk on the other channels
+	float lastPeak;
+	uint32_t lastOnset;
+} TriggerChannel;
+
+typedef struct
+{
+	int numChannels;
+	TriggerChannel channels[TRIGGER_MAX_CHANNELS];
+
+	uint32_t scanFrames;
+	uint32_t maskFrames;
+	float retriggerDecay; //per frame multiplier for retriggerThreshold
+	float crosstalkRatio;
+	uint32_t crosstalkFrames;
+
+	uint32_t time; //frames processed so far
+	uint32_t numTriggers; //hits queued
+	uint32_t numRejected; //hits rejected as crosstalk
+
+	//single producer (the audio callback), single consumer queue of detected hits
+	TriggerEvent events[TRIGGER_QUEUE_SIZE];
+	_Atomic uint32_t writeIndex;
+	_Atomic uint32_t readIndex;
+	_Atomic uint32_t dropped; //events lost because nobody was emptying the queue
+} TriggerDetector;
+
+void triggerDetectorInit(TriggerDetector* td, int numChannels, float sampleRate);
+
+//absolute level a channel has to cross to start a hit, clamped to 0-0.99
+void triggerDetectorSetThreshold(TriggerDetector* td, int channel, float threshold);
+//how long to look for the peak after the threshold is crossed, this is the detection latency
+void triggerDetectorSetScanTime(TriggerDetector* td, float ms, float sampleRate);
+//how long after a hit starts before the same channel can trigger again
+void triggerDetectorSetMaskTime(TriggerDetector* td, float ms, float sampleRate);
+//time constant the retrigger threshold decays with after a hit, should be a bit longer than the pads ring for
+void triggerDetectorSetRetriggerDecay(TriggerDetector* td, float ms, float sampleRate);
+//a hit whose peak is below ratio times that of a hit on another channel starting within ms of it is treated as crosstalk
+void triggerDetectorSetCrosstalk(TriggerDetector* td, float ratio, float ms, float sampleRate);
+
+//runs numFrames samples of every channel through the detector, returns the number of events queued
+int triggerDetectorProcess(TriggerDetector* td, float** channels, int numFrames);
+
+//takes the oldest event off the queue, returns 0 if it was empty
+int triggerDetectorPopEvent(TriggerDetector* td, TriggerEvent* event);
+
+#endif /* TRIGGERS_H_ */
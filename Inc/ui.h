@@ -10,6 +10,8 @@
 #define NUM_ADC_CHANNELS 6
 extern uint16_t ADC_values[NUM_ADC_CHANNELS];
 
+void uiTick(void);
+
 
 #endif /* UI_H_ */
 
@@ -14,17 +14,28 @@
 #include "tim.h"
 #include "ui.h"
 #include "adc.h"
-#define NUM_BUTTONS 3
+#include "ringbuffer.h"
+#include "triggers.h"
+#include "eventqueue.h"
+#include "profiler.h"
+#include "drumvoices.h"
+#include "sdqueue.h"
 
 
 //the audio buffers are put in the D2 RAM area because that is a memory location that the DMA has access to.
 int32_t audioOutBuffer[AUDIO_BUFFER_SIZE] __ATTR_RAM_D2;
 int32_t audioInBuffer[AUDIO_BUFFER_SIZE] __ATTR_RAM_D2;
+float audioInL[AUDIO_FRAME_SIZE];
+float audioInR[AUDIO_FRAME_SIZE];
+float audioOutL[AUDIO_FRAME_SIZE];
+float audioOutR[AUDIO_FRAME_SIZE];
 uint16_t ADC3_values[NUM_EXT_ADC_CHANNELS * AUDIO_FRAME_SIZE] __ATTR_RAM_D3;
 void audioFrame(uint16_t buffer_offset);
+void audioBlock(float* inL, float* inR, float* outL, float* outR, int numSamples);
+static void plateInit(void);
+static void plateReset(void* object);
 float audioTickL(float audioIn, int sampleNum);
 float audioTickR(float audioIn, int sampleNum);
-void buttonCheck(void);
 tHighpass dcBlock[3];
 
 
@@ -34,15 +45,86 @@ HAL_StatusTypeDef receive_status;
 
 uint8_t codecReady = 0;
 
-volatile uint8_t buttonValues[NUM_BUTTONS];
-volatile uint8_t buttonValuesPrev[NUM_BUTTONS];
-volatile uint32_t buttonCounters[NUM_BUTTONS];
-volatile uint32_t buttonPressed[NUM_BUTTONS];
-
-volatile float audioADCInputs[NUM_EXT_ADC_CHANNELS][ADC_RING_BUFFER_SIZE];
-uint64_t currentADC3BufferPos = 0;
+//piezo samples go from the ADC3 DMA interrupt to the audio callback through a lock-free ring
+float adcRingMemory[NUM_EXT_ADC_CHANNELS * ADC_RING_BUFFER_SIZE];
+RingBuffer adcRing;
+//the block of piezo samples that lines up with the audio block being computed
+float piezoInputs[NUM_EXT_ADC_CHANNELS][AUDIO_FRAME_SIZE];
 uint64_t frameCounter2 = 0;
 
+TriggerDetector triggers;
+
+//the audio interrupt reports to the main loop through audioToMain and takes commands from it through mainToAudio,
+//anything slow (GPIO timing, debouncing, SD access, freeing memory) happens on the main loop's side
+EventQueue audioToMain;
+EventQueue mainToAudio;
+uint32_t audioTime = 0; //frames computed since startup, the timestamp on events
+
+//levels are sent to the main loop every METER_BLOCKS blocks
+#define METER_BLOCKS 32
+#define NUM_METERS (2 + NUM_EXT_ADC_CHANNELS)
+float meterPeaks[NUM_METERS];
+uint32_t meterBlockCount = 0;
+uint32_t reportedErrors[NUM_AUDIO_ERRORS];
+
+//cycle counts for every audioFrame, define PROFILER_SCOPES to time audioTickL/R separately as well
+Profiler audioProfiler;
+int tickLScope;
+int tickRScope;
+int drumScope;
+int plateScope;
+int kitScope;
+
+//which instrument each piezo plays, set with ParamPadInstrument. The kit is silent until samples are loaded
+PadInstrument padInstruments[NUM_EXT_ADC_CHANNELS] = {PadDrum, PadDrum, PadPlate};
+
+//one drum per piezo, in channel order
+DrumVoices drums;
+float drumOut[AUDIO_FRAME_SIZE];
+
+//a struck plate, excited directly by the signal of the piezos routed to it
+#define PLATE_MODES 64
+#define PLATE_GATE 0.01f //piezo blocks below this peak don't reach the plate, so ADC noise doesn't keep it ringing
+tModalBank plate;
+float plateIn[AUDIO_FRAME_SIZE];
+float plateOut[AUDIO_FRAME_SIZE];
+
+//the plate is reset if it ever blows up, and each output is muted for any block with a NaN or Inf in it
+tNumericGuard plateGuard;
+tNumericGuard outputGuard[2];
+
+//samples loaded by the main loop, swapped in by the audio interrupt
+tBuffer sampleSlots[NUM_SAMPLE_SLOTS];
+
+//the sampled kit, one zone per sample slot: a soft and a hard layer on the first two piezos, with two
+//samples taking turns in each hard layer, and two taking turns on the third. An empty slot is silent.
+#define NUM_KIT_VOICES 16
+typedef struct
+{
+	int piezo;
+	float velocityLow;
+	float velocityHigh;
+} KitZone;
+static const KitZone kitZones[NUM_SAMPLE_SLOTS] =
+{
+	{0, 0.0f, 0.5f}, {0, 0.5f, 1.0f}, {0, 0.5f, 1.0f},
+	{1, 0.0f, 0.5f}, {1, 0.5f, 1.0f}, {1, 0.5f, 1.0f},
+	{2, 0.0f, 1.0f}, {2, 0.0f, 1.0f}
+};
+tMultiSampler kit;
+float kitOut[AUDIO_FRAME_SIZE];
+
+//samples too big to keep in SDRAM, started by the main loop and read ahead from the card by streamer.
+//nothing loads or starts a stream yet, so they're compiled out unless AUDIO_STREAMS is defined
+#ifdef AUDIO_STREAMS
+#define NUM_STREAM_VOICES 8
+StreamVoice streamVoices[NUM_STREAM_VOICES];
+int numStreamVoices = 0; //the ones that got a ring
+Streamer streamer;
+int streamScope;
+float streamOut[AUDIO_FRAME_SIZE];
+#endif
+
 
 float sample = 0.0f;
 
@@ -79,9 +161,6 @@ typedef enum BOOL {
 	TRUE
 } BOOL;
 
-int sampleNumGlobal = 0;
-
-
 tCycle sine;
 
 
@@ -92,7 +171,8 @@ void audioInit(I2C_HandleTypeDef* hi2c, SAI_HandleTypeDef* hsaiOut, SAI_HandleTy
 	LEAF_init(SAMPLE_RATE, AUDIO_FRAME_SIZE, mediumMemory, MEDIUM_MEM_SIZE, &randomNumber);
 
 	tMempool_init (&smallPool, smallMemory, SMALL_MEM_SIZE);
-	tMempool_init (&largePool, largeMemory, LARGE_MEM_SIZE);
+	// samples and delay lines get swapped in and out of the large pool at runtime, so use the constant-time allocator there
+	tMempool_initWithType (&largePool, largeMemory, LARGE_MEM_SIZE, MempoolSegregatedFit);
 
 	for (int i = 0; i < 6; i++)
 	{
@@ -118,6 +198,52 @@ void audioInit(I2C_HandleTypeDef* hi2c, SAI_HandleTypeDef* hsaiOut, SAI_HandleTy
 	tHighpass_init(&dcBlock[1], 30.0f);
 	tHighpass_init(&dcBlock[2], 30.0f);
 
+	ringBufferInit(&adcRing, adcRingMemory, NUM_EXT_ADC_CHANNELS, ADC_RING_BUFFER_SIZE);
+	triggerDetectorInit(&triggers, NUM_EXT_ADC_CHANNELS, SAMPLE_RATE);
+	eventQueueInit(&audioToMain);
+	eventQueueInit(&mainToAudio);
+
+	//the DWT has to be running already, CycleCounterInit() in main does that
+	profilerInit(&audioProfiler, SAMPLE_RATE, AUDIO_FRAME_SIZE);
+	tickLScope = profilerAddScope(&audioProfiler, "audioTickL");
+	tickRScope = profilerAddScope(&audioProfiler, "audioTickR");
+	drumScope = profilerAddScope(&audioProfiler, "drums");
+
+	drumVoicesInit(&drums, SAMPLE_RATE);
+	drumVoicesAddInstrument(&drums, DrumKick, 2, DrumStealOldest, 0, &leaf.mempool);
+	drumVoicesAddInstrument(&drums, DrumSnare, 3, DrumStealQuietest, 0, &leaf.mempool);
+	drumVoicesAddInstrument(&drums, DrumHihat, 3, DrumStealOldest, 0, &leaf.mempool);
+
+	plateScope = profilerAddScope(&audioProfiler, "plate");
+	plateInit();
+	tNumericGuard_init(&plateGuard, &plateReset, &plate);
+	tNumericGuard_init(&outputGuard[0], NULL, NULL);
+	tNumericGuard_init(&outputGuard[1], NULL, NULL);
+
+	kitScope = profilerAddScope(&audioProfiler, "kit");
+	tMultiSampler_init(&kit, NUM_EXT_ADC_CHANNELS, NUM_SAMPLE_SLOTS, NUM_KIT_VOICES);
+	for (int i = 0; i < NUM_SAMPLE_SLOTS; i++)
+	{
+		tMultiSampler_addZone(&kit, NULL, kitZones[i].piezo, kitZones[i].velocityLow, kitZones[i].velocityHigh);
+	}
+
+#ifdef AUDIO_STREAMS
+	//the rings are DMA targets, so they start on a cache line. A voice that doesn't get one is left out
+	streamScope = profilerAddScope(&audioProfiler, "streams");
+	streamerInit(&streamer, &sdQueue);
+	for (int i = 0; i < NUM_STREAM_VOICES; i++)
+	{
+		uint8_t* ring = (uint8_t*)mpool_alloc(STREAM_RING_BYTES + 31, largePool);
+		if (ring == NULL)
+		{
+			break;
+		}
+		StreamVoice* v = &streamVoices[numStreamVoices++];
+		streamVoiceInit(v, (uint8_t*)(((uintptr_t)ring + 31) & ~(uintptr_t)31));
+		streamerAddVoice(&streamer, v);
+	}
+#endif
+
 	for (int i = 0; i < AUDIO_BUFFER_SIZE; i++)
 	{
 		audioOutBuffer[i] = 0;
@@ -152,6 +278,7 @@ void audioFrame(uint16_t buffer_offset)
 {
 	int i;
 	int32_t current_sample = 0;
+	profilerBegin(&audioProfiler, PROFILER_CALLBACK);
 	frameCounter2++;
 	//HAL_ADC_Start_DMA(&hadc3,(uint32_t*)&ADC3_values[(buffer_offset > 0)], 3*AUDIO_FRAME_SIZE);
 /*
@@ -173,8 +300,6 @@ void audioFrame(uint16_t buffer_offset)
 	}
 */
 
-	buttonCheck();
-
 	//read the analog inputs and smooth them with ramps
 	for (i = 0; i < 6; i++)
 	{
@@ -187,89 +312,347 @@ void audioFrame(uint16_t buffer_offset)
 
 	if (codecReady)
 	{
-		for (i = 0; i < (HALF_BUFFER_SIZE); i++)
+		//split the interleaved codec data into one block per channel (right is the even slot, left the odd one)
+		for (i = 0; i < AUDIO_FRAME_SIZE; i++)
 		{
-			if ((i & 1) == 0)
-			{
-				current_sample = (int32_t)(audioTickR((float) ((audioInBuffer[buffer_offset + i] << 8) * INV_TWO_TO_31), i/2) * TWO_TO_23);
-			}
-			else
-			{
-				current_sample = (int32_t)(audioTickL((float) ((audioInBuffer[buffer_offset + i] << 8) * INV_TWO_TO_31), i/2) * TWO_TO_23);
-			}
+			audioInR[i] = (float) ((audioInBuffer[buffer_offset + (i * 2)] << 8) * INV_TWO_TO_31);
+			audioInL[i] = (float) ((audioInBuffer[buffer_offset + (i * 2) + 1] << 8) * INV_TWO_TO_31);
+		}
+
+		audioBlock(audioInL, audioInR, audioOutL, audioOutR, AUDIO_FRAME_SIZE);
 
-			audioOutBuffer[buffer_offset + i] = current_sample;
+		for (i = 0; i < AUDIO_FRAME_SIZE; i++)
+		{
+			current_sample = (int32_t)(audioOutR[i] * TWO_TO_23);
+			audioOutBuffer[buffer_offset + (i * 2)] = current_sample;
+			current_sample = (int32_t)(audioOutL[i] * TWO_TO_23);
+			audioOutBuffer[buffer_offset + (i * 2) + 1] = current_sample;
 		}
 	}
+	profilerEnd(&audioProfiler, PROFILER_CALLBACK);
 }
-float rightIn = 0.0f;
 
-volatile int dummy;
-int inAttack;
+#ifdef AUDIO_STREAMS
+//a free voice, or else the one furthest into its sample
+static StreamVoice* allocateStreamVoice(void)
+{
+	StreamVoice* steal = &streamVoices[0];
+	for (int i = 0; i < numStreamVoices; i++)
+	{
+		if (!streamVoices[i].active)
+		{
+			return &streamVoices[i];
+		}
+		if (streamVoices[i].index > steal->index)
+		{
+			steal = &streamVoices[i];
+		}
+	}
+	return steal;
+}
+#endif
 
-float mic0;
-float mic1;
-float mic2;
+//returns 0 if the command couldn't be finished yet and has to be tried again next block
+static int audioHandleCommand(const Event* command)
+{
+	if (command->type == EventParam)
+	{
+		if (command->id == ParamTriggerThreshold)
+		{
+			triggerDetectorSetThreshold(&triggers, command->channel, command->value);
+		}
+		else if (command->id == ParamTriggerScanTime)
+		{
+			triggerDetectorSetScanTime(&triggers, command->value, SAMPLE_RATE);
+		}
+		else if (command->id == ParamTriggerMaskTime)
+		{
+			triggerDetectorSetMaskTime(&triggers, command->value, SAMPLE_RATE);
+		}
+		else if (command->id == ParamTriggerCrosstalkRatio)
+		{
+			triggerDetectorSetCrosstalk(&triggers, command->value, triggers.crosstalkFrames / SAMPLE_RATE_MS, SAMPLE_RATE);
+		}
+		else if ((command->id == ParamPadInstrument) && (command->channel < NUM_EXT_ADC_CHANNELS)
+				&& (command->value >= 0.0f) && (command->value < (float)NUM_PAD_INSTRUMENTS))
+		{
+			padInstruments[command->channel] = (PadInstrument) command->value;
+		}
+	}
+	else if ((command->type == EventSampleLoad) && (command->id < NUM_SAMPLE_SLOTS))
+	{
+		//the old sample goes back to the main loop to be freed, so there has to be room to send it
+		tBuffer old = sampleSlots[command->id];
+		if ((old != NULL) && !eventQueueSend(&audioToMain, EventSampleRelease, command->id, 0, audioTime, 0.0f, old))
+		{
+			return 0;
+		}
+		sampleSlots[command->id] = (tBuffer) command->data;
+		//stops any voice still playing the old sample before it goes back
+		tMultiSampler_setZoneBuffer(&kit, command->id, &sampleSlots[command->id]);
+	}
+#ifdef AUDIO_STREAMS
+	else if ((command->type == EventStreamPlay) && (command->data != NULL) && (numStreamVoices > 0))
+	{
+		streamVoicePlay(allocateStreamVoice(), (const StreamSample*) command->data, 1.0f, command->value);
+	}
+#endif
+	return 1;
+}
 
-float peak[3];
+//commands from the main loop, at most a queue's worth per block so a flood of them can't stretch the interrupt
+Event deferredCommand;
+uint8_t hasDeferredCommand = 0;
+static void audioHandleCommands(void)
+{
+	if (hasDeferredCommand)
+	{
+		if (!audioHandleCommand(&deferredCommand))
+		{
+			return;
+		}
+		hasDeferredCommand = 0;
+	}
 
-float audioTickL(float audioIn, int sampleNum)
+	for (int i = 0; (i < EVENT_QUEUE_SIZE) && eventQueuePop(&mainToAudio, &deferredCommand); i++)
+	{
+		if (!audioHandleCommand(&deferredCommand))
+		{
+			hasDeferredCommand = 1;
+			return;
+		}
+	}
+}
+
+static uint32_t numericErrors(void)
 {
+	tNumericGuard* guards[3] = {&plateGuard, &outputGuard[0], &outputGuard[1]};
+	uint32_t count = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		tNumericGuardStats stats;
+		tNumericGuard_getStats(guards[i], &stats);
+		count += stats.nanBlocks + stats.infBlocks;
+	}
+	return count;
+}
 
-	sample = 0.0f;
+static void audioSendError(AudioError error, uint32_t count)
+{
+	if (count != reportedErrors[error])
+	{
+		if (eventQueueSend(&audioToMain, EventError, error, 0, audioTime, (float)count, NULL))
+		{
+			reportedErrors[error] = count;
+		}
+	}
+}
 
-	mic0 = audioADCInputs[0][sampleNumGlobal];
-	mic1 = audioADCInputs[1][sampleNumGlobal];
-	mic2 = audioADCInputs[2][sampleNumGlobal];
+static void audioSendReports(float* outL, float* outR, int numSamples)
+{
+	for (int i = 0; i < numSamples; i++)
+	{
+		float l = fabsf(outL[i]);
+		float r = fabsf(outR[i]);
+		if (l > meterPeaks[MeterOutputL]) meterPeaks[MeterOutputL] = l;
+		if (r > meterPeaks[MeterOutputR]) meterPeaks[MeterOutputR] = r;
+		for (int ch = 0; ch < NUM_EXT_ADC_CHANNELS; ch++)
+		{
+			float p = fabsf(piezoInputs[ch][i]);
+			if (p > meterPeaks[MeterPiezo + ch]) meterPeaks[MeterPiezo + ch] = p;
+		}
+	}
 
-	int position = currentADC3BufferPos;
+	if (++meterBlockCount >= METER_BLOCKS)
+	{
+		meterBlockCount = 0;
+		eventQueueSend(&audioToMain, EventMeter, MeterOutputL, 0, audioTime, meterPeaks[MeterOutputL], NULL);
+		eventQueueSend(&audioToMain, EventMeter, MeterOutputR, 0, audioTime, meterPeaks[MeterOutputR], NULL);
+		for (int ch = 0; ch < NUM_EXT_ADC_CHANNELS; ch++)
+		{
+			eventQueueSend(&audioToMain, EventMeter, MeterPiezo, ch, audioTime, meterPeaks[MeterPiezo + ch], NULL);
+		}
+		for (int i = 0; i < NUM_METERS; i++)
+		{
+			meterPeaks[i] = 0.0f;
+		}
+
+		//errors only go out with the meters, so a persistent fault can't fill the queue
+		audioSendError(ErrorADCOverrun, ringBufferGetOverruns(&adcRing));
+		audioSendError(ErrorADCUnderrun, ringBufferGetUnderruns(&adcRing));
+		audioSendError(ErrorTriggersDropped, (uint32_t)atomic_load_explicit(&triggers.dropped, memory_order_relaxed));
+		audioSendError(ErrorEventsDropped, eventQueueGetDropped(&audioToMain));
+		audioSendError(ErrorCallbackOverrun, audioProfiler.scopes[PROFILER_CALLBACK].overruns + audioProfiler.reentries);
+		audioSendError(ErrorNumeric, numericErrors());
+#ifdef AUDIO_STREAMS
+		uint32_t underruns = 0;
+		for (int i = 0; i < numStreamVoices; i++) underruns += streamVoices[i].underruns;
+		audioSendError(ErrorStreamUnderrun, underruns);
+#endif
+	}
+}
 
-	if (currentADC3BufferPos < sampleNumGlobal)
+//modes of a simply supported rectangular plate, f(m,n) proportional to m^2 + (n/aspect)^2,
+//struck a little off center so most modes are excited, higher modes die away faster
+static void plateInit(void)
+{
+	float aspect = 1.37f;
+	float strikeX = 0.31f;
+	float strikeY = 0.43f;
+	float base = 90.0f;
+	tModalBank_init(&plate, PLATE_MODES);
+	for (int i = 0; i < PLATE_MODES; i++)
 	{
-		position += ADC_RING_BUFFER_SIZE;
+		int m = (i % 8) + 1;
+		int n = (i / 8) + 1;
+		float ratio = (float)(m * m) + ((float)(n * n) / (aspect * aspect));
+		float freq = base * ratio;
+		float decay = 2.5f / sqrtf(ratio);
+		float gain = sinf((float)m * PI * strikeX) * sinf((float)n * PI * strikeY) * 0.05f;
+		tModalBank_setMode(&plate, i, freq, decay, gain);
 	}
+}
+
+static void plateReset(void* object)
+{
+	tModalBank_clear((tModalBank*)object);
+}
+
+//compute a whole frame at once - LEAF objects that have a _process function should be run over the full block here,
+//per-sample work that can't be done that way still goes in audioTickL/R
+void audioBlock(float* inL, float* inR, float* outL, float* outR, int numSamples)
+{
+	float* piezoChannels[NUM_EXT_ADC_CHANNELS] = {piezoInputs[0], piezoInputs[1], piezoInputs[2]};
 
+	audioHandleCommands();
 
-	if (mic0 >= 0.1f || mic1 >= 0.1f || mic2 >= 0.1f)
+	//if the ADC has got more than a block ahead, drop the oldest samples so the piezos stay within a block of real time
+	uint32_t backlog = ringBufferAvailable(&adcRing);
+	if (backlog > (uint32_t)(numSamples * 2))
 	{
-		//read this until currentADC3BufferPos, check for peak
-		for (int i = sampleNumGlobal; i <= position; i++)
-				{
-					if (fabs(audioADCInputs[0][i+1]) > fabs(audioADCInputs[0][i]))
-					{
-						peak[0] = fabs(audioADCInputs[0][i]);
-					}
-					if (fabs(audioADCInputs[1][i+1]) > fabs(audioADCInputs[1][i]))
-					{
-						peak[1] = fabs(audioADCInputs[1][i]);
-					}
-					if (fabs(audioADCInputs[2][i+1]) > fabs(audioADCInputs[2][i]))
-					{
-						peak[2] = fabs(audioADCInputs[2][i]);
-					}
-				}
-		dummy++;
+		ringBufferSkip(&adcRing, backlog - (numSamples * 2));
 	}
+	//anything the ADC hasn't delivered yet reads as silence, and shows up in the ring's underrun count
+	ringBufferRead(&adcRing, piezoChannels, numSamples);
 
-	if (peak[0] > peak[1] && peak[0] > peak[2])
+	triggerDetectorProcess(&triggers, piezoChannels, numSamples);
+	TriggerEvent hit;
+	while (triggerDetectorPopEvent(&triggers, &hit))
 	{
-		HAL_GPIO_WritePin(GPIOB, GPIO_PIN_15, GPIO_PIN_SET);
-		HAL_Delay(15);
-		HAL_GPIO_WritePin(GPIOB, GPIO_PIN_15, GPIO_PIN_RESET);
+		eventQueueSend(&audioToMain, EventTrigger, 0, hit.channel, hit.time, hit.velocity, NULL);
+		if (padInstruments[hit.channel] == PadDrum)
+		{
+			drumVoicesTrigger(&drums, hit.channel, hit.velocity);
+		}
+		else if (padInstruments[hit.channel] == PadKit)
+		{
+			tMultiSampler_trigger(&kit, hit.channel, hit.velocity);
+		}
+	}
+
+	PROFILER_SCOPE_BEGIN(&audioProfiler, drumScope);
+	drumVoicesProcess(&drums, drumOut, numSamples);
+	PROFILER_SCOPE_END(&audioProfiler, drumScope);
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		plateIn[i] = 0.0f;
+	}
+	for (int c = 0; c < NUM_EXT_ADC_CHANNELS; c++)
+	{
+		if (padInstruments[c] != PadPlate)
+		{
+			continue;
+		}
+		float piezoPeak = 0.0f;
+		for (int i = 0; i < numSamples; i++)
+		{
+			float p = fabsf(piezoInputs[c][i]);
+			if (p > piezoPeak) piezoPeak = p;
+		}
+		if (piezoPeak > PLATE_GATE)
+		{
+			for (int i = 0; i < numSamples; i++)
+			{
+				plateIn[i] += piezoInputs[c][i];
+			}
+		}
 	}
-	else if (peak[1] > peak[0] && peak[1] > peak[2])
+	PROFILER_SCOPE_BEGIN(&audioProfiler, plateScope);
+	tModalBank_process(&plate, plateIn, plateOut, numSamples);
+	PROFILER_SCOPE_END(&audioProfiler, plateScope);
+	tNumericGuard_check(&plateGuard, plateOut, numSamples);
+
+	PROFILER_SCOPE_BEGIN(&audioProfiler, kitScope);
+	tMultiSampler_process(&kit, kitOut, numSamples);
+	PROFILER_SCOPE_END(&audioProfiler, kitScope);
+
+#ifdef AUDIO_STREAMS
+	//streams mix in with the drums
+	PROFILER_SCOPE_BEGIN(&audioProfiler, streamScope);
+	for (int v = 0; v < numStreamVoices; v++)
 	{
-		HAL_GPIO_WritePin(GPIOC, GPIO_PIN_6, GPIO_PIN_SET);
-		HAL_Delay(15);
-		HAL_GPIO_WritePin(GPIOC, GPIO_PIN_6, GPIO_PIN_RESET);
+		if (streamVoices[v].active)
+		{
+			streamVoiceProcess(&streamVoices[v], streamOut, numSamples);
+			for (int i = 0; i < numSamples; i++) drumOut[i] += streamOut[i];
+		}
 	}
-	else if (peak[2] > peak[0] && peak[2] > peak[1])
+	PROFILER_SCOPE_END(&audioProfiler, streamScope);
+#endif
+
+	for (int i = 0; i < numSamples; i++)
 	{
-		HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, GPIO_PIN_SET);
-		HAL_Delay(15);
-		HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, GPIO_PIN_RESET);
+		PROFILER_SCOPE_BEGIN(&audioProfiler, tickRScope);
+		outR[i] = audioTickR(inR[i], i);
+		PROFILER_SCOPE_END(&audioProfiler, tickRScope);
+		PROFILER_SCOPE_BEGIN(&audioProfiler, tickLScope);
+		outL[i] = audioTickL(inL[i], i);
+		PROFILER_SCOPE_END(&audioProfiler, tickLScope);
+		outL[i] += drumOut[i] + plateOut[i] + kitOut[i];
+		outR[i] += drumOut[i] + plateOut[i] + kitOut[i];
 	}
+	tNumericGuard_check(&outputGuard[0], outL, numSamples);
+	tNumericGuard_check(&outputGuard[1], outR, numSamples);
 
+	audioSendReports(outL, outR, numSamples);
+	audioTime += numSamples;
+}
+
+//called from the main loop
+
+int audioSetParam(AudioParam param, int channel, float value)
+{
+	return eventQueueSend(&mainToAudio, EventParam, param, channel, 0, value, NULL);
+}
+
+//once the audio interrupt has swapped buffer in, whatever was in the slot before comes back as an EventSampleRelease
+int audioLoadSample(int slot, tBuffer buffer)
+{
+	return eventQueueSend(&mainToAudio, EventSampleLoad, slot, 0, 0, 0.0f, buffer);
+}
+
+#ifdef AUDIO_STREAMS
+//sample has to stay loaded for as long as it might be playing
+int audioPlayStream(const StreamSample* sample, float gain)
+{
+	return eventQueueSend(&mainToAudio, EventStreamPlay, 0, 0, 0, gain, (void*)sample);
+}
+
+void audioStreamTick(void)
+{
+	streamerTick(&streamer);
+}
+#endif
+float rightIn = 0.0f;
+
+volatile int dummy;
+int inAttack;
+
+float audioTickL(float audioIn, int sampleNum)
+{
+
+	sample = 0.0f;
 
 	//A2db db2a funtions > decibels
 
@@ -278,11 +661,6 @@ float audioTickL(float audioIn, int sampleNum)
 	// leds: B15 C6 A8 D12 A9 // brainboard led: B4
 
 
-	sampleNumGlobal++;
-	if (sampleNumGlobal >= 2048)
-	{
-		sampleNumGlobal = 0;
-	}
 	return sample;
 
 /*
@@ -301,84 +679,13 @@ uint32_t myCounter = 0;
 float audioTickR(float audioIn, int sampleNum)
 {
 	rightIn = audioIn;
-	//sample = (audioADCInputs[1][sampleNumGlobal] + audioADCInputs[2][sampleNumGlobal]) * 0.5f;
-	sample = audioADCInputs[2][sampleNumGlobal];
+	//sample = (piezoInputs[1][sampleNum] + piezoInputs[2][sampleNum]) * 0.5f;
+	sample = piezoInputs[2][sampleNum];
 	//sample = 0.0f;
 	return sample;
 }
 
 
-volatile uint8_t LED_States[3] = {0,0,0};
-void buttonCheck(void)
-{
-	buttonValues[0] = !HAL_GPIO_ReadPin(GPIOG, GPIO_PIN_6);
-	buttonValues[1] = !HAL_GPIO_ReadPin(GPIOG, GPIO_PIN_7);
-	//buttonValues[2] = !HAL_GPIO_ReadPin(GPIOD, GPIO_PIN_11);
-	for (int i = 0; i < NUM_BUTTONS; i++)
-	{
-	  if ((buttonValues[i] != buttonValuesPrev[i]) && (buttonCounters[i] < 10))
-	  {
-		  buttonCounters[i]++;
-	  }
-	  if ((buttonValues[i] != buttonValuesPrev[i]) && (buttonCounters[i] >= 10))
-	  {
-		  if (buttonValues[i] == 1)
-		  {
-			  buttonPressed[i] = 1;
-		  }
-		  buttonValuesPrev[i] = buttonValues[i];
-		  buttonCounters[i] = 0;
-	  }
-	}
-
-	if (buttonPressed[0] == 1)
-	{
-
-
-		if (LED_States[0] == 0)
-		{
-			//HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, GPIO_PIN_SET);
-			LED_States[0] = 1;
-		}
-		else
-		{
-			//HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, GPIO_PIN_RESET);
-			LED_States[0] = 0;
-		}
-		buttonPressed[0] = 0;
-
-	}
-	if (buttonPressed[1] == 1)
-	{
-		if (LED_States[1] == 0)
-		{
-			//HAL_GPIO_WritePin(GPIOD, GPIO_PIN_12, GPIO_PIN_SET);
-			LED_States[1] = 1;
-		}
-		else
-		{
-			//HAL_GPIO_WritePin(GPIOD, GPIO_PIN_12, GPIO_PIN_RESET);
-			LED_States[1] = 0;
-		}
-		buttonPressed[1] = 0;
-	}
-
-	if (buttonPressed[2] == 1)
-	{
-		if (LED_States[2] == 0)
-		{
-
-			LED_States[2] = 1;
-		}
-		else
-		{
-
-			LED_States[2] = 0;
-		}
-		buttonPressed[2] = 0;
-	}
-}
-
 void HAL_SAI_ErrorCallback(SAI_HandleTypeDef *hsai)
 {
 	;
@@ -405,28 +712,35 @@ void HAL_SAI_RxHalfCpltCallback(SAI_HandleTypeDef *hsai)
 	audioFrame(0);
 }
 
-void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) //buffer just filled
+//convert half of the circular ADC3 DMA buffer and hand it to the audio callback through adcRing
+//each half is handled while the DMA is filling the other one, so the samples can't change underneath us
+static void adcToRing(int firstFrame, int numFrames)
 {
-	if (hadc == &hadc3)
+	float frames[NUM_EXT_ADC_CHANNELS * (AUDIO_FRAME_SIZE / 2)];
+	for (int i = 0; i < numFrames; i++)
 	{
-		for (int i = 0; i < AUDIO_FRAME_SIZE; i++)
+		for (int j = 0; j < NUM_EXT_ADC_CHANNELS; j++)
 		{
-			for (int j = 0; j < NUM_EXT_ADC_CHANNELS; j++)
-			{
-				int tempInt = ADC3_values[(i*NUM_EXT_ADC_CHANNELS) + j];
-				audioADCInputs[j][currentADC3BufferPos] = tHighpass_tick(&dcBlock[j],((float)(tempInt - TWO_TO_15) * INV_TWO_TO_15));
-			}
-			currentADC3BufferPos++;
-			if (currentADC3BufferPos >= 2048)
-			{
-				currentADC3BufferPos = 0;
-			}
+			int tempInt = ADC3_values[((firstFrame + i)*NUM_EXT_ADC_CHANNELS) + j];
+			frames[(i*NUM_EXT_ADC_CHANNELS) + j] = tHighpass_tick(&dcBlock[j],((float)(tempInt - TWO_TO_15) * INV_TWO_TO_15));
 		}
 	}
+	ringBufferWrite(&adcRing, frames, numFrames);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) //buffer just filled
+{
+	if (hadc == &hadc3)
+	{
+		adcToRing(AUDIO_FRAME_SIZE / 2, AUDIO_FRAME_SIZE / 2);
+	}
 }
 void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
 {
-	;
+	if (hadc == &hadc3)
+	{
+		adcToRing(0, AUDIO_FRAME_SIZE / 2);
+	}
 }
 void HAL_ADC_Error(ADC_HandleTypeDef *hadc)
 {
@@ -0,0 +1,166 @@
+/*
+ * diskqueue.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "diskqueue.h"
+
+//One ring of requests with four indices walking round it in order: readIndex <= doneIndex <=
+//startIndex <= writeIndex. The main loop owns writeIndex and readIndex, the completion interrupt
+//owns doneIndex, and startIndex belongs to whoever holds busy. A card only takes one command at a
+//time, so at most one request is in flight (startIndex == doneIndex + 1).
+//
+//Both the main loop (after a submit or during a poll) and the completion interrupt try to start the
+//next transfer. Whichever gets busy does it and the other one just returns. After letting go of busy
+//the holder looks again, so a submit or completion that lost the race for busy is never left waiting.
+//The busy exchange and those second looks are sequentially consistent, which is what makes that
+//hand-off safe between threads on the host as well as between the main loop and an interrupt.
+
+void diskQueueInit(DiskQueue* q, const DiskBackend* backend)
+{
+	q->backend = *backend;
+	atomic_store_explicit(&q->writeIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&q->startIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&q->doneIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&q->readIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&q->busy, 0, memory_order_relaxed);
+	q->nextTicket = 1;
+	q->stats.submitted = 0;
+	q->stats.completed = 0;
+	q->stats.errors = 0;
+	q->stats.rejected = 0;
+	q->stats.maxDepth = 0;
+	q->stats.sectors = 0;
+}
+
+//something is waiting and nothing is in flight
+static int canStart(DiskQueue* q)
+{
+	uint32_t start = atomic_load(&q->startIndex);
+	return (start != atomic_load(&q->writeIndex)) && (start == atomic_load(&q->doneIndex));
+}
+
+static void kick(DiskQueue* q)
+{
+	int cardBusy = 0;
+	while (!cardBusy && canStart(q) && !atomic_exchange(&q->busy, 1))
+	{
+		while (canStart(q))
+		{
+			uint32_t start = atomic_load(&q->startIndex);
+			DiskRequest* r = &q->requests[start & (DISK_QUEUE_SIZE - 1)];
+			//published before starting, in case the completion interrupt beats the backend's return
+			atomic_store(&q->startIndex, start + 1);
+			DiskStartResult result = q->backend.start(q->backend.context, (DiskOp)r->op, r->buffer, r->sector, r->count);
+			if (result == DiskBusy)
+			{
+				atomic_store(&q->startIndex, start);
+				cardBusy = 1;
+				break;
+			}
+			if (result == DiskFailed)
+			{
+				//nothing is in flight to complete it, so finish it here
+				r->status = DiskError;
+				atomic_store_explicit(&q->doneIndex, start + 1, memory_order_release);
+			}
+		}
+		atomic_store(&q->busy, 0);
+		if (atomic_load(&q->startIndex) != atomic_load(&q->doneIndex))
+		{
+			break; //a transfer is running, its completion carries on from here
+		}
+	}
+}
+
+static uint32_t submit(DiskQueue* q, DiskOp op, uint8_t* buffer, uint32_t sector, uint32_t count, void* user)
+{
+	uint32_t write = atomic_load_explicit(&q->writeIndex, memory_order_relaxed);
+	uint32_t read = atomic_load_explicit(&q->readIndex, memory_order_relaxed);
+	if ((write - read) >= DISK_QUEUE_SIZE)
+	{
+		q->stats.rejected++;
+		return 0;
+	}
+
+	DiskRequest* r = &q->requests[write & (DISK_QUEUE_SIZE - 1)];
+	uint32_t ticket = q->nextTicket++;
+	if (q->nextTicket == 0) q->nextTicket = 1;
+	r->ticket = ticket;
+	r->op = (uint8_t)op;
+	r->status = DiskPending;
+	r->buffer = buffer;
+	r->sector = sector;
+	r->count = count;
+	r->user = user;
+	atomic_store_explicit(&q->writeIndex, write + 1, memory_order_release);
+
+	q->stats.submitted++;
+	if ((write + 1 - read) > q->stats.maxDepth) q->stats.maxDepth = write + 1 - read;
+	kick(q);
+	return ticket;
+}
+
+uint32_t diskRead(DiskQueue* q, uint8_t* buffer, uint32_t sector, uint32_t count, void* user)
+{
+	return submit(q, DiskRead, buffer, sector, count, user);
+}
+
+uint32_t diskWrite(DiskQueue* q, const uint8_t* buffer, uint32_t sector, uint32_t count, void* user)
+{
+	//the backend only reads from it, the cast just lets both directions share one request type
+	return submit(q, DiskWrite, (uint8_t*)buffer, sector, count, user);
+}
+
+int diskPoll(DiskQueue* q, DiskRequest* request)
+{
+	//also retries a start the card wasn't ready for
+	kick(q);
+
+	uint32_t done = atomic_load_explicit(&q->doneIndex, memory_order_acquire);
+	uint32_t read = atomic_load_explicit(&q->readIndex, memory_order_relaxed);
+	if (done == read)
+	{
+		return 0;
+	}
+	*request = q->requests[read & (DISK_QUEUE_SIZE - 1)];
+	atomic_store_explicit(&q->readIndex, read + 1, memory_order_release);
+
+	q->stats.completed++;
+	if (request->status == DiskError) q->stats.errors++;
+	else q->stats.sectors += request->count;
+	return 1;
+}
+
+uint32_t diskQueuePending(DiskQueue* q)
+{
+	return atomic_load_explicit(&q->writeIndex, memory_order_relaxed) - atomic_load_explicit(&q->readIndex, memory_order_relaxed);
+}
+
+int diskQueueInFlight(DiskQueue* q)
+{
+	return atomic_load(&q->startIndex) != atomic_load(&q->doneIndex);
+}
+
+int diskQueueFull(DiskQueue* q)
+{
+	return diskQueuePending(q) >= DISK_QUEUE_SIZE;
+}
+
+DiskQueueStats diskQueueGetStats(DiskQueue* q)
+{
+	return q->stats;
+}
+
+void diskQueueComplete(DiskQueue* q, int ok)
+{
+	uint32_t done = atomic_load_explicit(&q->doneIndex, memory_order_relaxed);
+	if (done == atomic_load(&q->startIndex))
+	{
+		return; //nothing in flight, a stray callback
+	}
+	q->requests[done & (DISK_QUEUE_SIZE - 1)].status = ok ? DiskDone : DiskError;
+	atomic_store_explicit(&q->doneIndex, done + 1, memory_order_release);
+	kick(q);
+}
@@ -0,0 +1,308 @@
+/*
+ * drumvoices.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <math.h>
+#include "drumvoices.h"
+
+//A hit takes the first inactive voice of its instrument, then a voice that is already fading out
+//from a choke, and only then steals a sounding one, the oldest or the quietest depending on the
+//instrument. Voices are only computed while active. A voice switches itself off once its 808 has
+//gone to sleep (envelopes done and filters decayed), its output has stayed under silenceThreshold
+//for silenceFrames, or a choke fade reaches zero, so an idle kit costs almost nothing no matter
+//how many voices it has.
+
+#define DRUM_DEFAULT_SILENCE_THRESHOLD 0.0001f //-80 dB
+#define DRUM_DEFAULT_SILENCE_MS 20.0f
+#define DRUM_DEFAULT_CHOKE_MS 8.0f
+
+static uint32_t msToFrames(float ms, float sampleRate)
+{
+	float frames = ms * 0.001f * sampleRate;
+	return (frames < 1.0f) ? 1 : (uint32_t)frames;
+}
+
+void drumVoicesInit(DrumVoices* dv, float sampleRate)
+{
+	dv->numInstruments = 0;
+	dv->numVoices = 0;
+	dv->time = 0;
+	dv->numActive = 0;
+	dv->maxActive = 0;
+	dv->numSteals = 0;
+	dv->numChokes = 0;
+	drumVoicesSetSilence(dv, DRUM_DEFAULT_SILENCE_THRESHOLD, DRUM_DEFAULT_SILENCE_MS, sampleRate);
+	drumVoicesSetChokeTime(dv, DRUM_DEFAULT_CHOKE_MS, sampleRate);
+}
+
+int drumVoicesAddInstrument(DrumVoices* dv, DrumVoiceType type, int numVoices, DrumStealMode stealMode, int chokeGroup, tMempool* pool)
+{
+	if ((dv->numInstruments >= DRUM_MAX_INSTRUMENTS) || (numVoices < 1) || (dv->numVoices + numVoices > DRUM_MAX_VOICES))
+	{
+		return -1;
+	}
+
+	int instrument = dv->numInstruments++;
+	DrumInstrument* inst = &dv->instruments[instrument];
+	inst->type = type;
+	inst->stealMode = stealMode;
+	inst->firstVoice = (uint8_t)dv->numVoices;
+	inst->numVoices = (uint8_t)numVoices;
+	inst->chokeGroup = (uint8_t)chokeGroup;
+	inst->gain = 1.0f;
+
+	for (int i = 0; i < numVoices; i++)
+	{
+		DrumVoice* v = &dv->voices[dv->numVoices++];
+		switch (type)
+		{
+			case DrumKick: t808Kick_initToPool(&v->synth.kick, pool); break;
+			case DrumSnare: t808Snare_initToPool(&v->synth.snare, pool); break;
+			case DrumHihat: t808Hihat_initToPool(&v->synth.hihat, pool); break;
+			case DrumCowbell: t808Cowbell_initToPool(&v->synth.cowbell, 0, pool); break;
+		}
+		v->active = 0;
+		v->choking = 0;
+		v->instrument = (uint8_t)instrument;
+		v->startTime = 0;
+		v->level = 0.0f;
+		v->silentFrames = 0;
+		v->gain = 1.0f;
+	}
+	return instrument;
+}
+
+void drumVoicesSetSilence(DrumVoices* dv, float threshold, float ms, float sampleRate)
+{
+	dv->silenceThreshold = threshold;
+	dv->silenceFrames = msToFrames(ms, sampleRate);
+}
+
+void drumVoicesSetChokeTime(DrumVoices* dv, float ms, float sampleRate)
+{
+	dv->chokeStep = 1.0f / (float)msToFrames(ms, sampleRate);
+}
+
+void drumVoicesSetGain(DrumVoices* dv, int instrument, float gain)
+{
+	if ((instrument >= 0) && (instrument < dv->numInstruments))
+	{
+		dv->instruments[instrument].gain = gain;
+	}
+}
+
+DrumVoice* drumVoicesGetVoice(DrumVoices* dv, int instrument, int voice)
+{
+	DrumInstrument* inst = &dv->instruments[instrument];
+	return &dv->voices[inst->firstVoice + voice];
+}
+
+static void chokeInstrument(DrumVoices* dv, DrumInstrument* inst)
+{
+	for (int i = 0; i < inst->numVoices; i++)
+	{
+		DrumVoice* v = &dv->voices[inst->firstVoice + i];
+		if (v->active && !v->choking)
+		{
+			v->choking = 1;
+			dv->numChokes++;
+		}
+	}
+}
+
+void drumVoicesChoke(DrumVoices* dv, int instrument)
+{
+	if ((instrument >= 0) && (instrument < dv->numInstruments))
+	{
+		chokeInstrument(dv, &dv->instruments[instrument]);
+	}
+}
+
+static DrumVoice* allocateVoice(DrumVoices* dv, DrumInstrument* inst)
+{
+	DrumVoice* voices = &dv->voices[inst->firstVoice];
+	DrumVoice* choking = NULL;
+	DrumVoice* steal = NULL;
+
+	for (int i = 0; i < inst->numVoices; i++)
+	{
+		DrumVoice* v = &voices[i];
+		if (!v->active)
+		{
+			return v;
+		}
+		if (v->choking)
+		{
+			if ((choking == NULL) || (v->gain < choking->gain)) choking = v;
+		}
+		else if (steal == NULL)
+		{
+			steal = v;
+		}
+		else if (inst->stealMode == DrumStealQuietest)
+		{
+			if (v->level < steal->level) steal = v;
+		}
+		else if ((int32_t)(v->startTime - steal->startTime) < 0)
+		{
+			steal = v;
+		}
+	}
+
+	if (choking != NULL)
+	{
+		return choking;
+	}
+	dv->numSteals++;
+	return steal;
+}
+
+void drumVoicesTrigger(DrumVoices* dv, int instrument, float velocity)
+{
+	if ((instrument < 0) || (instrument >= dv->numInstruments))
+	{
+		return;
+	}
+	DrumInstrument* inst = &dv->instruments[instrument];
+
+	if (inst->chokeGroup != 0)
+	{
+		for (int i = 0; i < dv->numInstruments; i++)
+		{
+			if ((i != instrument) && (dv->instruments[i].chokeGroup == inst->chokeGroup))
+			{
+				chokeInstrument(dv, &dv->instruments[i]);
+			}
+		}
+	}
+
+	DrumVoice* v = allocateVoice(dv, inst);
+	switch (inst->type)
+	{
+		case DrumKick: t808Kick_on(&v->synth.kick, velocity); break;
+		case DrumSnare: t808Snare_on(&v->synth.snare, velocity); break;
+		case DrumHihat: t808Hihat_on(&v->synth.hihat, velocity); break;
+		case DrumCowbell: t808Cowbell_on(&v->synth.cowbell, velocity); break;
+	}
+	if (!v->active)
+	{
+		dv->numActive++;
+		if (dv->numActive > dv->maxActive) dv->maxActive = dv->numActive;
+	}
+	v->active = 1;
+	v->choking = 0;
+	v->gain = 1.0f;
+	v->startTime = dv->time;
+	v->level = velocity;
+	v->silentFrames = 0;
+}
+
+//the type switch is outside the loop so each voice runs one instrument's tick back to back
+static void renderVoice(DrumInstrument* inst, DrumVoice* v, float* buffer, int numFrames)
+{
+	switch (inst->type)
+	{
+		case DrumKick:
+			for (int i = 0; i < numFrames; i++) buffer[i] = t808Kick_tick(&v->synth.kick);
+			break;
+		case DrumSnare:
+			for (int i = 0; i < numFrames; i++) buffer[i] = t808Snare_tick(&v->synth.snare);
+			break;
+		case DrumHihat:
+			for (int i = 0; i < numFrames; i++) buffer[i] = t808Hihat_tick(&v->synth.hihat);
+			break;
+		case DrumCowbell:
+			for (int i = 0; i < numFrames; i++) buffer[i] = t808Cowbell_tick(&v->synth.cowbell);
+			break;
+	}
+}
+
+static int voiceIsAwake(DrumInstrument* inst, DrumVoice* v)
+{
+	switch (inst->type)
+	{
+		case DrumKick: return t808Kick_isActive(&v->synth.kick);
+		case DrumSnare: return t808Snare_isActive(&v->synth.snare);
+		case DrumHihat: return t808Hihat_isActive(&v->synth.hihat);
+		case DrumCowbell: return t808Cowbell_isActive(&v->synth.cowbell);
+	}
+	return 0;
+}
+
+static void deactivate(DrumVoices* dv, DrumVoice* v)
+{
+	v->active = 0;
+	v->choking = 0;
+	v->level = 0.0f;
+	dv->numActive--;
+}
+
+void drumVoicesProcess(DrumVoices* dv, float* out, int numFrames)
+{
+	float buffer[DRUM_BLOCK_SIZE];
+
+	for (int i = 0; i < numFrames; i++)
+	{
+		out[i] = 0.0f;
+	}
+
+	for (int start = 0; start < numFrames; start += DRUM_BLOCK_SIZE)
+	{
+		int n = numFrames - start;
+		if (n > DRUM_BLOCK_SIZE) n = DRUM_BLOCK_SIZE;
+		float* mix = out + start;
+
+		for (int k = 0; k < dv->numVoices; k++)
+		{
+			DrumVoice* v = &dv->voices[k];
+			if (!v->active)
+			{
+				continue;
+			}
+			DrumInstrument* inst = &dv->instruments[v->instrument];
+			renderVoice(inst, v, buffer, n);
+
+			float peak = 0.0f;
+			if (v->choking)
+			{
+				float gain = v->gain;
+				for (int i = 0; i < n; i++)
+				{
+					gain -= dv->chokeStep;
+					if (gain < 0.0f) gain = 0.0f;
+					float x = buffer[i] * gain;
+					float a = fabsf(x);
+					if (a > peak) peak = a;
+					mix[i] += x * inst->gain;
+				}
+				v->gain = gain;
+			}
+			else
+			{
+				for (int i = 0; i < n; i++)
+				{
+					float a = fabsf(buffer[i]);
+					if (a > peak) peak = a;
+					mix[i] += buffer[i] * inst->gain;
+				}
+			}
+			v->level = peak;
+
+			if (peak < dv->silenceThreshold)
+			{
+				v->silentFrames += n;
+			}
+			else
+			{
+				v->silentFrames = 0;
+			}
+			if ((v->choking && (v->gain <= 0.0f)) || (v->silentFrames >= dv->silenceFrames) || !voiceIsAwake(inst, v))
+			{
+				deactivate(dv, v);
+			}
+		}
+		dv->time += n;
+	}
+}
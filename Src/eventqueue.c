@@ -0,0 +1,68 @@
+/*
+ * eventqueue.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "eventqueue.h"
+
+//Same scheme as the ring buffer: the producer owns writeIndex, the consumer owns readIndex, and each
+//publishes its index with release ordering after it's done with the slot.
+
+void eventQueueInit(EventQueue* q)
+{
+	atomic_store_explicit(&q->writeIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&q->readIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&q->dropped, 0, memory_order_relaxed);
+}
+
+int eventQueuePush(EventQueue* q, const Event* event)
+{
+	uint32_t write = atomic_load_explicit(&q->writeIndex, memory_order_relaxed);
+	uint32_t read = atomic_load_explicit(&q->readIndex, memory_order_acquire);
+	if ((write - read) >= EVENT_QUEUE_SIZE)
+	{
+		atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+		return 0;
+	}
+	q->events[write & (EVENT_QUEUE_SIZE - 1)] = *event;
+	atomic_store_explicit(&q->writeIndex, write + 1, memory_order_release);
+	return 1;
+}
+
+int eventQueueSend(EventQueue* q, EventType type, uint8_t id, uint8_t channel, uint32_t time, float value, void* data)
+{
+	Event event;
+	event.type = (uint8_t)type;
+	event.id = id;
+	event.channel = channel;
+	event.time = time;
+	event.value = value;
+	event.data = data;
+	return eventQueuePush(q, &event);
+}
+
+int eventQueuePop(EventQueue* q, Event* event)
+{
+	uint32_t write = atomic_load_explicit(&q->writeIndex, memory_order_acquire);
+	uint32_t read = atomic_load_explicit(&q->readIndex, memory_order_relaxed);
+	if (write == read)
+	{
+		return 0;
+	}
+	*event = q->events[read & (EVENT_QUEUE_SIZE - 1)];
+	atomic_store_explicit(&q->readIndex, read + 1, memory_order_release);
+	return 1;
+}
+
+uint32_t eventQueueAvailable(EventQueue* q)
+{
+	uint32_t write = atomic_load_explicit(&q->writeIndex, memory_order_acquire);
+	uint32_t read = atomic_load_explicit(&q->readIndex, memory_order_relaxed);
+	return write - read;
+}
+
+uint32_t eventQueueGetDropped(EventQueue* q)
+{
+	return atomic_load_explicit(&q->dropped, memory_order_relaxed);
+}
@@ -39,6 +39,7 @@
 #include "ui.h"
 #include "leaf.h"
 #include "audiostream.h"
+#include "sdqueue.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -138,9 +139,7 @@ int main(void)
   CycleCounterInit();
   HAL_GPIO_WritePin(GPIOC, GPIO_PIN_14, GPIO_PIN_RESET);
 
-  uint32_t tempFPURegisterVal = __get_FPSCR();
-  tempFPURegisterVal |= (1<<24); // set the FTZ (flush-to-zero) bit in the FPU control register
-  __set_FPSCR(tempFPURegisterVal);
+  //flush-to-zero is set by LEAF_init in audioInit, for the audio interrupts as well as here
 
   if (HAL_ADC_Start_DMA(&hadc1,(uint32_t*)&ADC_values, NUM_ADC_CHANNELS) != HAL_OK)
 	{
@@ -151,6 +150,10 @@ int main(void)
   SDRAM_Initialization_sequence();
   HAL_Delay(100);
 
+  //streaming reads go through sdQueue without waiting on the card, FatFs keeps its blocking driver and
+  //pauses the queue around each command. Without a card the queue just fails every request.
+  sdQueueInit();
+
 
 
   audioInit(&hi2c2, &hsai_BlockA1, &hsai_BlockB1);
@@ -164,6 +167,9 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
+	  //buttons, LEDs and anything else the audio interrupt hands off
+	  uiTick();
+
 	  /*
 	  int buttonRead = !HAL_GPIO_ReadPin(GPIOG, GPIO_PIN_7);
 	  if (buttonRead)
@@ -0,0 +1,99 @@
+/*
+ * profiler.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <stdio.h>
+#include "profiler.h"
+
+#if defined(USE_HAL_DRIVER)
+#include "system_stm32h7xx.h"
+#endif
+
+void profilerInit(Profiler* p, float sampleRate, int blockSize)
+{
+#if defined(USE_HAL_DRIVER)
+	//the DWT counts core clock cycles
+	p->ticksPerSecond = SystemCoreClock;
+#else
+	p->ticksPerSecond = 1000000000u;
+#endif
+	p->budgetTicks = (uint32_t)(((float)blockSize / sampleRate) * (float)p->ticksPerSecond);
+	p->numScopes = 1;
+	p->scopes[PROFILER_CALLBACK].name = "callback";
+	p->inCallback = 0;
+	profilerReset(p);
+}
+
+void profilerReset(Profiler* p)
+{
+	for (int i = 0; i < PROFILER_MAX_SCOPES; i++)
+	{
+		ProfilerScope* s = &p->scopes[i];
+		s->count = 0;
+		s->minTicks = UINT32_MAX;
+		s->maxTicks = 0;
+		s->totalTicks = 0;
+		s->overruns = 0;
+	}
+	p->reentries = 0;
+}
+
+int profilerAddScope(Profiler* p, const char* name)
+{
+	if (p->numScopes >= PROFILER_MAX_SCOPES)
+	{
+		return -1;
+	}
+	int id = p->numScopes++;
+	p->scopes[id].name = name;
+	return id;
+}
+
+void profilerScopeEnd(Profiler* p, int id, uint32_t ticks)
+{
+	ProfilerScope* s = &p->scopes[id];
+	s->count++;
+	s->totalTicks += ticks;
+	if (ticks < s->minTicks)
+	{
+		s->minTicks = ticks;
+	}
+	if (ticks > s->maxTicks)
+	{
+		s->maxTicks = ticks;
+	}
+	//the next half-buffer interrupt was already waiting by the time this one finished
+	if (ticks > p->budgetTicks)
+	{
+		s->overruns++;
+	}
+}
+
+void profilerGetReport(Profiler* p, int id, ProfilerReport* report)
+{
+	ProfilerScope* s = &p->scopes[id];
+	float toPercent = 100.0f / (float)p->budgetTicks;
+	report->name = s->name;
+	report->count = s->count;
+	report->minTicks = (s->count > 0) ? s->minTicks : 0;
+	report->maxTicks = s->maxTicks;
+	report->avgTicks = (s->count > 0) ? (float)((double)s->totalTicks / (double)s->count) : 0.0f;
+	report->minPercent = (float)report->minTicks * toPercent;
+	report->avgPercent = report->avgTicks * toPercent;
+	report->maxPercent = (float)report->maxTicks * toPercent;
+	report->overruns = s->overruns;
+}
+
+void profilerPrint(Profiler* p)
+{
+	printf("profiler: %u ticks per block, %u reentries\n", (unsigned)p->budgetTicks, (unsigned)p->reentries);
+	for (int i = 0; i < p->numScopes; i++)
+	{
+		ProfilerReport r;
+		profilerGetReport(p, i, &r);
+		printf("profiler: %-12s %8u runs, min %.2f%% avg %.2f%% max %.2f%% of the block, %u overruns\n",
+				r.name, (unsigned)r.count, r.minPercent, r.avgPercent, r.maxPercent, (unsigned)r.overruns);
+	}
+}
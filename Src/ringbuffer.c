@@ -0,0 +1,156 @@
+/*
+ * ringbuffer.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "ringbuffer.h"
+
+//The producer owns writeIndex and the consumer owns readIndex. Each side reads the other's index with
+//acquire ordering and publishes its own with release ordering, so the consumer never sees a frame before
+//its samples have been stored, and the producer never reuses a slot before the consumer has finished with it.
+//On the Cortex-M7 these compile to plain loads and stores with a DMB.
+
+void ringBufferInit(RingBuffer* rb, float* memory, uint32_t numChannels, uint32_t size)
+{
+	//the indices wrap with a mask, so a size that isn't a power of two is rounded down to one. Rounding up would run past memory.
+	while (size & (size - 1))
+	{
+		size &= size - 1;
+	}
+	rb->buffer = memory;
+	rb->size = size;
+	rb->mask = (size > 0) ? (size - 1) : 0;
+	rb->numChannels = numChannels;
+	ringBufferReset(rb);
+}
+
+//only safe while neither side is running
+void ringBufferReset(RingBuffer* rb)
+{
+	atomic_store_explicit(&rb->writeIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&rb->readIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&rb->overruns, 0, memory_order_relaxed);
+	atomic_store_explicit(&rb->underruns, 0, memory_order_relaxed);
+	for (uint32_t i = 0; i < rb->size * rb->numChannels; i++)
+	{
+		rb->buffer[i] = 0.0f;
+	}
+}
+
+uint32_t ringBufferSpace(RingBuffer* rb)
+{
+	uint32_t write = atomic_load_explicit(&rb->writeIndex, memory_order_relaxed);
+	uint32_t read = atomic_load_explicit(&rb->readIndex, memory_order_acquire);
+	return rb->size - (write - read);
+}
+
+//returns 1 if the frame was written, 0 if the ring was full and it was dropped
+int ringBufferWriteFrame(RingBuffer* rb, const float* frame)
+{
+	return (int)ringBufferWrite(rb, frame, 1);
+}
+
+//writes as many of the interleaved frames as fit, counts the rest as overruns, and returns the number written
+uint32_t ringBufferWrite(RingBuffer* rb, const float* interleaved, uint32_t numFrames)
+{
+	uint32_t write = atomic_load_explicit(&rb->writeIndex, memory_order_relaxed);
+	uint32_t read = atomic_load_explicit(&rb->readIndex, memory_order_acquire);
+	uint32_t space = rb->size - (write - read);
+
+	uint32_t toWrite = numFrames;
+	if (toWrite > space)
+	{
+		//drop the newest frames rather than overwriting ones the consumer might be reading
+		atomic_fetch_add_explicit(&rb->overruns, toWrite - space, memory_order_relaxed);
+		toWrite = space;
+	}
+
+	for (uint32_t i = 0; i < toWrite; i++)
+	{
+		uint32_t index = (write + i) & rb->mask;
+		for (uint32_t ch = 0; ch < rb->numChannels; ch++)
+		{
+			rb->buffer[(ch * rb->size) + index] = interleaved[(i * rb->numChannels) + ch];
+		}
+	}
+
+	atomic_store_explicit(&rb->writeIndex, write + toWrite, memory_order_release);
+	return toWrite;
+}
+
+uint32_t ringBufferAvailable(RingBuffer* rb)
+{
+	uint32_t write = atomic_load_explicit(&rb->writeIndex, memory_order_acquire);
+	uint32_t read = atomic_load_explicit(&rb->readIndex, memory_order_relaxed);
+	return write - read;
+}
+
+//reads up to numFrames frames into one array per channel. If fewer are available the rest of each
+//array is filled with zeros and the shortfall is counted as underruns. Returns the number of frames read.
+uint32_t ringBufferRead(RingBuffer* rb, float** channels, uint32_t numFrames)
+{
+	uint32_t write = atomic_load_explicit(&rb->writeIndex, memory_order_acquire);
+	uint32_t read = atomic_load_explicit(&rb->readIndex, memory_order_relaxed);
+	uint32_t available = write - read;
+
+	uint32_t toRead = numFrames;
+	if (toRead > available)
+	{
+		atomic_fetch_add_explicit(&rb->underruns, toRead - available, memory_order_relaxed);
+		toRead = available;
+	}
+
+	//copy in at most two runs, before and after the wrap
+	uint32_t start = read & rb->mask;
+	uint32_t first = rb->size - start;
+	if (first > toRead)
+	{
+		first = toRead;
+	}
+
+	for (uint32_t ch = 0; ch < rb->numChannels; ch++)
+	{
+		const float* src = &rb->buffer[ch * rb->size];
+		float* dest = channels[ch];
+		uint32_t i;
+		for (i = 0; i < first; i++)
+		{
+			dest[i] = src[start + i];
+		}
+		for (; i < toRead; i++)
+		{
+			dest[i] = src[i - first];
+		}
+		for (; i < numFrames; i++)
+		{
+			dest[i] = 0.0f;
+		}
+	}
+
+	atomic_store_explicit(&rb->readIndex, read + toRead, memory_order_release);
+	return toRead;
+}
+
+//drops up to numFrames of the oldest frames, for a consumer that has fallen behind. Returns the number dropped.
+uint32_t ringBufferSkip(RingBuffer* rb, uint32_t numFrames)
+{
+	uint32_t available = ringBufferAvailable(rb);
+	if (numFrames > available)
+	{
+		numFrames = available;
+	}
+	uint32_t read = atomic_load_explicit(&rb->readIndex, memory_order_relaxed);
+	atomic_store_explicit(&rb->readIndex, read + numFrames, memory_order_release);
+	return numFrames;
+}
+
+uint32_t ringBufferGetOverruns(RingBuffer* rb)
+{
+	return atomic_load_explicit(&rb->overruns, memory_order_relaxed);
+}
+
+uint32_t ringBufferGetUnderruns(RingBuffer* rb)
+{
+	return atomic_load_explicit(&rb->underruns, memory_order_relaxed);
+}
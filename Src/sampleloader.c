@@ -0,0 +1,136 @@
+/*
+ * sampleloader.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <string.h>
+#include "fatfs.h"
+#include "sampleloader.h"
+
+#define WAVE_FORMAT_PCM 1
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+static uint32_t readLE(const uint8_t* b, int bytes)
+{
+	uint32_t v = 0;
+	for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | b[i];
+	return v;
+}
+
+//walks the RIFF chunks for fmt and data, leaving the file anywhere
+static int parseWav(FIL* file, int* bytesPerSample, float* sampleRate, uint32_t* dataOffset, uint32_t* dataBytes)
+{
+	uint8_t header[24];
+	UINT got;
+	if ((f_read(file, header, 12, &got) != FR_OK) || (got != 12) || (memcmp(header, "RIFF", 4) != 0) || (memcmp(header + 8, "WAVE", 4) != 0))
+	{
+		return 0;
+	}
+
+	int haveFormat = 0;
+	uint32_t position = 12;
+	while (1)
+	{
+		if ((f_lseek(file, position) != FR_OK) || (f_read(file, header, 8, &got) != FR_OK) || (got != 8))
+		{
+			return 0;
+		}
+		uint32_t size = readLE(header + 4, 4);
+		if (memcmp(header, "fmt ", 4) == 0)
+		{
+			if ((size < 16) || (f_read(file, header, 16, &got) != FR_OK) || (got != 16))
+			{
+				return 0;
+			}
+			uint32_t format = readLE(header, 2);
+			uint32_t channels = readLE(header + 2, 2);
+			uint32_t bits = readLE(header + 14, 2);
+			if (((format != WAVE_FORMAT_PCM) && (format != WAVE_FORMAT_EXTENSIBLE)) || (channels != 1) || ((bits != 16) && (bits != 24)))
+			{
+				return 0;
+			}
+			*sampleRate = (float)readLE(header + 4, 4);
+			*bytesPerSample = (int)(bits / 8);
+			haveFormat = 1;
+		}
+		else if (memcmp(header, "data", 4) == 0)
+		{
+			*dataOffset = position + 8;
+			*dataBytes = size;
+			return haveFormat;
+		}
+		position += 8 + size + (size & 1);
+	}
+}
+
+int sampleLoadStream(StreamSample* s, const char* path, uint32_t attackFrames, float outputRate, tMempool* pool)
+{
+	FIL file;
+	if (f_open(&file, path, FA_READ) != FR_OK)
+	{
+		return 0;
+	}
+
+	int bytesPerSample;
+	float sampleRate;
+	uint32_t dataOffset, dataBytes;
+	if (!parseWav(&file, &bytesPerSample, &sampleRate, &dataOffset, &dataBytes))
+	{
+		f_close(&file);
+		return 0;
+	}
+	//a truncated file just streams what's there
+	if (dataOffset + dataBytes > f_size(&file)) dataBytes = f_size(&file) - dataOffset;
+
+	uint32_t attackBytes = streamSampleInit(s, dataOffset, dataBytes / bytesPerSample, bytesPerSample, sampleRate / outputRate, attackFrames);
+
+	//the file's clusters as (count, first cluster) runs, which FatFs's fast seek builds for us
+	DWORD linkMap[2 + (2 * STREAM_MAX_EXTENTS)];
+	linkMap[0] = sizeof(linkMap) / sizeof(DWORD);
+	file.cltbl = linkMap;
+	if (f_lseek(&file, CREATE_LINKMAP) != FR_OK)
+	{
+		f_close(&file);
+		return 0;
+	}
+	FATFS* fs = file.obj.fs;
+	uint32_t fileSector = 0;
+	for (DWORD* run = &linkMap[1]; run[0] != 0; run += 2)
+	{
+		uint32_t count = run[0] * fs->csize;
+		if (!streamSampleAddExtent(s, fileSector, fs->database + ((run[1] - 2) * fs->csize), count))
+		{
+			f_close(&file);
+			return 0;
+		}
+		fileSector += count;
+	}
+	file.cltbl = NULL;
+
+	//the attack is rounded up to a whole sector, which can run past the end of the file
+	uint32_t inFile = f_size(&file) - s->attackBase;
+	if (inFile > attackBytes) inFile = attackBytes;
+
+	s->attack = (uint8_t*)mpool_alloc(attackBytes, *pool);
+	UINT got;
+	if ((s->attack == NULL) || (f_lseek(&file, s->attackBase) != FR_OK) || (f_read(&file, s->attack, attackBytes, &got) != FR_OK) || (got < inFile))
+	{
+		if (s->attack != NULL) mpool_free((char*)s->attack, *pool);
+		s->attack = NULL;
+		f_close(&file);
+		return 0;
+	}
+	memset(s->attack + got, 0, attackBytes - got);
+	f_close(&file);
+	return 1;
+}
+
+void sampleFreeStream(StreamSample* s, tMempool* pool)
+{
+	if (s->attack != NULL)
+	{
+		mpool_free((char*)s->attack, *pool);
+		s->attack = NULL;
+	}
+}
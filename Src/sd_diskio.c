@@ -23,6 +23,15 @@
 
 /* USER CODE BEGIN firstSection */
 /* can be used to modify / undefine following code or add new definitions */
+/* sdQueue streams from the same card with DMA, so the generated driver below
+   is renamed and lastSection installs SD_Driver as wrappers that bracket every
+   command with sdQueuePause/sdQueueResume */
+#include "sdqueue.h"
+#define SD_initialize SD_initializeUnpaused
+#define SD_status SD_statusUnpaused
+#define SD_read SD_readUnpaused
+#define SD_write SD_writeUnpaused
+#define SD_Driver SD_DriverUnpaused
 /* USER CODE END firstSection*/
 
 /* Includes ------------------------------------------------------------------*/
@@ -255,6 +264,60 @@ DRESULT SD_ioctl(BYTE lun, BYTE cmd, void *buff)
 
 /* USER CODE BEGIN lastSection */ 
 /* can be used to modify / undefine previous code or add new code */
+#undef SD_initialize
+#undef SD_status
+#undef SD_read
+#undef SD_write
+#undef SD_Driver
+
+static DSTATUS SD_initialize(BYTE lun)
+{
+  sdQueuePause();
+  DSTATUS status = SD_initializeUnpaused(lun);
+  sdQueueResume();
+  return status;
+}
+
+static DSTATUS SD_status(BYTE lun)
+{
+  sdQueuePause();
+  DSTATUS status = SD_statusUnpaused(lun);
+  sdQueueResume();
+  return status;
+}
+
+static DRESULT SD_read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
+{
+  sdQueuePause();
+  DRESULT res = SD_readUnpaused(lun, buff, sector, count);
+  sdQueueResume();
+  return res;
+}
+
+#if _USE_WRITE == 1
+static DRESULT SD_write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
+{
+  sdQueuePause();
+  DRESULT res = SD_writeUnpaused(lun, buff, sector, count);
+  sdQueueResume();
+  return res;
+}
+#endif /* _USE_WRITE == 1 */
+
+/* SD_ioctl only reads the card info the BSP already has, so it needs no pause */
+const Diskio_drvTypeDef  SD_Driver =
+{
+  SD_initialize,
+  SD_status,
+  SD_read,
+#if  _USE_WRITE == 1
+  SD_write,
+#endif /* _USE_WRITE == 1 */
+
+#if  _USE_IOCTL == 1
+  SD_ioctl,
+#endif /* _USE_IOCTL == 1 */
+};
 /* USER CODE END lastSection */
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
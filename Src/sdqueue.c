@@ -0,0 +1,123 @@
+/*
+ * sdqueue.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "main.h"
+#include "sdmmc.h"
+#include "bsp_driver_sd.h"
+#include "sdqueue.h"
+
+//The D-cache sits between the CPU and every buffer the DMA touches. Before a write the buffer is
+//cleaned, so the card gets what the CPU last wrote rather than stale RAM. Before a read it is
+//invalidated, so no dirty line can be evicted over the incoming data partway through, and once the
+//read is done it is invalidated again to drop anything speculatively reloaded while it ran. Sectors
+//are 512 bytes, so a 32 byte aligned buffer always covers whole cache lines and the maintenance
+//never touches a neighbour's data.
+
+#define SD_CACHE_LINE 32
+#define SD_READY_TIMEOUT 500 //ms, the longest a card may take to program a write is 250
+
+DiskQueue sdQueue;
+
+//the transfer in flight, for the invalidate once it lands
+static uint8_t* sdBuffer;
+static uint32_t sdBytes;
+
+//after a write or an error the card may still be programming and has to be asked (CMD13) before it
+//takes the next command. A read leaves it ready as soon as the data is in.
+static volatile int sdCheckCard = 0;
+//FatFs has the card
+static volatile int sdPaused = 0;
+
+//the card state is a polled command, so it's only ever asked from the main loop
+static int sdCardReady(void)
+{
+	if (!sdCheckCard)
+	{
+		return 1;
+	}
+	if ((__get_IPSR() != 0) || (BSP_SD_GetCardState() != MSD_OK))
+	{
+		return 0;
+	}
+	sdCheckCard = 0;
+	return 1;
+}
+
+static DiskStartResult sdStart(void* context, DiskOp op, uint8_t* buffer, uint32_t sector, uint32_t count)
+{
+	if (((uintptr_t)buffer & (SD_CACHE_LINE - 1)) != 0)
+	{
+		return DiskFailed;
+	}
+	//from the completion interrupt this leaves a busy card to the main loop's next poll
+	if (sdPaused || !sdCardReady())
+	{
+		return DiskBusy;
+	}
+
+	uint32_t bytes = count * DISK_SECTOR_SIZE;
+	sdBuffer = buffer;
+	sdBytes = bytes;
+	if (op == DiskWrite)
+	{
+		sdCheckCard = 1;
+		SCB_CleanDCache_by_Addr((uint32_t*)buffer, (int32_t)bytes);
+		return (BSP_SD_WriteBlocks_DMA((uint32_t*)buffer, sector, count) == MSD_OK) ? DiskStarted : DiskFailed;
+	}
+	SCB_InvalidateDCache_by_Addr((uint32_t*)buffer, (int32_t)bytes);
+	return (BSP_SD_ReadBlocks_DMA((uint32_t*)buffer, sector, count) == MSD_OK) ? DiskStarted : DiskFailed;
+}
+
+int sdQueueInit(void)
+{
+	DiskBackend backend;
+	backend.start = sdStart;
+	backend.context = NULL;
+	diskQueueInit(&sdQueue, &backend);
+
+	if (hsd1.State == HAL_SD_STATE_RESET)
+	{
+		return (BSP_SD_Init() == MSD_OK);
+	}
+	return 1;
+}
+
+void sdQueuePause(void)
+{
+	//nothing starts once this is set, the completion interrupt included
+	sdPaused = 1;
+	while (diskQueueInFlight(&sdQueue))
+	{
+	}
+	//a card that never comes back fails FatFs's command instead of hanging here
+	uint32_t start = HAL_GetTick();
+	while (!sdCardReady() && ((HAL_GetTick() - start) < SD_READY_TIMEOUT))
+	{
+	}
+}
+
+void sdQueueResume(void)
+{
+	sdPaused = 0;
+}
+
+//these replace the weak ones in bsp_driver_sd.c and run in the SDMMC1 interrupt
+void BSP_SD_ReadCpltCallback(void)
+{
+	SCB_InvalidateDCache_by_Addr((uint32_t*)sdBuffer, (int32_t)sdBytes);
+	diskQueueComplete(&sdQueue, 1);
+}
+
+void BSP_SD_WriteCpltCallback(void)
+{
+	diskQueueComplete(&sdQueue, 1);
+}
+
+void HAL_SD_ErrorCallback(SD_HandleTypeDef *hsd)
+{
+	sdCheckCard = 1;
+	diskQueueComplete(&sdQueue, 0);
+}
@@ -0,0 +1,392 @@
+/*
+ * streamsampler.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <stddef.h>
+#include "streamsampler.h"
+
+//A sample's bytes past streamStart are cut into chunks of STREAM_CHUNK_BYTES, and chunk c of the hit
+//a voice is playing lands in slot c % STREAM_RING_CHUNKS of its ring. The audio side publishes the
+//chunk it's reading (playChunk) at the start of every block and never reads past what the streamer
+//has published as ready, and the streamer never asks for a chunk whose slot is still at or ahead of
+//playChunk. A retrigger bumps the voice's generation. The streamer waits for whatever it still has in
+//flight for the old hit to land, then starts over for the new one, and tags ready with the generation
+//it belongs to so the audio side can't mistake one hit's chunks for another's. Until the first chunks
+//arrive the new hit plays from its attack, which is why that has to be long enough.
+
+#define STREAM_GENERATION(g) (((g) & 0xFF) << 24)
+#define STREAM_READY_MASK 0xFFFFFF
+
+uint32_t streamSampleInit(StreamSample* s, uint32_t dataOffset, uint32_t length, int bytesPerSample, float rate, uint32_t attackFrames)
+{
+	s->bytesPerSample = (uint8_t)bytesPerSample;
+	s->rate = rate;
+	s->length = length;
+	s->dataOffset = dataOffset;
+	s->fileBytes = dataOffset + (length * (uint32_t)bytesPerSample);
+	s->attack = NULL;
+	s->attackBase = dataOffset & ~(uint32_t)(DISK_SECTOR_SIZE - 1);
+
+	uint32_t attackEnd = dataOffset + (attackFrames * (uint32_t)bytesPerSample);
+	if (attackEnd > s->fileBytes) attackEnd = s->fileBytes;
+	s->streamStart = (attackEnd + DISK_SECTOR_SIZE - 1) & ~(uint32_t)(DISK_SECTOR_SIZE - 1);
+	s->numExtents = 0;
+	return s->streamStart - s->attackBase;
+}
+
+int streamSampleAddExtent(StreamSample* s, uint32_t fileSector, uint32_t diskSector, uint32_t count)
+{
+	if (s->numExtents > 0)
+	{
+		StreamExtent* last = &s->extents[s->numExtents - 1];
+		if ((last->fileSector + last->count == fileSector) && (last->diskSector + last->count == diskSector))
+		{
+			last->count += count;
+			return 1;
+		}
+	}
+	if (s->numExtents >= STREAM_MAX_EXTENTS)
+	{
+		return 0;
+	}
+	StreamExtent* e = &s->extents[s->numExtents++];
+	e->fileSector = fileSector;
+	e->diskSector = diskSector;
+	e->count = count;
+	return 1;
+}
+
+/**********************************************/
+//audio interrupt side
+
+void streamVoiceInit(StreamVoice* v, uint8_t* ring)
+{
+	atomic_store_explicit(&v->sample, NULL, memory_order_relaxed);
+	v->ring = ring;
+	v->active = 0;
+	v->index = 0;
+	v->frac = 0.0f;
+	v->rate = 1.0f;
+	v->gain = 1.0f;
+	v->underruns = 0;
+	atomic_store_explicit(&v->generation, 0, memory_order_relaxed);
+	atomic_store_explicit(&v->playChunk, 0, memory_order_relaxed);
+	atomic_store_explicit(&v->ready, 0, memory_order_relaxed);
+	v->streamGeneration = 0;
+	v->requested = 0;
+	v->numChunks = 0;
+	v->inFlight = 0;
+	v->failed = 0;
+}
+
+//hands the voice over to the streamer as a new hit, or as nothing to read if sample is NULL
+static void newGeneration(StreamVoice* v, const StreamSample* sample)
+{
+	atomic_store_explicit(&v->playChunk, 0, memory_order_relaxed);
+	atomic_store_explicit(&v->sample, sample, memory_order_relaxed);
+	atomic_fetch_add_explicit(&v->generation, 1, memory_order_release);
+}
+
+void streamVoicePlay(StreamVoice* v, const StreamSample* sample, float rate, float gain)
+{
+	v->index = 0;
+	v->frac = 0.0f;
+	v->rate = rate * sample->rate;
+	v->gain = gain;
+	v->active = 1;
+	newGeneration(v, sample);
+}
+
+void streamVoiceStop(StreamVoice* v)
+{
+	if (v->active)
+	{
+		v->active = 0;
+		newGeneration(v, NULL);
+	}
+}
+
+static inline float decode(const uint8_t* b, int bytesPerSample)
+{
+	if (bytesPerSample == 2)
+	{
+		return (float)(int16_t)(b[0] | (b[1] << 8)) * (1.0f / 32768.0f);
+	}
+	int32_t x = (int32_t)(((uint32_t)b[0] << 8) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 24));
+	return (float)(x >> 8) * (1.0f / 8388608.0f);
+}
+
+static inline uint32_t chunkOf(const StreamSample* s, uint32_t position)
+{
+	return (position < s->streamStart) ? 0 : (position - s->streamStart) / STREAM_CHUNK_BYTES;
+}
+
+//one byte of the file, for a frame that straddles the end of the attack or a chunk boundary
+static uint8_t byteAt(StreamVoice* v, const StreamSample* s, uint32_t position, uint32_t readyChunks, int* missing)
+{
+	if (position < s->streamStart)
+	{
+		return s->attack[position - s->attackBase];
+	}
+	uint32_t offset = position - s->streamStart;
+	uint32_t chunk = offset / STREAM_CHUNK_BYTES;
+	if (chunk >= readyChunks)
+	{
+		*missing = 1;
+		return 0;
+	}
+	return v->ring[((chunk & (STREAM_RING_CHUNKS - 1)) * STREAM_CHUNK_BYTES) + (offset % STREAM_CHUNK_BYTES)];
+}
+
+static inline float frameAt(StreamVoice* v, const StreamSample* s, uint32_t frame, uint32_t readyChunks, int* missing)
+{
+	int bps = s->bytesPerSample;
+	uint32_t position = s->dataOffset + (frame * (uint32_t)bps);
+	if (position + bps <= s->streamStart)
+	{
+		return decode(&s->attack[position - s->attackBase], bps);
+	}
+	if (position >= s->streamStart)
+	{
+		uint32_t offset = position - s->streamStart;
+		uint32_t chunk = offset / STREAM_CHUNK_BYTES;
+		uint32_t inChunk = offset % STREAM_CHUNK_BYTES;
+		if (inChunk + bps <= STREAM_CHUNK_BYTES)
+		{
+			if (chunk >= readyChunks)
+			{
+				*missing = 1;
+				return 0.0f;
+			}
+			return decode(&v->ring[((chunk & (STREAM_RING_CHUNKS - 1)) * STREAM_CHUNK_BYTES) + inChunk], bps);
+		}
+	}
+	uint8_t b[3];
+	for (int i = 0; i < bps; i++)
+	{
+		b[i] = byteAt(v, s, position + i, readyChunks, missing);
+	}
+	return decode(b, bps);
+}
+
+void streamVoiceProcess(StreamVoice* v, float* out, int numFrames)
+{
+	int i = 0;
+	if (v->active)
+	{
+		const StreamSample* s = atomic_load_explicit(&v->sample, memory_order_relaxed);
+		uint32_t generation = atomic_load_explicit(&v->generation, memory_order_relaxed);
+		atomic_store_explicit(&v->playChunk, chunkOf(s, s->dataOffset + (v->index * s->bytesPerSample)), memory_order_release);
+		uint32_t ready = atomic_load_explicit(&v->ready, memory_order_acquire);
+		uint32_t readyChunks = ((ready & ~STREAM_READY_MASK) == STREAM_GENERATION(generation)) ? (ready & STREAM_READY_MASK) : 0;
+
+		uint32_t index = v->index;
+		float frac = v->frac;
+		for (; i < numFrames; i++)
+		{
+			if (index + 1 >= s->length)
+			{
+				v->active = 0;
+				newGeneration(v, NULL);
+				break;
+			}
+			int missing = 0;
+			float a = frameAt(v, s, index, readyChunks, &missing);
+			float b = frameAt(v, s, index + 1, readyChunks, &missing);
+			if (missing)
+			{
+				out[i] = 0.0f;
+				v->underruns++;
+			}
+			else
+			{
+				out[i] = v->gain * (a + (frac * (b - a)));
+			}
+			frac += v->rate;
+			uint32_t step = (uint32_t)frac;
+			index += step;
+			frac -= (float)step;
+		}
+		v->index = index;
+		v->frac = frac;
+	}
+	for (; i < numFrames; i++)
+	{
+		out[i] = 0.0f;
+	}
+}
+
+/**********************************************/
+//main loop side
+
+void streamerInit(Streamer* s, DiskQueue* queue)
+{
+	s->queue = queue;
+	s->numVoices = 0;
+	for (int i = 0; i < DISK_QUEUE_SIZE; i++)
+	{
+		s->freeReads[i] = &s->reads[i];
+	}
+	s->numFreeReads = DISK_QUEUE_SIZE;
+	s->chunksRead = 0;
+	s->readErrors = 0;
+}
+
+int streamerAddVoice(Streamer* s, StreamVoice* v)
+{
+	if (s->numVoices >= STREAM_MAX_VOICES)
+	{
+		return 0;
+	}
+	s->voices[s->numVoices++] = v;
+	return 1;
+}
+
+//the voice's next chunk as up to STREAM_CHUNK_SECTORS pieces, each one run of sectors on the card.
+//Returns the number of pieces, 0 if the sample's extents don't cover it
+static int chunkPieces(const StreamSample* sample, uint32_t chunk, StreamExtent* pieces)
+{
+	uint32_t fileSector = (sample->streamStart / DISK_SECTOR_SIZE) + (chunk * STREAM_CHUNK_SECTORS);
+	uint32_t endSector = (sample->fileBytes + DISK_SECTOR_SIZE - 1) / DISK_SECTOR_SIZE;
+	uint32_t count = endSector - fileSector;
+	if (count > STREAM_CHUNK_SECTORS) count = STREAM_CHUNK_SECTORS;
+
+	int numPieces = 0;
+	for (int e = 0; (e < sample->numExtents) && (count > 0); e++)
+	{
+		const StreamExtent* extent = &sample->extents[e];
+		if ((fileSector < extent->fileSector) || (fileSector >= extent->fileSector + extent->count))
+		{
+			continue;
+		}
+		uint32_t n = extent->fileSector + extent->count - fileSector;
+		if (n > count) n = count;
+		pieces[numPieces].fileSector = fileSector;
+		pieces[numPieces].diskSector = extent->diskSector + (fileSector - extent->fileSector);
+		pieces[numPieces].count = n;
+		numPieces++;
+		fileSector += n;
+		count -= n;
+	}
+	return (count == 0) ? numPieces : 0;
+}
+
+static void collect(Streamer* s)
+{
+	DiskRequest request;
+	while (diskPoll(s->queue, &request))
+	{
+		StreamRead* read = (StreamRead*)request.user;
+		StreamVoice* v = read->voice;
+		v->inFlight--;
+		//anything for a hit that's been replaced is dropped
+		if ((read->generation == v->streamGeneration) && !v->failed)
+		{
+			if (request.status != DiskDone)
+			{
+				v->failed = 1;
+				s->readErrors++;
+			}
+			else if (read->last)
+			{
+				atomic_store_explicit(&v->ready, STREAM_GENERATION(read->generation) | (read->chunk + 1), memory_order_release);
+				s->chunksRead++;
+			}
+		}
+		s->freeReads[s->numFreeReads++] = read;
+	}
+}
+
+//picks up retriggers. Returns the voice's sample if it has chunks left to read for its current hit
+static const StreamSample* voiceSample(StreamVoice* v)
+{
+	uint32_t generation = atomic_load_explicit(&v->generation, memory_order_acquire);
+	const StreamSample* sample = atomic_load_explicit(&v->sample, memory_order_relaxed);
+	if (generation != v->streamGeneration)
+	{
+		if (v->inFlight > 0)
+		{
+			return NULL; //the last hit's reads are still landing in the ring
+		}
+		v->streamGeneration = generation;
+		v->requested = 0;
+		v->failed = 0;
+		v->numChunks = 0;
+		if ((sample != NULL) && (sample->fileBytes > sample->streamStart))
+		{
+			v->numChunks = (sample->fileBytes - sample->streamStart + STREAM_CHUNK_BYTES - 1) / STREAM_CHUNK_BYTES;
+		}
+	}
+	if ((sample == NULL) || v->failed || (v->requested >= v->numChunks))
+	{
+		return NULL;
+	}
+	return sample;
+}
+
+void streamerTick(Streamer* s)
+{
+	collect(s);
+
+	while (1)
+	{
+		//whoever has the least read ahead of where it's playing goes first
+		StreamVoice* next = NULL;
+		const StreamSample* nextSample = NULL;
+		uint32_t nextAhead = STREAM_RING_CHUNKS;
+		for (int i = 0; i < s->numVoices; i++)
+		{
+			StreamVoice* v = s->voices[i];
+			const StreamSample* sample = voiceSample(v);
+			if (sample == NULL)
+			{
+				continue;
+			}
+			uint32_t play = atomic_load_explicit(&v->playChunk, memory_order_acquire);
+			if (v->requested < play)
+			{
+				v->requested = play; //it has already played past these, as silence
+			}
+			uint32_t ahead = v->requested - play;
+			if (ahead < nextAhead)
+			{
+				next = v;
+				nextSample = sample;
+				nextAhead = ahead;
+			}
+		}
+		if (next == NULL)
+		{
+			return;
+		}
+
+		StreamExtent pieces[STREAM_CHUNK_SECTORS];
+		int numPieces = chunkPieces(nextSample, next->requested, pieces);
+		if (numPieces == 0)
+		{
+			next->failed = 1;
+			s->readErrors++;
+			continue;
+		}
+		if ((numPieces > s->numFreeReads) || (diskQueuePending(s->queue) + numPieces > DISK_QUEUE_SIZE))
+		{
+			return; //the rest waits for the card to catch up
+		}
+
+		uint8_t* slot = next->ring + ((next->requested & (STREAM_RING_CHUNKS - 1)) * STREAM_CHUNK_BYTES);
+		for (int p = 0; p < numPieces; p++)
+		{
+			StreamRead* read = s->freeReads[--s->numFreeReads];
+			read->voice = next;
+			read->generation = next->streamGeneration;
+			read->chunk = next->requested;
+			read->last = (p == numPieces - 1);
+			next->inFlight++;
+			diskRead(s->queue, slot, pieces[p].diskSector, pieces[p].count, read);
+			slot += pieces[p].count * DISK_SECTOR_SIZE;
+		}
+		next->requested++;
+	}
+}
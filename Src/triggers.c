@@ -0,0 +1,236 @@
+/*
+ * triggers.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <math.h>
+#include "triggers.h"
+
+//Each channel waits for its rectified signal to cross the threshold, then scans for the peak for
+//scanFrames, then ignores the channel until maskFrames after the onset so the ringing tail of the
+//piezo can't retrigger it. After that the channel has to cross a threshold that starts at the last
+//peak and decays away, so the rest of the tail doesn't retrigger it either. Hitting one pad also
+//shakes the other two mics, so when a scan finishes the hit is dropped if another channel has a
+//much louder hit (finished or still scanning) that started within crosstalkFrames of it.
+
+#define TRIGGER_DEFAULT_THRESHOLD 0.1f
+#define TRIGGER_MAX_THRESHOLD 0.99f //velocity is scaled by 1 - threshold, so it has to stay below 1
+#define TRIGGER_DEFAULT_SCAN_MS 2.0f
+#define TRIGGER_DEFAULT_MASK_MS 40.0f
+#define TRIGGER_DEFAULT_RETRIGGER_DECAY_MS 50.0f
+#define TRIGGER_DEFAULT_CROSSTALK_RATIO 0.5f
+#define TRIGGER_DEFAULT_CROSSTALK_MS 10.0f
+
+static uint32_t msToFrames(float ms, float sampleRate)
+{
+	float frames = ms * 0.001f * sampleRate;
+	return (frames < 1.0f) ? 1 : (uint32_t)frames;
+}
+
+void triggerDetectorInit(TriggerDetector* td, int numChannels, float sampleRate)
+{
+	if (numChannels > TRIGGER_MAX_CHANNELS)
+	{
+		numChannels = TRIGGER_MAX_CHANNELS;
+	}
+	td->numChannels = numChannels;
+
+	for (int i = 0; i < TRIGGER_MAX_CHANNELS; i++)
+	{
+		TriggerChannel* c = &td->channels[i];
+		c->threshold = TRIGGER_DEFAULT_THRESHOLD;
+		c->retriggerThreshold = 0.0f;
+		c->state = TriggerIdle;
+		c->counter = 0;
+		c->peak = 0.0f;
+		c->onset = 0;
+		c->lastPeak = 0.0f;
+		c->lastOnset = 0;
+	}
+
+	triggerDetectorSetScanTime(td, TRIGGER_DEFAULT_SCAN_MS, sampleRate);
+	triggerDetectorSetMaskTime(td, TRIGGER_DEFAULT_MASK_MS, sampleRate);
+	triggerDetectorSetRetriggerDecay(td, TRIGGER_DEFAULT_RETRIGGER_DECAY_MS, sampleRate);
+	triggerDetectorSetCrosstalk(td, TRIGGER_DEFAULT_CROSSTALK_RATIO, TRIGGER_DEFAULT_CROSSTALK_MS, sampleRate);
+
+	td->time = 0;
+	td->numTriggers = 0;
+	td->numRejected = 0;
+	atomic_store_explicit(&td->writeIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&td->readIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&td->dropped, 0, memory_order_relaxed);
+}
+
+void triggerDetectorSetThreshold(TriggerDetector* td, int channel, float threshold)
+{
+	if (channel < 0 || channel >= td->numChannels)
+	{
+		return;
+	}
+	if (threshold < 0.0f)
+	{
+		threshold = 0.0f;
+	}
+	else if (threshold > TRIGGER_MAX_THRESHOLD)
+	{
+		threshold = TRIGGER_MAX_THRESHOLD;
+	}
+	td->channels[channel].threshold = threshold;
+}
+
+void triggerDetectorSetScanTime(TriggerDetector* td, float ms, float sampleRate)
+{
+	td->scanFrames = msToFrames(ms, sampleRate);
+}
+
+void triggerDetectorSetMaskTime(TriggerDetector* td, float ms, float sampleRate)
+{
+	td->maskFrames = msToFrames(ms, sampleRate);
+}
+
+void triggerDetectorSetRetriggerDecay(TriggerDetector* td, float ms, float sampleRate)
+{
+	td->retriggerDecay = expf(-1.0f / (float)msToFrames(ms, sampleRate));
+}
+
+void triggerDetectorSetCrosstalk(TriggerDetector* td, float ratio, float ms, float sampleRate)
+{
+	td->crosstalkRatio = ratio;
+	td->crosstalkFrames = msToFrames(ms, sampleRate);
+}
+
+static int triggerQueuePush(TriggerDetector* td, const TriggerEvent* event)
+{
+	uint32_t write = atomic_load_explicit(&td->writeIndex, memory_order_relaxed);
+	uint32_t read = atomic_load_explicit(&td->readIndex, memory_order_acquire);
+	if ((write - read) >= TRIGGER_QUEUE_SIZE)
+	{
+		atomic_fetch_add_explicit(&td->dropped, 1, memory_order_relaxed);
+		return 0;
+	}
+	td->events[write & (TRIGGER_QUEUE_SIZE - 1)] = *event;
+	atomic_store_explicit(&td->writeIndex, write + 1, memory_order_release);
+	return 1;
+}
+
+int triggerDetectorPopEvent(TriggerDetector* td, TriggerEvent* event)
+{
+	uint32_t write = atomic_load_explicit(&td->writeIndex, memory_order_acquire);
+	uint32_t read = atomic_load_explicit(&td->readIndex, memory_order_relaxed);
+	if (write == read)
+	{
+		return 0;
+	}
+	*event = td->events[read & (TRIGGER_QUEUE_SIZE - 1)];
+	atomic_store_explicit(&td->readIndex, read + 1, memory_order_release);
+	return 1;
+}
+
+static uint32_t framesApart(uint32_t a, uint32_t b)
+{
+	return (a > b) ? (a - b) : (b - a);
+}
+
+//a scan on channel ch just finished, decide whether it was a hit or crosstalk from another pad
+static int triggerIsCrosstalk(TriggerDetector* td, int ch)
+{
+	TriggerChannel* c = &td->channels[ch];
+	for (int o = 0; o < td->numChannels; o++)
+	{
+		if (o == ch)
+		{
+			continue;
+		}
+		TriggerChannel* other = &td->channels[o];
+		if ((other->state == TriggerScanning) && (framesApart(other->onset, c->onset) <= td->crosstalkFrames)
+				&& (c->peak < (td->crosstalkRatio * other->peak)))
+		{
+			return 1;
+		}
+		if ((other->lastPeak > 0.0f) && (framesApart(other->lastOnset, c->onset) <= td->crosstalkFrames)
+				&& (c->peak < (td->crosstalkRatio * other->lastPeak)))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int triggerDetectorProcess(TriggerDetector* td, float** channels, int numFrames)
+{
+	int numEvents = 0;
+
+	//frame by frame across the channels, so crosstalk decisions see the other channels at the same moment
+	for (int i = 0; i < numFrames; i++)
+	{
+		uint32_t now = td->time + (uint32_t)i;
+
+		for (int ch = 0; ch < td->numChannels; ch++)
+		{
+			TriggerChannel* c = &td->channels[ch];
+			float x = channels[ch][i];
+			if (x < 0.0f)
+			{
+				x = -x;
+			}
+
+			//only matters once the channel is idle again, but it has to keep decaying through the mask
+			c->retriggerThreshold *= td->retriggerDecay;
+
+			if (c->state == TriggerIdle)
+			{
+				if ((x >= c->threshold) && (x >= c->retriggerThreshold))
+				{
+					c->state = TriggerScanning;
+					c->onset = now;
+					c->peak = x;
+					c->counter = td->scanFrames;
+				}
+			}
+			else if (c->state == TriggerScanning)
+			{
+				if (x > c->peak)
+				{
+					c->peak = x;
+				}
+				if (--c->counter == 0)
+				{
+					if (triggerIsCrosstalk(td, ch))
+					{
+						td->numRejected++;
+					}
+					else
+					{
+						TriggerEvent event;
+						event.time = c->onset;
+						event.latency = (uint16_t)(now - c->onset);
+						event.channel = (uint8_t)ch;
+						event.peak = c->peak;
+						float velocity = (c->peak - c->threshold) / (1.0f - c->threshold);
+						event.velocity = (velocity > 1.0f) ? 1.0f : ((velocity < 0.0f) ? 0.0f : velocity);
+
+						c->lastPeak = c->peak;
+						c->lastOnset = c->onset;
+						td->numTriggers++;
+						numEvents += triggerQueuePush(td, &event);
+					}
+					//mask the tail either way, crosstalk rings too
+					c->retriggerThreshold = c->peak;
+					c->state = TriggerMasked;
+					c->counter = (td->maskFrames > td->scanFrames) ? (td->maskFrames - td->scanFrames) : 1;
+				}
+			}
+			else
+			{
+				if (--c->counter == 0)
+				{
+					c->state = TriggerIdle;
+				}
+			}
+		}
+	}
+
+	td->time += (uint32_t)numFrames;
+	return numEvents;
+}
@@ -6,7 +6,128 @@
  */
 #include "main.h"
 #include "ui.h"
+#include "audiostream.h"
 
+#define NUM_BUTTONS 3
+#define DEBOUNCE_MS 5
+#define TRIGGER_LED_MS 15 //how long a pad's LED stays lit after a hit
 
 
 uint16_t ADC_values[NUM_ADC_CHANNELS] __ATTR_RAM_D2;
+
+volatile uint8_t buttonValues[NUM_BUTTONS];
+volatile uint8_t buttonValuesPrev[NUM_BUTTONS];
+volatile uint32_t buttonChangeTimes[NUM_BUTTONS];
+volatile uint32_t buttonPressed[NUM_BUTTONS];
+volatile uint8_t LED_States[3] = {0,0,0};
+
+uint8_t triggerLEDOn[NUM_EXT_ADC_CHANNELS];
+uint32_t triggerLEDOffTimes[NUM_EXT_ADC_CHANNELS];
+
+//what the audio interrupt last reported, for watching in the debugger
+volatile float uiMeters[2 + NUM_EXT_ADC_CHANNELS];
+volatile uint32_t uiErrors[NUM_AUDIO_ERRORS];
+volatile float uiLastVelocity[NUM_EXT_ADC_CHANNELS];
+
+// leds: B15 C6 A8 light up for piezos 0 1 2
+static void setTriggerLED(int channel, GPIO_PinState state)
+{
+	if (channel == 0)
+	{
+		HAL_GPIO_WritePin(GPIOB, GPIO_PIN_15, state);
+	}
+	else if (channel == 1)
+	{
+		HAL_GPIO_WritePin(GPIOC, GPIO_PIN_6, state);
+	}
+	else if (channel == 2)
+	{
+		HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, state);
+	}
+}
+
+static void handleAudioEvents(uint32_t now)
+{
+	Event event;
+	while (eventQueuePop(&audioToMain, &event))
+	{
+		if ((event.type == EventTrigger) && (event.channel < NUM_EXT_ADC_CHANNELS))
+		{
+			uiLastVelocity[event.channel] = event.value;
+			triggerLEDOn[event.channel] = 1;
+			triggerLEDOffTimes[event.channel] = now + TRIGGER_LED_MS;
+			setTriggerLED(event.channel, GPIO_PIN_SET);
+		}
+		else if (event.type == EventMeter)
+		{
+			int meter = (event.id == MeterPiezo) ? (MeterPiezo + event.channel) : event.id;
+			if (meter < (2 + NUM_EXT_ADC_CHANNELS))
+			{
+				uiMeters[meter] = event.value;
+			}
+		}
+		else if ((event.type == EventError) && (event.id < NUM_AUDIO_ERRORS))
+		{
+			uiErrors[event.id] = (uint32_t)event.value;
+		}
+		else if (event.type == EventSampleRelease)
+		{
+			//the audio interrupt is done with it, so it can be freed here without the interrupt waiting on the allocator
+			tBuffer buffer = (tBuffer) event.data;
+			tBuffer_free(&buffer);
+		}
+	}
+
+	for (int i = 0; i < NUM_EXT_ADC_CHANNELS; i++)
+	{
+		if (triggerLEDOn[i] && ((int32_t)(now - triggerLEDOffTimes[i]) >= 0))
+		{
+			triggerLEDOn[i] = 0;
+			setTriggerLED(i, GPIO_PIN_RESET);
+		}
+	}
+}
+
+//a button has to read the same for DEBOUNCE_MS before a change counts
+static void buttonCheck(uint32_t now)
+{
+	buttonValues[0] = !HAL_GPIO_ReadPin(GPIOG, GPIO_PIN_6);
+	buttonValues[1] = !HAL_GPIO_ReadPin(GPIOG, GPIO_PIN_7);
+	//buttonValues[2] = !HAL_GPIO_ReadPin(GPIOD, GPIO_PIN_11);
+	for (int i = 0; i < NUM_BUTTONS; i++)
+	{
+	  if (buttonValues[i] == buttonValuesPrev[i])
+	  {
+		  buttonChangeTimes[i] = now;
+	  }
+	  else if ((now - buttonChangeTimes[i]) >= DEBOUNCE_MS)
+	  {
+		  if (buttonValues[i] == 1)
+		  {
+			  buttonPressed[i] = 1;
+		  }
+		  buttonValuesPrev[i] = buttonValues[i];
+		  buttonChangeTimes[i] = now;
+	  }
+	}
+
+	for (int i = 0; i < NUM_BUTTONS; i++)
+	{
+		if (buttonPressed[i] == 1)
+		{
+			LED_States[i] = !LED_States[i];
+			buttonPressed[i] = 0;
+		}
+	}
+}
+
+//everything the audio interrupt used to do that doesn't have to be sample accurate, called over and over from main's while(1)
+void uiTick(void)
+{
+	uint32_t now = HAL_GetTick();
+	handleAudioEvents(now);
+	buttonCheck(now);
+#ifdef AUDIO_STREAMS
+	audioStreamTick();
+#endif
+}
@@ -20,6 +20,7 @@ extern "C" {
 #include "leaf-math.h"
 #include "leaf-filters.h"
 #include "leaf-envelopes.h"
+#include "leaf-fft.h"
     
     /*!
      * @internal
@@ -197,6 +198,7 @@ extern "C" {
     {
         tMempool mempool;
         
+        tFFT fft;
         float* inputbuf;
         float* processbuf;
         float* spectrumbuf;
@@ -288,6 +290,42 @@ extern "C" {
     void    tPeriodDetection_setAlpha           (tPeriodDetection* const, float alpha);
     void    tPeriodDetection_setTolerance       (tPeriodDetection* const, float tolerance);
     
+    // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
+    
+    /* Numeric Guard. Checks the output of a recursive object (a filter, reverb or resonator)
+       once per block. A NaN or Inf means its state has blown up and won't come back by
+       itself, so the block is zeroed and the object's reset function, e.g. a wrapper around
+       its _clear, is called. Denormals are only counted: with flush to zero on they cost
+       nothing and decay away. The counts are for a debug screen or a host to watch. */
+    typedef struct _tNumericGuardStats
+    {
+        uint32_t blocks; // checked
+        uint32_t nanBlocks;
+        uint32_t infBlocks;
+        uint32_t denormalBlocks;
+        uint32_t resets;
+    } tNumericGuardStats;
+    
+    typedef struct _tNumericGuard
+    {
+        tMempool mempool;
+        void (*reset)(void* object);
+        void* object;
+        tNumericGuardStats stats;
+    } _tNumericGuard;
+    
+    typedef _tNumericGuard* tNumericGuard;
+    
+    // reset can be NULL to only mute and count
+    void    tNumericGuard_init                  (tNumericGuard* const, void (*reset)(void* object), void* object);
+    void    tNumericGuard_initToPool            (tNumericGuard* const, void (*reset)(void* object), void* object, tMempool* const);
+    void    tNumericGuard_free                  (tNumericGuard* const);
+    
+    // Returns the LEAF_NUMERIC_ flags found in buffer, zeroing it and resetting the object on NaN or Inf
+    int     tNumericGuard_check                 (tNumericGuard* const, float* buffer, int n);
+    void    tNumericGuard_getStats              (tNumericGuard* const, tNumericGuardStats* stats);
+    void    tNumericGuard_clearStats            (tNumericGuard* const);
+    
     //==============================================================================
     
 #ifdef __cplusplus
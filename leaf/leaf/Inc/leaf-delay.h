@@ -57,6 +57,7 @@ extern "C" {
     float       tDelay_tapOut       (tDelay* const, uint32_t tapDelay);
     float       tDelay_addTo        (tDelay* const, float value, uint32_t tapDelay);
     float       tDelay_tick         (tDelay* const, float sample);
+    void        tDelay_process      (tDelay* const, const float* input, float* output, int n);
     float       tDelay_getLastOut   (tDelay* const);
     float       tDelay_getLastIn    (tDelay* const);
     
@@ -84,6 +85,47 @@ extern "C" {
     
     typedef _tLinearDelay* tLinearDelay;
     
+    // One sample of tLinearDelay_tick and tLinearDelay_setDelay on the struct itself, so a block
+    // loop can run them on a local copy of the state
+    static inline float _tLinearDelay_tick(_tLinearDelay* d, float input)
+    {
+        d->buff[d->inPoint] = input * d->gain;
+        
+        // Increment input pointer modulo length.
+        if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+        
+        uint32_t idx = (uint32_t) d->outPoint;
+        // First 1/2 of interpolation
+        d->lastOut = d->buff[idx] * d->omAlpha;
+        // Second 1/2 of interpolation
+        if ((idx + 1) < d->maxDelay)
+            d->lastOut += d->buff[idx+1] * d->alpha;
+        else
+            d->lastOut += d->buff[0] * d->alpha;
+        
+        // Increment output pointer modulo length
+        if ( (++d->outPoint) >= d->maxDelay )   d->outPoint = 0;
+        
+        return d->lastOut;
+    }
+    
+    static inline void _tLinearDelay_setDelay(_tLinearDelay* d, float delay)
+    {
+        d->delay = LEAF_clip(0.0f, delay,  d->maxDelay);
+        
+        float outPointer = d->inPoint - d->delay;
+        
+        while ( outPointer < 0 )
+            outPointer += d->maxDelay; // modulo maximum length
+        
+        d->outPoint = (uint32_t) outPointer;   // integer part
+        
+        d->alpha = outPointer - d->outPoint; // fractional part
+        d->omAlpha = 1.0f - d->alpha;
+        
+        if ( d->outPoint == d->maxDelay ) d->outPoint = 0;
+    }
+    
     void    tLinearDelay_init        (tLinearDelay* const, float delay, uint32_t maxDelay);
     void    tLinearDelay_initToPool  (tLinearDelay* const, float delay, uint32_t maxDelay, tMempool* const);
     void    tLinearDelay_free        (tLinearDelay* const);
@@ -95,6 +137,7 @@ extern "C" {
     float 	tLinearDelay_tapOut 	 (tLinearDelay* const, uint32_t tapDelay);
     float   tLinearDelay_addTo       (tLinearDelay* const, float value, uint32_t tapDelay);
     float   tLinearDelay_tick        (tLinearDelay* const, float sample);
+    void    tLinearDelay_process     (tLinearDelay* const, const float* input, float* output, int n);
     void    tLinearDelay_tickIn      (tLinearDelay* const, float input);
     float   tLinearDelay_tickOut     (tLinearDelay* const);
     float   tLinearDelay_getLastOut  (tLinearDelay* const);
@@ -208,6 +251,51 @@ extern "C" {
     
     typedef _tTapeDelay* tTapeDelay;
     
+    // Hermite read at idx + alpha. idx is in [0, maxDelay), so the neighbours wrap with a compare.
+    static inline float _tTapeDelay_read(_tTapeDelay* d, int idx, float alpha)
+    {
+        int prev = idx - 1, next = idx + 1, next2 = idx + 2;
+        if (prev < 0) prev += (int)d->maxDelay;
+        if (next >= (int)d->maxDelay) next -= (int)d->maxDelay;
+        if (next2 >= (int)d->maxDelay) next2 -= (int)d->maxDelay;
+        return LEAF_interpolate_hermite_x(d->buff[prev], d->buff[idx], d->buff[next], d->buff[next2], alpha);
+    }
+    
+    // One sample of tTapeDelay_tick and tTapeDelay_tapOut on the struct itself, so a block
+    // loop can run them on a local copy of the state
+    static inline float _tTapeDelay_tick(_tTapeDelay* d, float input)
+    {
+        d->buff[d->inPoint] = input * d->gain;
+        
+        // Increment input pointer modulo length.
+        if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+        
+        int idx =  (int) d->idx;
+        d->lastOut = _tTapeDelay_read(d, idx, d->idx - idx);
+        
+        float diff = (d->inPoint - d->idx);
+        while (diff < 0.f) diff += d->maxDelay;
+        
+        d->inc = 1.0f + (diff - d->delay) / d->delay;
+        
+        d->idx += d->inc;
+        
+        if (d->idx >= d->maxDelay) d->idx = 0.0f;
+        
+        return d->lastOut;
+    }
+    
+    static inline float _tTapeDelay_tapOut(_tTapeDelay* d, float tapDelay)
+    {
+        float tap = (float) d->inPoint - tapDelay - 1.f;
+        
+        // Check for wraparound.
+        while ( tap < 0.f )   tap += (float)d->maxDelay;
+        
+        int idx =  (int) tap;
+        return _tTapeDelay_read(d, idx, tap - idx);
+    }
+    
     void    tTapeDelay_init        (tTapeDelay* const, float delay, uint32_t maxDelay);
     void    tTapeDelay_initToPool  (tTapeDelay* const, float delay, uint32_t maxDelay, tMempool* const);
     void    tTapeDelay_free        (tTapeDelay* const);
@@ -104,6 +104,10 @@ extern "C" {
         double tempsDenom;
         double tempErrDenom;
         double tempOutDenom;
+        
+        // Float path, with its own state
+        float fLogD, fB, fA, fHalfA, fLongthing, fVT;
+        float fLn1, fSign1, fXn1;
 
     } _tLockhartWavefolder;
     
@@ -113,7 +117,13 @@ extern "C" {
     void    tLockhartWavefolder_initToPool   (tLockhartWavefolder* const, tMempool* const);
     void    tLockhartWavefolder_free    (tLockhartWavefolder* const);
     
+    // Double precision reference, solving the Lambert W by iteration every sample
     float   tLockhartWavefolder_tick    (tLockhartWavefolder* const, float samp);
+    // Float only, with LEAF_wrightOmega in place of the iteration, for single precision FPUs.
+    // Within about 1e-4 of tick for inputs up to +-10, where tick overflows above about +-9.
+    float   tLockhartWavefolder_tickFast    (tLockhartWavefolder* const, float samp);
+    // tickFast over a block, input and output can be the same buffer
+    void    tLockhartWavefolder_process (tLockhartWavefolder* const, const float* input, float* output, int n);
 
     //==============================================================================
 
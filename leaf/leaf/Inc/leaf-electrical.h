@@ -92,6 +92,47 @@ extern "C" {
     float   tWDF_getVoltage             (tWDF* const);
     float   tWDF_getCurrent             (tWDF* const);
     
+    //==============================================================================
+    
+    /* Flattened WDF. Compiles a tWDF tree into one flat per-sample update, so the tree
+       is described once with tWDF_init but never walked at audio rate. Everything below
+       the root is linear, so the wave reaching the root, the new state of every capacitor
+       and inductor, and the output voltage are all fixed weighted sums of the old states,
+       the input and the root's reflected wave. Those weights are worked out at init by
+       running the tree's own scattering on one unit wave at a time, with the port
+       resistances already in them; a tick is then a handful of multiply-adds around the
+       root's nonlinearity. After changing component values with tWDF_setValue, call
+       tWDFFlat_update to recompile. The tree has to outlive the flat version. */
+    typedef struct _tWDFFlat
+    {
+        tMempool mempool;
+        tWDF* root;
+        tWDF* outputPoint;
+        WDFComponentType rootType;
+        float rootResistance;
+        int numStates; // capacitors and inductors in the tree
+        _tWDF** reactive; // the nodes holding the states, in tree order
+        float* state; // the incident wave stored in each of them
+        float* newState;
+        float* treeState; // the tree's own states, kept aside while compiling
+        // Weights over the old states, then the input, then (except up) the root's reflected wave
+        float* up; // wave reaching the root
+        float* out; // voltage at outputPoint
+        float* next; // numStates rows, the new states
+    } _tWDFFlat;
+    
+    typedef _tWDFFlat* tWDFFlat;
+    
+    void    tWDFFlat_init               (tWDFFlat* const, tWDF* const root, tWDF* const outputPoint);
+    void    tWDFFlat_initToPool         (tWDFFlat* const, tWDF* const root, tWDF* const outputPoint, tMempool* const);
+    void    tWDFFlat_free               (tWDFFlat* const);
+    
+    float   tWDFFlat_tick               (tWDFFlat* const, float input);
+    void    tWDFFlat_process            (tWDFFlat* const, const float* input, float* output, int n);
+    // Recompiles from the tree's current component values, keeping the state
+    void    tWDFFlat_update             (tWDFFlat* const);
+    void    tWDFFlat_clear              (tWDFFlat* const);
+    
     
     //==============================================================================
     
@@ -64,10 +64,13 @@ extern "C" {
     void    tEnvelope_free          (tEnvelope* const);
     
     float   tEnvelope_tick          (tEnvelope* const);
+    void    tEnvelope_process       (tEnvelope* const, float* out, int n);
     void    tEnvelope_setAttack     (tEnvelope* const, float attack);
     void    tEnvelope_setDecay      (tEnvelope* const, float decay);
     void    tEnvelope_loop          (tEnvelope* const, int loop);
     void    tEnvelope_on            (tEnvelope* const, float velocity);
+    // Nonzero until the decay has finished (always while looping), after which tick returns 0.
+    int     tEnvelope_isActive      (tEnvelope* const);
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -88,6 +91,7 @@ extern "C" {
     void    tExpSmooth_free         (tExpSmooth* const);
 
     float   tExpSmooth_tick         (tExpSmooth* const);
+    void    tExpSmooth_process      (tExpSmooth* const, float* out, int n);
     float   tExpSmooth_sample       (tExpSmooth* const);
     void    tExpSmooth_setFactor    (tExpSmooth* const, float factor);
     void    tExpSmooth_setDest      (tExpSmooth* const, float dest);
@@ -136,6 +140,8 @@ extern "C" {
         void    tADSR_setLeakFactor (tADSR* const, float leakFactor);
         void    tADSR_on            (tADSR* const, float velocity);
         void    tADSR_off           (tADSR* const);
+        // Nonzero from on until the release has finished.
+        int     tADSR_isActive      (tADSR* const);
 
 
     
@@ -182,6 +188,8 @@ extern "C" {
      void    tADSR2_setLeakFactor (tADSR2* const, float leakFactor);
      void    tADSR2_on            (tADSR2* const, float velocity);
      void    tADSR2_off           (tADSR2* const);
+     // Nonzero while the gate is on or the release is above leaf.silenceThreshold.
+     int     tADSR2_isActive      (tADSR2* const);
 
 
      // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
@@ -237,6 +245,7 @@ extern "C" {
      void    tADSR3_setLeakFactor (tADSR3* const, float leakFactor);
      void    tADSR3_on            (tADSR3* const, float velocity);
      void    tADSR3_off           (tADSR3* const);
+     int     tADSR3_isActive      (tADSR3* const);
 
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -278,6 +287,7 @@ extern "C" {
          void    tADSR4_setLeakFactor (tADSR4* const, float leakFactor);
          void    tADSR4_on            (tADSR4* const, float velocity);
          void    tADSR4_off           (tADSR4* const);
+         int     tADSR4_isActive      (tADSR4* const);
      // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
 
     /* Ramp */
@@ -300,6 +310,7 @@ extern "C" {
     void    tRamp_free          (tRamp* const);
     
     float   tRamp_tick          (tRamp* const);
+    void    tRamp_process       (tRamp* const, float* out, int n);
     float   tRamp_sample        (tRamp* const);
     void    tRamp_setTime       (tRamp* const, float time);
     void    tRamp_setDest       (tRamp* const, float dest);
@@ -365,6 +376,8 @@ extern "C" {
 
 	float   tSlide_tick         (tSlide* const, float in);
 
+	void    tSlide_process      (tSlide* const, const float* input, float* output, int n);
+
 #ifdef __cplusplus
 }
 #endif
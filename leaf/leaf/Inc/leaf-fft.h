@@ -0,0 +1,79 @@
+/*==============================================================================
+ 
+ leaf-fft.h
+ Created: 17 Oct 2026
+ 
+ ==============================================================================*/
+
+#ifndef LEAF_FFT_H_INCLUDED
+#define LEAF_FFT_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    
+    //==============================================================================
+    
+#include "leaf-global.h"
+#include "leaf-mempool.h"
+    
+    //==============================================================================
+    
+    typedef enum FFTType
+    {
+        FFTReal = 0, // size real samples in, size / 2 + 1 bins out
+        FFTComplex, // size complex samples, as separate real and imaginary arrays
+        FFTTypeNil
+    } FFTType;
+    
+    /* FFT plan. Twiddles and the bit reversal table are worked out once at init and kept in
+     the mempool, so a transform is just the butterflies. Power of two sizes only. Complex
+     transforms are radix-4 with a radix-2 pass when the size is an odd power of two, and use
+     SSE or NEON on targets that have them. Real transforms run a half size complex transform
+     and untangle the result.
+     
+     Real spectra are packed into size floats: [0] is DC, [1] is Nyquist, and bin k is at
+     [2k] (real) and [2k + 1] (imaginary). Neither direction is normalized, so inverse(forward(x))
+     is size * x. */
+    typedef struct _tFFT
+    {
+        tMempool mempool;
+        
+        FFTType type;
+        int size;
+        int complexSize; // points in the complex transform, size / 2 for a real plan
+        int log2Size; // of complexSize
+        
+        float* twiddles; // per radix-4 stage: W^2 real, W^2 imag, W real, W imag, each stage's quarter size long
+        int* bitReverse;
+        float* realTwiddles; // cos and sin of 2 pi k / size for k up to size / 4, real plans only
+        float* workReal; // complexSize scratch, real plans only
+        float* workImag;
+    } _tFFT;
+    
+    typedef _tFFT* tFFT;
+    
+    void    tFFT_init               (tFFT* const, int size, FFTType type);
+    void    tFFT_initToPool         (tFFT* const, int size, FFTType type, tMempool* const);
+    void    tFFT_free               (tFFT* const);
+    
+    // Real plans, input and output can be the same array
+    void    tFFT_forward            (tFFT* const, const float* input, float* output);
+    void    tFFT_inverse            (tFFT* const, const float* input, float* output);
+    
+    // Complex plans, in place
+    void    tFFT_forwardComplex     (tFFT* const, float* real, float* imag);
+    void    tFFT_inverseComplex     (tFFT* const, float* real, float* imag);
+    
+    int     tFFT_getSize            (tFFT* const);
+    
+    //==============================================================================
+    
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LEAF_FFT_H_INCLUDED
+
+//==============================================================================
+
@@ -19,6 +19,7 @@ extern "C" {
 #include "leaf-mempool.h"
 #include "leaf-delay.h"
 #include "leaf-tables.h"
+#include "leaf-fft.h"
     
     /*!
      * @internal
@@ -44,6 +45,19 @@ extern "C" {
     
     typedef _tAllpass* tAllpass;
     
+    // One sample of tAllpass_tick, with the allpass and its delay line passed separately so a
+    // block loop can run it on local copies of both
+    static inline float _tAllpass_tick(_tAllpass* f, _tLinearDelay* d, float input)
+    {
+        float s1 = (-f->gain) * f->lastOut + input;
+        
+        float s2 = _tLinearDelay_tick(d, s1) + (f->gain) * input;
+        
+        f->lastOut = s2;
+        
+        return f->lastOut;
+    }
+    
     void    tAllpass_init           (tAllpass* const, float initDelay, uint32_t maxDelay);
     void    tAllpass_initToPool     (tAllpass* const, float initDelay, uint32_t maxDelay, tMempool* const);
     void    tAllpass_free           (tAllpass* const);
@@ -67,11 +81,24 @@ extern "C" {
     
     typedef _tOnePole* tOnePole;
     
+    // One sample of tOnePole_tick on the struct itself
+    static inline float _tOnePole_tick(_tOnePole* f, float input)
+    {
+        float in = input * f->gain;
+        float out = (f->b0 * in) + (f->a1 * f->lastOut);
+        
+        f->lastIn = in;
+        f->lastOut = out;
+        
+        return out;
+    }
+    
     void    tOnePole_init           (tOnePole* const, float thePole);
     void    tOnePole_initToPool     (tOnePole* const, float thePole, tMempool* const);
     void    tOnePole_free           (tOnePole* const);
     
     float   tOnePole_tick           (tOnePole* const, float input);
+    void    tOnePole_process        (tOnePole* const, const float* input, float* output, int n);
     void    tOnePole_setB0          (tOnePole* const, float b0);
     void    tOnePole_setA1          (tOnePole* const, float a1);
     void    tOnePole_setPole        (tOnePole* const, float thePole);
@@ -103,6 +130,7 @@ extern "C" {
     void    tTwoPole_free           (tTwoPole* const);
     
     float   tTwoPole_tick           (tTwoPole* const, float input);
+    void    tTwoPole_process        (tTwoPole* const, const float* input, float* output, int n);
     void    tTwoPole_setB0          (tTwoPole* const, float b0);
     void    tTwoPole_setA1          (tTwoPole* const, float a1);
     void    tTwoPole_setA2          (tTwoPole* const, float a2);
@@ -218,6 +246,7 @@ extern "C" {
     void    tBiQuad_free           (tBiQuad* const);
     
     float   tBiQuad_tick           (tBiQuad* const, float input);
+    void    tBiQuad_process        (tBiQuad* const, const float* input, float* output, int n);
     void    tBiQuad_setB0          (tBiQuad* const, float b0);
     void    tBiQuad_setB1          (tBiQuad* const, float b1);
     void    tBiQuad_setB2          (tBiQuad* const, float b2);
@@ -258,9 +287,13 @@ extern "C" {
     void    tSVF_free           (tSVF* const);
     
     float   tSVF_tick           (tSVF* const, float v0);
+    void    tSVF_process        (tSVF* const, const float* input, float* output, int n);
     void    tSVF_setFreq        (tSVF* const, float freq);
     void    tSVF_setQ           (tSVF* const, float Q);
     void    tSVF_setFreqAndQ    (tSVF* const svff, float freq, float Q);
+    // Nonzero until the filter's state has decayed below leaf.silenceThreshold. With no input it then outputs silence.
+    int     tSVF_isActive       (tSVF* const);
+    void    tSVF_clear          (tSVF* const);
     //==============================================================================
     
     /* Efficient State Variable Filter for 14-bit control input, [0, 4096). */
@@ -295,13 +328,24 @@ extern "C" {
     
     typedef _tHighpass* tHighpass;
     
+    // One sample of tHighpass_tick on the struct itself
+    static inline float _tHighpass_tick(_tHighpass* f, float x)
+    {
+        f->ys = x - f->xs + f->R * f->ys;
+        f->xs = x;
+        return f->ys;
+    }
+    
     void    tHighpass_init          (tHighpass* const, float freq);
     void    tHighpass_initToPool    (tHighpass* const, float freq, tMempool* const);
     void    tHighpass_free          (tHighpass* const);
     
     float   tHighpass_tick          (tHighpass* const, float x);
+    void    tHighpass_process       (tHighpass* const, const float* input, float* output, int n);
     void    tHighpass_setFreq       (tHighpass* const, float freq);
     float   tHighpass_getFreq       (tHighpass* const);
+    // Nonzero until the filter's state has decayed below leaf.silenceThreshold.
+    int     tHighpass_isActive      (tHighpass* const);
     
     //==============================================================================
     
@@ -430,6 +474,8 @@ extern "C" {
 		void 	tVZFilter_setSampleRate  (tVZFilter* const, float sampleRate);
 		float   tVZFilter_tick           	(tVZFilter* const, float input);
 		float   tVZFilter_tickEfficient           	(tVZFilter* const vf, float in);
+		void    tVZFilter_process           	(tVZFilter* const, const float* input, float* output, int n);
+		void    tVZFilter_processEfficient     	(tVZFilter* const, const float* input, float* output, int n);
 		void   tVZFilter_calcCoeffs           (tVZFilter* const);
 		void   tVZFilter_setBandwidth        	(tVZFilter* const, float bandWidth);
 		void   tVZFilter_setFreq           (tVZFilter* const, float freq);
@@ -464,8 +510,84 @@ extern "C" {
 			void    tDiodeFilter_free           (tDiodeFilter* const);
 
 			float   tDiodeFilter_tick           	(tDiodeFilter* const, float input);
+			void    tDiodeFilter_process        	(tDiodeFilter* const, const float* input, float* output, int n);
 			void    tDiodeFilter_setFreq     (tDiodeFilter* const vf, float cutoff);
 			void    tDiodeFilter_setQ     (tDiodeFilter* const vf, float resonance);
+			// Back to the state it starts in, for recovering from a blow up
+			void    tDiodeFilter_clear    (tDiodeFilter* const vf);
+
+    //==============================================================================
+    
+    /* Cascade of second order sections, run a section at a time over a whole block.
+     Sections are normalized biquads (transposed direct form II) and can be copied from a
+     tBiQuad, or from the linear response of a tSVF or tVZFilter, so those objects can be
+     used as coefficient calculators for a multi-band EQ. Several channels can share one
+     set of coefficients, either planar one channel at a time or interleaved. */
+    typedef struct _tFilterCascade
+    {
+        tMempool mempool;
+        
+        int numSections;
+        int numChannels;
+        
+        float* coeffs; // b0, b1, b2, a1, a2 for each section
+        float* state; // z1, z2 for each section of each channel, [channel][section][2]
+    } _tFilterCascade;
+    
+    typedef _tFilterCascade* tFilterCascade;
+    
+    void    tFilterCascade_init                 (tFilterCascade* const, int numSections, int numChannels);
+    void    tFilterCascade_initToPool           (tFilterCascade* const, int numSections, int numChannels, tMempool* const);
+    void    tFilterCascade_free                 (tFilterCascade* const);
+    
+    float   tFilterCascade_tick                 (tFilterCascade* const, float input);
+    void    tFilterCascade_process              (tFilterCascade* const, int channel, const float* input, float* output, int n);
+    void    tFilterCascade_processInterleaved   (tFilterCascade* const, const float* input, float* output, int numFrames);
+    void    tFilterCascade_clear                (tFilterCascade* const);
+    void    tFilterCascade_setSection           (tFilterCascade* const, int section, float b0, float b1, float b2, float a1, float a2);
+    void    tFilterCascade_setSectionFromBiQuad (tFilterCascade* const, int section, tBiQuad* const);
+    void    tFilterCascade_setSectionFromSVF    (tFilterCascade* const, int section, tSVF* const);
+    void    tFilterCascade_setSectionFromVZFilter (tFilterCascade* const, int section, tVZFilter* const);
+    
+    //==============================================================================
+    
+    /* Uniformly partitioned FFT convolution (overlap-save). The impulse response is cut into
+     partitions of blockSize samples whose spectra are kept, along with the spectra of the last
+     few input blocks, so each block costs one FFT, one inverse FFT and a complex multiply-add per
+     partition no matter how the input lines up. Output is delayed by blockSize samples.
+     blockSize must be a power of two, usually the audio frame size. Everything including the IR
+     spectra comes out of the mempool passed in, so long IRs can live in a large external pool. */
+    typedef struct _tConvolver
+    {
+        tMempool mempool;
+        
+        int blockSize;
+        int fftSize; // 2 * blockSize
+        int maxPartitions; // enough for the IR length given at init
+        int numPartitions; // partitions in the current IR
+        
+        tFFT fft;
+        float* irSpectra; // fftSize packed real spectrum per partition, scaled by 1/fftSize
+        float* fdl; // spectra of the last maxPartitions input blocks
+        int fdlHead;
+        
+        float* inputBuffer; // last block then the block being filled
+        float* outputBuffer; // the block being played out
+        float* accum; // fftSize scratch
+        int pos; // position in the current block
+    } _tConvolver;
+    
+    typedef _tConvolver* tConvolver;
+    
+    void    tConvolver_init             (tConvolver* const, const float* ir, int irLength, int blockSize);
+    void    tConvolver_initToPool       (tConvolver* const, const float* ir, int irLength, int blockSize, tMempool* const);
+    void    tConvolver_free             (tConvolver* const);
+    
+    float   tConvolver_tick             (tConvolver* const, float input);
+    void    tConvolver_process          (tConvolver* const, const float* input, float* output, int n);
+    void    tConvolver_setIR            (tConvolver* const, const float* ir, int irLength); // irLength can't be more than at init
+    void    tConvolver_clear            (tConvolver* const);
+    int     tConvolver_getLatency       (tConvolver* const);
 
 
 #ifdef __cplusplus
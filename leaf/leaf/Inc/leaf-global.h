@@ -33,6 +33,7 @@ extern "C" {
         tMempool mempool; //!< The default LEAF mempool object.
         _tMempool _mempool;
         size_t header_size; //!< The size in bytes of memory region headers within mempools.
+        float   silenceThreshold; //!< Level below which objects with an _isActive() function count as silent and may stop processing. Defaults to 0.00001 (-100 dB).
         ///@}
     };
     typedef struct LEAF LEAF;
@@ -29,6 +29,11 @@ extern "C" {
      * An example.
      */
     
+    // The 808 voices go to sleep once their envelopes have finished and their output filters have
+    // decayed below leaf.silenceThreshold. A sleeping voice's tick returns 0 without computing
+    // anything until the next _on, and _isActive reports whether it is awake, so a voice manager
+    // can skip idle voices altogether.
+    
     //==============================================================================
     
     // 808 Cowbell
@@ -46,6 +51,7 @@ extern "C" {
         float oscMix;
         float filterCutoff;
         uint8_t useStick;
+        uint8_t active;
     } _t808Cowbell;
     
     typedef _t808Cowbell* t808Cowbell;
@@ -62,6 +68,7 @@ extern "C" {
     void    t808Cowbell_setFreq         (t808Cowbell* const, float freq);
     void    t808Cowbell_setOscMix       (t808Cowbell* const, float oscMix);
     void    t808Cowbell_setStick        (t808Cowbell* const, int useStick);
+    int     t808Cowbell_isActive        (t808Cowbell* const);
     
     //==============================================================================
     
@@ -84,6 +91,7 @@ extern "C" {
         float stretch;
         float FM_amount;
         float oscNoiseMix;
+        uint8_t active;
     } _t808Hihat;
     
     typedef _t808Hihat* t808Hihat;
@@ -104,6 +112,7 @@ extern "C" {
     void    t808Hihat_setOscFreq            (t808Hihat* const, float freq);
     void    t808Hihat_setStretch            (t808Hihat* const hihat, float stretch);
     void    t808Hihat_setFM                 (t808Hihat* const hihat, float FM_amount);
+    int     t808Hihat_isActive              (t808Hihat* const);
     
     //==============================================================================
     
@@ -130,6 +139,7 @@ extern "C" {
         float tone1Freq, tone2Freq;
         
         float noiseFilterFreq;
+        uint8_t active;
     } _t808Snare;
     
     typedef _t808Snare* t808Snare;
@@ -148,6 +158,7 @@ extern "C" {
     void    t808Snare_setToneNoiseMix       (t808Snare* const, float toneNoiseMix);
     void    t808Snare_setNoiseFilterFreq    (t808Snare* const, float noiseFilterFreq);
     void    t808Snare_setNoiseFilterQ       (t808Snare* const, float noiseFilterQ);
+    int     t808Snare_isActive              (t808Snare* const);
     
     //==============================================================================
     
@@ -172,6 +183,7 @@ extern "C" {
         float sighAmountInHz;
         float chirpRatioMinusOne;
         float noiseFilterFreq;
+        uint8_t active;
     } _t808Kick;
     
     typedef _t808Kick* t808Kick;
@@ -190,6 +202,7 @@ extern "C" {
     void    t808Kick_setToneNoiseMix    (t808Kick* const, float toneNoiseMix);
     void    t808Kick_setNoiseFilterFreq (t808Kick* const, float noiseFilterFreq);
     void    t808Kick_setNoiseFilterQ    (t808Kick* const, float noiseFilterQ);
+    int     t808Kick_isActive           (t808Kick* const);
     
     //==============================================================================
     
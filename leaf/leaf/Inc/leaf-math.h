@@ -154,6 +154,23 @@ extern "C" {
 
 
     float LEAF_tanh(float x);
+    
+    // Wright omega function, the solution w of w + ln(w) = x, so W(e^x) for the Lambert W.
+    // omega3 is a piecewise cubic first guess, omega4 adds one Newton step, and
+    // LEAF_wrightOmega adds a Fritsch step on top for close to full float accuracy.
+    // From D'Angelo, Gabrielli and Turchet, "Fast Approximation of the Lambert W Function
+    // for Virtual Analog Modelling", DAFx 2019.
+    float LEAF_wrightOmega3(float x);
+    float LEAF_wrightOmega4(float x);
+    float LEAF_wrightOmega(float x);
+    
+    // Flags for LEAF_checkNumerics
+#define LEAF_NUMERIC_NAN 1
+#define LEAF_NUMERIC_INF 2
+#define LEAF_NUMERIC_DENORMAL 4
+    // Which of NaN, Inf and denormal turn up in buffer, or 0 if none. Looks at the bits, so
+    // it still works when the compiler assumes finite math.
+    int LEAF_checkNumerics(const float* buffer, int n);
     void LEAF_generate_sine(float* buffer, int size);
     void LEAF_generate_sawtooth(float* buffer, float basefreq, int size);
     void LEAF_generate_triangle(float* buffer, float basefreq, int size);
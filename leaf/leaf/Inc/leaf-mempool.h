@@ -47,6 +47,7 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
     
     //==============================================================================
     
@@ -61,6 +62,18 @@ extern "C" {
      * @{
      */
     
+    /*!
+     * Allocation strategies for a tMempool.
+     */
+    enum MempoolType
+    {
+        MempoolFirstFit, //!< Single free list searched first-fit. Smallest overhead, but alloc and free slow down as the pool fragments.
+        MempoolSegregatedFit, //!< Two-level segregated fit (TLSF) free lists. Constant-time alloc and free, at the cost of a small index table at the start of the pool.
+        MempoolTypeNil,
+    };
+    
+    typedef enum MempoolType MempoolType;
+    
     // node of free list
     typedef struct mpool_node_t {
         char                *pool;     // memory pool field
@@ -69,13 +82,61 @@ extern "C" {
         size_t size;
     } mpool_node_t;
     
+    // Segregated fit settings. Free blocks are binned first by power of two and then into
+    // MPOOL_TLSF_SL_COUNT linear subdivisions of that range. Blocks smaller than
+    // MPOOL_TLSF_SMALL_BLOCK all go in the first row, spaced MPOOL_ALIGN_SIZE apart.
+#define MPOOL_TLSF_SL_LOG2 (4)
+#define MPOOL_TLSF_SL_COUNT (1 << MPOOL_TLSF_SL_LOG2)
+#define MPOOL_TLSF_FL_SHIFT (MPOOL_TLSF_SL_LOG2 + 3)
+#define MPOOL_TLSF_FL_MAX (30)
+#define MPOOL_TLSF_FL_COUNT (MPOOL_TLSF_FL_MAX - MPOOL_TLSF_FL_SHIFT + 1)
+#define MPOOL_TLSF_SMALL_BLOCK (1 << MPOOL_TLSF_FL_SHIFT)
+    
+    // header of a segregated fit block, same size as mpool_node_t so leaf.header_size holds for both
+    typedef struct mpool_tlsf_node_t {
+        struct mpool_tlsf_node_t *prev_phys;  // block directly before this one in memory
+        struct mpool_tlsf_node_t *next_free;  // next node in this size class, only valid while free
+        struct mpool_tlsf_node_t *prev_free;  // prev node in this size class, only valid while free
+        size_t size;                          // payload size, lowest bit set while the block is free
+    } mpool_tlsf_node_t;
+    
+    // index of the segregated free lists, stored at the start of the pool's memory
+    typedef struct mpool_tlsf_t {
+        uint32_t           fl_bitmap;                                        // bit set for each first level with a free block
+        uint32_t           sl_bitmap[MPOOL_TLSF_FL_COUNT];                   // bit set for each second level list with a free block
+        mpool_tlsf_node_t* blocks[MPOOL_TLSF_FL_COUNT][MPOOL_TLSF_SL_COUNT]; // heads of the free lists
+    } mpool_tlsf_t;
+    
     typedef struct _tMempool
     {
         char*         mpool;       // start of the mpool
         size_t        usize;       // used size of the pool
         size_t        msize;       // max size of the pool
         mpool_node_t* head;        // first node of memory pool free list
+        MempoolType   type;        // allocation strategy
+        mpool_tlsf_t* tlsf;        // segregated fit index, NULL for first fit pools
+        size_t        peak_usize;  // high-water mark of usize
+        uint32_t      num_blocks;  // number of live allocations
+        uint32_t      failed_allocs; // number of allocs that couldn't be satisfied
+        uint32_t      max_walk;    // most free list nodes visited by a single alloc or free
     } _tMempool;
+    
+    /*!
+     * A snapshot of a tMempool's usage, filled in by tMempool_getStats().
+     */
+    typedef struct tMempoolStats
+    {
+        size_t   size;          //!< Total size of the pool in bytes.
+        size_t   used;          //!< Bytes currently used, including block headers.
+        size_t   peakUsed;      //!< Most bytes ever used at once since init or the last tMempool_resetStats().
+        size_t   totalFree;     //!< Bytes available in free blocks, not counting their headers.
+        size_t   largestFree;   //!< Size of the largest free block, the biggest single allocation that can currently succeed.
+        uint32_t numBlocks;     //!< Number of live allocations.
+        uint32_t numFreeBlocks; //!< Number of free blocks.
+        uint32_t failedAllocs;  //!< Number of allocations that failed because no free block was big enough.
+        uint32_t maxWalk;       //!< Most free list nodes visited by a single alloc or free, the worst case cost seen so far.
+        float    fragmentation; //!< 1 - largestFree / totalFree. 0 when all free space is in one block.
+    } tMempoolStats;
 
     typedef _tMempool* tMempool;
     
@@ -112,6 +173,58 @@ extern "C" {
      */
     void    tMempool_freeFromPool   (tMempool* const pool, tMempool* const poolFrom);
     
+    
+    //! Initialize a tMempool with a given allocation strategy to the default LEAF mempool.
+    /*!
+     @param pool A pointer to the tMempool to be initialized.
+     @param memory A pointer to the chunk of memory to be used as a mempool.
+     @param size The size of the chunk of memory to be used as a mempool.
+     @param type The allocation strategy. MempoolSegregatedFit gives bounded alloc and free times regardless of fragmentation and is safe to use near the audio interrupt.
+     */
+    void    tMempool_initWithType   (tMempool* const pool, char* memory, size_t size, MempoolType type);
+    
+    
+    //! Initialize a tMempool with a given allocation strategy to a specified mempool.
+    /*!
+     @param pool A pointer to the tMempool to be initialized.
+     @param memory A pointer to the chunk of memory to be used as a mempool.
+     @param size The size of the chunk of memory to be used as a mempool.
+     @param type The allocation strategy.
+     @param poolTo A pointer to the tMempool to which a tMempool should be initialized.
+     */
+    void    tMempool_initWithTypeToPool (tMempool* const pool, char* memory, size_t size, MempoolType type, tMempool* const poolTo);
+    
+    
+    //! Get usage and fragmentation statistics for a tMempool. Walks the free lists, so don't call this from the audio interrupt.
+    /*!
+     @param pool A pointer to the tMempool to inspect. Use &leaf.mempool for the default LEAF mempool.
+     @param stats A pointer to the tMempoolStats to fill in.
+     */
+    void    tMempool_getStats       (tMempool* const pool, tMempoolStats* stats);
+    
+    
+    //! Reset the peak usage, failed alloc count and max walk length of a tMempool.
+    /*!
+     @param pool A pointer to the tMempool.
+     */
+    void    tMempool_resetStats     (tMempool* const pool);
+    
+    
+    //! Call a function for every block in a tMempool, allocated or free, in address order.
+    /*!
+     @param pool A pointer to the tMempool.
+     @param callback The function to call with the start of each block's memory, its size in bytes, whether it is free, and userData.
+     @param userData A pointer passed through to the callback.
+     */
+    void    tMempool_iterate        (tMempool* const pool, void (*callback)(char* block, size_t size, int isFree, void* userData), void* userData);
+    
+    
+    //! Print the statistics and block map of a tMempool with printf().
+    /*!
+     @param pool A pointer to the tMempool.
+     */
+    void    tMempool_dump           (tMempool* const pool);
+    
     /*! @} */
     
     //==============================================================================
@@ -124,6 +237,7 @@ extern "C" {
     //    } mpool_t;
     
     void mpool_create (char* memory, size_t size, _tMempool* pool);
+    void mpool_create_with_type (char* memory, size_t size, MempoolType type, _tMempool* pool);
     
     char* mpool_alloc(size_t size, _tMempool* pool);
     char* mpool_calloc(size_t asize, _tMempool* pool);
@@ -133,6 +247,11 @@ extern "C" {
     size_t mpool_get_size(_tMempool* pool);
     size_t mpool_get_used(_tMempool* pool);
     
+    void mpool_get_stats(_tMempool* pool, tMempoolStats* stats);
+    void mpool_reset_stats(_tMempool* pool);
+    void mpool_iterate(_tMempool* pool, void (*callback)(char* block, size_t size, int isFree, void* userData), void* userData);
+    void mpool_dump(_tMempool* pool);
+    
     void leaf_pool_init(char* memory, size_t size);
     
     char* leaf_alloc(size_t size);
@@ -27,16 +27,41 @@ extern "C" {
     
     //==============================================================================
     
+    // The table oscillators and tPhasor keep phase as a 32 bit fraction of a cycle.
+    // It wraps for free in either direction, so through-zero FM needs no bounds checks
+    // and the pitch never drifts however long a drone runs. The top bits index the
+    // table and the bits below them are the interpolation fraction.
+#define OSC_PHASE_SCALE     4294967296.0f // 2^32
+#define OSC_TABLE_SHIFT     21 // 32 - log2(2048), all the oscillator tables are 2048 long
+#define OSC_TABLE_FRAC_MASK ((1u << OSC_TABLE_SHIFT) - 1u)
+#define OSC_TABLE_FRAC      (1.0f / 2097152.0f) // 2^-21
+    
     typedef struct _tCycle
     {
         tMempool mempool;
-        // Underlying phasor
-        float phase;
-        float inc,freq;
+        // Underlying phasor, a 32 bit fraction of a cycle
+        uint32_t phase;
+        uint32_t inc;
+        float freq;
     } _tCycle;
     
     typedef _tCycle* tCycle;
     
+    // One sample of tCycle_tick on the struct itself
+    static inline float _tCycle_tick(_tCycle* c)
+    {
+        // Phasor increment, wraps on overflow
+        c->phase += c->inc;
+        
+        // Wavetable synthesis
+        uint32_t idx = c->phase >> OSC_TABLE_SHIFT;
+        float fracPart = (float)(int32_t)(c->phase & OSC_TABLE_FRAC_MASK) * OSC_TABLE_FRAC;
+        float samp0 = __leaf_table_sinewave[idx];
+        float samp1 = __leaf_table_sinewave[(idx + 1) & (SINE_TABLE_SIZE - 1)];
+        
+        return (samp0 + (samp1 - samp0) * fracPart);
+    }
+    
     /*!
      * @defgroup tcycle tCycle
      * @ingroup oscillators
@@ -74,6 +99,15 @@ extern "C" {
     float   tCycle_tick         (tCycle* const osc);
     
     
+    //! Tick a tCycle over a block of samples.
+    /*!
+     @param osc A pointer to the relevant tCycle.
+     @param out The buffer to write the block of output samples to, as floats from -1 to 1.
+     @param n The number of samples to compute.
+     */
+    void    tCycle_process      (tCycle* const osc, float* out, int n);
+    
+    
     //! Set the frequency of a tCycle oscillator.
     /*!
      @param osc A pointer to the relevant tCycle.
@@ -89,9 +123,10 @@ extern "C" {
     typedef struct _tTriangle
     {
         tMempool mempool;
-        // Underlying phasor
-        float phase;
-        float inc,freq;
+        // Underlying phasor, a 32 bit fraction of a cycle
+        uint32_t phase;
+        uint32_t inc;
+        float freq;
         int oct;
         float w;
     } _tTriangle;
@@ -135,6 +170,15 @@ extern "C" {
     float   tTriangle_tick          (tTriangle* const osc);
     
     
+    //! Tick a tTriangle over a block of samples.
+    /*!
+     @param osc A pointer to the relevant tTriangle.
+     @param out The buffer to write the block of output samples to, as floats from -1 to 1.
+     @param n The number of samples to compute.
+     */
+    void    tTriangle_process       (tTriangle* const osc, float* out, int n);
+    
+    
     //! Set the frequency of a tTriangle oscillator.
     /*!
      @param osc A pointer to the relevant tTriangle.
@@ -150,9 +194,10 @@ extern "C" {
     typedef struct _tSquare
     {
         tMempool mempool;
-        // Underlying phasor
-        float phase;
-        float inc,freq;
+        // Underlying phasor, a 32 bit fraction of a cycle
+        uint32_t phase;
+        uint32_t inc;
+        float freq;
         int oct;
         float w;
     } _tSquare;
@@ -194,6 +239,15 @@ extern "C" {
      @return The ticked sample as a float from -1 to 1.
      */
     float   tSquare_tick        (tSquare* const osc);
+    
+    
+    //! Tick a tSquare over a block of samples.
+    /*!
+     @param osc A pointer to the relevant tSquare.
+     @param out The buffer to write the block of output samples to, as floats from -1 to 1.
+     @param n The number of samples to compute.
+     */
+    void    tSquare_process     (tSquare* const osc, float* out, int n);
 
     
     //! Set the frequency of a tSquare oscillator.
@@ -211,9 +265,10 @@ extern "C" {
     typedef struct _tSawtooth
     {
         tMempool mempool;
-        // Underlying phasor
-        float phase;
-        float inc,freq;
+        // Underlying phasor, a 32 bit fraction of a cycle
+        uint32_t phase;
+        uint32_t inc;
+        float freq;
         int oct;
         float w;
     } _tSawtooth;
@@ -257,6 +312,15 @@ extern "C" {
     float   tSawtooth_tick          (tSawtooth* const osc);
     
     
+    //! Tick a tSawtooth over a block of samples.
+    /*!
+     @param osc A pointer to the relevant tSawtooth.
+     @param out The buffer to write the block of output samples to, as floats from -1 to 1.
+     @param n The number of samples to compute.
+     */
+    void    tSawtooth_process       (tSawtooth* const osc, float* out, int n);
+    
+    
     //! Set the frequency of a tSawtooth oscillator.
     /*!
      @param osc A pointer to the relevant tSawtooth.
@@ -273,8 +337,9 @@ extern "C" {
         tMempool mempool;
         float* sine;
         int size;
-        float phase;
-        float inc,freq;
+        uint32_t phase; // 32 bit fraction of a cycle
+        uint32_t inc;
+        float freq;
     } _tSine;
     
     typedef _tSine* tSine;
@@ -314,8 +379,17 @@ extern "C" {
      @return The ticked sample as a float from -1 to 1.
      */
     float   tSine_tick         (tSine* const osc);
-    
-    
+
+
+    //! Tick a tSine over a block of samples.
+    /*!
+     @param osc A pointer to the relevant tSine.
+     @param out The buffer to write the block of output samples to, as floats from -1 to 1.
+     @param n The number of samples to compute.
+     */
+    void    tSine_process      (tSine* const osc, float* out, int n);
+
+
     //! Set the frequency of a tSine oscillator.
     /*!
      @param osc A pointer to the relevant tSine.
@@ -512,8 +586,9 @@ extern "C" {
     typedef struct _tPhasor
     {
         tMempool mempool;
-        float phase;
-        float inc,freq;
+        uint32_t phase; // 32 bit fraction of a cycle
+        uint32_t inc;
+        float freq;
         uint8_t phaseDidReset;
     } _tPhasor;
     
@@ -556,6 +631,15 @@ extern "C" {
     float   tPhasor_tick        (tPhasor* const osc);
     
     
+    //! Tick a tPhasor over a block of samples.
+    /*!
+     @param osc A pointer to the relevant tPhasor.
+     @param out The buffer to write the block of output samples to, as floats from 0 to 1.
+     @param n The number of samples to compute.
+     */
+    void    tPhasor_process     (tPhasor* const osc, float* out, int n);
+    
+    
     //! Set the frequency of a tPhasor oscillator.
     /*!
      @param osc A pointer to the relevant tPhasor.
@@ -626,6 +710,15 @@ extern "C" {
      */
     float   tNoise_tick         (tNoise* const noise);
     
+    
+    //! Tick a tNoise over a block of samples.
+    /*!
+     @param noise A pointer to the relevant tNoise.
+     @param out The buffer to write the block of output samples to, as floats from -1 to 1.
+     @param n The number of samples to compute.
+     */
+    void    tNoise_process      (tNoise* const noise, float* out, int n);
+    
     /*! @} */
     
     //==============================================================================
@@ -877,7 +970,277 @@ extern "C" {
     void tMBSaw_syncIn(tMBSaw* const osc, float sync);
     float tMBSaw_syncOut(tMBSaw* const osc);
     
+    //==============================================================================
     
+    /*!
+     * @defgroup toscbank tOscBank
+     * @ingroup oscillators
+     * @brief A bank of table oscillators that are computed together, several voices at a time.
+     * @{
+     */
+    
+    /*!
+     * Oscillator bank waveforms
+     */
+    enum OscBankWaveform
+    {
+        OscBankSine, //!< Sine, linearly interpolated from __leaf_table_sinewave.
+        OscBankSawtooth, //!< Band-limited sawtooth, same tables as tSawtooth.
+        OscBankSquare, //!< Band-limited square, same tables as tSquare.
+        OscBankTriangle, //!< Band-limited triangle, same tables as tTriangle.
+        OscBankWaveformNil,
+    };
+    
+    typedef enum OscBankWaveform OscBankWaveform;
+    
+    // Voices are computed in groups of this many. On targets with NEON or SSE2 a group is one vector.
+#define OSCBANK_LANES 4
+    
+    typedef struct _tOscBank
+    {
+        tMempool mempool;
+        OscBankWaveform waveform;
+        int numVoices;
+        int numLanes; // numVoices rounded up to a multiple of OSCBANK_LANES, extra lanes are silent
+        const float* table; // first band-limited table, or the sine table
+        // Per voice state, one array per field
+        uint32_t* phase; // 32 bit fraction of a cycle
+        uint32_t* inc;
+        float* freq;
+        float* w;
+        int* offset; // start of the voice's lower band-limited table, relative to table
+        float* amp;
+        float* ampTarget;
+    } _tOscBank;
+    
+    typedef _tOscBank* tOscBank;
+    
+    //! Initialize a tOscBank to the default LEAF mempool.
+    /*!
+     @param bank A pointer to the tOscBank to be initialized.
+     @param numVoices The number of voices in the bank.
+     @param waveform The waveform of every voice in the bank.
+     */
+    void    tOscBank_init           (tOscBank* const bank, int numVoices, OscBankWaveform waveform);
+    
+    
+    //! Initialize a tOscBank to a specified mempool.
+    /*!
+     @param bank A pointer to the tOscBank to be initialized.
+     @param numVoices The number of voices in the bank.
+     @param waveform The waveform of every voice in the bank.
+     @param pool A pointer to the tMempool to which the tOscBank should be initialized.
+     */
+    void    tOscBank_initToPool     (tOscBank* const bank, int numVoices, OscBankWaveform waveform, tMempool* const pool);
+    
+    
+    //! Free a tOscBank from its mempool.
+    /*!
+     @param bank A pointer to the tOscBank to be freed.
+     */
+    void    tOscBank_free           (tOscBank* const bank);
+    
+    
+    //! Tick every voice of a tOscBank once and return the mix.
+    /*!
+     @param bank A pointer to the relevant tOscBank.
+     @return The sum of every voice scaled by its amplitude.
+     */
+    float   tOscBank_tick           (tOscBank* const bank);
+    
+    
+    //! Compute a block of the mix of every voice in a tOscBank. Amplitude changes are ramped linearly over the block.
+    /*!
+     @param bank A pointer to the relevant tOscBank.
+     @param out The buffer to write the block of mixed output samples to.
+     @param n The number of samples to compute.
+     */
+    void    tOscBank_process        (tOscBank* const bank, float* out, int n);
+    
+    
+    //! Set the frequency of one voice of a tOscBank.
+    /*!
+     @param bank A pointer to the relevant tOscBank.
+     @param voice The index of the voice, for example a tPoly voice number.
+     @param freq The frequency to set the voice to.
+     */
+    void    tOscBank_setFreq        (tOscBank* const bank, int voice, float freq);
+    
+    
+    //! Set the amplitude of one voice of a tOscBank. Voices start at an amplitude of 1.
+    /*!
+     @param bank A pointer to the relevant tOscBank.
+     @param voice The index of the voice.
+     @param amp The amplitude to ramp to over the next tick or block.
+     */
+    void    tOscBank_setAmplitude   (tOscBank* const bank, int voice, float amp);
+    
+    
+    //! Set the phase of one voice of a tOscBank.
+    /*!
+     @param bank A pointer to the relevant tOscBank.
+     @param voice The index of the voice.
+     @param phase The phase to set the voice to, from 0 to 1.
+     */
+    void    tOscBank_setPhase       (tOscBank* const bank, int voice, float phase);
+    
+    
+    //! Set the waveform of every voice in a tOscBank.
+    /*!
+     @param bank A pointer to the relevant tOscBank.
+     @param waveform The waveform to switch to.
+     */
+    void    tOscBank_setWaveform    (tOscBank* const bank, OscBankWaveform waveform);
+    
+    
+    //! Get the number of voices in a tOscBank.
+    /*!
+     @param bank A pointer to the relevant tOscBank.
+     @return The number of voices.
+     */
+    int     tOscBank_getNumVoices   (tOscBank* const bank);
+
+    /*! @} */
+
+    //==============================================================================
+
+    /*!
+     * @defgroup twavetable tWaveTable
+     * @ingroup oscillators
+     * @brief Band-limited oscillator for arbitrary single-cycle waveforms, with wavetable scanning.
+     * @{
+     */
+
+    /*!
+     Header of a wavetable file written by wtbuilder (wtbuilder/ in the Drumbox tree). It is followed by
+     numFrames * size little-endian int16 samples, one frame after another, where 32767 is 1.0.
+     */
+    typedef struct tWaveTableFileHeader
+    {
+        char magic[4]; //!< "LWT1"
+        uint32_t size; //!< Samples per frame, a power of two.
+        uint32_t numFrames; //!< Number of single-cycle frames.
+    } tWaveTableFileHeader;
+
+    /*
+     Each frame is filtered into numLevels octave-spaced mipmaps, all size samples long. Level l
+     keeps harmonics up to (size / 2) >> l, so the last level is a sine. The tables are laid out
+     as [frame][level][size] in one block of the mempool.
+     */
+    typedef struct _tWaveTable
+    {
+        tMempool mempool;
+        float* tables;
+        int size;
+        int sizeShift; // 32 - log2(size), phase bits below the table index
+        float fracScale; // 2^-sizeShift
+        int numFrames;
+        int numLevels;
+        // Underlying phasor, a 32 bit fraction of a cycle
+        uint32_t phase;
+        uint32_t inc;
+        float freq;
+        float index;
+        // Crossfade between two mipmap levels of two frames, set by setFreq and setIndex
+        const float* table; // brighter level of the lower frame
+        int levelStride; // offset to the darker level, 0 on the last level
+        int frameStride; // offset to the next frame, 0 on the last frame
+        float levelMix;
+        float frameMix;
+    } _tWaveTable;
+
+    typedef _tWaveTable* tWaveTable;
+
+    //! Initialize a tWaveTable to the default LEAF mempool and build its mipmaps. This runs an FFT per level of every frame, so do it outside the audio callback.
+    /*!
+     @param osc A pointer to the tWaveTable to be initialized.
+     @param frames numFrames single-cycle waveforms of size samples each, one after another. They are copied, and DC is removed.
+     @param size The number of samples in each frame, a power of two from 4 to 65536.
+     @param numFrames The number of frames to scan through with tWaveTable_setIndex, at least 1. If size or numFrames is out of range the tWaveTable is initialized as a sine instead.
+     */
+    void    tWaveTable_init             (tWaveTable* const osc, const float* frames, int size, int numFrames);
+
+
+    //! Initialize a tWaveTable to a specified mempool and build its mipmaps.
+    /*!
+     @param osc A pointer to the tWaveTable to be initialized.
+     @param frames numFrames single-cycle waveforms of size samples each, one after another.
+     @param size The number of samples in each frame, a power of two from 4 to 65536.
+     @param numFrames The number of frames, at least 1. Out of range sizes fall back to a sine.
+     @param pool A pointer to the tMempool to which the tWaveTable should be initialized.
+     */
+    void    tWaveTable_initToPool       (tWaveTable* const osc, const float* frames, int size, int numFrames, tMempool* const pool);
+
+
+    //! Initialize a tWaveTable to the default LEAF mempool from the contents of a wavetable file, for example one read from the SD card.
+    /*!
+     @param osc A pointer to the tWaveTable to be initialized.
+     @param data The contents of the file.
+     @param length The length of data in bytes.
+     @return 1 if data was a valid wavetable file. Otherwise 0, and the tWaveTable is initialized as a sine so it is still safe to tick and free.
+     */
+    int     tWaveTable_initFromData     (tWaveTable* const osc, const char* data, int length);
+
+
+    //! Initialize a tWaveTable to a specified mempool from the contents of a wavetable file.
+    /*!
+     @param osc A pointer to the tWaveTable to be initialized.
+     @param data The contents of the file.
+     @param length The length of data in bytes.
+     @param pool A pointer to the tMempool to which the tWaveTable should be initialized.
+     @return 1 if data was a valid wavetable file, 0 if the tWaveTable fell back to a sine.
+     */
+    int     tWaveTable_initFromDataToPool (tWaveTable* const osc, const char* data, int length, tMempool* const pool);
+
+
+    //! Free a tWaveTable from its mempool.
+    /*!
+     @param osc A pointer to the tWaveTable to be freed.
+     */
+    void    tWaveTable_free             (tWaveTable* const osc);
+
+
+    //! Tick a tWaveTable oscillator.
+    /*!
+     @param osc A pointer to the relevant tWaveTable.
+     @return The ticked sample.
+     */
+    float   tWaveTable_tick             (tWaveTable* const osc);
+
+
+    //! Tick a tWaveTable over a block of samples.
+    /*!
+     @param osc A pointer to the relevant tWaveTable.
+     @param out The buffer to write the block of output samples to.
+     @param n The number of samples to compute.
+     */
+    void    tWaveTable_process          (tWaveTable* const osc, float* out, int n);
+
+
+    //! Set the frequency of a tWaveTable oscillator. This also picks the pair of mipmaps to crossfade between, so that no harmonic goes above Nyquist.
+    /*!
+     @param osc A pointer to the relevant tWaveTable.
+     @param freq The frequency to set the oscillator to.
+     */
+    void    tWaveTable_setFreq          (tWaveTable* const osc, float freq);
+
+
+    //! Set the position in a multi-frame tWaveTable. Positions between frames crossfade between the two.
+    /*!
+     @param osc A pointer to the relevant tWaveTable.
+     @param index The position from 0 (first frame) to 1 (last frame).
+     */
+    void    tWaveTable_setIndex         (tWaveTable* const osc, float index);
+
+
+    //! Get the number of frames in a tWaveTable.
+    /*!
+     @param osc A pointer to the relevant tWaveTable.
+     @return The number of frames.
+     */
+    int     tWaveTable_getNumFrames     (tWaveTable* const osc);
+
+    /*! @} */
     
     
 #ifdef __cplusplus
@@ -301,6 +301,54 @@ extern "C" {
     
     //==============================================================================
     
+    /* Modal resonator bank. Each mode is a two pole resonator ringing at its frequency
+       and falling 60 dB over its decay time; all of them are driven by the same input,
+       for instance a piezo, and summed. The modes are stored one array per field and
+       computed MODALBANK_LANES at a time, with NEON or SSE2 where the target has them.
+       The bank sleeps once its input and every mode are below leaf.silenceThreshold. */
+#define MODALBANK_LANES 4
+    
+    typedef struct _tModalBank
+    {
+        tMempool mempool;
+        int numModes;
+        int numLanes; // numModes rounded up to a multiple of MODALBANK_LANES, extra lanes are silent
+        // Per mode, one array per field
+        float* freq;
+        float* decay;
+        float* gain;
+        float* a1; // 2r cos(w)
+        float* a2; // r^2
+        float* b; // gain * sin(w), so an impulse of 1 rings at gain
+        float* y1;
+        float* y2;
+        float inputPeak; // since the last sleep check
+        int sinceCheck;
+        uint8_t active;
+    } _tModalBank;
+    
+    typedef _tModalBank* tModalBank;
+    
+    void    tModalBank_init         (tModalBank* const, int numModes);
+    void    tModalBank_initToPool   (tModalBank* const, int numModes, tMempool* const);
+    void    tModalBank_free         (tModalBank* const);
+    
+    float   tModalBank_tick         (tModalBank* const, float input);
+    // output is overwritten with the sum of every mode, input and output can be the same buffer
+    void    tModalBank_process      (tModalBank* const, const float* input, float* output, int n);
+    // Freq in Hz, decay in seconds to fall 60 dB, gain is the amplitude an impulse of 1 excites.
+    // Modes at or above Nyquist are silent.
+    void    tModalBank_setMode      (tModalBank* const, int mode, float freq, float decay, float gain);
+    void    tModalBank_setFreq      (tModalBank* const, int mode, float freq);
+    void    tModalBank_setDecay     (tModalBank* const, int mode, float decay);
+    void    tModalBank_setGain      (tModalBank* const, int mode, float gain);
+    // Silences every mode at once.
+    void    tModalBank_clear        (tModalBank* const);
+    int     tModalBank_getNumModes  (tModalBank* const);
+    int     tModalBank_isActive     (tModalBank* const);
+    
+    //==============================================================================
+    
 #ifdef __cplusplus
 }
 #endif
@@ -57,6 +57,7 @@ extern "C" {
     
     void    tPRCReverb_clear        (tPRCReverb* const);
     float   tPRCReverb_tick         (tPRCReverb* const, float input);
+    void    tPRCReverb_process      (tPRCReverb* const, const float* input, float* output, int n);
     
     // Set reverb time in seconds.
     void    tPRCReverb_setT60       (tPRCReverb* const, float t60);
@@ -92,6 +93,7 @@ extern "C" {
     
     void    tNReverb_clear          (tNReverb* const);
     float   tNReverb_tick           (tNReverb* const, float input);
+    void    tNReverb_process        (tNReverb* const, const float* input, float* output, int n);
     void    tNReverb_tickStereo     (tNReverb* const rev, float input, float* output);
     
     // Set reverb time in seconds.
@@ -145,6 +147,10 @@ extern "C" {
         tHighpass   f2_hp;
         
         tCycle      f2_lfo;
+        
+        // SLEEP
+        uint8_t     active;
+        uint32_t    quietCount, quietLength;
     } _tDattorroReverb;
     
     typedef _tDattorroReverb* tDattorroReverb;
@@ -155,6 +161,7 @@ extern "C" {
     
     void    tDattorroReverb_clear             (tDattorroReverb* const);
     float   tDattorroReverb_tick              (tDattorroReverb* const, float input);
+    void    tDattorroReverb_process           (tDattorroReverb* const, const float* input, float* output, int n);
     void    tDattorroReverb_tickStereo        (tDattorroReverb* const rev, float input, float* output);
     void    tDattorroReverb_setMix            (tDattorroReverb* const, float mix);
     void    tDattorroReverb_setFreeze         (tDattorroReverb* const rev, uint32_t freeze);
@@ -165,6 +172,11 @@ extern "C" {
     void    tDattorroReverb_setFeedbackFilter (tDattorroReverb* const, float freq);
     void    tDattorroReverb_setFeedbackGain   (tDattorroReverb* const, float gain);
     
+    // The reverb goes to sleep once its input and tank have stayed below leaf.silenceThreshold for a
+    // full pass through the tank, and then only passes the dry signal through until the input is
+    // above the threshold again. Never sleeps while frozen. Returns nonzero while awake.
+    int     tDattorroReverb_isActive          (tDattorroReverb* const);
+    
 #ifdef __cplusplus
 }
 #endif
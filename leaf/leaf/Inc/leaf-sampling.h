@@ -40,11 +40,24 @@ extern "C" {
         RecordModeNil
     } RecordMode;
     
+    // How a tBuffer stores its samples. The packed formats take a half or three quarters of the memory
+    // of BufferFloat, and tSampler converts them as part of its interpolation.
+    typedef enum BufferFormat
+    {
+        BufferFloat = 0,
+        BufferInt16,
+        BufferInt24, // 3 bytes a sample, little endian
+        BufferFormatNil
+    } BufferFormat;
+    
     typedef struct _tBuffer
     {
         tMempool mempool;
         
-        float* buff;
+        BufferFormat format;
+        float* buff; // NULL unless the format is BufferFloat
+        int16_t* buff16;
+        uint8_t* buff24;
         
         uint32_t idx;
         uint32_t bufferLength;
@@ -58,6 +71,8 @@ extern "C" {
     
     void  tBuffer_init                  (tBuffer* const, uint32_t length);
     void  tBuffer_initToPool            (tBuffer* const, uint32_t length, tMempool* const);
+    void  tBuffer_initWithFormat        (tBuffer* const, uint32_t length, BufferFormat format);
+    void  tBuffer_initWithFormatToPool  (tBuffer* const, uint32_t length, BufferFormat format, tMempool* const);
     void  tBuffer_free                  (tBuffer* const);
     
     void  tBuffer_tick                  (tBuffer* const, float sample);
@@ -79,6 +94,7 @@ extern "C" {
     uint32_t tBuffer_getRecordedLength  (tBuffer* const sb);
     void 	tBuffer_setRecordedLength	(tBuffer* const sb, int length);
     int 	tBuffer_isActive			(tBuffer* const sb);
+    BufferFormat tBuffer_getFormat      (tBuffer* const sb);
     
     //==============================================================================
     
@@ -90,6 +106,16 @@ extern "C" {
         PlayModeNil
     } PlayMode;
     
+    // How tSampler reads between samples. Cubic is the 4 point Hermite it has always used, sinc an
+    // 8 point windowed sinc for pitching samples down cleanly.
+    typedef enum InterpolationQuality
+    {
+        InterpolationLinear = 0,
+        InterpolationCubic,
+        InterpolationSinc,
+        InterpolationQualityNil
+    } InterpolationQuality;
+    
     typedef struct _tSampler
     {
         tMempool mempool;
@@ -113,6 +139,7 @@ extern "C" {
         uint32_t cfxlen;
         float numticks;
         PlayMode mode;
+        InterpolationQuality quality;
         int retrigger;
         
         int active;
@@ -130,6 +157,9 @@ extern "C" {
     void    tSampler_free               (tSampler* const);
     
     float   tSampler_tick               (tSampler* const);
+    // Same output as tick. Runs of samples away from the loop points, crossfades and the end
+    // are rendered in one tight loop.
+    void    tSampler_process            (tSampler* const, float* out, int n);
     
     void    tSampler_setSample          (tSampler* const, tBuffer* const);
     
@@ -145,6 +175,7 @@ extern "C" {
     void    tSampler_setCrossfadeLength (tSampler* const sp, uint32_t length);
     
     void    tSampler_setRate            (tSampler* const, float rate);
+    void    tSampler_setQuality         (tSampler* const, InterpolationQuality quality);
     
     //==============================================================================
     
@@ -182,6 +213,86 @@ extern "C" {
     
     void    tAutoSampler_setRate            (tAutoSampler* const, float rate);
     
+    //==============================================================================
+    
+    // A sampled instrument for drums. Each zone is a tBuffer played for hits on one key (a pad or
+    // piezo) within a range of velocities from 0 to 1. Zones with the same key and velocity range
+    // form a round robin group and take turns. Voices are preallocated and a hit takes a free one, or
+    // steals one already fading out or else the oldest, so triggering never allocates. A stolen voice
+    // still gets its short release.
+    
+#define MULTISAMPLER_VELOCITY_STEPS 128 // resolution of the velocity lookup
+#define MULTISAMPLER_MAX_ROUND_ROBIN 8 // zones in one group
+#define MULTISAMPLER_BLOCK_SIZE 32 // voices are rendered this many samples at a time
+    
+    typedef struct tMultiSamplerZone
+    {
+        tBuffer buffer; // NULL leaves the zone silent
+        int key;
+        float velocityLow, velocityHigh;
+        float gain;
+        float rate;
+        int group;
+    } tMultiSamplerZone;
+    
+    typedef struct tMultiSamplerGroup
+    {
+        int key;
+        float velocityLow, velocityHigh;
+        int numZones;
+        int zones[MULTISAMPLER_MAX_ROUND_ROBIN];
+        int next;
+    } tMultiSamplerGroup;
+    
+    typedef struct tMultiSamplerVoice
+    {
+        tSampler sampler;
+        int zone;
+        int key;
+        float gain;
+        uint32_t startTime;
+    } tMultiSamplerVoice;
+    
+    typedef struct _tMultiSampler
+    {
+        tMempool mempool;
+        
+        int numKeys;
+        int maxZones;
+        int numZones;
+        tMultiSamplerZone* zones;
+        int numGroups;
+        tMultiSamplerGroup* groups;
+        int16_t* lookup; // the group for each key and velocity step, -1 for none
+        
+        int numVoices;
+        tMultiSamplerVoice* voices; // numVoices, and a spare for the tail of a stolen one
+        tBuffer silence; // what idle voices point at
+        uint32_t time; // hits so far
+        uint32_t numSteals;
+    } _tMultiSampler;
+    
+    typedef _tMultiSampler* tMultiSampler;
+    
+    void    tMultiSampler_init              (tMultiSampler* const, int numKeys, int maxZones, int numVoices);
+    void    tMultiSampler_initToPool        (tMultiSampler* const, int numKeys, int maxZones, int numVoices, tMempool* const);
+    void    tMultiSampler_free              (tMultiSampler* const);
+    
+    // Returns the zone number, or -1 if there's no room for it. The buffer can be NULL and set later.
+    int     tMultiSampler_addZone           (tMultiSampler* const, tBuffer* const, int key, float velocityLow, float velocityHigh);
+    // Swaps a zone's sample, cutting off any voice still playing the old one so it can be freed.
+    void    tMultiSampler_setZoneBuffer     (tMultiSampler* const, int zone, tBuffer* const);
+    void    tMultiSampler_setZoneGain       (tMultiSampler* const, int zone, float gain);
+    void    tMultiSampler_setZoneTuning     (tMultiSampler* const, int zone, float semitones);
+    void    tMultiSampler_setQuality        (tMultiSampler* const, InterpolationQuality quality);
+    
+    void    tMultiSampler_trigger           (tMultiSampler* const, int key, float velocity);
+    // fades out every voice of a key, for choking a cymbal
+    void    tMultiSampler_stop              (tMultiSampler* const, int key);
+    
+    float   tMultiSampler_tick              (tMultiSampler* const);
+    void    tMultiSampler_process           (tMultiSampler* const, float* out, int n);
+    
 #ifdef __cplusplus
 }
 #endif
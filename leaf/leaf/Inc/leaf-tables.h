@@ -121,6 +121,13 @@ extern "C" {
     
     //==============================================================================
     
+    /* windowed sinc interpolation for tSampler */
+#define SINC_TAPS               8
+#define SINC_PHASES             64
+    extern const float __leaf_table_sinc[SINC_PHASES + 1][SINC_TAPS];
+    
+    //==============================================================================
+    
 #ifdef __cplusplus
 }
 #endif
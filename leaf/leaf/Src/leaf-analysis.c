@@ -9,12 +9,10 @@
 #if _WIN32 || _WIN64
 
 #include "..\Inc\leaf-analysis.h"
-#include "..\Externals\d_fft_mayer.h"
 
 #else
 
 #include "../Inc/leaf-analysis.h"
-#include "../Externals/d_fft_mayer.h"
 
 #endif
 
@@ -296,14 +294,14 @@ void tEnvPD_processBlock(tEnvPD* const xpd, float* in)
     int n = x->blockSize;
     
     int count;
-    t_sample *sump;
+    float *sump;
     in += n;
     for (count = x->x_phase, sump = x->x_sumbuf;
          count < x->x_npoints; count += x->x_realperiod, sump++)
     {
-        t_sample *hp = x->buf + count;
-        t_sample *fp = in;
-        t_sample sum = *sump;
+        float *hp = x->buf + count;
+        float *fp = in;
+        float sum = *sump;
         int i;
         
         for (i = 0; i < n; i++)
@@ -463,9 +461,6 @@ static void atkdtk_envelope(tAttackDetection* const ad, float *in)
 /***************************** private procedures *****************************/
 /******************************************************************************/
 
-#define REALFFT mayer_realfft
-#define REALIFFT mayer_realifft
-
 static void snac_analyzeframe(tSNAC* const s);
 static void snac_autocorrelation(tSNAC* const s);
 static void snac_normalize(tSNAC* const s);
@@ -503,6 +498,7 @@ void    tSNAC_initToPool    (tSNAC* const snac, int overlaparg, tMempool* const
     s->processbuf = (float*) mpool_calloc(sizeof(float) * (SNAC_FRAME_SIZE * 2), m);
     s->spectrumbuf = (float*) mpool_calloc(sizeof(float) * (SNAC_FRAME_SIZE / 2), m);
     s->biasbuf = (float*) mpool_calloc(sizeof(float) * SNAC_FRAME_SIZE, m);
+    tFFT_initToPool(&s->fft, SNAC_FRAME_SIZE * 2, FFTReal, mp);
     
     snac_biasbuf(snac);
     tSNAC_setOverlap(snac, overlaparg);
@@ -516,6 +512,7 @@ void tSNAC_free (tSNAC* const snac)
     mpool_free((char*)s->processbuf, s->mempool);
     mpool_free((char*)s->spectrumbuf, s->mempool);
     mpool_free((char*)s->biasbuf, s->mempool);
+    tFFT_free(&s->fft);
     mpool_free((char*)s, s->mempool);
 }
 
@@ -632,31 +629,30 @@ static void snac_autocorrelation(tSNAC* const snac)
     
     int n, m;
     int framesize = s->framesize;
-    int fftsize = framesize * 2;
     float *processbuf = s->processbuf;
     float *spectrumbuf = s->spectrumbuf;
     
-    REALFFT(fftsize, processbuf);
+    tFFT_forward(&s->fft, processbuf, processbuf);
     
     // compute power spectrum
     processbuf[0] *= processbuf[0];                      // DC
-    processbuf[framesize] *= processbuf[framesize];      // Nyquist
+    processbuf[1] *= processbuf[1];                      // Nyquist
     
     for(n=1; n<framesize; n++)
     {
-        processbuf[n] = processbuf[n] * processbuf[n]
-        + processbuf[fftsize-n] * processbuf[fftsize-n]; // imag coefficients appear reversed
-        processbuf[fftsize-n] = 0.;
+        processbuf[2*n] = processbuf[2*n] * processbuf[2*n]
+        + processbuf[2*n+1] * processbuf[2*n+1];
+        processbuf[2*n+1] = 0.;
     }
     
     // store power spectrum up to SR/4 for possible later use
     for(m=0; m<(framesize>>1); m++)
     {
-        spectrumbuf[m] = processbuf[m];
+        spectrumbuf[m] = processbuf[2*m];
     }
     
     // transform power spectrum to autocorrelation function
-    REALIFFT(fftsize, processbuf);
+    tFFT_inverse(&s->fft, processbuf, processbuf);
     return;
 }
 
@@ -950,3 +946,70 @@ void tPeriodDetection_setTolerance        (tPeriodDetection* pd, float tolerance
     if (tolerance < 0.0f) p->tolerance = 0.0f;
     else p->tolerance = tolerance;
 }
+
+//===========================================================================
+/* Numeric Guard */
+//===========================================================================
+
+void    tNumericGuard_init(tNumericGuard* const ng, void (*reset)(void* object), void* object)
+{
+    tNumericGuard_initToPool(ng, reset, object, &leaf.mempool);
+}
+
+void    tNumericGuard_initToPool(tNumericGuard* const ng, void (*reset)(void* object), void* object, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tNumericGuard* g = *ng = (_tNumericGuard*) mpool_alloc(sizeof(_tNumericGuard), m);
+    g->mempool = m;
+    
+    g->reset = reset;
+    g->object = object;
+    tNumericGuard_clearStats(ng);
+}
+
+void    tNumericGuard_free(tNumericGuard* const ng)
+{
+    _tNumericGuard* g = *ng;
+    
+    mpool_free((char*)g, g->mempool);
+}
+
+int     tNumericGuard_check(tNumericGuard* const ng, float* buffer, int n)
+{
+    _tNumericGuard* g = *ng;
+    
+    g->stats.blocks++;
+    int flags = LEAF_checkNumerics(buffer, n);
+    if (flags == 0) return 0;
+    
+    if (flags & LEAF_NUMERIC_NAN) g->stats.nanBlocks++;
+    if (flags & LEAF_NUMERIC_INF) g->stats.infBlocks++;
+    if (flags & LEAF_NUMERIC_DENORMAL) g->stats.denormalBlocks++;
+    
+    if (flags & (LEAF_NUMERIC_NAN | LEAF_NUMERIC_INF))
+    {
+        for (int i = 0; i < n; i++) buffer[i] = 0.0f;
+        if (g->reset != NULL)
+        {
+            g->reset(g->object);
+            g->stats.resets++;
+        }
+    }
+    return flags;
+}
+
+void    tNumericGuard_getStats(tNumericGuard* const ng, tNumericGuardStats* stats)
+{
+    _tNumericGuard* g = *ng;
+    *stats = g->stats;
+}
+
+void    tNumericGuard_clearStats(tNumericGuard* const ng)
+{
+    _tNumericGuard* g = *ng;
+    g->stats.blocks = 0;
+    g->stats.nanBlocks = 0;
+    g->stats.infBlocks = 0;
+    g->stats.denormalBlocks = 0;
+    g->stats.resets = 0;
+}
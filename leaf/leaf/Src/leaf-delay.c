@@ -80,6 +80,33 @@ float   tDelay_tick (tDelay* const dl, float input)
     return d->lastOut;
 }
 
+void    tDelay_process (tDelay* const dl, const float* input, float* output, int n)
+{
+    _tDelay* d = *dl;
+    
+    float* buff = d->buff;
+    const uint32_t maxDelay = d->maxDelay;
+    const float gain = d->gain;
+    uint32_t inPoint = d->inPoint, outPoint = d->outPoint;
+    
+    for (int i = 0; i < n; i++)
+    {
+        buff[inPoint] = input[i] * gain;
+        if (++inPoint == maxDelay)     inPoint = 0;
+        
+        output[i] = buff[outPoint];
+        if (++outPoint == maxDelay)    outPoint = 0;
+    }
+    
+    if (n > 0)
+    {
+        d->lastIn = input[n-1];
+        d->lastOut = output[n-1];
+    }
+    d->inPoint = inPoint;
+    d->outPoint = outPoint;
+}
+
 int     tDelay_setDelay (tDelay* const dl, uint32_t delay)
 {
     _tDelay* d = *dl;
@@ -211,26 +238,33 @@ void    tLinearDelay_clear(tLinearDelay* const dl)
 
 float   tLinearDelay_tick (tLinearDelay* const dl, float input)
 {
-    _tLinearDelay* d = *dl;
-
-    d->buff[d->inPoint] = input * d->gain;
-
-    // Increment input pointer modulo length.
-    if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
-
-    uint32_t idx = (uint32_t) d->outPoint;
-    // First 1/2 of interpolation
-    d->lastOut = d->buff[idx] * d->omAlpha;
-        // Second 1/2 of interpolation
-    if ((idx + 1) < d->maxDelay)
-        d->lastOut += d->buff[idx+1] * d->alpha;
-    else
-        d->lastOut += d->buff[0] * d->alpha;
-
-    // Increment output pointer modulo length
-    if ( (++d->outPoint) >= d->maxDelay )   d->outPoint = 0;
+    return _tLinearDelay_tick(*dl, input);
+}
 
-    return d->lastOut;
+void    tLinearDelay_process (tLinearDelay* const dl, const float* input, float* output, int n)
+{
+    _tLinearDelay* d = *dl;
+    
+    float* buff = d->buff;
+    const uint32_t maxDelay = d->maxDelay;
+    const float gain = d->gain, alpha = d->alpha, omAlpha = d->omAlpha;
+    uint32_t inPoint = d->inPoint, outPoint = d->outPoint;
+    
+    for (int i = 0; i < n; i++)
+    {
+        buff[inPoint] = input[i] * gain;
+        if (++inPoint == maxDelay)     inPoint = 0;
+        
+        uint32_t next = outPoint + 1;
+        if (next >= maxDelay) next = 0;
+        output[i] = buff[outPoint] * omAlpha + buff[next] * alpha;
+        
+        outPoint = next;
+    }
+    
+    if (n > 0) d->lastOut = output[n-1];
+    d->inPoint = inPoint;
+    d->outPoint = outPoint;
 }
 
 void   tLinearDelay_tickIn (tLinearDelay* const dl, float input)
@@ -264,21 +298,7 @@ float   tLinearDelay_tickOut (tLinearDelay* const dl)
 
 int     tLinearDelay_setDelay (tLinearDelay* const dl, float delay)
 {
-    _tLinearDelay* d = *dl;
-
-    d->delay = LEAF_clip(0.0f, delay,  d->maxDelay);
-
-    float outPointer = d->inPoint - d->delay;
-
-    while ( outPointer < 0 )
-        outPointer += d->maxDelay; // modulo maximum length
-
-    d->outPoint = (uint32_t) outPointer;   // integer part
-
-    d->alpha = outPointer - d->outPoint; // fractional part
-    d->omAlpha = 1.0f - d->alpha;
-
-    if ( d->outPoint == d->maxDelay ) d->outPoint = 0;
+    _tLinearDelay_setDelay(*dl, delay);
 
     return 0;
 }
@@ -773,33 +793,10 @@ void tTapeDelay_clear(tTapeDelay* const dl)
 
 float   tTapeDelay_tick (tTapeDelay* const dl, float input)
 {
-    _tTapeDelay* d = *dl;
-
-    d->buff[d->inPoint] = input * d->gain;
-
-    // Increment input pointer modulo length.
-    if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
-
-    int idx =  (int) d->idx;
-    float alpha = d->idx - idx;
-
-    d->lastOut =    LEAF_interpolate_hermite_x (d->buff[((idx - 1) + d->maxDelay) % d->maxDelay],
-                                              d->buff[idx],
-                                              d->buff[(idx + 1) % d->maxDelay],
-                                              d->buff[(idx + 2) % d->maxDelay],
-                                              alpha);
-
-    float diff = (d->inPoint - d->idx);
-    while (diff < 0.f) diff += d->maxDelay;
-
-    d->inc = 1.0f + (diff - d->delay) / d->delay; //* SMOOTH_FACTOR;
+    float out = _tTapeDelay_tick(*dl, input);
 
-    d->idx += d->inc;
-
-    if (d->idx >= d->maxDelay) d->idx = 0.0f;
-
-    if (d->lastOut)
-        return d->lastOut;
+    if (out)
+        return out;
     return 0.0f;
 }
 
@@ -825,25 +822,7 @@ void     tTapeDelay_setDelay (tTapeDelay* const dl, float delay)
 
 float tTapeDelay_tapOut (tTapeDelay* const dl, float tapDelay)
 {
-    _tTapeDelay* d = *dl;
-
-    float tap = (float) d->inPoint - tapDelay - 1.f;
-
-    // Check for wraparound.
-    while ( tap < 0.f )   tap += (float)d->maxDelay;
-
-    int idx =  (int) tap;
-
-    float alpha = tap - idx;
-
-    float samp =    LEAF_interpolate_hermite_x (d->buff[((idx - 1) + d->maxDelay) % d->maxDelay],
-                                              d->buff[idx],
-                                              d->buff[(idx + 1) % d->maxDelay],
-                                              d->buff[(idx + 2) % d->maxDelay],
-                                              alpha);
-
-    return samp;
-
+    return _tTapeDelay_tapOut(*dl, tapDelay);
 }
 
 void tTapeDelay_tapIn (tTapeDelay* const dl, float value, uint32_t tapDelay)
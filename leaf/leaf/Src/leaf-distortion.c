@@ -358,8 +358,16 @@ void tLockhartWavefolder_initToPool (tLockhartWavefolder* const wf, tMempool* co
     w->tempsDenom = 0.0f;
     w->tempErrDenom = 0.0f;
     w->tempOutDenom = 0.0f;
-
-
+    
+    w->fLogD = (float) log(w->d);
+    w->fB = (float) w->b;
+    w->fA = (float) w->a;
+    w->fHalfA = (float) w->half_a;
+    w->fLongthing = (float) w->longthing;
+    w->fVT = (float) w->VT;
+    w->fLn1 = 0.0f;
+    w->fSign1 = 0.0f;
+    w->fXn1 = 0.0f;
 }
 
 void tLockhartWavefolder_free (tLockhartWavefolder* const wf)
@@ -549,6 +557,54 @@ float tLockhartWavefolder_tick(tLockhartWavefolder* const wf, float in)
     return out;
 }
 
+// Below this step the antiderivative difference is ill-conditioned in float, so the
+// folder is evaluated directly at the midpoint instead
+#define LOCKHART_FAST_THRESH 1.0e-3f
+
+// d*exp(b|x|) overflows a float long before the folder runs out of range, but
+// W(d*exp(b|x|)) is just the Wright omega of log(d) + b|x|, which doesn't
+static inline float lockhartFastStep(_tLockhartWavefolder* w, float in)
+{
+    float l = (float)((in > 0.0f) - (in < 0.0f));
+    float Ln = LEAF_wrightOmega(w->fLogD + (l * w->fB * in));
+    float dx = in - w->fXn1;
+    float out;
+    
+    if (fabsf(dx) < LOCKHART_FAST_THRESH)
+    {
+        float xn = 0.5f * (in + w->fXn1);
+        float Lm = LEAF_wrightOmega(w->fLogD + (l * w->fB * xn));
+        out = (l * w->fVT * Lm) - (w->fA * xn);
+    }
+    else
+    {
+        // (F(x) - F(x1)) / dx with the x^2 terms divided out exactly, and Ln - Ln1 taken
+        // from w + ln(w) = b|x| + log(d), which doesn't lose the small difference of two
+        // large numbers when both sides of the step have the same sign
+        float dL;
+        if (l == w->fSign1) dL = (l * w->fB * dx) - logf(Ln / w->fLn1);
+        else dL = Ln - w->fLn1;
+        out = ((w->fLongthing * dL * (Ln + w->fLn1 + 2.0f)) / dx) - (w->fHalfA * (in + w->fXn1));
+    }
+    
+    w->fLn1 = Ln;
+    w->fSign1 = l;
+    w->fXn1 = in;
+    
+    return out;
+}
+
+float tLockhartWavefolder_tickFast(tLockhartWavefolder* const wf, float in)
+{
+    return lockhartFastStep(*wf, in);
+}
+
+void tLockhartWavefolder_process(tLockhartWavefolder* const wf, const float* input, float* output, int n)
+{
+    _tLockhartWavefolder* w = *wf;
+    for (int i = 0; i < n; i++) output[i] = lockhartFastStep(w, input[i]);
+}
+
 //============================================================================================================
 // CRUSHER
 //============================================================================================================
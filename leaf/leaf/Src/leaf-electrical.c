@@ -132,7 +132,7 @@ static void wdf_init(tWDF* const wdf, WDFComponentType type, float value, tWDF*
         r->port_conductance_up  = 1.0f / r->port_resistance_up;
         r->port_conductance_left = 1.0f / r->port_resistance_left;
         r->port_conductance_right = 1.0f / r->port_resistance_right;
-        r->gamma_zero = 1.0f / (r->port_resistance_right + r->port_resistance_left);
+        r->gamma_zero = 1.0f / (r->port_conductance_right + r->port_conductance_left);
         
         r->get_port_resistance = &get_port_resistance_for_parallel;
         r->get_reflected_wave_up = &get_reflected_wave_for_parallel;
@@ -172,7 +172,8 @@ void tWDF_init(tWDF* const wdf, WDFComponentType type, float value, tWDF* const
 void    tWDF_initToPool(tWDF* const wdf, WDFComponentType type, float value, tWDF* const rL, tWDF* const rR, tMempool* const mp)
 {
     _tMempool* m = *mp;
-    *wdf = (_tWDF*) mpool_alloc(sizeof(_tWDF), m);
+    _tWDF* r = *wdf = (_tWDF*) mpool_alloc(sizeof(_tWDF), m);
+    r->mempool = m;
     
     wdf_init(wdf, type, value, rL, rR);
 }
@@ -484,58 +485,212 @@ static float log2Approximation(float x)
     return (l2A * x*x*x) + (l2B * x*x) + (l2Y * x) + l2K;
 }
 
-#define wX1 -3.684303659906469f
-#define wX2 1.972967391708859f
-#define wA  9.451797158780131e-3f
-#define wB  0.1126446405111627f
-#define wY  0.4451353886588814f
-#define wK  0.5836596684310648f
-static float wrightOmega3(float x)
+static float lambertW(float a, float r, float I, float iVT)
 {
-    if (x <= wX1)
-    {
-        return 0;
-    }
-    else if (x < wX2)
+    return LEAF_wrightOmega4(((a + r*I) * iVT) + logf((r * I) * iVT));
+}
+
+#define Is_DIODE    2.52e-9f
+#define VT_DIODE    0.02585f
+static float diode_reflect(float a, float r)
+{
+    return a + 2.0f*r*Is_DIODE - 2.0f*VT_DIODE*lambertW(a, r, Is_DIODE, 1.0f/VT_DIODE);
+}
+
+static float diode_pair_reflect(float a, float r)
+{
+    float sgn = 0.0f;
+    if (a > 0.0f) sgn = 1.0f;
+    else if (a < 0.0f) sgn = -1.0f;
+    return a + 2 * sgn * (r*Is_DIODE - VT_DIODE*lambertW(sgn*a, r, Is_DIODE, 1.0f/VT_DIODE));
+}
+
+static float get_reflected_wave_for_diode(tWDF* const wdf, float input, float incident_wave)
+{
+    _tWDF* n = *wdf;
+    return diode_reflect(incident_wave, n->port_resistance_up);
+}
+
+static float get_reflected_wave_for_diode_pair(tWDF* const wdf, float input, float incident_wave)
+{
+    _tWDF* n = *wdf;
+    return diode_pair_reflect(incident_wave, n->port_resistance_up);
+}
+
+//==============================================================================
+
+static tWDF* wdf_root_child(_tWDF* r)
+{
+    if (r->child_left != NULL) return r->child_left;
+    return r->child_right;
+}
+
+// Capacitors and inductors below wdf, in the order the tree visits them
+static int wdf_find_reactive(tWDF* const wdf, _tWDF** reactive, int count)
+{
+    if (wdf == NULL) return count;
+    _tWDF* r = *wdf;
+    
+    if ((r->type == Capacitor) || (r->type == Inductor))
     {
-        return (wA * x*x*x) + (wB * x*x) + (wY * x) + wK;
+        if (reactive != NULL) reactive[count] = r;
+        return count + 1;
     }
-    else
+    count = wdf_find_reactive(r->child_left, reactive, count);
+    return wdf_find_reactive(r->child_right, reactive, count);
+}
+
+// One pass of the tree with only state j (or the input when j is numStates, or the
+// root's reflection when j is numStates + 1) set to 1, with whatever the tree's
+// scattering does in between. Returns the wave reaching the root.
+static float wdfflat_probe(_tWDFFlat* f, int j, float* newState, float* out)
+{
+    _tWDF* root = *f->root;
+    tWDF* child = wdf_root_child(root);
+    int n = f->numStates;
+    float input = (j == n) ? 1.0f : 0.0f;
+    float rootWave = (j == n + 1) ? 1.0f : 0.0f;
+    
+    for (int i = 0; i < n; i++) f->reactive[i]->incident_wave_up = (i == j) ? 1.0f : 0.0f;
+    
+    float up = tWDF_getReflectedWaveUp(child, input);
+    root->incident_wave_up = up;
+    root->reflected_wave_up = rootWave;
+    tWDF_setIncidentWave(child, rootWave, input);
+    
+    for (int i = 0; i < f->numStates; i++) newState[i] = f->reactive[i]->incident_wave_up;
+    *out = tWDF_getVoltage(f->outputPoint);
+    return up;
+}
+
+// Everything below the root is linear and has no constant term, so sending one unit
+// wave in at a time gives each weight directly.
+static void wdfflat_compile(_tWDFFlat* f)
+{
+    int n = f->numStates;
+    int width = n + 2;
+    _tWDF* root = *f->root;
+    
+    f->rootType = root->type;
+    f->rootResistance = tWDF_getPortResistance(f->root);
+    
+    // The tree's own waves are put back afterwards
+    for (int i = 0; i < n; i++) f->treeState[i] = f->reactive[i]->incident_wave_up;
+    float rootIncident = root->incident_wave_up;
+    float rootReflected = root->reflected_wave_up;
+    
+    for (int j = 0; j < width; j++)
     {
-        return x - logf(x);
+        float up = wdfflat_probe(f, j, f->newState, &f->out[j]);
+        if (j <= n) f->up[j] = up;
+        for (int i = 0; i < n; i++) f->next[(i * width) + j] = f->newState[i];
     }
+    
+    for (int i = 0; i < n; i++) f->reactive[i]->incident_wave_up = f->treeState[i];
+    root->incident_wave_up = rootIncident;
+    root->reflected_wave_up = rootReflected;
 }
 
-static float wrightOmegaApproximation(float x)
+void tWDFFlat_init(tWDFFlat* const wdf, tWDF* const root, tWDF* const outputPoint)
 {
-    float w3 = wrightOmega3(x);
-    return w3 - ((w3 - expf(x - w3)) / (w3 + 1.0f));
+    tWDFFlat_initToPool(wdf, root, outputPoint, &leaf.mempool);
 }
 
-static float lambertW(float a, float r, float I, float iVT)
+void tWDFFlat_initToPool(tWDFFlat* const wdf, tWDF* const root, tWDF* const outputPoint, tMempool* const mp)
 {
-    return wrightOmegaApproximation(((a + r*I) * iVT) + log((r * I) * iVT));
+    _tMempool* m = *mp;
+    _tWDFFlat* f = *wdf = (_tWDFFlat*) mpool_alloc(sizeof(_tWDFFlat), m);
+    f->mempool = m;
+    
+    f->root = root;
+    f->outputPoint = outputPoint;
+    
+    int n = wdf_find_reactive(wdf_root_child(*root), NULL, 0);
+    f->numStates = n;
+    // Every array gets at least one element so a purely resistive tree still allocates cleanly
+    int size = (n > 0) ? n : 1;
+    f->reactive = (_tWDF**) mpool_alloc(sizeof(_tWDF*) * size, m);
+    f->state = (float*) mpool_alloc(sizeof(float) * size, m);
+    f->newState = (float*) mpool_alloc(sizeof(float) * size, m);
+    f->treeState = (float*) mpool_alloc(sizeof(float) * size, m);
+    f->up = (float*) mpool_alloc(sizeof(float) * (n + 1), m);
+    f->out = (float*) mpool_alloc(sizeof(float) * (n + 2), m);
+    f->next = (float*) mpool_alloc(sizeof(float) * size * (n + 2), m);
+    wdf_find_reactive(wdf_root_child(*root), f->reactive, 0);
+    
+    wdfflat_compile(f);
+    for (int i = 0; i < n; i++) f->state[i] = f->reactive[i]->incident_wave_up;
 }
 
-#define Is_DIODE    2.52e-9f
-#define VT_DIODE    0.02585f
-static float get_reflected_wave_for_diode(tWDF* const wdf, float input, float incident_wave)
+void tWDFFlat_free(tWDFFlat* const wdf)
 {
-    _tWDF* n = *wdf;
+    _tWDFFlat* f = *wdf;
     
-    float a = incident_wave;
-    float r = n->port_resistance_up;
-    return a + 2.0f*r*Is_DIODE - 2.0f*VT_DIODE*lambertW(a, r, Is_DIODE, 1.0f/VT_DIODE);
+    mpool_free((char*)f->next, f->mempool);
+    mpool_free((char*)f->out, f->mempool);
+    mpool_free((char*)f->up, f->mempool);
+    mpool_free((char*)f->treeState, f->mempool);
+    mpool_free((char*)f->newState, f->mempool);
+    mpool_free((char*)f->state, f->mempool);
+    mpool_free((char*)f->reactive, f->mempool);
+    mpool_free((char*)f, f->mempool);
 }
 
-static float get_reflected_wave_for_diode_pair(tWDF* const wdf, float input, float incident_wave)
+static inline float wdfflat_root(_tWDFFlat* f, float input, float a)
 {
-    _tWDF* n = *wdf;
+    switch (f->rootType)
+    {
+        case Diode: return diode_reflect(a, f->rootResistance);
+        case DiodePair: return diode_pair_reflect(a, f->rootResistance);
+        case IdealSource: return (2.0f * input) - a;
+        default: return 0.0f;
+    }
+}
+
+static inline float wdfflat_step(_tWDFFlat* f, float input)
+{
+    int n = f->numStates;
+    int width = n + 2;
+    float* state = f->state;
     
-    float a = incident_wave;
-    float sgn = 0.0f;
-    if (a > 0.0f) sgn = 1.0f;
-    else if (a < 0.0f) sgn = -1.0f;
-    float r = n->port_resistance_up;
-    return a + 2 * sgn * (r*Is_DIODE - VT_DIODE*lambertW(sgn*a, r, Is_DIODE, 1.0f/VT_DIODE));
+    float a = f->up[n] * input;
+    for (int i = 0; i < n; i++) a += f->up[i] * state[i];
+    
+    float b = wdfflat_root(f, input, a);
+    
+    float out = (f->out[n] * input) + (f->out[n + 1] * b);
+    for (int i = 0; i < n; i++) out += f->out[i] * state[i];
+    
+    for (int k = 0; k < n; k++)
+    {
+        const float* row = &f->next[k * width];
+        float s = (row[n] * input) + (row[n + 1] * b);
+        for (int i = 0; i < n; i++) s += row[i] * state[i];
+        f->newState[k] = s;
+    }
+    for (int k = 0; k < n; k++) state[k] = f->newState[k];
+    
+    return out;
+}
+
+float tWDFFlat_tick(tWDFFlat* const wdf, float input)
+{
+    return wdfflat_step(*wdf, input);
+}
+
+void tWDFFlat_process(tWDFFlat* const wdf, const float* input, float* output, int n)
+{
+    _tWDFFlat* f = *wdf;
+    for (int i = 0; i < n; i++) output[i] = wdfflat_step(f, input[i]);
+}
+
+void tWDFFlat_update(tWDFFlat* const wdf)
+{
+    wdfflat_compile(*wdf);
+}
+
+void tWDFFlat_clear(tWDFFlat* const wdf)
+{
+    _tWDFFlat* f = *wdf;
+    for (int i = 0; i < f->numStates; i++) f->state[i] = 0.0f;
 }
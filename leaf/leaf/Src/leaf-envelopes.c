@@ -117,6 +117,12 @@ void     tEnvelope_loop(tEnvelope* const envlp, int loop)
     env->loop = loop;
 }
 
+int     tEnvelope_isActive(tEnvelope* const envlp)
+{
+    _tEnvelope* env = *envlp;
+    return env->inAttack || env->inDecay || env->inRamp;
+}
+
 
 void     tEnvelope_on(tEnvelope* const envlp, float velocity)
 {
@@ -213,6 +219,92 @@ float   tEnvelope_tick(tEnvelope* const envlp)
 }
 
 
+void    tEnvelope_process(tEnvelope* const envlp, float* out, int n)
+{
+    _tEnvelope* env = *envlp;
+    
+    const float* exp_buff = env->exp_buff;
+    const float attackInc = env->attackInc, decayInc = env->decayInc, rampInc = env->rampInc;
+    const float gain = env->gain, rampPeak = env->rampPeak;
+    const int loop = env->loop;
+    int inAttack = env->inAttack, inDecay = env->inDecay, inRamp = env->inRamp;
+    float attackPhase = env->attackPhase, decayPhase = env->decayPhase, rampPhase = env->rampPhase;
+    float next = env->next;
+    int i = 0;
+    
+    // Run the stages until they're all done, then fill the rest of the block with the last value
+    for (; (i < n) && (inRamp || inAttack || inDecay); i++)
+    {
+        if (inRamp)
+        {
+            if (rampPhase > UINT16_MAX)
+            {
+                inRamp = OFALSE;
+                inAttack = OTRUE;
+                next = 0.0f;
+            }
+            else
+            {
+                next = rampPeak * exp_buff[(uint32_t)rampPhase];
+            }
+            
+            rampPhase += rampInc;
+        }
+        
+        if (inAttack)
+        {
+            if (attackPhase > UINT16_MAX)
+            {
+                inDecay = OTRUE;
+                inAttack = OFALSE;
+                next = gain * 1.0f;
+            }
+            else
+            {
+                next = gain * exp_buff[UINT16_MAX - (uint32_t)attackPhase];
+            }
+            
+            attackPhase += attackInc;
+        }
+        
+        if (inDecay)
+        {
+            if (decayPhase >= UINT16_MAX)
+            {
+                inDecay = OFALSE;
+                
+                if (loop)
+                {
+                    attackPhase = 0;
+                    decayPhase = 0;
+                    inAttack = OTRUE;
+                }
+                else
+                {
+                    next = 0.0f;
+                }
+            }
+            else
+            {
+                next = gain * (exp_buff[(uint32_t)decayPhase]);
+            }
+            
+            decayPhase += decayInc;
+        }
+        
+        out[i] = next;
+    }
+    for (; i < n; i++) out[i] = next;
+    
+    env->inAttack = inAttack;
+    env->inDecay = inDecay;
+    env->inRamp = inRamp;
+    env->attackPhase = attackPhase;
+    env->decayPhase = decayPhase;
+    env->rampPhase = rampPhase;
+    env->next = next;
+}
+
 
 /* ADSR */
 void    tADSR_init(tADSR* const adsrenv, float attack, float decay, float sustain, float release)
@@ -395,6 +487,12 @@ void tADSR_off(tADSR* const adsrenv)
     adsr->releasePeak = adsr->next;
 }
 
+int     tADSR_isActive(tADSR* const adsrenv)
+{
+    _tADSR* adsr = *adsrenv;
+    return adsr->inAttack || adsr->inDecay || adsr->inSustain || adsr->inRelease || adsr->inRamp;
+}
+
 float   tADSR_tick(tADSR* const adsrenv)
 {
     _tADSR* adsr = *adsrenv;
@@ -602,6 +700,13 @@ void tADSR2_off(tADSR2* const adsrenv)
     adsr->envTarget = 0.0f;
 }
 
+int     tADSR2_isActive(tADSR2* const adsrenv)
+{
+    _tADSR2* adsr = *adsrenv;
+    // the release is a one pole decay that never quite reaches zero
+    return adsr->gate || (adsr->env > leaf.silenceThreshold);
+}
+
 float   tADSR2_tick(tADSR2* const adsrenv)
 {
     _tADSR2* adsr = *adsrenv;
@@ -754,6 +859,12 @@ void tADSR3_off(tADSR3* const adsrenv)
     }
 }
 
+int     tADSR3_isActive(tADSR3* const adsrenv)
+{
+    _tADSR3* adsr = *adsrenv;
+    return adsr->state != env_idle;
+}
+
 float   tADSR3_tick(tADSR3* const adsrenv)
 {
     _tADSR3* adsr = *adsrenv;
@@ -935,6 +1046,12 @@ void tADSR4_off(tADSR4* const adsrenv)
     }
 }
 
+int     tADSR4_isActive(tADSR4* const adsrenv)
+{
+    _tADSR4* adsr = *adsrenv;
+    return adsr->whichStage != env_idle;
+}
+
 float   tADSR4_tick(tADSR4* const adsrenv)
 {
     _tADSR4* adsr = *adsrenv;
@@ -1224,6 +1341,34 @@ float   tRamp_tick(tRamp* const ramp)
     return r->curr;
 }
 
+void    tRamp_process(tRamp* const ramp, float* out, int n)
+{
+    _tRamp* r = *ramp;
+    
+    float curr = r->curr;
+    float inc = r->inc;
+    const float dest = r->dest;
+    int i = 0;
+    
+    // Ramp until the destination is reached, then fill the rest of the block with it
+    for (; (i < n) && (inc != 0.0f); i++)
+    {
+        curr += inc;
+        
+        if (((curr >= dest) && (inc > 0.0f)) || ((curr <= dest) && (inc < 0.0f)))
+        {
+            inc = 0.0f;
+            curr = dest;
+        }
+        
+        out[i] = curr;
+    }
+    for (; i < n; i++) out[i] = curr;
+    
+    r->curr = curr;
+    r->inc = inc;
+}
+
 float   tRamp_sample(tRamp* const ramp)
 {
     _tRamp* r = *ramp;
@@ -1444,6 +1589,23 @@ float   tExpSmooth_tick(tExpSmooth* const expsmooth)
     return smooth->curr;
 }
 
+void    tExpSmooth_process(tExpSmooth* const expsmooth, float* out, int n)
+{
+    _tExpSmooth* smooth = *expsmooth;
+    
+    const float target = smooth->factor*smooth->dest;
+    const float oneminusfactor = smooth->oneminusfactor;
+    float curr = smooth->curr;
+    
+    for (int i = 0; i < n; i++)
+    {
+        curr = target + oneminusfactor*curr;
+        out[i] = curr;
+    }
+    
+    smooth->curr = curr;
+}
+
 float   tExpSmooth_sample(tExpSmooth* const expsmooth)
 {
     _tExpSmooth* smooth = *expsmooth;
@@ -1550,3 +1712,33 @@ float tSlide_tick(tSlide* const sl, float in)
 	return s->currentOut;
 }
 
+void tSlide_process(tSlide* const sl, const float* input, float* output, int n)
+{
+	_tSlide* s = *sl;
+
+	const float invUpSlide = s->invUpSlide, invDownSlide = s->invDownSlide;
+	float prevOut = s->prevOut;
+	float in = s->prevIn;
+
+	for (int i = 0; i < n; i++)
+	{
+		in = input[i];
+		if (in >= prevOut)
+		{
+			prevOut = prevOut + ((in - prevOut) * invUpSlide);
+		}
+		else
+		{
+			prevOut = prevOut + ((in - prevOut) * invDownSlide);
+		}
+#ifdef NO_DENORMAL_CHECK
+#else
+		if (prevOut < VSF) prevOut = 0.0f;
+#endif
+		output[i] = prevOut;
+	}
+
+	s->prevIn = in;
+	s->prevOut = prevOut;
+	s->currentOut = prevOut;
+}
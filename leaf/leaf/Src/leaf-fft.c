@@ -0,0 +1,351 @@
+/*==============================================================================
+ 
+ leaf-fft.c
+ Created: 17 Oct 2026
+ 
+ ==============================================================================*/
+
+#if _WIN32 || _WIN64
+
+#include "..\Inc\leaf-fft.h"
+#include "..\leaf.h"
+
+#else
+
+#include "../Inc/leaf-fft.h"
+#include "../leaf.h"
+
+#endif
+
+// Vector units for the butterflies, if the target has one
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_FFT_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEAF_FFT_SSE 1
+#endif
+
+#define LEAF_FFT_TWO_PI 6.283185307179586
+
+void    tFFT_init(tFFT* const fft, int size, FFTType type)
+{
+    tFFT_initToPool(fft, size, type, &leaf.mempool);
+}
+
+void    tFFT_initToPool(tFFT* const fft, int size, FFTType type, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tFFT* f = *fft = (_tFFT*) mpool_alloc(sizeof(_tFFT), m);
+    f->mempool = m;
+    
+    f->type = type;
+    f->size = size;
+    f->complexSize = (type == FFTReal) ? size / 2 : size;
+    
+    int M = f->complexSize;
+    f->log2Size = 0;
+    while ((1 << f->log2Size) < M) f->log2Size++;
+    
+    f->bitReverse = (int*) mpool_alloc(sizeof(int) * M, m);
+    for (int i = 0; i < M; i++)
+    {
+        int r = 0;
+        for (int b = 0; b < f->log2Size; b++) r |= ((i >> b) & 1) << (f->log2Size - 1 - b);
+        f->bitReverse[i] = r;
+    }
+    
+    // One radix-2 pass first if log2Size is odd, then radix-4 stages combining
+    // four sub-transforms of q points each
+    int q0 = (f->log2Size & 1) ? 2 : 1;
+    int numTwiddles = 0;
+    for (int q = q0; q < M; q *= 4) numTwiddles += 4 * q;
+    f->twiddles = (float*) mpool_alloc(sizeof(float) * (numTwiddles > 0 ? numTwiddles : 1), m);
+    float* tw = f->twiddles;
+    for (int q = q0; q < M; q *= 4)
+    {
+        for (int k = 0; k < q; k++)
+        {
+            double a = -LEAF_FFT_TWO_PI * (double)k / (double)(4 * q);
+            tw[k]           = (float)cos(2.0 * a);
+            tw[q + k]       = (float)sin(2.0 * a);
+            tw[(2 * q) + k] = (float)cos(a);
+            tw[(3 * q) + k] = (float)sin(a);
+        }
+        tw += 4 * q;
+    }
+    
+    if (type == FFTReal)
+    {
+        int quarter = size / 4;
+        f->realTwiddles = (float*) mpool_alloc(sizeof(float) * 2 * (quarter + 1), m);
+        for (int k = 0; k <= quarter; k++)
+        {
+            double a = LEAF_FFT_TWO_PI * (double)k / (double)size;
+            f->realTwiddles[2 * k] = (float)cos(a);
+            f->realTwiddles[(2 * k) + 1] = (float)sin(a);
+        }
+        f->workReal = (float*) mpool_alloc(sizeof(float) * M, m);
+        f->workImag = (float*) mpool_alloc(sizeof(float) * M, m);
+    }
+    else
+    {
+        f->realTwiddles = NULL;
+        f->workReal = NULL;
+        f->workImag = NULL;
+    }
+}
+
+void    tFFT_free(tFFT* const fft)
+{
+    _tFFT* f = *fft;
+    
+    if (f->type == FFTReal)
+    {
+        mpool_free((char*)f->workImag, f->mempool);
+        mpool_free((char*)f->workReal, f->mempool);
+        mpool_free((char*)f->realTwiddles, f->mempool);
+    }
+    mpool_free((char*)f->twiddles, f->mempool);
+    mpool_free((char*)f->bitReverse, f->mempool);
+    mpool_free((char*)f, f->mempool);
+}
+
+int     tFFT_getSize(tFFT* const fft)
+{
+    _tFFT* f = *fft;
+    return f->size;
+}
+
+// Radix-4 decimation in time butterfly, written as two fused radix-2 passes so it works on
+// data in plain bit reversed order. a, b, c, d are k, k + q, k + 2q, k + 3q of a 4q point group.
+static inline void fft_butterfly4(float* re, float* im, int a, int q, float w2r, float w2i, float wr, float wi)
+{
+    int b = a + q, c = a + (2 * q), d = a + (3 * q);
+    
+    float bwr = (re[b] * w2r) - (im[b] * w2i);
+    float bwi = (re[b] * w2i) + (im[b] * w2r);
+    float dwr = (re[d] * w2r) - (im[d] * w2i);
+    float dwi = (re[d] * w2i) + (im[d] * w2r);
+    
+    float a1r = re[a] + bwr, a1i = im[a] + bwi;
+    float b1r = re[a] - bwr, b1i = im[a] - bwi;
+    float c1r = re[c] + dwr, c1i = im[c] + dwi;
+    float d1r = re[c] - dwr, d1i = im[c] - dwi;
+    
+    float cwr = (c1r * wr) - (c1i * wi);
+    float cwi = (c1r * wi) + (c1i * wr);
+    float dw2r = (d1r * wr) - (d1i * wi);
+    float dw2i = (d1r * wi) + (d1i * wr);
+    
+    re[a] = a1r + cwr;  im[a] = a1i + cwi;
+    re[c] = a1r - cwr;  im[c] = a1i - cwi;
+    // the second half of the group is a quarter turn further round, times -i
+    re[b] = b1r + dw2i; im[b] = b1i - dw2r;
+    re[d] = b1r - dw2i; im[d] = b1i + dw2r;
+}
+
+#if LEAF_FFT_SSE || LEAF_FFT_NEON
+
+#if LEAF_FFT_SSE
+typedef __m128 fftvec;
+#define FFT_LOAD(p)      _mm_loadu_ps(p)
+#define FFT_STORE(p, v)  _mm_storeu_ps((p), (v))
+#define FFT_ADD(a, b)    _mm_add_ps((a), (b))
+#define FFT_SUB(a, b)    _mm_sub_ps((a), (b))
+#define FFT_MUL(a, b)    _mm_mul_ps((a), (b))
+#else
+typedef float32x4_t fftvec;
+#define FFT_LOAD(p)      vld1q_f32(p)
+#define FFT_STORE(p, v)  vst1q_f32((p), (v))
+#define FFT_ADD(a, b)    vaddq_f32((a), (b))
+#define FFT_SUB(a, b)    vsubq_f32((a), (b))
+#define FFT_MUL(a, b)    vmulq_f32((a), (b))
+#endif
+
+// Four butterflies at once, k to k + 3 of the same group
+static inline void fft_butterfly4x4(float* re, float* im, int a, int q, const float* tw, int k)
+{
+    int b = a + q, c = a + (2 * q), d = a + (3 * q);
+    fftvec w2r = FFT_LOAD(&tw[k]), w2i = FFT_LOAD(&tw[q + k]);
+    fftvec wr = FFT_LOAD(&tw[(2 * q) + k]), wi = FFT_LOAD(&tw[(3 * q) + k]);
+    
+    fftvec ar = FFT_LOAD(&re[a]), ai = FFT_LOAD(&im[a]);
+    fftvec br = FFT_LOAD(&re[b]), bi = FFT_LOAD(&im[b]);
+    fftvec cr = FFT_LOAD(&re[c]), ci = FFT_LOAD(&im[c]);
+    fftvec dr = FFT_LOAD(&re[d]), di = FFT_LOAD(&im[d]);
+    
+    fftvec bwr = FFT_SUB(FFT_MUL(br, w2r), FFT_MUL(bi, w2i));
+    fftvec bwi = FFT_ADD(FFT_MUL(br, w2i), FFT_MUL(bi, w2r));
+    fftvec dwr = FFT_SUB(FFT_MUL(dr, w2r), FFT_MUL(di, w2i));
+    fftvec dwi = FFT_ADD(FFT_MUL(dr, w2i), FFT_MUL(di, w2r));
+    
+    fftvec a1r = FFT_ADD(ar, bwr), a1i = FFT_ADD(ai, bwi);
+    fftvec b1r = FFT_SUB(ar, bwr), b1i = FFT_SUB(ai, bwi);
+    fftvec c1r = FFT_ADD(cr, dwr), c1i = FFT_ADD(ci, dwi);
+    fftvec d1r = FFT_SUB(cr, dwr), d1i = FFT_SUB(ci, dwi);
+    
+    fftvec cwr = FFT_SUB(FFT_MUL(c1r, wr), FFT_MUL(c1i, wi));
+    fftvec cwi = FFT_ADD(FFT_MUL(c1r, wi), FFT_MUL(c1i, wr));
+    fftvec dw2r = FFT_SUB(FFT_MUL(d1r, wr), FFT_MUL(d1i, wi));
+    fftvec dw2i = FFT_ADD(FFT_MUL(d1r, wi), FFT_MUL(d1i, wr));
+    
+    FFT_STORE(&re[a], FFT_ADD(a1r, cwr));  FFT_STORE(&im[a], FFT_ADD(a1i, cwi));
+    FFT_STORE(&re[c], FFT_SUB(a1r, cwr));  FFT_STORE(&im[c], FFT_SUB(a1i, cwi));
+    FFT_STORE(&re[b], FFT_ADD(b1r, dw2i)); FFT_STORE(&im[b], FFT_SUB(b1i, dw2r));
+    FFT_STORE(&re[d], FFT_SUB(b1r, dw2i)); FFT_STORE(&im[d], FFT_ADD(b1i, dw2r));
+}
+
+#endif
+
+// Forward complex transform of bit reversed data, in place
+static void fft_stages(_tFFT* f, float* re, float* im)
+{
+    int M = f->complexSize;
+    int q = 1;
+    
+    if (f->log2Size & 1)
+    {
+        for (int i = 0; i < M; i += 2)
+        {
+            float tr = re[i + 1], ti = im[i + 1];
+            re[i + 1] = re[i] - tr; im[i + 1] = im[i] - ti;
+            re[i] += tr;            im[i] += ti;
+        }
+        q = 2;
+    }
+    
+    const float* tw = f->twiddles;
+    for (; q < M; q *= 4)
+    {
+        for (int group = 0; group < M; group += 4 * q)
+        {
+#if LEAF_FFT_SSE || LEAF_FFT_NEON
+            if (q >= 4)
+            {
+                for (int k = 0; k < q; k += 4) fft_butterfly4x4(re, im, group + k, q, tw, k);
+                continue;
+            }
+#endif
+            for (int k = 0; k < q; k++)
+            {
+                fft_butterfly4(re, im, group + k, q, tw[k], tw[q + k], tw[(2 * q) + k], tw[(3 * q) + k]);
+            }
+        }
+        tw += 4 * q;
+    }
+}
+
+static void fft_bitReverse(_tFFT* f, float* re, float* im)
+{
+    for (int i = 0; i < f->complexSize; i++)
+    {
+        int j = f->bitReverse[i];
+        if (i < j)
+        {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+}
+
+void    tFFT_forwardComplex(tFFT* const fft, float* real, float* imag)
+{
+    _tFFT* f = *fft;
+    fft_bitReverse(f, real, imag);
+    fft_stages(f, real, imag);
+}
+
+// The inverse is the forward transform with real and imaginary parts swapped on the way in and out
+void    tFFT_inverseComplex(tFFT* const fft, float* real, float* imag)
+{
+    _tFFT* f = *fft;
+    fft_bitReverse(f, imag, real);
+    fft_stages(f, imag, real);
+}
+
+void    tFFT_forward(tFFT* const fft, const float* input, float* output)
+{
+    _tFFT* f = *fft;
+    int M = f->complexSize;
+    float* re = f->workReal;
+    float* im = f->workImag;
+    
+    // Even samples as the real part and odd samples as the imaginary part of a half size transform
+    for (int i = 0; i < M; i++)
+    {
+        int j = f->bitReverse[i];
+        re[j] = input[2 * i];
+        im[j] = input[(2 * i) + 1];
+    }
+    fft_stages(f, re, im);
+    
+    // Split into the spectra of the even and odd samples and recombine.
+    // Bins k and M - k come out of the same pair of inputs.
+    output[0] = re[0] + im[0];
+    output[1] = re[0] - im[0];
+    for (int k = 1, j = M - 1; k < j; k++, j--)
+    {
+        float er = 0.5f * (re[k] + re[j]);
+        float ei = 0.5f * (im[k] - im[j]);
+        float orr = 0.5f * (im[k] + im[j]);
+        float oi = -0.5f * (re[k] - re[j]);
+        float c = f->realTwiddles[2 * k], s = f->realTwiddles[(2 * k) + 1];
+        // times e^(-i 2 pi k / size)
+        float tr = (orr * c) + (oi * s);
+        float ti = (oi * c) - (orr * s);
+        output[2 * k] = er + tr;
+        output[(2 * k) + 1] = ei + ti;
+        output[2 * j] = er - tr;
+        output[(2 * j) + 1] = ti - ei;
+    }
+    if (M > 1)
+    {
+        int h = M / 2;
+        output[2 * h] = re[h];
+        output[(2 * h) + 1] = -im[h];
+    }
+}
+
+void    tFFT_inverse(tFFT* const fft, const float* input, float* output)
+{
+    _tFFT* f = *fft;
+    int M = f->complexSize;
+    float* re = f->workReal;
+    float* im = f->workImag;
+    
+    // Rebuild the half size spectrum, times two so the result comes out scaled by size
+    re[0] = input[0] + input[1];
+    im[0] = input[0] - input[1];
+    for (int k = 1, j = M - 1; k < j; k++, j--)
+    {
+        float xr = input[2 * k], xi = input[(2 * k) + 1];
+        float yr = input[2 * j], yi = input[(2 * j) + 1];
+        float er = xr + yr, ei = xi - yi;
+        float dr = xr - yr, di = xi + yi;
+        float c = f->realTwiddles[2 * k], s = f->realTwiddles[(2 * k) + 1];
+        // odd part is (x[k] - conj x[M - k]) times e^(i 2 pi k / size)
+        float orr = (dr * c) - (di * s);
+        float oi = (dr * s) + (di * c);
+        // Z[k] = E + iO, Z[M - k] = conj(E) + i conj(O)
+        re[k] = er - oi;
+        im[k] = ei + orr;
+        re[j] = er + oi;
+        im[j] = orr - ei;
+    }
+    if (M > 1)
+    {
+        int h = M / 2;
+        re[h] = 2.0f * input[2 * h];
+        im[h] = -2.0f * input[(2 * h) + 1];
+    }
+    
+    fft_bitReverse(f, im, re);
+    fft_stages(f, im, re);
+    
+    for (int i = 0; i < M; i++)
+    {
+        output[2 * i] = re[i];
+        output[(2 * i) + 1] = im[i];
+    }
+}
@@ -65,13 +65,7 @@ float   tAllpass_tick(tAllpass* const ft, float input)
 {
     _tAllpass* f = *ft;
     
-    float s1 = (-f->gain) * f->lastOut + input;
-    
-    float s2 = tLinearDelay_tick(&f->delay, s1) + (f->gain) * input;
-    
-    f->lastOut = s2;
-    
-    return f->lastOut;
+    return _tAllpass_tick(f, f->delay, input);
 }
 
 // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ OnePole Filter ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ //
@@ -151,16 +145,26 @@ void    tOnePole_setGain(tOnePole* const ft, float gain)
 }
 
 float   tOnePole_tick(tOnePole* const ft, float input)
+{
+    return _tOnePole_tick(*ft, input);
+}
+
+void    tOnePole_process(tOnePole* const ft, const float* input, float* output, int n)
 {
     _tOnePole* f = *ft;
     
-    float in = input * f->gain;
-    float out = (f->b0 * in) + (f->a1 * f->lastOut);
+    const float gain = f->gain, b0 = f->b0, a1 = f->a1;
+    float in = f->lastIn, out = f->lastOut;
+    
+    for (int i = 0; i < n; i++)
+    {
+        in = input[i] * gain;
+        out = (b0 * in) + (a1 * out);
+        output[i] = out;
+    }
     
     f->lastIn = in;
     f->lastOut = out;
-    
-    return out;
 }
 
 // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ TwoPole Filter ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ //
@@ -203,6 +207,25 @@ float   tTwoPole_tick(tTwoPole* const ft, float input)
     return out;
 }
 
+void    tTwoPole_process(tTwoPole* const ft, const float* input, float* output, int n)
+{
+    _tTwoPole* f = *ft;
+    
+    const float gain = f->gain, b0 = f->b0, a1 = f->a1, a2 = f->a2;
+    float y1 = f->lastOut[0], y2 = f->lastOut[1];
+    
+    for (int i = 0; i < n; i++)
+    {
+        float out = (b0 * input[i] * gain) - (a1 * y1) - (a2 * y2);
+        y2 = y1;
+        y1 = out;
+        output[i] = out;
+    }
+    
+    f->lastOut[0] = y1;
+    f->lastOut[1] = y2;
+}
+
 void    tTwoPole_setB0(tTwoPole* const ft, float b0)
 {
     _tTwoPole* f = *ft;
@@ -636,6 +659,35 @@ float   tBiQuad_tick(tBiQuad* const ft, float input)
     return out;
 }
 
+void    tBiQuad_process(tBiQuad* const ft, const float* input, float* output, int n)
+{
+    _tBiQuad* f = *ft;
+    
+    const float gain = f->gain;
+    const float b0 = f->b0, b1 = f->b1, b2 = f->b2, a1 = f->a1, a2 = f->a2;
+    float x1 = f->lastIn[0], x2 = f->lastIn[1];
+    float y1 = f->lastOut[0], y2 = f->lastOut[1];
+    
+    for (int i = 0; i < n; i++)
+    {
+        float in = input[i] * gain;
+        float out = b0 * in + b1 * x1 + b2 * x2;
+        out -= a2 * y2 + a1 * y1;
+        
+        x2 = x1;
+        x1 = in;
+        y2 = y1;
+        y1 = out;
+        
+        output[i] = out;
+    }
+    
+    f->lastIn[0] = x1;
+    f->lastIn[1] = x2;
+    f->lastOut[0] = y1;
+    f->lastOut[1] = y2;
+}
+
 void    tBiQuad_setResonance(tBiQuad* const ft, float freq, float radius, oBool normalize)
 {
     _tBiQuad* f = *ft;
@@ -838,6 +890,31 @@ float   tSVF_tick(tSVF* const svff, float v0)
     return (v0 * svf->cH) + (v1 * svf->cB) + (svf->k * v1 * svf->cBK) + (v2 * svf->cL);
 }
 
+void    tSVF_process(tSVF* const svff, const float* input, float* output, int n)
+{
+    _tSVF* svf = *svff;
+    
+    const float a1 = svf->a1, a2 = svf->a2, a3 = svf->a3;
+    const float cH = svf->cH, cL = svf->cL;
+    const float cB = svf->cB + (svf->k * svf->cBK);
+    float ic1eq = svf->ic1eq, ic2eq = svf->ic2eq;
+    
+    for (int i = 0; i < n; i++)
+    {
+        float v0 = input[i];
+        float v3 = v0 - ic2eq;
+        float v1 = (a1 * ic1eq) + (a2 * v3);
+        float v2 = ic2eq + (a2 * ic1eq) + (a3 * v3);
+        ic1eq = (2.0f * v1) - ic1eq;
+        ic2eq = (2.0f * v2) - ic2eq;
+        
+        output[i] = (v0 * cH) + (v1 * cB) + (v2 * cL);
+    }
+    
+    svf->ic1eq = ic1eq;
+    svf->ic2eq = ic2eq;
+}
+
 void     tSVF_setFreq(tSVF* const svff, float freq)
 {
     _tSVF* svf = *svff;
@@ -869,6 +946,19 @@ void    tSVF_setFreqAndQ(tSVF* const svff, float freq, float Q)
     svf->a3 = svf->g * svf->a2;
 }
 
+int     tSVF_isActive(tSVF* const svff)
+{
+    _tSVF* svf = *svff;
+    return (fabsf(svf->ic1eq) > leaf.silenceThreshold) || (fabsf(svf->ic2eq) > leaf.silenceThreshold);
+}
+
+void    tSVF_clear(tSVF* const svff)
+{
+    _tSVF* svf = *svff;
+    svf->ic1eq = 0.0f;
+    svf->ic2eq = 0.0f;
+}
+
 // Efficient version of tSVF where frequency is set based on 12-bit integer input for lookup in tanh wavetable.
 void   tEfficientSVF_init(tEfficientSVF* const svff, SVFType type, uint16_t input, float Q)
 {
@@ -980,13 +1070,35 @@ float     tHighpass_getFreq(tHighpass* const ft)
     return f->frequency;
 }
 
+int     tHighpass_isActive(tHighpass* const ft)
+{
+    _tHighpass* f = *ft;
+    return (fabsf(f->xs) > leaf.silenceThreshold) || (fabsf(f->ys) > leaf.silenceThreshold);
+}
+
 // From JOS DC Blocker
 float   tHighpass_tick(tHighpass* const ft, float x)
+{
+    return _tHighpass_tick(*ft, x);
+}
+
+void    tHighpass_process(tHighpass* const ft, const float* input, float* output, int n)
 {
     _tHighpass* f = *ft;
-    f->ys = x - f->xs + f->R * f->ys;
-    f->xs = x;
-    return f->ys;
+    
+    const float R = f->R;
+    float xs = f->xs, ys = f->ys;
+    
+    for (int i = 0; i < n; i++)
+    {
+        float x = input[i];
+        ys = x - xs + R * ys;
+        xs = x;
+        output[i] = ys;
+    }
+    
+    f->xs = xs;
+    f->ys = ys;
 }
 
 void tHighpassSampleRateChanged(tHighpass* const ft)
@@ -1259,6 +1371,56 @@ float   tVZFilter_tick           	(tVZFilter* const vf, float in)
 
 }
 
+void    tVZFilter_process           (tVZFilter* const vf, const float* input, float* output, int n)
+{
+    _tVZFilter* f = *vf;
+    
+    const float g = f->g, h = f->h, R2g = f->R2 + f->g;
+    const float cL = f->cL, cB = f->cB, cH = f->cH;
+    float s1 = f->s1, s2 = f->s2;
+    
+    for (int i = 0; i < n; i++)
+    {
+        float yH = (input[i] - R2g*s1 - s2) * h;
+        
+        float yB = tanhf(g*yH) + s1;
+        s1 = g*yH + yB;
+        
+        float yL = tanhf(g*yB) + s2;
+        s2 = g*yB + yL;
+        
+        output[i] = cL*yL + cB*yB + cH*yH;
+    }
+    
+    f->s1 = s1;
+    f->s2 = s2;
+}
+
+void    tVZFilter_processEfficient  (tVZFilter* const vf, const float* input, float* output, int n)
+{
+    _tVZFilter* f = *vf;
+    
+    const float g = f->g, h = f->h, R2g = f->R2 + f->g;
+    const float cL = f->cL, cB = f->cB, cH = f->cH;
+    float s1 = f->s1, s2 = f->s2;
+    
+    for (int i = 0; i < n; i++)
+    {
+        float yH = (input[i] - R2g*s1 - s2) * h;
+        
+        float yB = (g*yH) + s1;
+        s1 = g*yH + yB;
+        
+        float yL = (g*yB) + s2;
+        s2 = g*yB + yL;
+        
+        output[i] = cL*yL + cB*yB + cH*yH;
+    }
+    
+    f->s1 = s1;
+    f->s2 = s2;
+}
+
 float   tVZFilter_tickEfficient           	(tVZFilter* const vf, float in)
 {
 	_tVZFilter* f = *vf;
@@ -1499,15 +1661,22 @@ void    tDiodeFilter_initToPool     (tDiodeFilter* const vf, float cutoff, float
 	 f->r = (7.f * resonance + 0.5f);
 	 f->Vt = 0.5f;
 	 f->n = 1.836f;
-	 f->zi = 0.0f; //previous input value
 	 f->gamma = f->Vt*f->n;
+	 tDiodeFilter_clear(vf);
+	 f->g0inv = 1.f/(2.f*f->Vt);
+	 f->g1inv = 1.f/(2.f*f->gamma);
+	 f->g2inv = 1.f/(6.f*f->gamma);
+}
+
+// small nonzero states so the ladder can start oscillating at high resonance
+void    tDiodeFilter_clear  (tDiodeFilter* const vf)
+{
+	 _tDiodeFilter* f = *vf;
+	 f->zi = 0.0f; //previous input value
 	 f->s0 = 0.01f;
 	 f->s1 = 0.02f;
 	 f->s2 = 0.03f;
 	 f->s3 = 0.04f;
-	 f->g0inv = 1.f/(2.f*f->Vt);
-	 f->g1inv = 1.f/(2.f*f->gamma);
-	 f->g2inv = 1.f/(6.f*f->gamma);
 }
 
 void    tDiodeFilter_free   (tDiodeFilter* const vf)
@@ -1542,24 +1711,12 @@ float   tDiodeFilter_tick           	(tDiodeFilter* const vf, float in)
 
 	// This formula gives the result for y3 thanks to MATLAB
 	float y3 = (f->s2 + f->s3 + t2*(f->s1 + f->s2 + f->s3 + t1*(f->s0 + f->s1 + f->s2 + f->s3 + t0*in)) + t1*(2.0f*f->s2 + 2.0f*f->s3))*t3 + f->s3 + 2.0f*f->s3*t1 + t2*(2.0f*f->s3 + 3.0f*f->s3*t1);
-//    if (isnan(y3))
-//    {
-//        __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, 400);
-//    }
 	float tempy3denom = (t4 + t1*(2.0f*t4 + 4.0f) + t2*(t4 + t1*(t4 + f->r*t0 + 4.0f) + 3.0f) + 2.0f)*t3 + t4 + t1*(2.0f*t4 + 2.0f) + t2*(2.0f*t4 + t1*(3.0f*t4 + 3.0f) + 2.0f) + 1.0f;
-//    if (isnan(tempy3denom))
-//    {
-//        __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, 400);
-//    }
 	if (tempy3denom == 0.0f)
 	{
 		tempy3denom = 0.000001f;
 	}
 	y3 = y3 / tempy3denom;
-//    if (isnan(y3))
-//    {
-//        __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, 400);
-//    }
 	if (t1 == 0.0f)
 	{
 		t1 = 0.000001f;
@@ -1580,15 +1737,6 @@ float   tDiodeFilter_tick           	(tDiodeFilter* const vf, float in)
 
 	// update state
 	f->s0 += 2.0f * (t0*xx + t1*(y1-y0));
-//    if (isnan(f->s0))
-//    {
-//        __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, 400);
-//    }
-
-//    if (isinf(f->s0))
-//    {
-//        __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, 400);
-//    }
 	f->s1 += 2.0f * (t2*(y2-y1) - t1*(y1-y0));
 	f->s2 += 2.0f * (t3*(y3-y2) - t2*(y2-y1));
 	f->s3 += 2.0f * (-t4*(y3) - t3*(y3-y2));
@@ -1598,6 +1746,55 @@ float   tDiodeFilter_tick           	(tDiodeFilter* const vf, float in)
 
 }
 
+void    tDiodeFilter_process        (tDiodeFilter* const vf, const float* input, float* output, int n)
+{
+    _tDiodeFilter* f = *vf;
+    
+    const float g = f->f, r = f->r;
+    const float g0inv = f->g0inv, g1inv = f->g1inv, g2inv = f->g2inv;
+    float s0 = f->s0, s1 = f->s1, s2 = f->s2, s3 = f->s3;
+    float zi = f->zi;
+    
+    for (int i = 0; i < n; i++)
+    {
+        float in = input[i];
+        float ih = 0.5f * (in + zi);
+        
+        float t0 = g*tanhXdX((ih - r * s3)*g0inv)*g0inv;
+        float t1 = g*tanhXdX((s1-s0)*g1inv)*g1inv;
+        float t2 = g*tanhXdX((s2-s1)*g1inv)*g1inv;
+        float t3 = g*tanhXdX((s3-s2)*g1inv)*g1inv;
+        float t4 = g*tanhXdX((s3)*g2inv)*g2inv;
+        
+        float y3 = (s2 + s3 + t2*(s1 + s2 + s3 + t1*(s0 + s1 + s2 + s3 + t0*in)) + t1*(2.0f*s2 + 2.0f*s3))*t3 + s3 + 2.0f*s3*t1 + t2*(2.0f*s3 + 3.0f*s3*t1);
+        float tempy3denom = (t4 + t1*(2.0f*t4 + 4.0f) + t2*(t4 + t1*(t4 + r*t0 + 4.0f) + 3.0f) + 2.0f)*t3 + t4 + t1*(2.0f*t4 + 2.0f) + t2*(2.0f*t4 + t1*(3.0f*t4 + 3.0f) + 2.0f) + 1.0f;
+        if (tempy3denom == 0.0f) tempy3denom = 0.000001f;
+        y3 = y3 / tempy3denom;
+        if (t1 == 0.0f) t1 = 0.000001f;
+        if (t2 == 0.0f) t2 = 0.000001f;
+        if (t3 == 0.0f) t3 = 0.000001f;
+        
+        float y2 = (s3 - (1+t4+t3)*y3) / (-t3);
+        float y1 = (s2 - (1+t3+t2)*y2 + t3*y3) / (-t2);
+        float y0 = (s1 - (1+t2+t1)*y1 + t2*y2) / (-t1);
+        float xx = (in - r*y3);
+        
+        s0 += 2.0f * (t0*xx + t1*(y1-y0));
+        s1 += 2.0f * (t2*(y2-y1) - t1*(y1-y0));
+        s2 += 2.0f * (t3*(y3-y2) - t2*(y2-y1));
+        s3 += 2.0f * (-t4*(y3) - t3*(y3-y2));
+        
+        zi = in;
+        output[i] = y3*r;
+    }
+    
+    f->s0 = s0;
+    f->s1 = s1;
+    f->s2 = s2;
+    f->s3 = s3;
+    f->zi = zi;
+}
+
 
 
 void    tDiodeFilter_setFreq     (tDiodeFilter* const vf, float cutoff)
@@ -1614,3 +1811,323 @@ void    tDiodeFilter_setQ     (tDiodeFilter* const vf, float resonance)
 
 }
 
+//============================================================================================================
+// Filter cascade
+//============================================================================================================
+
+void    tFilterCascade_init(tFilterCascade* const fc, int numSections, int numChannels)
+{
+    tFilterCascade_initToPool(fc, numSections, numChannels, &leaf.mempool);
+}
+
+void    tFilterCascade_initToPool(tFilterCascade* const fc, int numSections, int numChannels, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tFilterCascade* f = *fc = (_tFilterCascade*) mpool_alloc(sizeof(_tFilterCascade), m);
+    f->mempool = m;
+    
+    f->numSections = numSections;
+    f->numChannels = numChannels;
+    
+    f->coeffs = (float*) mpool_alloc(sizeof(float) * 5 * numSections, m);
+    f->state = (float*) mpool_alloc(sizeof(float) * 2 * numSections * numChannels, m);
+    
+    // Start with every section passing straight through
+    for (int s = 0; s < numSections; s++)
+    {
+        tFilterCascade_setSection(fc, s, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    tFilterCascade_clear(fc);
+}
+
+void    tFilterCascade_free(tFilterCascade* const fc)
+{
+    _tFilterCascade* f = *fc;
+    
+    mpool_free((char*)f->state, f->mempool);
+    mpool_free((char*)f->coeffs, f->mempool);
+    mpool_free((char*)f, f->mempool);
+}
+
+void    tFilterCascade_clear(tFilterCascade* const fc)
+{
+    _tFilterCascade* f = *fc;
+    
+    for (int i = 0; i < 2 * f->numSections * f->numChannels; i++) f->state[i] = 0.0f;
+}
+
+void    tFilterCascade_setSection(tFilterCascade* const fc, int section, float b0, float b1, float b2, float a1, float a2)
+{
+    _tFilterCascade* f = *fc;
+    
+    if (section < 0 || section >= f->numSections) return;
+    
+    float* c = &f->coeffs[5 * section];
+    c[0] = b0;
+    c[1] = b1;
+    c[2] = b2;
+    c[3] = a1;
+    c[4] = a2;
+}
+
+void    tFilterCascade_setSectionFromBiQuad(tFilterCascade* const fc, int section, tBiQuad* const ft)
+{
+    _tBiQuad* b = *ft;
+    
+    // tBiQuad scales its input by gain, which folds into the feedforward coefficients
+    tFilterCascade_setSection(fc, section, b->b0 * b->gain, b->b1 * b->gain, b->b2 * b->gain, b->a1, b->a2);
+}
+
+// Bilinear transform of H(s) = (m0*s^2 + m1*s + m2) / (s^2 + k*s + 1), with the cutoff already prewarped into g.
+// This is the linear response of the trapezoidal SVFs, where m0, m1 and m2 mix the high, band and low outputs.
+static void tFilterCascade_setSectionFromSVFCoeffs(tFilterCascade* const fc, int section, float g, float k, float m0, float m1, float m2)
+{
+    float gg = g * g;
+    float a0 = 1.0f / (1.0f + (k * g) + gg);
+    
+    float b0 = (m0 + (m1 * g) + (m2 * gg)) * a0;
+    float b1 = 2.0f * ((m2 * gg) - m0) * a0;
+    float b2 = (m0 - (m1 * g) + (m2 * gg)) * a0;
+    float a1 = 2.0f * (gg - 1.0f) * a0;
+    float a2 = (1.0f - (k * g) + gg) * a0;
+    
+    tFilterCascade_setSection(fc, section, b0, b1, b2, a1, a2);
+}
+
+void    tFilterCascade_setSectionFromSVF(tFilterCascade* const fc, int section, tSVF* const svff)
+{
+    _tSVF* svf = *svff;
+    
+    // tSVF mixes in the input itself rather than the highpass output, so fold that into all three terms
+    float m1 = svf->cB + (svf->k * svf->cBK);
+    tFilterCascade_setSectionFromSVFCoeffs(fc, section, svf->g, svf->k, svf->cH, m1 + (svf->k * svf->cH), svf->cL + svf->cH);
+}
+
+// Matches tVZFilter_tickEfficient, the saturating tVZFilter_tick has no exact biquad equivalent
+void    tFilterCascade_setSectionFromVZFilter(tFilterCascade* const fc, int section, tVZFilter* const vf)
+{
+    _tVZFilter* v = *vf;
+    
+    tFilterCascade_setSectionFromSVFCoeffs(fc, section, v->g, v->R2, v->cH, v->cB, v->cL);
+}
+
+float   tFilterCascade_tick(tFilterCascade* const fc, float input)
+{
+    float output;
+    tFilterCascade_process(fc, 0, &input, &output, 1);
+    return output;
+}
+
+// Runs every section over n samples spaced stride apart. One section goes over the whole block
+// at a time so its coefficients and state stay in registers; the first section reads the input
+// and the rest work in place on the output.
+static void tFilterCascade_run(_tFilterCascade* f, float* state, const float* input, float* output, int n, int stride)
+{
+    const float* in = input;
+    for (int s = 0; s < f->numSections; s++)
+    {
+        const float* c = &f->coeffs[5 * s];
+        const float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        float z1 = state[2 * s], z2 = state[2 * s + 1];
+        
+        for (int i = 0; i < n * stride; i += stride)
+        {
+            float x = in[i];
+            float y = (b0 * x) + z1;
+            z1 = (b1 * x) - (a1 * y) + z2;
+            z2 = (b2 * x) - (a2 * y);
+            output[i] = y;
+        }
+        
+        state[2 * s] = z1;
+        state[2 * s + 1] = z2;
+        in = output;
+    }
+    
+    if (f->numSections == 0 && input != output)
+    {
+        for (int i = 0; i < n * stride; i += stride) output[i] = input[i];
+    }
+}
+
+void    tFilterCascade_process(tFilterCascade* const fc, int channel, const float* input, float* output, int n)
+{
+    _tFilterCascade* f = *fc;
+    
+    if (channel < 0 || channel >= f->numChannels) return;
+    
+    tFilterCascade_run(f, &f->state[2 * f->numSections * channel], input, output, n, 1);
+}
+
+void    tFilterCascade_processInterleaved(tFilterCascade* const fc, const float* input, float* output, int numFrames)
+{
+    _tFilterCascade* f = *fc;
+    
+    // Each channel is a strided walk through the same buffers with its own state
+    for (int ch = 0; ch < f->numChannels; ch++)
+    {
+        tFilterCascade_run(f, &f->state[2 * f->numSections * ch], &input[ch], &output[ch], numFrames, f->numChannels);
+    }
+}
+
+//==============================================================================
+// Partitioned convolution
+
+void    tConvolver_init(tConvolver* const cv, const float* ir, int irLength, int blockSize)
+{
+    tConvolver_initToPool(cv, ir, irLength, blockSize, &leaf.mempool);
+}
+
+void    tConvolver_initToPool(tConvolver* const cv, const float* ir, int irLength, int blockSize, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tConvolver* c = *cv = (_tConvolver*) mpool_alloc(sizeof(_tConvolver), m);
+    c->mempool = m;
+    
+    c->blockSize = blockSize;
+    c->fftSize = blockSize * 2;
+    c->maxPartitions = (irLength + blockSize - 1) / blockSize;
+    if (c->maxPartitions < 1) c->maxPartitions = 1;
+    
+    tFFT_initToPool(&c->fft, c->fftSize, FFTReal, mp);
+    c->irSpectra = (float*) mpool_alloc(sizeof(float) * c->fftSize * c->maxPartitions, m);
+    c->fdl = (float*) mpool_alloc(sizeof(float) * c->fftSize * c->maxPartitions, m);
+    c->inputBuffer = (float*) mpool_alloc(sizeof(float) * c->fftSize, m);
+    c->outputBuffer = (float*) mpool_alloc(sizeof(float) * c->blockSize, m);
+    c->accum = (float*) mpool_alloc(sizeof(float) * c->fftSize, m);
+    
+    tConvolver_setIR(cv, ir, irLength);
+    tConvolver_clear(cv);
+}
+
+void    tConvolver_free(tConvolver* const cv)
+{
+    _tConvolver* c = *cv;
+    
+    mpool_free((char*)c->accum, c->mempool);
+    mpool_free((char*)c->outputBuffer, c->mempool);
+    mpool_free((char*)c->inputBuffer, c->mempool);
+    mpool_free((char*)c->fdl, c->mempool);
+    mpool_free((char*)c->irSpectra, c->mempool);
+    tFFT_free(&c->fft);
+    mpool_free((char*)c, c->mempool);
+}
+
+void    tConvolver_setIR(tConvolver* const cv, const float* ir, int irLength)
+{
+    _tConvolver* c = *cv;
+    
+    int maxLength = c->maxPartitions * c->blockSize;
+    if (irLength > maxLength) irLength = maxLength;
+    c->numPartitions = (irLength + c->blockSize - 1) / c->blockSize;
+    if (c->numPartitions < 1) c->numPartitions = 1;
+    
+    // Fold the inverse FFT's 1/N into the IR so the block loop doesn't have to scale
+    float scale = 1.0f / (float)c->fftSize;
+    for (int p = 0; p < c->numPartitions; p++)
+    {
+        float* h = &c->irSpectra[p * c->fftSize];
+        for (int i = 0; i < c->blockSize; i++)
+        {
+            int j = (p * c->blockSize) + i;
+            h[i] = (j < irLength) ? ir[j] * scale : 0.0f;
+        }
+        for (int i = c->blockSize; i < c->fftSize; i++) h[i] = 0.0f;
+        tFFT_forward(&c->fft, h, h);
+    }
+}
+
+void    tConvolver_clear(tConvolver* const cv)
+{
+    _tConvolver* c = *cv;
+    
+    for (int i = 0; i < c->fftSize * c->maxPartitions; i++) c->fdl[i] = 0.0f;
+    for (int i = 0; i < c->fftSize; i++) c->inputBuffer[i] = 0.0f;
+    for (int i = 0; i < c->blockSize; i++) c->outputBuffer[i] = 0.0f;
+    c->fdlHead = 0;
+    c->pos = 0;
+}
+
+int     tConvolver_getLatency(tConvolver* const cv)
+{
+    _tConvolver* c = *cv;
+    return c->blockSize;
+}
+
+// acc += x * h, for spectra in tFFT's packed layout: DC and Nyquist are real and
+// sit at [0] and [1], then bin k is at [2k] and [2k + 1]
+static void tConvolver_multiplyAccumulate(float* acc, const float* x, const float* h, int N)
+{
+    acc[0] += x[0] * h[0];
+    acc[1] += x[1] * h[1];
+    for (int i = 2; i < N; i += 2)
+    {
+        float xr = x[i], xi = x[i + 1];
+        float hr = h[i], hi = h[i + 1];
+        acc[i] += (xr * hr) - (xi * hi);
+        acc[i + 1] += (xr * hi) + (xi * hr);
+    }
+}
+
+static void tConvolver_convolveBlock(_tConvolver* c)
+{
+    int N = c->fftSize;
+    int B = c->blockSize;
+    
+    float* x = &c->fdl[c->fdlHead * N];
+    tFFT_forward(&c->fft, c->inputBuffer, x);
+    
+    for (int i = 0; i < N; i++) c->accum[i] = 0.0f;
+    int slot = c->fdlHead;
+    for (int p = 0; p < c->numPartitions; p++)
+    {
+        tConvolver_multiplyAccumulate(c->accum, &c->fdl[slot * N], &c->irSpectra[p * N], N);
+        if (--slot < 0) slot = c->maxPartitions - 1;
+    }
+    tFFT_inverse(&c->fft, c->accum, c->accum);
+    
+    // Overlap-save: only the second half is free of circular wraparound
+    for (int i = 0; i < B; i++)
+    {
+        c->outputBuffer[i] = c->accum[B + i];
+        c->inputBuffer[i] = c->inputBuffer[B + i];
+    }
+    
+    if (++c->fdlHead >= c->maxPartitions) c->fdlHead = 0;
+}
+
+float   tConvolver_tick(tConvolver* const cv, float input)
+{
+    float output;
+    tConvolver_process(cv, &input, &output, 1);
+    return output;
+}
+
+void    tConvolver_process(tConvolver* const cv, const float* input, float* output, int n)
+{
+    _tConvolver* c = *cv;
+    
+    int done = 0;
+    while (done < n)
+    {
+        // Run up to the end of the current block, then convolve it
+        int count = c->blockSize - c->pos;
+        if (count > n - done) count = n - done;
+        
+        float* in = &c->inputBuffer[c->blockSize + c->pos];
+        const float* out = &c->outputBuffer[c->pos];
+        for (int i = 0; i < count; i++)
+        {
+            in[i] = input[done + i];
+            output[done + i] = out[i];
+        }
+        done += count;
+        c->pos += count;
+        
+        if (c->pos == c->blockSize)
+        {
+            tConvolver_convolveBlock(c);
+            c->pos = 0;
+        }
+    }
+}
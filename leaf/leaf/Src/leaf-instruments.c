@@ -52,6 +52,7 @@ void        t808Cowbell_initToPool      (t808Cowbell* const cowbellInst, int use
     tEnvelope_initToPool(&cowbell->envStick, 5.0f, 5.0f, 0, mp);
     
     cowbell->useStick = useStick;
+    cowbell->active = 0;
 }
 
 void        t808Cowbell_free    (t808Cowbell* const cowbellInst)
@@ -78,12 +79,16 @@ void t808Cowbell_on(t808Cowbell* const cowbellInst, float vel)
     
     if (cowbell->useStick)
         tEnvelope_on(&cowbell->envStick,vel);
+    
+    cowbell->active = 1;
 }
 
 float t808Cowbell_tick(t808Cowbell* const cowbellInst)
 {
     _t808Cowbell* cowbell = *cowbellInst;
     
+    if (!cowbell->active) return 0.0f;
+    
     float sample = 0.0f;
     
     // Mix oscillators.
@@ -101,6 +106,12 @@ float t808Cowbell_tick(t808Cowbell* const cowbellInst)
     
     sample = tHighpass_tick(&cowbell->highpass, sample);
     
+    if (!tEnvelope_isActive(&cowbell->envGain) && !tEnvelope_isActive(&cowbell->envStick) &&
+        !tHighpass_isActive(&cowbell->highpass))
+    {
+        cowbell->active = 0;
+    }
+    
     return sample;
 }
 
@@ -141,6 +152,12 @@ void t808Cowbell_setStick(t808Cowbell* const cowbellInst, int useStick)
     cowbell->useStick = useStick;
 }
 
+int t808Cowbell_isActive(t808Cowbell* const cowbellInst)
+{
+    _t808Cowbell* cowbell = *cowbellInst;
+    return cowbell->active;
+}
+
 // ----------------- HIHAT ----------------------------//
 
 void t808Hihat_init(t808Hihat* const hihatInst)
@@ -181,6 +198,8 @@ void    t808Hihat_initToPool  (t808Hihat* const hihatInst, tMempool* const mp)
     tSquare_setFreq(&hihat->p[3], 5.43f * hihat->freq);
     tSquare_setFreq(&hihat->p[4], 6.79f * hihat->freq);
     tSquare_setFreq(&hihat->p[5], 8.21f * hihat->freq);
+    
+    hihat->active = 0;
 }
 
 void    t808Hihat_free  (t808Hihat* const hihatInst)
@@ -211,6 +230,7 @@ void t808Hihat_on(t808Hihat* const hihatInst, float vel)
     _t808Hihat* hihat = *hihatInst;
     tEnvelope_on(&hihat->envGain, vel);
     tEnvelope_on(&hihat->envStick, vel);
+    hihat->active = 1;
 }
 
 void t808Hihat_setOscNoiseMix(t808Hihat* const hihatInst, float oscNoiseMix)
@@ -223,6 +243,8 @@ float t808Hihat_tick(t808Hihat* const hihatInst)
 {
     _t808Hihat* hihat = *hihatInst;
     
+    if (!hihat->active) return 0.0f;
+    
     float sample = 0.0f;
     float gainScale = 0.1666f;
 
@@ -251,6 +273,13 @@ float t808Hihat_tick(t808Hihat* const hihatInst)
     sample = tHighpass_tick(&hihat->highpass, sample);
     sample += ((0.5f * tEnvelope_tick(&hihat->envStick)) * tSVF_tick(&hihat->bandpassStick, tNoise_tick(&hihat->stick)));
     sample = tanhf(sample * 2.0f);
+    
+    // the bandpasses are ahead of the envelopes, only the highpass can still ring
+    if (!tEnvelope_isActive(&hihat->envGain) && !tEnvelope_isActive(&hihat->envStick) &&
+        !tHighpass_isActive(&hihat->highpass))
+    {
+        hihat->active = 0;
+    }
 
     return sample;
 }
@@ -309,6 +338,12 @@ void t808Hihat_setOscFreq(t808Hihat* const hihatInst, float freq)
     hihat->freq = freq;
 }
 
+int t808Hihat_isActive(t808Hihat* const hihatInst)
+{
+    _t808Hihat* hihat = *hihatInst;
+    return hihat->active;
+}
+
 // ----------------- SNARE ----------------------------//
 
 void t808Snare_init (t808Snare* const snareInst)
@@ -344,6 +379,7 @@ void    t808Snare_initToPool    (t808Snare* const snareInst, tMempool* const mp)
     tEnvelope_initToPool(&snare->noiseEnvGain, 0.0f, 100.0f, OFALSE, mp);
     tEnvelope_initToPool(&snare->noiseEnvFilter, 0.0f, 1000.0f, OFALSE, mp);
     snare->noiseGain = 1.0f;
+    snare->active = 0;
 }
 
 void    t808Snare_free  (t808Snare* const snareInst)
@@ -380,6 +416,7 @@ void t808Snare_on(t808Snare* const snareInst, float vel)
     
     tEnvelope_on(&snare->noiseEnvGain, vel);
     tEnvelope_on(&snare->noiseEnvFilter, vel);
+    snare->active = 1;
 }
 
 void t808Snare_setTone1Freq(t808Snare* const snareInst, float freq)
@@ -432,12 +469,20 @@ void t808Snare_setNoiseFilterQ(t808Snare* const snareInst, float noiseFilterQ)
     tSVF_setQ(&snare->noiseLowpass, noiseFilterQ);
 }
 
+int t808Snare_isActive(t808Snare* const snareInst)
+{
+    _t808Snare* snare = *snareInst;
+    return snare->active;
+}
+
 static float tone[2];
 
 float t808Snare_tick(t808Snare* const snareInst)
 {
     _t808Snare* snare = *snareInst;
     
+    if (!snare->active) return 0.0f;
+    
     for (int i = 0; i < 2; i++)
     {
         tTriangle_setFreq(&snare->tone[i], snare->tone1Freq + (20.0f * tEnvelope_tick(&snare->toneEnvOsc[i])));
@@ -453,6 +498,13 @@ float t808Snare_tick(t808Snare* const snareInst)
     
     float sample = (snare->toneNoiseMix)*(tone[0] * snare->toneGain[0] + tone[1] * snare->toneGain[1]) + (1.0f-snare->toneNoiseMix) * (noise * snare->noiseGain);
     sample = tanhf(sample * 2.0f);
+    
+    // every filter is ahead of its gain envelope, so the snare is silent once those are done
+    if (!tEnvelope_isActive(&snare->noiseEnvGain) && !tEnvelope_isActive(&snare->toneEnvGain[0]) &&
+        !tEnvelope_isActive(&snare->toneEnvGain[1]))
+    {
+        snare->active = 0;
+    }
     return sample;
 }
 
@@ -481,6 +533,7 @@ void t808Kick_initToPool (t808Kick* const kickInst, tMempool* const mp)
     tNoise_initToPool(&kick->noiseOsc, PinkNoise, mp);
     tEnvelope_initToPool(&kick->noiseEnvGain, 0.0f, 1.0f, OFALSE, mp);
     kick->noiseGain = 0.3f;
+    kick->active = 0;
 }
 
 void    t808Kick_free   (t808Kick* const kickInst)
@@ -502,11 +555,19 @@ float       t808Kick_tick                  (t808Kick* const kickInst)
 {
     _t808Kick* kick = *kickInst;
     
+    if (!kick->active) return 0.0f;
+    
 	tCycle_setFreq(&kick->tone, (kick->toneInitialFreq * (1.0f + (kick->chirpRatioMinusOne * tEnvelope_tick(&kick->toneEnvOscChirp)))) + (kick->sighAmountInHz * tEnvelope_tick(&kick->toneEnvOscSigh)));
 	float sample = tCycle_tick(&kick->tone) * tEnvelope_tick(&kick->toneEnvGain);
 	sample+= tNoise_tick(&kick->noiseOsc) * tEnvelope_tick(&kick->noiseEnvGain);
 	//add distortion here
 	sample = tSVF_tick(&kick->toneLowpass, sample);
+	
+	if (!tEnvelope_isActive(&kick->toneEnvGain) && !tEnvelope_isActive(&kick->noiseEnvGain) &&
+	    !tSVF_isActive(&kick->toneLowpass))
+	{
+		kick->active = 0;
+	}
 	return sample;
 }
 
@@ -517,7 +578,7 @@ void        t808Kick_on                    (t808Kick* const kickInst, float vel)
 	tEnvelope_on(&kick->toneEnvOscSigh, vel);
 	tEnvelope_on(&kick->toneEnvGain, vel);
 	tEnvelope_on(&kick->noiseEnvGain, vel);
-
+	kick->active = 1;
 }
 void        t808Kick_setToneFreq          (t808Kick* const kickInst, float freq)
 {
@@ -540,4 +601,10 @@ void        t808Kick_setToneNoiseMix       (t808Kick* const kickInst, float tone
 void        t808Kick_setNoiseFilterFreq    (t808Kick* const kickInst, float noiseFilterFreq);
 void        t808Kick_setNoiseFilterQ       (t808Kick* const kickInst, float noiseFilterQ);
 
+int         t808Kick_isActive              (t808Kick* const kickInst)
+{
+    _t808Kick* kick = *kickInst;
+    return kick->active;
+}
+
 
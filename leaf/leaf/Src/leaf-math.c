@@ -384,6 +384,70 @@ float LEAF_tanh(float x)
         return x * ( 27.0f + x * x ) / ( 27.0f + 9.0f * x * x );
 }
 
+#define wX1 -3.684303659906469f
+#define wX2 1.972967391708859f
+#define wA  9.451797158780131e-3f
+#define wB  0.1126446405111627f
+#define wY  0.4451353886588814f
+#define wK  0.5836596684310648f
+float LEAF_wrightOmega3(float x)
+{
+    if (x <= wX1)
+    {
+        return 0;
+    }
+    else if (x < wX2)
+    {
+        return (wA * x*x*x) + (wB * x*x) + (wY * x) + wK;
+    }
+    else
+    {
+        return x - logf(x);
+    }
+}
+
+float LEAF_wrightOmega4(float x)
+{
+    float w3 = LEAF_wrightOmega3(x);
+    return w3 - ((w3 - expf(x - w3)) / (w3 + 1.0f));
+}
+
+int LEAF_checkNumerics(const float* buffer, int n)
+{
+    // One cheap pass for anything with an all ones or all zeros exponent (except zero
+    // itself), and only if that finds something, a second one to say what it was
+    uint32_t special = 0;
+    for (int i = 0; i < n; i++)
+    {
+        union { float f; uint32_t u; } v;
+        v.f = buffer[i];
+        uint32_t e = v.u & 0x7F800000;
+        special |= (e == 0x7F800000) | ((e == 0) & ((v.u & 0x007FFFFF) != 0));
+    }
+    if (!special) return 0;
+    
+    int flags = 0;
+    for (int i = 0; i < n; i++)
+    {
+        union { float f; uint32_t u; } v;
+        v.f = buffer[i];
+        uint32_t e = v.u & 0x7F800000;
+        uint32_t m = v.u & 0x007FFFFF;
+        if (e == 0x7F800000) flags |= (m != 0) ? LEAF_NUMERIC_NAN : LEAF_NUMERIC_INF;
+        else if ((e == 0) && (m != 0)) flags |= LEAF_NUMERIC_DENORMAL;
+    }
+    return flags;
+}
+
+// Relative error under 6e-7 from -30 to 900
+float LEAF_wrightOmega(float x)
+{
+    float w = LEAF_wrightOmega4(x);
+    float r = x - w - logf(w);
+    float q = 2.0f * (1.0f + w) * (1.0f + w + (0.6666667f * r));
+    return w * (1.0f + ((r / (1.0f + w)) * ((q - r) / (q - (2.0f * r)))));
+}
+
 
 void LEAF_generate_sine(float* buffer, int size)
 {
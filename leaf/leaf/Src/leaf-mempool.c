@@ -55,16 +55,42 @@ static inline size_t mpool_align(size_t size);
 static inline mpool_node_t* create_node(char* block_location, mpool_node_t* next, mpool_node_t* prev, size_t size);
 static inline void delink_node(mpool_node_t* node);
 
+static void tlsf_create(_tMempool* pool);
+static char* tlsf_alloc(size_t asize, _tMempool* pool);
+static void tlsf_free(char* ptr, _tMempool* pool);
+
+static inline void mpool_record_alloc(_tMempool* pool, size_t size, uint32_t walk);
+static inline void mpool_record_free(_tMempool* pool, size_t size, uint32_t walk);
+static inline void mpool_alloc_failed(_tMempool* pool);
+
 /**
  * create memory pool
  */
 void mpool_create (char* memory, size_t size, _tMempool* pool)
+{
+    mpool_create_with_type(memory, size, MempoolFirstFit, pool);
+}
+
+void mpool_create_with_type (char* memory, size_t size, MempoolType type, _tMempool* pool)
 {
     leaf.header_size = mpool_align(sizeof(mpool_node_t));
     
     pool->mpool = (char*)memory;
     pool->usize  = 0;
     pool->msize  = size;
+    pool->type = type;
+    pool->tlsf = NULL;
+    pool->peak_usize = 0;
+    pool->num_blocks = 0;
+    pool->failed_allocs = 0;
+    pool->max_walk = 0;
+    
+    if (type == MempoolSegregatedFit)
+    {
+        pool->head = NULL;
+        tlsf_create(pool);
+        return;
+    }
     
     pool->head = create_node(pool->mpool, NULL, NULL, pool->msize-leaf.header_size);
     
@@ -89,27 +115,31 @@ void leaf_pool_init(char* memory, size_t size)
  */
 char* mpool_alloc(size_t asize, _tMempool* pool)
 {
+    if (pool->type == MempoolSegregatedFit) return tlsf_alloc(asize, pool);
+    
     // If the head is NULL, the mempool is full
     if (pool->head == NULL)
     {
-        leaf_mempool_overrun();
+        mpool_alloc_failed(pool);
         return NULL;
     }
     
     // Should we alloc the first block large enough or check all blocks and pick the one closest in size?
     size_t size_to_alloc = mpool_align(asize);
     mpool_node_t* node_to_alloc = pool->head;
+    uint32_t walk = 1;
     
     // Traverse the free list for a large enough block
     while (node_to_alloc->size < size_to_alloc)
     {
         node_to_alloc = node_to_alloc->next;
+        walk++;
         
         // If we reach the end of the free list, there
         // are no blocks large enough, return NULL
         if (node_to_alloc == NULL)
         {
-            leaf_mempool_overrun();
+            mpool_alloc_failed(pool);
             return NULL;
         }
     }
@@ -126,6 +156,12 @@ char* mpool_alloc(size_t asize, _tMempool* pool)
                                node_to_alloc->next,
                                node_to_alloc->prev,
                                leftover - leaf.header_size);
+        
+        // The leftover takes the allocated node's place in the free list
+        if (new_node->next != NULL) new_node->next->prev = new_node;
+        if (new_node->prev != NULL) new_node->prev->next = new_node;
+        node_to_alloc->next = NULL;
+        node_to_alloc->prev = NULL;
     }
     else
     {
@@ -133,6 +169,9 @@ char* mpool_alloc(size_t asize, _tMempool* pool)
         node_to_alloc->size += leftover;
         
         new_node = node_to_alloc->next;
+        
+        // Remove the allocated node from the free list
+        delink_node(node_to_alloc);
     }
     
     // Update the head if we are allocating the first node of the free list
@@ -142,10 +181,7 @@ char* mpool_alloc(size_t asize, _tMempool* pool)
         pool->head = new_node;
     }
     
-    // Remove the allocated node from the free list
-    delink_node(node_to_alloc);
-    
-    pool->usize += leaf.header_size + node_to_alloc->size;
+    mpool_record_alloc(pool, node_to_alloc->size, walk);
     
     if (leaf.clearOnAllocation > 0)
     {
@@ -163,27 +199,40 @@ char* mpool_alloc(size_t asize, _tMempool* pool)
  */
 char* mpool_calloc(size_t asize, _tMempool* pool)
 {
+    if (pool->type == MempoolSegregatedFit)
+    {
+        char* block = tlsf_alloc(asize, pool);
+        if (block != NULL)
+        {
+            size_t size = ((mpool_tlsf_node_t*)(block - leaf.header_size))->size;
+            for (size_t i = 0; i < size; i++) block[i] = 0;
+        }
+        return block;
+    }
+    
     // If the head is NULL, the mempool is full
     if (pool->head == NULL)
     {
-        leaf_mempool_overrun();
+        mpool_alloc_failed(pool);
         return NULL;
     }
     
     // Should we alloc the first block large enough or check all blocks and pick the one closest in size?
     size_t size_to_alloc = mpool_align(asize);
     mpool_node_t* node_to_alloc = pool->head;
+    uint32_t walk = 1;
     
     // Traverse the free list for a large enough block
     while (node_to_alloc->size < size_to_alloc)
     {
         node_to_alloc = node_to_alloc->next;
+        walk++;
         
         // If we reach the end of the free list, there
         // are no blocks large enough, return NULL
         if (node_to_alloc == NULL)
         {
-            leaf_mempool_overrun();
+            mpool_alloc_failed(pool);
             return NULL;
         }
     }
@@ -200,6 +249,12 @@ char* mpool_calloc(size_t asize, _tMempool* pool)
                                node_to_alloc->next,
                                node_to_alloc->prev,
                                leftover - leaf.header_size);
+        
+        // The leftover takes the allocated node's place in the free list
+        if (new_node->next != NULL) new_node->next->prev = new_node;
+        if (new_node->prev != NULL) new_node->prev->next = new_node;
+        node_to_alloc->next = NULL;
+        node_to_alloc->prev = NULL;
     }
     else
     {
@@ -207,6 +262,9 @@ char* mpool_calloc(size_t asize, _tMempool* pool)
         node_to_alloc->size += leftover;
         
         new_node = node_to_alloc->next;
+        
+        // Remove the allocated node from the free list
+        delink_node(node_to_alloc);
     }
     
     // Update the head if we are allocating the first node of the free list
@@ -216,10 +274,7 @@ char* mpool_calloc(size_t asize, _tMempool* pool)
         pool->head = new_node;
     }
     
-    // Remove the allocated node from the free list
-    delink_node(node_to_alloc);
-    
-    pool->usize += leaf.header_size + node_to_alloc->size;
+    mpool_record_alloc(pool, node_to_alloc->size, walk);
     // Format the new pool
     char* new_pool = (char*)node_to_alloc->pool;
     for (int i = 0; i < node_to_alloc->size; i++) new_pool[i] = 0;
@@ -250,17 +305,25 @@ char* leaf_calloc(size_t size)
 
 void mpool_free(char* ptr, _tMempool* pool)
 {
+    if (pool->type == MempoolSegregatedFit)
+    {
+        tlsf_free(ptr, pool);
+        return;
+    }
+    
     //if (ptr < pool->mpool || ptr >= pool->mpool + pool->msize)
     // Get the node at the freed space
     mpool_node_t* freed_node = (mpool_node_t*) (ptr - leaf.header_size);
     
-    pool->usize -= leaf.header_size + freed_node->size;
+    mpool_record_free(pool, freed_node->size, 0);
     
     // Check each node in the list against the newly freed one to see if it's adjacent in memory
     mpool_node_t* other_node = pool->head;
     mpool_node_t* next_node;
+    uint32_t walk = 0;
     while (other_node != NULL)
     {
+        walk++;
         if ((long) other_node < (long) pool->mpool ||
             (long) other_node >= (((long) pool->mpool) + pool->msize))
         {
@@ -305,6 +368,7 @@ void mpool_free(char* ptr, _tMempool* pool)
         
         other_node = next_node;
     }
+    if (walk > pool->max_walk) pool->max_walk = walk;
     
     // Ensure the freed node is attached to the head
     freed_node->next = pool->head;
@@ -385,6 +449,404 @@ static inline void delink_node(mpool_node_t* node)
     node->prev = NULL;
 }
 
+//==============================================================================
+
+/**
+ * Two-level segregated fit (TLSF) allocator
+ *
+ * Free blocks are kept in lists indexed by size class. The first level picks the
+ * power of two range a size falls in, the second level splits that range into
+ * MPOOL_TLSF_SL_COUNT linear steps, and a bitmap at each level records which lists
+ * are non-empty, so finding a free block is a couple of bit scans rather than a walk.
+ * Every block also points back at the block physically before it, so free can
+ * merge with both neighbours without searching. Both alloc and free do a fixed
+ * amount of work whatever the state of the pool.
+ *
+ * Layout: [mpool_tlsf_t index][block header][payload]...[block header][payload][sentinel header]
+ * The zero-size sentinel at the end is always marked used so merging stops there.
+ */
+
+#define TLSF_FREE_BIT ((size_t)1)
+
+static inline int tlsf_fls(uint32_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return word ? 31 - __builtin_clz(word) : -1;
+#else
+    int bit = 31;
+    if (!word) return -1;
+    if (!(word & 0xffff0000u)) { word <<= 16; bit -= 16; }
+    if (!(word & 0xff000000u)) { word <<= 8; bit -= 8; }
+    if (!(word & 0xf0000000u)) { word <<= 4; bit -= 4; }
+    if (!(word & 0xc0000000u)) { word <<= 2; bit -= 2; }
+    if (!(word & 0x80000000u)) { bit -= 1; }
+    return bit;
+#endif
+}
+
+static inline int tlsf_ffs(uint32_t word)
+{
+    return tlsf_fls(word & (~word + 1));
+}
+
+static inline size_t tlsf_size(mpool_tlsf_node_t* node)
+{
+    return node->size & ~TLSF_FREE_BIT;
+}
+
+static inline int tlsf_is_free(mpool_tlsf_node_t* node)
+{
+    return (int)(node->size & TLSF_FREE_BIT);
+}
+
+static inline mpool_tlsf_node_t* tlsf_next_phys(mpool_tlsf_node_t* node)
+{
+    return (mpool_tlsf_node_t*)((char*)node + leaf.header_size + tlsf_size(node));
+}
+
+// Size class a block of the given size belongs in
+static inline void tlsf_mapping_insert(size_t size, int* fl, int* sl)
+{
+    if (size < MPOOL_TLSF_SMALL_BLOCK)
+    {
+        *fl = 0;
+        *sl = (int)(size / (MPOOL_TLSF_SMALL_BLOCK / MPOOL_TLSF_SL_COUNT));
+    }
+    else
+    {
+        int f = tlsf_fls((uint32_t)size);
+        *sl = (int)(size >> (f - MPOOL_TLSF_SL_LOG2)) ^ MPOOL_TLSF_SL_COUNT;
+        *fl = f - (MPOOL_TLSF_FL_SHIFT - 1);
+    }
+}
+
+// Size class to start searching from so that any block found is big enough
+static inline void tlsf_mapping_search(size_t size, int* fl, int* sl)
+{
+    if (size >= MPOOL_TLSF_SMALL_BLOCK)
+    {
+        size += ((size_t)1 << (tlsf_fls((uint32_t)size) - MPOOL_TLSF_SL_LOG2)) - 1;
+    }
+    tlsf_mapping_insert(size, fl, sl);
+}
+
+static inline void tlsf_insert_node(mpool_tlsf_t* tlsf, mpool_tlsf_node_t* node)
+{
+    int fl, sl;
+    tlsf_mapping_insert(tlsf_size(node), &fl, &sl);
+    
+    mpool_tlsf_node_t* head = tlsf->blocks[fl][sl];
+    node->next_free = head;
+    node->prev_free = NULL;
+    if (head != NULL) head->prev_free = node;
+    tlsf->blocks[fl][sl] = node;
+    
+    tlsf->fl_bitmap |= (1u << fl);
+    tlsf->sl_bitmap[fl] |= (1u << sl);
+    
+    node->size |= TLSF_FREE_BIT;
+}
+
+static inline void tlsf_remove_node(mpool_tlsf_t* tlsf, mpool_tlsf_node_t* node)
+{
+    int fl, sl;
+    tlsf_mapping_insert(tlsf_size(node), &fl, &sl);
+    
+    if (node->next_free != NULL) node->next_free->prev_free = node->prev_free;
+    if (node->prev_free != NULL) node->prev_free->next_free = node->next_free;
+    
+    if (tlsf->blocks[fl][sl] == node)
+    {
+        tlsf->blocks[fl][sl] = node->next_free;
+        if (node->next_free == NULL)
+        {
+            tlsf->sl_bitmap[fl] &= ~(1u << sl);
+            if (tlsf->sl_bitmap[fl] == 0) tlsf->fl_bitmap &= ~(1u << fl);
+        }
+    }
+    
+    node->next_free = NULL;
+    node->prev_free = NULL;
+    node->size &= ~TLSF_FREE_BIT;
+}
+
+static void tlsf_create(_tMempool* pool)
+{
+    size_t index_size = mpool_align(sizeof(mpool_tlsf_t));
+    
+    // Not even room for the index, a block and the sentinel; leave the pool empty so every alloc fails
+    if (pool->msize < index_size + 3 * leaf.header_size + MPOOL_ALIGN_SIZE)
+    {
+        pool->usize = pool->msize;
+        return;
+    }
+    
+    mpool_tlsf_t* tlsf = pool->tlsf = (mpool_tlsf_t*)pool->mpool;
+    tlsf->fl_bitmap = 0;
+    for (int i = 0; i < MPOOL_TLSF_FL_COUNT; i++)
+    {
+        tlsf->sl_bitmap[i] = 0;
+        for (int j = 0; j < MPOOL_TLSF_SL_COUNT; j++) tlsf->blocks[i][j] = NULL;
+    }
+    
+    // Blocks larger than the top size class can't be indexed, so cap the usable space there
+    size_t block_size = (pool->msize - index_size - 2 * leaf.header_size) & ~(size_t)(MPOOL_ALIGN_SIZE - 1);
+    size_t max_block = ((size_t)1 << MPOOL_TLSF_FL_MAX) - MPOOL_ALIGN_SIZE;
+    if (block_size > max_block) block_size = max_block;
+    
+    mpool_tlsf_node_t* node = (mpool_tlsf_node_t*)(pool->mpool + index_size);
+    node->prev_phys = NULL;
+    node->size = block_size;
+    
+    mpool_tlsf_node_t* sentinel = tlsf_next_phys(node);
+    sentinel->prev_phys = node;
+    sentinel->next_free = NULL;
+    sentinel->prev_free = NULL;
+    sentinel->size = 0;
+    
+    tlsf_insert_node(tlsf, node);
+    
+    // Count the index and sentinel as used so usize + free space still adds up to msize
+    pool->usize = pool->msize - (leaf.header_size + block_size);
+    pool->peak_usize = pool->usize;
+}
+
+static char* tlsf_alloc(size_t asize, _tMempool* pool)
+{
+    mpool_tlsf_t* tlsf = pool->tlsf;
+    
+    size_t size_to_alloc = mpool_align(asize);
+    if (size_to_alloc < MPOOL_ALIGN_SIZE) size_to_alloc = MPOOL_ALIGN_SIZE;
+    
+    if (tlsf == NULL || size_to_alloc > ((size_t)1 << MPOOL_TLSF_FL_MAX) - MPOOL_ALIGN_SIZE)
+    {
+        mpool_alloc_failed(pool);
+        return NULL;
+    }
+    
+    int fl, sl;
+    tlsf_mapping_search(size_to_alloc, &fl, &sl);
+    
+    // Find the first non-empty list at or above the requested size class
+    mpool_tlsf_node_t* node = NULL;
+    if (fl < MPOOL_TLSF_FL_COUNT)
+    {
+        uint32_t sl_map = tlsf->sl_bitmap[fl] & (~0u << sl);
+        if (sl_map == 0)
+        {
+            uint32_t fl_map = (fl + 1 < 32) ? tlsf->fl_bitmap & (~0u << (fl + 1)) : 0;
+            if (fl_map != 0)
+            {
+                fl = tlsf_ffs(fl_map);
+                sl_map = tlsf->sl_bitmap[fl];
+            }
+        }
+        if (sl_map != 0)
+        {
+            sl = tlsf_ffs(sl_map);
+            node = tlsf->blocks[fl][sl];
+        }
+    }
+    
+    if (node == NULL)
+    {
+        mpool_alloc_failed(pool);
+        return NULL;
+    }
+    
+    tlsf_remove_node(tlsf, node);
+    
+    // Split off whatever is left over if it's big enough to be a block of its own
+    size_t node_size = tlsf_size(node);
+    if (node_size >= size_to_alloc + leaf.header_size + MPOOL_ALIGN_SIZE)
+    {
+        mpool_tlsf_node_t* next = tlsf_next_phys(node);
+        
+        node->size = size_to_alloc;
+        mpool_tlsf_node_t* remaining = tlsf_next_phys(node);
+        remaining->prev_phys = node;
+        remaining->size = node_size - size_to_alloc - leaf.header_size;
+        next->prev_phys = remaining;
+        
+        tlsf_insert_node(tlsf, remaining);
+    }
+    
+    mpool_record_alloc(pool, tlsf_size(node), 1);
+    
+    char* block = (char*)node + leaf.header_size;
+    
+    if (leaf.clearOnAllocation > 0)
+    {
+        size_t size = tlsf_size(node);
+        for (size_t i = 0; i < size; i++) block[i] = 0;
+    }
+    
+    return block;
+}
+
+static void tlsf_free(char* ptr, _tMempool* pool)
+{
+    mpool_tlsf_t* tlsf = pool->tlsf;
+    mpool_tlsf_node_t* node = (mpool_tlsf_node_t*)(ptr - leaf.header_size);
+    
+    if (tlsf == NULL ||
+        (char*)node < pool->mpool + mpool_align(sizeof(mpool_tlsf_t)) ||
+        (char*)node >= pool->mpool + pool->msize ||
+        tlsf_is_free(node))
+    {
+        LEAF_error(2);
+        return;
+    }
+    
+    mpool_record_free(pool, tlsf_size(node), 1);
+    
+    // Merge with the block before
+    mpool_tlsf_node_t* prev = node->prev_phys;
+    if (prev != NULL && tlsf_is_free(prev))
+    {
+        tlsf_remove_node(tlsf, prev);
+        prev->size += leaf.header_size + tlsf_size(node);
+        node = prev;
+        tlsf_next_phys(node)->prev_phys = node;
+    }
+    
+    // Merge with the block after
+    mpool_tlsf_node_t* next = tlsf_next_phys(node);
+    if (tlsf_is_free(next))
+    {
+        tlsf_remove_node(tlsf, next);
+        node->size += leaf.header_size + tlsf_size(next);
+        tlsf_next_phys(node)->prev_phys = node;
+    }
+    
+    tlsf_insert_node(tlsf, node);
+}
+
+//==============================================================================
+
+/**
+ * statistics
+ */
+static inline void mpool_record_alloc(_tMempool* pool, size_t size, uint32_t walk)
+{
+    pool->usize += leaf.header_size + size;
+    if (pool->usize > pool->peak_usize) pool->peak_usize = pool->usize;
+    pool->num_blocks++;
+    if (walk > pool->max_walk) pool->max_walk = walk;
+}
+
+static inline void mpool_record_free(_tMempool* pool, size_t size, uint32_t walk)
+{
+    pool->usize -= leaf.header_size + size;
+    pool->num_blocks--;
+    if (walk > pool->max_walk) pool->max_walk = walk;
+}
+
+static inline void mpool_alloc_failed(_tMempool* pool)
+{
+    pool->failed_allocs++;
+    leaf_mempool_overrun();
+}
+
+void mpool_get_stats(_tMempool* pool, tMempoolStats* stats)
+{
+    stats->size = pool->msize;
+    stats->used = pool->usize;
+    stats->peakUsed = pool->peak_usize;
+    stats->numBlocks = pool->num_blocks;
+    stats->failedAllocs = pool->failed_allocs;
+    stats->maxWalk = pool->max_walk;
+    stats->numFreeBlocks = 0;
+    stats->totalFree = 0;
+    stats->largestFree = 0;
+    
+    if (pool->type == MempoolSegregatedFit)
+    {
+        mpool_tlsf_t* tlsf = pool->tlsf;
+        if (tlsf == NULL) return;
+        for (int fl = 0; fl < MPOOL_TLSF_FL_COUNT; fl++)
+        {
+            for (int sl = 0; sl < MPOOL_TLSF_SL_COUNT; sl++)
+            {
+                for (mpool_tlsf_node_t* node = tlsf->blocks[fl][sl]; node != NULL; node = node->next_free)
+                {
+                    size_t size = tlsf_size(node);
+                    stats->numFreeBlocks++;
+                    stats->totalFree += size;
+                    if (size > stats->largestFree) stats->largestFree = size;
+                }
+            }
+        }
+    }
+    else
+    {
+        for (mpool_node_t* node = pool->head; node != NULL; node = node->next)
+        {
+            stats->numFreeBlocks++;
+            stats->totalFree += node->size;
+            if (node->size > stats->largestFree) stats->largestFree = node->size;
+        }
+    }
+    
+    // 0 when all free space is one block, approaching 1 as it gets split into many small ones
+    stats->fragmentation = stats->totalFree > 0 ? 1.0f - ((float)stats->largestFree / (float)stats->totalFree) : 0.0f;
+}
+
+void mpool_reset_stats(_tMempool* pool)
+{
+    pool->peak_usize = pool->usize;
+    pool->failed_allocs = 0;
+    pool->max_walk = 0;
+}
+
+void mpool_iterate(_tMempool* pool, void (*callback)(char* block, size_t size, int isFree, void* userData), void* userData)
+{
+    if (pool->type == MempoolSegregatedFit)
+    {
+        if (pool->tlsf == NULL) return;
+        // Walk the blocks in address order until the zero-size sentinel
+        mpool_tlsf_node_t* node = (mpool_tlsf_node_t*)(pool->mpool + mpool_align(sizeof(mpool_tlsf_t)));
+        while (tlsf_size(node) > 0)
+        {
+            callback((char*)node + leaf.header_size, tlsf_size(node), tlsf_is_free(node), userData);
+            node = tlsf_next_phys(node);
+        }
+    }
+    else
+    {
+        // First fit blocks tile the whole pool. Only free nodes are linked, except a lone head.
+        char* end = pool->mpool + pool->msize;
+        char* location = pool->mpool;
+        while (location + leaf.header_size <= end)
+        {
+            mpool_node_t* node = (mpool_node_t*)location;
+            int isFree = (node == pool->head || node->next != NULL || node->prev != NULL);
+            callback(node->pool, node->size, isFree, userData);
+            location += leaf.header_size + node->size;
+        }
+    }
+}
+
+static void mpool_dump_block(char* block, size_t size, int isFree, void* userData)
+{
+    _tMempool* pool = (_tMempool*)userData;
+    printf("  %10lu %10lu %s\n", (unsigned long)(block - pool->mpool), (unsigned long)size, isFree ? "free" : "used");
+}
+
+void mpool_dump(_tMempool* pool)
+{
+    tMempoolStats stats;
+    mpool_get_stats(pool, &stats);
+    
+    printf("mempool %p (%s)\n", (void*)pool->mpool, pool->type == MempoolSegregatedFit ? "segregated fit" : "first fit");
+    printf("  size %lu, used %lu, peak %lu\n", (unsigned long)stats.size, (unsigned long)stats.used, (unsigned long)stats.peakUsed);
+    printf("  %lu live blocks, %lu free blocks, largest free %lu, fragmentation %.3f\n",
+           (unsigned long)stats.numBlocks, (unsigned long)stats.numFreeBlocks, (unsigned long)stats.largestFree, stats.fragmentation);
+    printf("  %lu failed allocs, max walk %lu\n", (unsigned long)stats.failedAllocs, (unsigned long)stats.maxWalk);
+    printf("      offset       size\n");
+    mpool_iterate(pool, &mpool_dump_block, pool);
+}
+
 void leaf_mempool_overrun(void)
 {
     LEAF_error(1);
@@ -402,11 +864,21 @@ void tMempool_free(tMempool* const mp)
 }
 
 void    tMempool_initToPool     (tMempool* const mp, char* memory, size_t size, tMempool* const mem)
+{
+    tMempool_initWithTypeToPool(mp, memory, size, MempoolFirstFit, mem);
+}
+
+void    tMempool_initWithType   (tMempool* const mp, char* memory, size_t size, MempoolType type)
+{
+    tMempool_initWithTypeToPool(mp, memory, size, type, &leaf.mempool);
+}
+
+void    tMempool_initWithTypeToPool (tMempool* const mp, char* memory, size_t size, MempoolType type, tMempool* const mem)
 {
     _tMempool* mm = *mem;
     _tMempool* m = *mp = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
     
-    mpool_create (memory, size, m);
+    mpool_create_with_type (memory, size, type, m);
 }
 
 void    tMempool_freeFromPool   (tMempool* const mp, tMempool* const mem)
@@ -416,3 +888,23 @@ void    tMempool_freeFromPool   (tMempool* const mp, tMempool* const mem)
     
     mpool_free((char*)m, mm);
 }
+
+void    tMempool_getStats       (tMempool* const mp, tMempoolStats* stats)
+{
+    mpool_get_stats(*mp, stats);
+}
+
+void    tMempool_resetStats     (tMempool* const mp)
+{
+    mpool_reset_stats(*mp);
+}
+
+void    tMempool_iterate        (tMempool* const mp, void (*callback)(char* block, size_t size, int isFree, void* userData), void* userData)
+{
+    mpool_iterate(*mp, callback, userData);
+}
+
+void    tMempool_dump           (tMempool* const mp)
+{
+    mpool_dump(*mp);
+}
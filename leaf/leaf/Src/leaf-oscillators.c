@@ -16,6 +16,21 @@
 
 #endif
 
+// Vector units used by tOscBank, if the target has one
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_OSCBANK_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEAF_OSCBANK_SSE 1
+#endif
+
+static inline uint32_t osc_phaseInc(float freq)
+{
+    // through int64 so negative and above-Nyquist frequencies wrap instead of saturating
+    return (uint32_t)(int64_t)(freq * leaf.invSampleRate * OSC_PHASE_SCALE);
+}
+
 // Cycle
 void    tCycle_init(tCycle* const cy)
 {
@@ -28,8 +43,8 @@ void    tCycle_initToPool   (tCycle* const cy, tMempool* const mp)
     _tCycle* c = *cy = (_tCycle*) mpool_alloc(sizeof(_tCycle), m);
     c->mempool = m;
     
-    c->inc      =  0.0f;
-    c->phase    =  0.0f;
+    c->inc      =  0;
+    c->phase    =  0;
 }
 
 void    tCycle_free (tCycle* const cy)
@@ -45,41 +60,41 @@ void     tCycle_setFreq(tCycle* const cy, float freq)
     
     c->freq  = freq;
 
-    c->inc = freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(freq);
 }
 
-//need to check bounds and wrap table properly to allow through-zero FM
 float   tCycle_tick(tCycle* const cy)
+{
+    return _tCycle_tick(*cy);
+}
+
+void    tCycle_process(tCycle* const cy, float* out, int n)
 {
     _tCycle* c = *cy;
-    float temp;;
-    int intPart;;
-    float fracPart;
-    float samp0;
-    float samp1;
     
-    // Phasor increment
-    c->phase += c->inc;
-    while (c->phase >= 1.0f) c->phase -= 1.0f;
-    while (c->phase < 0.0f) c->phase += 1.0f;
-
-    // Wavetable synthesis
-
-	temp = SINE_TABLE_SIZE * c->phase;
-	intPart = (int)temp;
-	fracPart = temp - (float)intPart;
-	samp0 = __leaf_table_sinewave[intPart];
-	if (++intPart >= SINE_TABLE_SIZE) intPart = 0;
-	samp1 = __leaf_table_sinewave[intPart];
-
-    return (samp0 + (samp1 - samp0) * fracPart);
+    uint32_t phase = c->phase;
+    const uint32_t inc = c->inc;
+    
+    for (int i = 0; i < n; i++)
+    {
+        phase += inc;
+        
+        uint32_t idx = phase >> OSC_TABLE_SHIFT;
+        float fracPart = (float)(int32_t)(phase & OSC_TABLE_FRAC_MASK) * OSC_TABLE_FRAC;
+        float samp0 = __leaf_table_sinewave[idx];
+        float samp1 = __leaf_table_sinewave[(idx + 1) & (SINE_TABLE_SIZE - 1)];
+        
+        out[i] = samp0 + (samp1 - samp0) * fracPart;
+    }
+    
+    c->phase = phase;
 }
 
 void     tCycleSampleRateChanged (tCycle* const cy)
 {
     _tCycle* c = *cy;
     
-    c->inc = c->freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(c->freq);
 }
 
 //========================================================================
@@ -95,8 +110,8 @@ void    tTriangle_initToPool    (tTriangle* const cy, tMempool* const mp)
     _tTriangle* c = *cy = (_tTriangle*) mpool_alloc(sizeof(_tTriangle), m);
     c->mempool = m;
     
-    c->inc      =  0.0f;
-    c->phase    =  0.0f;
+    c->inc      =  0;
+    c->phase    =  0;
     tTriangle_setFreq(cy, 220);
 }
 
@@ -113,9 +128,9 @@ void tTriangle_setFreq(tTriangle* const cy, float freq)
     
     c->freq  = freq;
     
-    c->inc = c->freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(c->freq);
     
-    c->w = c->freq * INV_20;
+    c->w = fabsf(c->freq) * INV_20; // the tables only care how fast, not which way
     for (c->oct = 0; c->w > 2.0f; c->oct++)
     {
         c->w = 0.5f * c->w;
@@ -128,27 +143,43 @@ float   tTriangle_tick(tTriangle* const cy)
 {
     _tTriangle* c = *cy;
     
-    // Phasor increment
+    // Phasor increment, wraps on overflow
     c->phase += c->inc;
-    while (c->phase >= 1.0f) c->phase -= 1.0f;
-    while (c->phase < 0.0f) c->phase += 1.0f;
-    
-    float out = 0.0f;
     
-    int idx = (int)(c->phase * TRI_TABLE_SIZE);
+    uint32_t idx = c->phase >> OSC_TABLE_SHIFT;
     
     // Wavetable synthesis
-    out = __leaf_table_triangle[c->oct+1][idx] +
-         (__leaf_table_triangle[c->oct][idx] - __leaf_table_triangle[c->oct+1][idx]) * c->w;
+    return __leaf_table_triangle[c->oct+1][idx] +
+          (__leaf_table_triangle[c->oct][idx] - __leaf_table_triangle[c->oct+1][idx]) * c->w;
+}
+
+void    tTriangle_process(tTriangle* const cy, float* out, int n)
+{
+    _tTriangle* c = *cy;
     
-    return out;
+    uint32_t phase = c->phase;
+    const uint32_t inc = c->inc;
+    const float w = c->w;
+    const float* lo = __leaf_table_triangle[c->oct];
+    const float* hi = __leaf_table_triangle[c->oct+1];
+    
+    for (int i = 0; i < n; i++)
+    {
+        phase += inc;
+        
+        uint32_t idx = phase >> OSC_TABLE_SHIFT;
+        
+        out[i] = hi[idx] + (lo[idx] - hi[idx]) * w;
+    }
+    
+    c->phase = phase;
 }
 
 void     tTriangleSampleRateChanged (tTriangle* const cy)
 {
     _tTriangle* c = *cy;
     
-    c->inc = c->freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(c->freq);
 }
 
 //========================================================================
@@ -164,8 +195,8 @@ void    tSquare_initToPool  (tSquare* const cy, tMempool* const mp)
     _tSquare* c = *cy = (_tSquare*) mpool_alloc(sizeof(_tSquare), m);
     c->mempool = m;
     
-    c->inc      =  0.0f;
-    c->phase    =  0.0f;
+    c->inc      =  0;
+    c->phase    =  0;
     tSquare_setFreq(cy, 220);
 }
 
@@ -182,9 +213,9 @@ void    tSquare_setFreq(tSquare* const cy, float freq)
 
     c->freq  = freq;
     
-    c->inc = c->freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(c->freq);
     
-    c->w = c->freq * INV_20;
+    c->w = fabsf(c->freq) * INV_20;
     for (c->oct = 0; c->w > 2.0f; c->oct++)
     {
         c->w = 0.5f * c->w;
@@ -196,27 +227,43 @@ float   tSquare_tick(tSquare* const cy)
 {
     _tSquare* c = *cy;
     
-    // Phasor increment
+    // Phasor increment, wraps on overflow
     c->phase += c->inc;
-    while (c->phase >= 1.0f) c->phase -= 1.0f;
-    while (c->phase < 0.0f) c->phase += 1.0f;
-    
-    float out = 0.0f;
     
-    int idx = (int)(c->phase * SQR_TABLE_SIZE);
+    uint32_t idx = c->phase >> OSC_TABLE_SHIFT;
     
     // Wavetable synthesis
-    out = __leaf_table_squarewave[c->oct+1][idx] +
-         (__leaf_table_squarewave[c->oct][idx] - __leaf_table_squarewave[c->oct+1][idx]) * c->w;
+    return __leaf_table_squarewave[c->oct+1][idx] +
+          (__leaf_table_squarewave[c->oct][idx] - __leaf_table_squarewave[c->oct+1][idx]) * c->w;
+}
+
+void    tSquare_process(tSquare* const cy, float* out, int n)
+{
+    _tSquare* c = *cy;
     
-    return out;
+    uint32_t phase = c->phase;
+    const uint32_t inc = c->inc;
+    const float w = c->w;
+    const float* lo = __leaf_table_squarewave[c->oct];
+    const float* hi = __leaf_table_squarewave[c->oct+1];
+    
+    for (int i = 0; i < n; i++)
+    {
+        phase += inc;
+        
+        uint32_t idx = phase >> OSC_TABLE_SHIFT;
+        
+        out[i] = hi[idx] + (lo[idx] - hi[idx]) * w;
+    }
+    
+    c->phase = phase;
 }
 
 void     tSquareSampleRateChanged (tSquare* const cy)
 {
     _tSquare* c = *cy;
     
-    c->inc = c->freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(c->freq);
 }
 
 //=====================================================================
@@ -232,8 +279,8 @@ void    tSawtooth_initToPool    (tSawtooth* const cy, tMempool* const mp)
     _tSawtooth* c = *cy = (_tSawtooth*) mpool_alloc(sizeof(_tSawtooth), m);
     c->mempool = m;
     
-    c->inc      = 0.0f;
-    c->phase    = 0.0f;
+    c->inc      = 0;
+    c->phase    = 0;
     tSawtooth_setFreq(cy, 220);
 }
 
@@ -250,9 +297,9 @@ void    tSawtooth_setFreq(tSawtooth* const cy, float freq)
     
     c->freq  = freq;
     
-    c->inc = c->freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(c->freq);
     
-    c->w = c->freq * INV_20;
+    c->w = fabsf(c->freq) * INV_20;
     for (c->oct = 0; c->w > 2.0f; c->oct++)
     {
         c->w = 0.5f * c->w;
@@ -264,27 +311,43 @@ float   tSawtooth_tick(tSawtooth* const cy)
 {
     _tSawtooth* c = *cy;
     
-    // Phasor increment
+    // Phasor increment, wraps on overflow
     c->phase += c->inc;
-    while (c->phase >= 1.0f) c->phase -= 1.0f;
-    while (c->phase < 0.0f) c->phase += 1.0f;
     
-    float out = 0.0f;
-    
-    int idx = (int)(c->phase * SAW_TABLE_SIZE);
+    uint32_t idx = c->phase >> OSC_TABLE_SHIFT;
     
     // Wavetable synthesis
-    out = __leaf_table_sawtooth[c->oct+1][idx] +
-         (__leaf_table_sawtooth[c->oct][idx] - __leaf_table_sawtooth[c->oct+1][idx]) * c->w;
+    return __leaf_table_sawtooth[c->oct+1][idx] +
+          (__leaf_table_sawtooth[c->oct][idx] - __leaf_table_sawtooth[c->oct+1][idx]) * c->w;
+}
+
+void    tSawtooth_process(tSawtooth* const cy, float* out, int n)
+{
+    _tSawtooth* c = *cy;
     
-    return out;
+    uint32_t phase = c->phase;
+    const uint32_t inc = c->inc;
+    const float w = c->w;
+    const float* lo = __leaf_table_sawtooth[c->oct];
+    const float* hi = __leaf_table_sawtooth[c->oct+1];
+    
+    for (int i = 0; i < n; i++)
+    {
+        phase += inc;
+        
+        uint32_t idx = phase >> OSC_TABLE_SHIFT;
+        
+        out[i] = hi[idx] + (lo[idx] - hi[idx]) * w;
+    }
+    
+    c->phase = phase;
 }
 
 void     tSawtoothSampleRateChanged (tSawtooth* const cy)
 {
     _tSawtooth* c = *cy;
     
-    c->inc = c->freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(c->freq);
 }
 
 //========================================================================
@@ -303,8 +366,8 @@ void    tSine_initToPool   (tSine* const cy, int size, tMempool* const mp)
     c->size = size;
     c->sine = (float*) mpool_alloc(sizeof(float) * c->size, m);
     LEAF_generate_sine(c->sine, size);
-    c->inc      =  0.0f;
-    c->phase    =  0.0f;
+    c->inc      =  0;
+    c->phase    =  0;
 }
 
 void    tSine_free (tSine* const cy)
@@ -320,41 +383,62 @@ void     tSine_setFreq(tSine* const cy, float freq)
     _tSine* c = *cy;
     
     c->freq  = freq;
-    c->inc = freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(freq);
 }
 
+// The table can be any size, so scale the phase into it with a 32x32->64 bit
+// multiply: the high word is the index and the low word the fraction.
 float   tSine_tick(tSine* const cy)
 {
     _tSine* c = *cy;
-    float temp;
-    int intPart;
-    float fracPart;
-    float samp0;
-    float samp1;
     
-    // Phasor increment
+    // Phasor increment, wraps on overflow
     c->phase += c->inc;
-    while (c->phase >= 1.0f) c->phase -= 1.0f;
-    while (c->phase < 0.0f) c->phase += 1.0f;
     
     // Wavetable synthesis
-    
-    temp = c->size * c->phase;
-    intPart = (int)temp;
-    fracPart = temp - (float)intPart;
-    samp0 = c->sine[intPart];
-    if (++intPart >= c->size) intPart = 0;
-    samp1 = c->sine[intPart];
+    uint64_t pos = (uint64_t)c->phase * (uint32_t)c->size;
+    uint32_t intPart = (uint32_t)(pos >> 32);
+    float fracPart = (float)(int32_t)((uint32_t)pos >> 8) * (1.0f / 16777216.0f);
+    uint32_t nextPart = intPart + 1;
+    if (nextPart >= (uint32_t)c->size) nextPart = 0;
+    float samp0 = c->sine[intPart];
+    float samp1 = c->sine[nextPart];
     
     return (samp0 + (samp1 - samp0) * fracPart);
+}
+
+void    tSine_process(tSine* const cy, float* out, int n)
+{
+    _tSine* c = *cy;
+    
+    uint32_t phase = c->phase;
+    const uint32_t inc = c->inc;
+    const uint32_t size = (uint32_t)c->size;
+    const float* sine = c->sine;
+    
+    for (int i = 0; i < n; i++)
+    {
+        phase += inc;
+        
+        uint64_t pos = (uint64_t)phase * size;
+        uint32_t intPart = (uint32_t)(pos >> 32);
+        float fracPart = (float)(int32_t)((uint32_t)pos >> 8) * (1.0f / 16777216.0f);
+        uint32_t nextPart = intPart + 1;
+        if (nextPart >= size) nextPart = 0;
+        float samp0 = sine[intPart];
+        float samp1 = sine[nextPart];
+        
+        out[i] = samp0 + (samp1 - samp0) * fracPart;
+    }
     
+    c->phase = phase;
 }
 
 void     tSineSampleRateChanged (tSine* const cy)
 {
     _tSine* c = *cy;
     
-    c->inc = c->freq * leaf.invSampleRate;
+    c->inc = osc_phaseInc(c->freq);
 }
 
 //==============================================================================
@@ -548,7 +632,7 @@ void     tPhasorSampleRateChanged (tPhasor* const ph)
 {
     _tPhasor* p = *ph;
     
-    p->inc = p->freq * leaf.invSampleRate;
+    p->inc = osc_phaseInc(p->freq);
 };
 
 void    tPhasor_init(tPhasor* const ph)
@@ -562,8 +646,8 @@ void    tPhasor_initToPool  (tPhasor* const ph, tMempool* const mp)
     _tPhasor* p = *ph = (_tPhasor*) mpool_alloc(sizeof(_tPhasor), m);
     p->mempool = m;
     
-    p->phase = 0.0f;
-    p->inc = 0.0f;
+    p->phase = 0;
+    p->inc = 0;
     p->phaseDidReset = 0;
 }
 
@@ -580,24 +664,41 @@ void    tPhasor_setFreq(tPhasor* const ph, float freq)
 
     p->freq  = freq;
     
-    p->inc = freq * leaf.invSampleRate;
+    p->inc = osc_phaseInc(freq);
 }
 
+// The output is the top 24 bits of the phase, which converts to a float in [0, 1) exactly.
+// phaseDidReset is set when the phase wrapped, in whichever direction it is running.
 float   tPhasor_tick(tPhasor* const ph)
 {
     _tPhasor* p = *ph;
     
+    uint32_t last = p->phase;
     p->phase += p->inc;
     
+    p->phaseDidReset = ((int32_t)p->inc < 0) ? (p->phase > last) : (p->phase < last);
     
-    p->phaseDidReset = 0;
-    if (p->phase >= 1.0f)
+    return (float)(int32_t)(p->phase >> 8) * (1.0f / 16777216.0f);
+}
+
+void    tPhasor_process(tPhasor* const ph, float* out, int n)
+{
+    _tPhasor* p = *ph;
+    
+    uint32_t phase = p->phase;
+    const uint32_t inc = p->inc;
+    
+    for (int i = 0; i < n; i++)
     {
-        p->phaseDidReset = 1;
-        p->phase -= 1.0f;
+        phase += inc;
+        out[i] = (float)(int32_t)(phase >> 8) * (1.0f / 16777216.0f);
     }
     
-    return p->phase;
+    // a wrap on the last sample leaves the phase behind where it was one step before
+    uint32_t last = phase - inc;
+    if (n > 0) p->phaseDidReset = ((int32_t)inc < 0) ? (phase > last) : (phase < last);
+    
+    p->phase = phase;
 }
 
 /* Noise */
@@ -644,6 +745,35 @@ float   tNoise_tick(tNoise* const ns)
     }
 }
 
+void    tNoise_process(tNoise* const ns, float* out, int n)
+{
+    _tNoise* nz = *ns;
+    
+    float(*rand)(void) = nz->rand;
+    
+    if (nz->type == PinkNoise)
+    {
+        float b0 = nz->pinkb0, b1 = nz->pinkb1, b2 = nz->pinkb2;
+        
+        for (int i = 0; i < n; i++)
+        {
+            float r = (rand() * 2.0f) - 1.0f;
+            b0 = 0.99765f * b0 + r * 0.0990460f;
+            b1 = 0.96300f * b1 + r * 0.2965164f;
+            b2 = 0.57000f * b2 + r * 1.0526913f;
+            out[i] = (b0 + b1 + b2 + r * 0.1848f) * 0.05f;
+        }
+        
+        nz->pinkb0 = b0;
+        nz->pinkb1 = b1;
+        nz->pinkb2 = b2;
+    }
+    else // WhiteNoise
+    {
+        for (int i = 0; i < n; i++) out[i] = (rand() * 2.0f) - 1.0f;
+    }
+}
+
 //=================================================================================
 /* Neuron */
 
@@ -1465,3 +1595,656 @@ float tMBSaw_syncOut(tMBSaw* const osc)
     _tMBSaw* c = *osc;
     return c->syncout;
 }
+
+//========================================================================
+/* Oscillator bank */
+void    tOscBank_init(tOscBank* const bank, int numVoices, OscBankWaveform waveform)
+{
+    tOscBank_initToPool(bank, numVoices, waveform, &leaf.mempool);
+}
+
+void    tOscBank_initToPool(tOscBank* const bank, int numVoices, OscBankWaveform waveform, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tOscBank* b = *bank = (_tOscBank*) mpool_alloc(sizeof(_tOscBank), m);
+    b->mempool = m;
+    
+    b->numVoices = numVoices;
+    b->numLanes = ((numVoices + OSCBANK_LANES - 1) / OSCBANK_LANES) * OSCBANK_LANES;
+    
+    b->phase = (uint32_t*) mpool_alloc(sizeof(uint32_t) * b->numLanes, m);
+    b->inc = (uint32_t*) mpool_alloc(sizeof(uint32_t) * b->numLanes, m);
+    b->freq = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->w = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->offset = (int*) mpool_alloc(sizeof(int) * b->numLanes, m);
+    b->amp = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->ampTarget = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    
+    for (int i = 0; i < b->numLanes; i++)
+    {
+        b->phase[i] = 0;
+        b->inc[i] = 0;
+        b->freq[i] = 0.0f;
+        b->w[i] = 1.0f;
+        b->offset[i] = 0;
+        // Padding lanes stay silent
+        b->amp[i] = (i < numVoices) ? 1.0f : 0.0f;
+        b->ampTarget[i] = b->amp[i];
+    }
+    
+    tOscBank_setWaveform(bank, waveform);
+}
+
+void    tOscBank_free(tOscBank* const bank)
+{
+    _tOscBank* b = *bank;
+    
+    mpool_free((char*)b->ampTarget, b->mempool);
+    mpool_free((char*)b->amp, b->mempool);
+    mpool_free((char*)b->offset, b->mempool);
+    mpool_free((char*)b->w, b->mempool);
+    mpool_free((char*)b->freq, b->mempool);
+    mpool_free((char*)b->inc, b->mempool);
+    mpool_free((char*)b->phase, b->mempool);
+    mpool_free((char*)b, b->mempool);
+}
+
+void    tOscBank_setWaveform(tOscBank* const bank, OscBankWaveform waveform)
+{
+    _tOscBank* b = *bank;
+    
+    b->waveform = waveform;
+    
+    if (waveform == OscBankSawtooth) b->table = &__leaf_table_sawtooth[0][0];
+    else if (waveform == OscBankSquare) b->table = &__leaf_table_squarewave[0][0];
+    else if (waveform == OscBankTriangle) b->table = &__leaf_table_triangle[0][0];
+    else b->table = __leaf_table_sinewave;
+}
+
+void    tOscBank_setFreq(tOscBank* const bank, int voice, float freq)
+{
+    _tOscBank* b = *bank;
+    
+    if (voice < 0 || voice >= b->numVoices) return;
+    
+    b->freq[voice] = freq;
+    b->inc[voice] = osc_phaseInc(freq);
+    
+    // Pick the pair of band-limited tables to crossfade between, same as tSawtooth
+    float w = fabsf(freq) * INV_20;
+    int oct;
+    for (oct = 0; w > 2.0f; oct++)
+    {
+        w = 0.5f * w;
+    }
+    w = 2.0f - w;
+    // The tables stop at 10, so above that just use the top pair
+    if (oct > 9)
+    {
+        oct = 9;
+        w = 0.0f;
+    }
+    b->w[voice] = w;
+    b->offset[voice] = oct * SAW_TABLE_SIZE;
+}
+
+void    tOscBank_setAmplitude(tOscBank* const bank, int voice, float amp)
+{
+    _tOscBank* b = *bank;
+    
+    if (voice < 0 || voice >= b->numVoices) return;
+    
+    b->ampTarget[voice] = amp;
+}
+
+void    tOscBank_setPhase(tOscBank* const bank, int voice, float phase)
+{
+    _tOscBank* b = *bank;
+    
+    if (voice < 0 || voice >= b->numVoices) return;
+    
+    b->phase[voice] = (uint32_t)(int64_t)((phase - floorf(phase)) * OSC_PHASE_SCALE);
+}
+
+int     tOscBank_getNumVoices(tOscBank* const bank)
+{
+    _tOscBank* b = *bank;
+    
+    return b->numVoices;
+}
+
+float   tOscBank_tick(tOscBank* const bank)
+{
+    float out;
+    tOscBank_process(bank, &out, 1);
+    return out;
+}
+
+#if LEAF_OSCBANK_SSE
+
+static inline float oscbank_sum(__m128 x)
+{
+    __m128 s = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+// Adds a block of one group of voices into out
+static void oscbank_process_group(_tOscBank* b, int g, float* out, int n, float invN)
+{
+    const float* table = b->table;
+    const int sine = (b->waveform == OscBankSine);
+    const __m128i mask = _mm_set1_epi32(SINE_TABLE_SIZE - 1);
+    const __m128i fracMask = _mm_set1_epi32(OSC_TABLE_FRAC_MASK);
+    const __m128 fracScale = _mm_set1_ps(OSC_TABLE_FRAC);
+    const __m128i one = _mm_set1_epi32(1);
+    
+    __m128i phase = _mm_loadu_si128((const __m128i*)&b->phase[g]);
+    const __m128i inc = _mm_loadu_si128((const __m128i*)&b->inc[g]);
+    const __m128 w = _mm_loadu_ps(&b->w[g]);
+    const __m128i offset = _mm_loadu_si128((const __m128i*)&b->offset[g]);
+    __m128 amp = _mm_loadu_ps(&b->amp[g]);
+    const __m128 target = _mm_loadu_ps(&b->ampTarget[g]);
+    const __m128 ampInc = _mm_mul_ps(_mm_sub_ps(target, amp), _mm_set1_ps(invN));
+    
+    int i0[OSCBANK_LANES], i1[OSCBANK_LANES];
+    float s0[OSCBANK_LANES], s1[OSCBANK_LANES];
+    
+    for (int i = 0; i < n; i++)
+    {
+        // Phasor increment, wraps on overflow
+        phase = _mm_add_epi32(phase, inc);
+        
+        __m128i idx = _mm_srli_epi32(phase, OSC_TABLE_SHIFT);
+        __m128 val;
+        
+        if (sine)
+        {
+            __m128 frac = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(phase, fracMask)), fracScale);
+            _mm_storeu_si128((__m128i*)i0, idx);
+            _mm_storeu_si128((__m128i*)i1, _mm_and_si128(_mm_add_epi32(idx, one), mask));
+            for (int k = 0; k < OSCBANK_LANES; k++)
+            {
+                s0[k] = table[i0[k]];
+                s1[k] = table[i1[k]];
+            }
+            __m128 v0 = _mm_loadu_ps(s0);
+            val = _mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(s1), v0), frac));
+        }
+        else
+        {
+            _mm_storeu_si128((__m128i*)i0, _mm_add_epi32(idx, offset));
+            for (int k = 0; k < OSCBANK_LANES; k++)
+            {
+                s0[k] = table[i0[k]];
+                s1[k] = table[i0[k] + SAW_TABLE_SIZE];
+            }
+            __m128 hi = _mm_loadu_ps(s1);
+            val = _mm_add_ps(hi, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(s0), hi), w));
+        }
+        
+        amp = _mm_add_ps(amp, ampInc);
+        out[i] += oscbank_sum(_mm_mul_ps(val, amp));
+    }
+    
+    _mm_storeu_si128((__m128i*)&b->phase[g], phase);
+}
+
+#elif LEAF_OSCBANK_NEON
+
+static inline float oscbank_sum(float32x4_t x)
+{
+#if defined(__aarch64__)
+    return vaddvq_f32(x);
+#else
+    float32x2_t s = vadd_f32(vget_low_f32(x), vget_high_f32(x));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+}
+
+// Adds a block of one group of voices into out
+static void oscbank_process_group(_tOscBank* b, int g, float* out, int n, float invN)
+{
+    const float* table = b->table;
+    const int sine = (b->waveform == OscBankSine);
+    const uint32x4_t mask = vdupq_n_u32(SINE_TABLE_SIZE - 1);
+    const uint32x4_t fracMask = vdupq_n_u32(OSC_TABLE_FRAC_MASK);
+    const uint32x4_t one = vdupq_n_u32(1);
+    
+    uint32x4_t phase = vld1q_u32(&b->phase[g]);
+    const uint32x4_t inc = vld1q_u32(&b->inc[g]);
+    const float32x4_t w = vld1q_f32(&b->w[g]);
+    const uint32x4_t offset = vld1q_u32((const uint32_t*)&b->offset[g]);
+    float32x4_t amp = vld1q_f32(&b->amp[g]);
+    const float32x4_t target = vld1q_f32(&b->ampTarget[g]);
+    const float32x4_t ampInc = vmulq_n_f32(vsubq_f32(target, amp), invN);
+    
+    uint32_t i0[OSCBANK_LANES], i1[OSCBANK_LANES];
+    float s0[OSCBANK_LANES], s1[OSCBANK_LANES];
+    
+    for (int i = 0; i < n; i++)
+    {
+        // Phasor increment, wraps on overflow
+        phase = vaddq_u32(phase, inc);
+        
+        uint32x4_t idx = vshrq_n_u32(phase, OSC_TABLE_SHIFT);
+        float32x4_t val;
+        
+        if (sine)
+        {
+            float32x4_t frac = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(phase, fracMask)), OSC_TABLE_FRAC);
+            vst1q_u32(i0, idx);
+            vst1q_u32(i1, vandq_u32(vaddq_u32(idx, one), mask));
+            for (int k = 0; k < OSCBANK_LANES; k++)
+            {
+                s0[k] = table[i0[k]];
+                s1[k] = table[i1[k]];
+            }
+            float32x4_t v0 = vld1q_f32(s0);
+            val = vmlaq_f32(v0, vsubq_f32(vld1q_f32(s1), v0), frac);
+        }
+        else
+        {
+            vst1q_u32(i0, vaddq_u32(idx, offset));
+            for (int k = 0; k < OSCBANK_LANES; k++)
+            {
+                s0[k] = table[i0[k]];
+                s1[k] = table[i0[k] + SAW_TABLE_SIZE];
+            }
+            float32x4_t hi = vld1q_f32(s1);
+            val = vmlaq_f32(hi, vsubq_f32(vld1q_f32(s0), hi), w);
+        }
+        
+        amp = vaddq_f32(amp, ampInc);
+        out[i] += oscbank_sum(vmulq_f32(val, amp));
+    }
+    
+    vst1q_u32(&b->phase[g], phase);
+}
+
+#else
+
+// Adds a block of one group of voices into out. Without a vector unit each voice
+// runs through the whole block on its own, which keeps its state in registers.
+static void oscbank_process_group(_tOscBank* b, int g, float* out, int n, float invN)
+{
+    const float* table = b->table;
+    const int sine = (b->waveform == OscBankSine);
+    
+    for (int v = g; v < g + OSCBANK_LANES; v++)
+    {
+        uint32_t phase = b->phase[v];
+        const uint32_t inc = b->inc[v];
+        float amp = b->amp[v];
+        const float ampInc = (b->ampTarget[v] - amp) * invN;
+        
+        // Nothing to add, only the phase needs to move on
+        if (amp == 0.0f && ampInc == 0.0f)
+        {
+            b->phase[v] = phase + inc * (uint32_t)n;
+            continue;
+        }
+        
+        if (sine)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                phase += inc;
+                
+                uint32_t idx = phase >> OSC_TABLE_SHIFT;
+                float fracPart = (float)(int32_t)(phase & OSC_TABLE_FRAC_MASK) * OSC_TABLE_FRAC;
+                float samp0 = table[idx];
+                float samp1 = table[(idx + 1) & (SINE_TABLE_SIZE - 1)];
+                
+                amp += ampInc;
+                out[i] += (samp0 + (samp1 - samp0) * fracPart) * amp;
+            }
+        }
+        else
+        {
+            const float w = b->w[v];
+            const float* lo = table + b->offset[v];
+            const float* hi = lo + SAW_TABLE_SIZE;
+            
+            for (int i = 0; i < n; i++)
+            {
+                phase += inc;
+                
+                uint32_t idx = phase >> OSC_TABLE_SHIFT;
+                
+                amp += ampInc;
+                out[i] += (hi[idx] + (lo[idx] - hi[idx]) * w) * amp;
+            }
+        }
+        
+        b->phase[v] = phase;
+    }
+}
+
+#endif
+
+void    tOscBank_process(tOscBank* const bank, float* out, int n)
+{
+    _tOscBank* b = *bank;
+    
+    if (n <= 0) return;
+    
+    for (int i = 0; i < n; i++) out[i] = 0.0f;
+    
+    const float invN = 1.0f / (float)n;
+    
+    for (int g = 0; g < b->numLanes; g += OSCBANK_LANES)
+    {
+        oscbank_process_group(b, g, out, n, invN);
+    }
+    
+    // Every amplitude ramp has reached its target at the end of the block
+    for (int v = 0; v < b->numLanes; v++) b->amp[v] = b->ampTarget[v];
+}
+
+//========================================================================
+/* WaveTable */
+static void wavetable_updateTable(_tWaveTable* w)
+{
+    // Level l is alias-free up to sampleRate / size * 2^l. Crossfade from the lowest
+    // safe level to the next darker one as the frequency rises through each octave.
+    float x = fabsf(w->freq) * (float)w->size * leaf.invSampleRate;
+    int level = 0;
+    float levelMix = 0.0f;
+    if (x > 0.5f)
+    {
+        float octave = log2f(x);
+        int k = (int)floorf(octave);
+        level = k + 1;
+        levelMix = octave - (float)k;
+    }
+    if (level >= w->numLevels - 1)
+    {
+        level = w->numLevels - 1;
+        levelMix = 0.0f;
+    }
+    w->levelStride = (level < w->numLevels - 1) ? w->size : 0;
+    w->levelMix = levelMix;
+    
+    float pos = w->index * (float)(w->numFrames - 1);
+    int frame = (int)pos;
+    if (frame >= w->numFrames - 1)
+    {
+        frame = w->numFrames - 1;
+        w->frameMix = 0.0f;
+        w->frameStride = 0;
+    }
+    else
+    {
+        w->frameMix = pos - (float)frame;
+        w->frameStride = w->numLevels * w->size;
+    }
+    
+    w->table = w->tables + (((frame * w->numLevels) + level) * w->size);
+}
+
+// Fill the mipmaps of every frame. Frames come from floats, from a wavetable file's
+// int16 samples, or, if both are NULL, are a sine.
+static void wavetable_build(tWaveTable* const osc, const float* frames, const unsigned char* samples, tMempool* const mp)
+{
+    _tWaveTable* w = *osc;
+    _tMempool* m = *mp;
+    int size = w->size;
+    int half = size / 2;
+    
+    tFFT fft;
+    tFFT_initToPool(&fft, size, FFTReal, mp);
+    float* work = (float*) mpool_alloc(sizeof(float) * size, m);
+    float* spectrum = (float*) mpool_alloc(sizeof(float) * size, m);
+    const float invSize = 1.0f / (float)size;
+    
+    for (int f = 0; f < w->numFrames; f++)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            if (frames != NULL) work[i] = frames[(f * size) + i];
+            else if (samples != NULL)
+            {
+                const unsigned char* s = samples + (2 * ((f * size) + i));
+                work[i] = (float)(int16_t)(s[0] | (s[1] << 8)) * (1.0f / 32767.0f);
+            }
+            else work[i] = sinf(TWO_PI * (float)i * invSize);
+        }
+        
+        tFFT_forward(&fft, work, spectrum);
+        spectrum[0] = 0.0f; // DC
+        spectrum[1] = 0.0f; // Nyquist
+        
+        // Each level drops the top octave of harmonics left in the one before
+        int harmonics = half;
+        for (int l = 0; l < w->numLevels; l++)
+        {
+            for (int k = (half >> l) + 1; k <= harmonics && k < half; k++)
+            {
+                spectrum[2 * k] = 0.0f;
+                spectrum[(2 * k) + 1] = 0.0f;
+            }
+            harmonics = half >> l;
+            
+            float* table = w->tables + (((f * w->numLevels) + l) * size);
+            tFFT_inverse(&fft, spectrum, table);
+            for (int i = 0; i < size; i++) table[i] *= invSize;
+        }
+    }
+    
+    mpool_free((char*)spectrum, m);
+    mpool_free((char*)work, m);
+    tFFT_free(&fft);
+}
+
+// Sizes the tables can be built at. Anything else falls back to a sine.
+static int wavetable_valid(uint32_t size, uint32_t numFrames)
+{
+    return (size >= 4) && (size <= 65536) && ((size & (size - 1)) == 0) && (numFrames > 0);
+}
+
+static void wavetable_alloc(tWaveTable* const osc, int size, int numFrames, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tWaveTable* w = *osc = (_tWaveTable*) mpool_alloc(sizeof(_tWaveTable), m);
+    w->mempool = m;
+    
+    int log2Size = 0;
+    while ((2 << log2Size) <= size) log2Size++;
+    w->size = 1 << log2Size;
+    w->sizeShift = 32 - log2Size;
+    w->fracScale = 1.0f / (float)(1u << w->sizeShift);
+    w->numFrames = numFrames;
+    w->numLevels = log2Size; // (size / 2) >> l harmonics, down to 1
+    w->tables = (float*) mpool_alloc(sizeof(float) * w->size * w->numLevels * numFrames, m);
+    
+    w->phase = 0;
+    w->inc = 0;
+    w->freq = 0.0f;
+    w->index = 0.0f;
+}
+
+void    tWaveTable_init(tWaveTable* const osc, const float* frames, int size, int numFrames)
+{
+    tWaveTable_initToPool(osc, frames, size, numFrames, &leaf.mempool);
+}
+
+void    tWaveTable_initToPool(tWaveTable* const osc, const float* frames, int size, int numFrames, tMempool* const mp)
+{
+    if (size > 0 && numFrames > 0 && wavetable_valid((uint32_t)size, (uint32_t)numFrames))
+    {
+        wavetable_alloc(osc, size, numFrames, mp);
+        wavetable_build(osc, frames, NULL, mp);
+    }
+    else
+    {
+        wavetable_alloc(osc, 64, 1, mp);
+        wavetable_build(osc, NULL, NULL, mp);
+    }
+    tWaveTable_setFreq(osc, 220.0f);
+}
+
+int     tWaveTable_initFromData(tWaveTable* const osc, const char* data, int length)
+{
+    return tWaveTable_initFromDataToPool(osc, data, length, &leaf.mempool);
+}
+
+int     tWaveTable_initFromDataToPool(tWaveTable* const osc, const char* data, int length, tMempool* const mp)
+{
+    const unsigned char* d = (const unsigned char*) data;
+    int valid = 0;
+    uint32_t size = 0, numFrames = 0;
+    
+    if (length >= (int)sizeof(tWaveTableFileHeader) && d[0] == 'L' && d[1] == 'W' && d[2] == 'T' && d[3] == '1')
+    {
+        size = d[4] | (d[5] << 8) | (d[6] << 16) | ((uint32_t)d[7] << 24);
+        numFrames = d[8] | (d[9] << 8) | (d[10] << 16) | ((uint32_t)d[11] << 24);
+        valid = wavetable_valid(size, numFrames) &&
+                ((uint32_t)(length - sizeof(tWaveTableFileHeader)) / (2 * size) >= numFrames);
+    }
+    
+    if (valid)
+    {
+        wavetable_alloc(osc, (int)size, (int)numFrames, mp);
+        wavetable_build(osc, NULL, d + sizeof(tWaveTableFileHeader), mp);
+    }
+    else
+    {
+        wavetable_alloc(osc, 64, 1, mp);
+        wavetable_build(osc, NULL, NULL, mp);
+    }
+    tWaveTable_setFreq(osc, 220.0f);
+    
+    return valid;
+}
+
+void    tWaveTable_free(tWaveTable* const osc)
+{
+    _tWaveTable* w = *osc;
+    
+    mpool_free((char*)w->tables, w->mempool);
+    mpool_free((char*)w, w->mempool);
+}
+
+float   tWaveTable_tick(tWaveTable* const osc)
+{
+    _tWaveTable* w = *osc;
+    
+    // Phasor increment, wraps on overflow
+    w->phase += w->inc;
+    
+    uint32_t idx = w->phase >> w->sizeShift;
+    uint32_t next = (idx + 1) & (w->size - 1);
+    float frac = (float)(int32_t)(w->phase & ((1u << w->sizeShift) - 1u)) * w->fracScale;
+    
+    const float* t0 = w->table;
+    const float* t1 = t0 + w->levelStride;
+    const float* t2 = t0 + w->frameStride;
+    const float* t3 = t2 + w->levelStride;
+    
+    float a = t0[idx] + (t0[next] - t0[idx]) * frac;
+    float b = t1[idx] + (t1[next] - t1[idx]) * frac;
+    float c = t2[idx] + (t2[next] - t2[idx]) * frac;
+    float d = t3[idx] + (t3[next] - t3[idx]) * frac;
+    
+    float lo = a + (b - a) * w->levelMix;
+    float hi = c + (d - c) * w->levelMix;
+    
+    return lo + (hi - lo) * w->frameMix;
+}
+
+void    tWaveTable_process(tWaveTable* const osc, float* out, int n)
+{
+    _tWaveTable* w = *osc;
+    
+    uint32_t phase = w->phase;
+    const uint32_t inc = w->inc;
+    const int shift = w->sizeShift;
+    const uint32_t fracMask = (1u << shift) - 1u;
+    const uint32_t sizeMask = (uint32_t)w->size - 1u;
+    const float fracScale = w->fracScale;
+    const float levelMix = w->levelMix;
+    const float frameMix = w->frameMix;
+    const float* t0 = w->table;
+    const float* t1 = t0 + w->levelStride;
+    
+    if (w->frameStride == 0)
+    {
+        // Single frame, or the index is at the last one
+        for (int i = 0; i < n; i++)
+        {
+            phase += inc;
+            
+            uint32_t idx = phase >> shift;
+            uint32_t next = (idx + 1) & sizeMask;
+            float frac = (float)(int32_t)(phase & fracMask) * fracScale;
+            
+            float a = t0[idx] + (t0[next] - t0[idx]) * frac;
+            float b = t1[idx] + (t1[next] - t1[idx]) * frac;
+            
+            out[i] = a + (b - a) * levelMix;
+        }
+    }
+    else
+    {
+        const float* t2 = t0 + w->frameStride;
+        const float* t3 = t2 + w->levelStride;
+        
+        for (int i = 0; i < n; i++)
+        {
+            phase += inc;
+            
+            uint32_t idx = phase >> shift;
+            uint32_t next = (idx + 1) & sizeMask;
+            float frac = (float)(int32_t)(phase & fracMask) * fracScale;
+            
+            float a = t0[idx] + (t0[next] - t0[idx]) * frac;
+            float b = t1[idx] + (t1[next] - t1[idx]) * frac;
+            float c = t2[idx] + (t2[next] - t2[idx]) * frac;
+            float d = t3[idx] + (t3[next] - t3[idx]) * frac;
+            
+            float lo = a + (b - a) * levelMix;
+            float hi = c + (d - c) * levelMix;
+            
+            out[i] = lo + (hi - lo) * frameMix;
+        }
+    }
+    
+    w->phase = phase;
+}
+
+void    tWaveTable_setFreq(tWaveTable* const osc, float freq)
+{
+    _tWaveTable* w = *osc;
+    
+    w->freq = freq;
+    w->inc = osc_phaseInc(freq);
+    
+    wavetable_updateTable(w);
+}
+
+void    tWaveTable_setIndex(tWaveTable* const osc, float index)
+{
+    _tWaveTable* w = *osc;
+    
+    if (index < 0.0f) index = 0.0f;
+    else if (index > 1.0f) index = 1.0f;
+    w->index = index;
+    
+    wavetable_updateTable(w);
+}
+
+int     tWaveTable_getNumFrames(tWaveTable* const osc)
+{
+    _tWaveTable* w = *osc;
+    
+    return w->numFrames;
+}
+
+void    tWaveTableSampleRateChanged(tWaveTable* const osc)
+{
+    _tWaveTable* w = *osc;
+    
+    w->inc = osc_phaseInc(w->freq);
+    wavetable_updateTable(w);
+}
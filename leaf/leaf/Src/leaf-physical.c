@@ -16,6 +16,15 @@
 
 #endif
 
+// Vector units used by tModalBank, if the target has one
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_MODALBANK_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEAF_MODALBANK_SSE 1
+#endif
+
 /* ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ tPluck ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ */
 void    tPluck_init         (tPluck* const pl, float lowestFrequency)
 {
@@ -956,3 +965,343 @@ void     tReedTable_setSlope   (tReedTable* const pm, float slope)
     _tReedTable* p = *pm;
     p->slope = slope;
 }
+
+/* ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ tModalBank ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ */
+
+// Samples per pass over the modes. Also how often the bank checks whether it can sleep.
+#define MODALBANK_CHUNK 64
+
+void    tModalBank_init         (tModalBank* const mb, int numModes)
+{
+    tModalBank_initToPool(mb, numModes, &leaf.mempool);
+}
+
+void    tModalBank_initToPool   (tModalBank* const mb, int numModes, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tModalBank* b = *mb = (_tModalBank*) mpool_alloc(sizeof(_tModalBank), m);
+    b->mempool = m;
+    
+    if (numModes < 1) numModes = 1;
+    b->numModes = numModes;
+    b->numLanes = ((numModes + MODALBANK_LANES - 1) / MODALBANK_LANES) * MODALBANK_LANES;
+    
+    b->freq = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->decay = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->gain = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->a1 = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->a2 = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->b = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->y1 = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    b->y2 = (float*) mpool_alloc(sizeof(float) * b->numLanes, m);
+    
+    // Every mode, and the padding lanes for good, start silent
+    for (int i = 0; i < b->numLanes; i++)
+    {
+        b->freq[i] = 0.0f;
+        b->decay[i] = 0.0f;
+        b->gain[i] = 0.0f;
+        b->a1[i] = 0.0f;
+        b->a2[i] = 0.0f;
+        b->b[i] = 0.0f;
+    }
+    
+    b->inputPeak = 0.0f;
+    b->sinceCheck = 0;
+    tModalBank_clear(mb);
+}
+
+void    tModalBank_free         (tModalBank* const mb)
+{
+    _tModalBank* b = *mb;
+    
+    mpool_free((char*)b->y2, b->mempool);
+    mpool_free((char*)b->y1, b->mempool);
+    mpool_free((char*)b->b, b->mempool);
+    mpool_free((char*)b->a2, b->mempool);
+    mpool_free((char*)b->a1, b->mempool);
+    mpool_free((char*)b->gain, b->mempool);
+    mpool_free((char*)b->decay, b->mempool);
+    mpool_free((char*)b->freq, b->mempool);
+    mpool_free((char*)b, b->mempool);
+}
+
+static void modalbank_updateMode(_tModalBank* b, int mode)
+{
+    float w = TWO_PI * b->freq[mode] * leaf.invSampleRate;
+    
+    if ((w <= 0.0f) || (w >= PI) || (b->decay[mode] <= 0.0f))
+    {
+        b->a1[mode] = 0.0f;
+        b->a2[mode] = 0.0f;
+        b->b[mode] = 0.0f;
+        return;
+    }
+    
+    // r^(decay * sampleRate) = 0.001, 60 dB down
+    float r = expf(-6.9077553f / (b->decay[mode] * leaf.sampleRate));
+    b->a1[mode] = 2.0f * r * cosf(w);
+    b->a2[mode] = r * r;
+    b->b[mode] = b->gain[mode] * sinf(w);
+}
+
+void    tModalBank_setMode      (tModalBank* const mb, int mode, float freq, float decay, float gain)
+{
+    _tModalBank* b = *mb;
+    
+    if (mode < 0 || mode >= b->numModes) return;
+    
+    b->freq[mode] = freq;
+    b->decay[mode] = decay;
+    b->gain[mode] = gain;
+    modalbank_updateMode(b, mode);
+}
+
+void    tModalBank_setFreq      (tModalBank* const mb, int mode, float freq)
+{
+    _tModalBank* b = *mb;
+    
+    if (mode < 0 || mode >= b->numModes) return;
+    
+    b->freq[mode] = freq;
+    modalbank_updateMode(b, mode);
+}
+
+void    tModalBank_setDecay     (tModalBank* const mb, int mode, float decay)
+{
+    _tModalBank* b = *mb;
+    
+    if (mode < 0 || mode >= b->numModes) return;
+    
+    b->decay[mode] = decay;
+    modalbank_updateMode(b, mode);
+}
+
+void    tModalBank_setGain      (tModalBank* const mb, int mode, float gain)
+{
+    _tModalBank* b = *mb;
+    
+    if (mode < 0 || mode >= b->numModes) return;
+    
+    b->gain[mode] = gain;
+    modalbank_updateMode(b, mode);
+}
+
+void    tModalBank_clear        (tModalBank* const mb)
+{
+    _tModalBank* b = *mb;
+    
+    for (int i = 0; i < b->numLanes; i++)
+    {
+        b->y1[i] = 0.0f;
+        b->y2[i] = 0.0f;
+    }
+    b->active = 0;
+}
+
+int     tModalBank_getNumModes  (tModalBank* const mb)
+{
+    _tModalBank* b = *mb;
+    return b->numModes;
+}
+
+int     tModalBank_isActive     (tModalBank* const mb)
+{
+    _tModalBank* b = *mb;
+    return b->active;
+}
+
+#if LEAF_MODALBANK_SSE
+
+// Writes the sum of every mode over a chunk of input. The groups of modes are summed
+// lane-wise into acc and only added across lanes once per sample at the end.
+static void modalbank_processChunk(_tModalBank* b, const float* x, float* out, int n)
+{
+    __m128 acc[MODALBANK_CHUNK];
+    
+    for (int i = 0; i < n; i++) acc[i] = _mm_setzero_ps();
+    
+    for (int g = 0; g < b->numLanes; g += MODALBANK_LANES)
+    {
+        const __m128 a1 = _mm_loadu_ps(&b->a1[g]);
+        const __m128 a2 = _mm_loadu_ps(&b->a2[g]);
+        const __m128 bb = _mm_loadu_ps(&b->b[g]);
+        __m128 y1 = _mm_loadu_ps(&b->y1[g]);
+        __m128 y2 = _mm_loadu_ps(&b->y2[g]);
+        
+        for (int i = 0; i < n; i++)
+        {
+            __m128 y = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a1, y1), _mm_mul_ps(a2, y2)), _mm_mul_ps(bb, _mm_set1_ps(x[i])));
+            y2 = y1;
+            y1 = y;
+            acc[i] = _mm_add_ps(acc[i], y);
+        }
+        
+        _mm_storeu_ps(&b->y1[g], y1);
+        _mm_storeu_ps(&b->y2[g], y2);
+    }
+    
+    for (int i = 0; i < n; i++)
+    {
+        __m128 s = _mm_add_ps(acc[i], _mm_movehl_ps(acc[i], acc[i]));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        out[i] = _mm_cvtss_f32(s);
+    }
+}
+
+#elif LEAF_MODALBANK_NEON
+
+// Writes the sum of every mode over a chunk of input. The groups of modes are summed
+// lane-wise into acc and only added across lanes once per sample at the end.
+static void modalbank_processChunk(_tModalBank* b, const float* x, float* out, int n)
+{
+    float32x4_t acc[MODALBANK_CHUNK];
+    
+    for (int i = 0; i < n; i++) acc[i] = vdupq_n_f32(0.0f);
+    
+    for (int g = 0; g < b->numLanes; g += MODALBANK_LANES)
+    {
+        const float32x4_t a1 = vld1q_f32(&b->a1[g]);
+        const float32x4_t a2 = vld1q_f32(&b->a2[g]);
+        const float32x4_t bb = vld1q_f32(&b->b[g]);
+        float32x4_t y1 = vld1q_f32(&b->y1[g]);
+        float32x4_t y2 = vld1q_f32(&b->y2[g]);
+        
+        for (int i = 0; i < n; i++)
+        {
+            float32x4_t y = vmlaq_n_f32(vmlsq_f32(vmulq_f32(a1, y1), a2, y2), bb, x[i]);
+            y2 = y1;
+            y1 = y;
+            acc[i] = vaddq_f32(acc[i], y);
+        }
+        
+        vst1q_f32(&b->y1[g], y1);
+        vst1q_f32(&b->y2[g], y2);
+    }
+    
+    for (int i = 0; i < n; i++)
+    {
+#if defined(__aarch64__)
+        out[i] = vaddvq_f32(acc[i]);
+#else
+        float32x2_t s = vadd_f32(vget_low_f32(acc[i]), vget_high_f32(acc[i]));
+        out[i] = vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+    }
+}
+
+#else
+
+// Writes the sum of every mode over a chunk of input. Without a vector unit the modes
+// of a group still run side by side, so the FPU has MODALBANK_LANES independent
+// recursions to overlap instead of waiting on one.
+static void modalbank_processChunk(_tModalBank* b, const float* x, float* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = 0.0f;
+    
+    for (int g = 0; g < b->numLanes; g += MODALBANK_LANES)
+    {
+        float a1[MODALBANK_LANES], a2[MODALBANK_LANES], bb[MODALBANK_LANES];
+        float y1[MODALBANK_LANES], y2[MODALBANK_LANES];
+        
+        for (int k = 0; k < MODALBANK_LANES; k++)
+        {
+            a1[k] = b->a1[g + k];
+            a2[k] = b->a2[g + k];
+            bb[k] = b->b[g + k];
+            y1[k] = b->y1[g + k];
+            y2[k] = b->y2[g + k];
+        }
+        
+        for (int i = 0; i < n; i++)
+        {
+            float sum = 0.0f;
+            for (int k = 0; k < MODALBANK_LANES; k++)
+            {
+                float y = (a1[k] * y1[k]) - (a2[k] * y2[k]) + (bb[k] * x[i]);
+                y2[k] = y1[k];
+                y1[k] = y;
+                sum += y;
+            }
+            out[i] += sum;
+        }
+        
+        for (int k = 0; k < MODALBANK_LANES; k++)
+        {
+            b->y1[g + k] = y1[k];
+            b->y2[g + k] = y2[k];
+        }
+    }
+}
+
+#endif
+
+// Once per MODALBANK_CHUNK samples, goes to sleep if nothing above the threshold
+// came in and every mode has rung out. Zeroing the modes then also keeps them
+// out of denormals.
+static void modalbank_checkSleep(_tModalBank* b, int n)
+{
+    b->sinceCheck += n;
+    if (b->sinceCheck < MODALBANK_CHUNK) return;
+    b->sinceCheck = 0;
+    
+    float peak = b->inputPeak;
+    b->inputPeak = 0.0f;
+    if (peak > leaf.silenceThreshold) return;
+    
+    for (int i = 0; i < b->numLanes; i++)
+    {
+        if ((fabsf(b->y1[i]) > leaf.silenceThreshold) || (fabsf(b->y2[i]) > leaf.silenceThreshold)) return;
+    }
+    
+    for (int i = 0; i < b->numLanes; i++)
+    {
+        b->y1[i] = 0.0f;
+        b->y2[i] = 0.0f;
+    }
+    b->active = 0;
+}
+
+void    tModalBank_process      (tModalBank* const mb, const float* input, float* output, int n)
+{
+    _tModalBank* b = *mb;
+    float x[MODALBANK_CHUNK];
+    
+    for (int start = 0; start < n; start += MODALBANK_CHUNK)
+    {
+        int len = n - start;
+        if (len > MODALBANK_CHUNK) len = MODALBANK_CHUNK;
+        
+        // Copied so input and output can be the same buffer
+        float peak = b->inputPeak;
+        for (int i = 0; i < len; i++)
+        {
+            x[i] = input[start + i];
+            float a = fabsf(x[i]);
+            if (a > peak) peak = a;
+        }
+        b->inputPeak = peak;
+        
+        if (!b->active)
+        {
+            if (peak <= leaf.silenceThreshold)
+            {
+                b->inputPeak = 0.0f;
+                for (int i = 0; i < len; i++) output[start + i] = 0.0f;
+                continue;
+            }
+            b->active = 1;
+            b->sinceCheck = 0;
+        }
+        
+        modalbank_processChunk(b, x, output + start, len);
+        modalbank_checkSleep(b, len);
+    }
+}
+
+float   tModalBank_tick         (tModalBank* const mb, float input)
+{
+    float out;
+    tModalBank_process(mb, &input, &out, 1);
+    return out;
+}
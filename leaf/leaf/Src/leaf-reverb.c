@@ -133,6 +133,46 @@ float   tPRCReverb_tick(tPRCReverb* const rev, float input)
     return out;
 }
 
+void    tPRCReverb_process(tPRCReverb* const rev, const float* input, float* output, int n)
+{
+    _tPRCReverb* r = *rev;
+    
+    const float allpassCoeff = r->allpassCoeff;
+    const float combCoeff = r->combCoeff;
+    const float wet = r->mix, dry = 1.0f - r->mix;
+    
+    // The delay lines feed back their own last output, so keep those in registers
+    // rather than asking each tDelay for it every sample.
+    float ap0 = tDelay_getLastOut(&r->allpassDelays[0]);
+    float ap1 = tDelay_getLastOut(&r->allpassDelays[1]);
+    float comb = tDelay_getLastOut(&r->combDelay);
+    
+    for (int i = 0; i < n; i++)
+    {
+        float in = input[i];
+        
+        float temp0 = (allpassCoeff * ap0) + in;
+        float temp = ap0;
+        ap0 = tDelay_tick(&r->allpassDelays[0], temp0);
+        temp0 = -(allpassCoeff * temp0) + temp;
+        
+        float temp1 = (allpassCoeff * ap1) + temp0;
+        temp = ap1;
+        ap1 = tDelay_tick(&r->allpassDelays[1], temp1);
+        temp1 = -(allpassCoeff * temp1) + temp;
+        
+        comb = tDelay_tick(&r->combDelay, temp1 + (combCoeff * comb));
+        
+        output[i] = (wet * comb) + (dry * in);
+    }
+    
+    if (n > 0)
+    {
+        r->lastIn = input[n-1];
+        r->lastOut = output[n-1];
+    }
+}
+
 void     tPRCReverbSampleRateChanged (tPRCReverb* const rev)
 {
     _tPRCReverb* r = *rev;
@@ -296,6 +336,71 @@ float   tNReverb_tick(tNReverb* const rev, float input)
     return out;
 }
 
+void    tNReverb_process(tNReverb* const rev, const float* input, float* output, int n)
+{
+    _tNReverb* r = *rev;
+    
+    // Run the delay lines on local copies and store them back at the end
+    _tLinearDelay combs[6];
+    _tLinearDelay allpasses[5];
+    for (int k = 0; k < 6; k++) combs[k] = *r->combDelays[k];
+    for (int k = 0; k < 5; k++) allpasses[k] = *r->allpassDelays[k];
+    
+    float combCoeffs[6];
+    for (int k = 0; k < 6; k++) combCoeffs[k] = r->combCoeffs[k];
+    const float allpassCoeff = r->allpassCoeff;
+    const float dry = 1.0f - r->mix;
+    float lowpassState = r->lowpassState;
+    float out = r->lastOut;
+    
+    for (int i = 0; i < n; i++)
+    {
+        float temp, temp0, temp1, temp2;
+        
+        temp0 = 0.0;
+        for (int k = 0; k < 6; k++)
+        {
+            temp = input[i] + (combCoeffs[k] * combs[k].lastOut);
+            temp0 += _tLinearDelay_tick(&combs[k], temp);
+        }
+        
+        for (int k = 0; k < 3; k++)
+        {
+            temp = allpasses[k].lastOut;
+            temp1 = allpassCoeff * temp;
+            temp1 += temp0;
+            _tLinearDelay_tick(&allpasses[k], temp1);
+            temp0 = -(allpassCoeff * temp1) + temp;
+        }
+        
+        lowpassState = 0.7f * lowpassState + 0.3f * temp0;
+        
+        temp = allpasses[3].lastOut;
+        temp1 = allpassCoeff * temp;
+        temp1 += lowpassState;
+        _tLinearDelay_tick(&allpasses[3], temp1);
+        temp1 = -(allpassCoeff * temp1) + temp;
+        
+        temp = allpasses[4].lastOut;
+        temp2 = allpassCoeff * temp;
+        temp2 += temp1;
+        _tLinearDelay_tick(&allpasses[4], temp2);
+        out = -(allpassCoeff * temp2) + temp;
+        
+        out += dry * input[i];
+        output[i] = out;
+    }
+    
+    for (int k = 0; k < 6; k++) *r->combDelays[k] = combs[k];
+    for (int k = 0; k < 5; k++) *r->allpassDelays[k] = allpasses[k];
+    r->lowpassState = lowpassState;
+    if (n > 0)
+    {
+        r->lastIn = input[n - 1];
+        r->lastOut = out;
+    }
+}
+
 void   tNReverb_tickStereo(tNReverb* const rev, float input, float* output)
 {
     _tNReverb* r = *rev;
@@ -362,6 +467,38 @@ float       in_allpass_delays[4] = { 4.771f, 3.595f, 12.73f, 9.307f };
 float       in_allpass_gains[4] = { 0.75f, 0.75f, 0.625f, 0.625f };
 
 
+// Longest path from the input through the tank and round both feedback loops, in ms before
+// scaling by size. Anything still in the reverb shows up at the loop outputs within this long.
+#define DATTORRO_TANK_MS (200.0f + 30.4f + 390.44f + 342.96f)
+
+static void dattorroUpdateQuietLength(_tDattorroReverb* r)
+{
+    r->quietLength = (uint32_t)SAMP(DATTORRO_TANK_MS);
+}
+
+// Returns 1 if the reverb is asleep and should skip this sample, wakes it on input above the threshold.
+static inline int dattorroSleeping(_tDattorroReverb* r, float input)
+{
+    if (r->active) return 0;
+    if (fabsf(input) <= leaf.silenceThreshold) return 1;
+    r->active = 1;
+    r->quietCount = 0;
+    return 0;
+}
+
+static inline void dattorroCheckQuiet(_tDattorroReverb* r, float input)
+{
+    if (r->frozen || (fabsf(input) > leaf.silenceThreshold) ||
+        (fabsf(r->f1_last) > leaf.silenceThreshold) || (fabsf(r->f2_last) > leaf.silenceThreshold))
+    {
+        r->quietCount = 0;
+    }
+    else if (++r->quietCount >= r->quietLength)
+    {
+        r->active = 0;
+    }
+}
+
 void    tDattorroReverb_init              (tDattorroReverb* const rev)
 {
     tDattorroReverb_initToPool(rev, &leaf.mempool);
@@ -377,6 +514,8 @@ void    tDattorroReverb_initToPool        (tDattorroReverb* const rev, tMempool*
     r->size = 1.f;
     r->t = r->size * leaf.sampleRate * 0.001f;
     r->frozen = 0;
+    r->active = 0;
+    r->quietCount = 0;
     // INPUT
     tTapeDelay_initToPool(&r->in_delay, 0.f, SAMP(200.f), mp);
     tOnePole_initToPool(&r->in_filter, 1.f, mp);
@@ -419,6 +558,8 @@ void    tDattorroReverb_initToPool        (tDattorroReverb* const rev, tMempool*
     
     
     // PARAMETERS
+    dattorroUpdateQuietLength(r);
+    
     tDattorroReverb_setMix(rev, 0.5f);
     
     tDattorroReverb_setInputDelay(rev,  0.f);
@@ -492,6 +633,8 @@ float   tDattorroReverb_tick              (tDattorroReverb* const rev, float inp
 
     float in_sample, f1_sample,f1_delay_2_sample,  f2_sample, f2_delay_2_sample;
 
+    if (dattorroSleeping(r, input)) return input * (1.0f - r->mix);
+
     if (r->frozen)
     {
     	input = 0.0f;
@@ -592,14 +735,168 @@ float   tDattorroReverb_tick              (tDattorroReverb* const rev, float inp
     
     float sample = (f1_sample + f2_sample) * 0.5f;
     
+    dattorroCheckQuiet(r, input);
+    
     return (input * (1.0f - r->mix) + sample * r->mix);
 }
 
+void    tDattorroReverb_process       (tDattorroReverb* const rev, const float* input, float* output, int n)
+{
+    _tDattorroReverb* r = *rev;
+    
+    // Run every delay line, filter and LFO on a local copy and store them back at the end
+    _tTapeDelay inDelay = *r->in_delay;
+    _tTapeDelay f1Delay1 = *r->f1_delay_1, f1Delay2 = *r->f1_delay_2, f1Delay3 = *r->f1_delay_3;
+    _tTapeDelay f2Delay1 = *r->f2_delay_1, f2Delay2 = *r->f2_delay_2, f2Delay3 = *r->f2_delay_3;
+    
+    _tAllpass inAllpass[4], f1Allpass = *r->f1_allpass, f2Allpass = *r->f2_allpass;
+    _tLinearDelay inAllpassDelay[4], f1AllpassDelay = *f1Allpass.delay, f2AllpassDelay = *f2Allpass.delay;
+    for (int k = 0; k < 4; k++)
+    {
+        inAllpass[k] = *r->in_allpass[k];
+        inAllpassDelay[k] = *inAllpass[k].delay;
+    }
+    
+    _tOnePole inFilter = *r->in_filter, f1Filter = *r->f1_filter, f2Filter = *r->f2_filter;
+    _tHighpass f1hp = *r->f1_hp, f2hp = *r->f2_hp;
+    _tCycle f1Lfo = *r->f1_lfo, f2Lfo = *r->f2_lfo;
+    
+    const float f1Center = SAMP(30.51f), f2Center = SAMP(22.58f), lfoDepth = SAMP(4.0f);
+    const float f1Taps[7] = { SAMP(8.9f), SAMP(99.8f), SAMP(64.2f), SAMP(67.f), SAMP(66.8f), SAMP(6.3f), SAMP(35.8f) };
+    const float f2Taps[7] = { SAMP(11.8f), SAMP(121.7f), SAMP(6.3f), SAMP(89.7f), SAMP(70.8f), SAMP(11.2f), SAMP(4.1f) };
+    
+    const float feedbackGain = r->feedback_gain;
+    const float mix = r->mix;
+    const float threshold = leaf.silenceThreshold;
+    const uint32_t frozen = r->frozen;
+    const uint32_t quietLength = r->quietLength;
+    uint8_t active = r->active;
+    uint32_t quietCount = r->quietCount;
+    float f1Last = r->f1_last, f2Last = r->f2_last;
+    float f1Delay2Last = r->f1_delay_2_last, f2Delay2Last = r->f2_delay_2_last;
+    
+    for (int i = 0; i < n; i++)
+    {
+        float x = input[i];
+        
+        // same as dattorroSleeping
+        if (!active)
+        {
+            if (fabsf(x) <= threshold)
+            {
+                output[i] = x * (1.0f - mix);
+                continue;
+            }
+            active = 1;
+            quietCount = 0;
+        }
+        
+        if (frozen) x = 0.0f;
+        
+        // INPUT
+        float in_sample = _tTapeDelay_tick(&inDelay, x);
+        in_sample = _tOnePole_tick(&inFilter, in_sample);
+        for (int k = 0; k < 4; k++) in_sample = _tAllpass_tick(&inAllpass[k], &inAllpassDelay[k], in_sample);
+        
+        // FEEDBACK 1
+        float f1_sample = in_sample + f2Last;
+        _tLinearDelay_setDelay(&f1AllpassDelay, f1Center + _tCycle_tick(&f1Lfo) * lfoDepth);
+        f1_sample = _tAllpass_tick(&f1Allpass, &f1AllpassDelay, f1_sample);
+        f1_sample = _tTapeDelay_tick(&f1Delay1, f1_sample);
+        f1_sample = _tOnePole_tick(&f1Filter, f1_sample);
+        f1_sample = f1_sample + f1Delay2Last * 0.5f;
+        f1Delay2Last = _tTapeDelay_tick(&f1Delay2, f1_sample * 0.5f);
+        f1_sample = f1Delay2Last + f1_sample;
+        f1_sample = _tHighpass_tick(&f1hp, f1_sample) * feedbackGain;
+        f1Last = _tTapeDelay_tick(&f1Delay3, f1_sample);
+        
+        // FEEDBACK 2
+        float f2_sample = in_sample + f1Last;
+        _tLinearDelay_setDelay(&f2AllpassDelay, f2Center + _tCycle_tick(&f2Lfo) * lfoDepth);
+        f2_sample = _tAllpass_tick(&f2Allpass, &f2AllpassDelay, f2_sample);
+        f2_sample = _tTapeDelay_tick(&f2Delay1, f2_sample);
+        f2_sample = _tOnePole_tick(&f2Filter, f2_sample);
+        f2_sample = f2_sample + f2Delay2Last * 0.5f;
+        f2Delay2Last = _tTapeDelay_tick(&f2Delay2, f2_sample * 0.5f);
+        f2_sample = f2Delay2Last + f2_sample;
+        f2_sample = _tHighpass_tick(&f2hp, f2_sample) * feedbackGain;
+        f2Last = _tTapeDelay_tick(&f2Delay3, f2_sample);
+        
+        // TAP OUT 1
+        f1_sample =  _tTapeDelay_tapOut(&f1Delay1, f1Taps[0]) + _tTapeDelay_tapOut(&f1Delay1, f1Taps[1]);
+        f1_sample -= _tTapeDelay_tapOut(&f1Delay2, f1Taps[2]);
+        f1_sample += _tTapeDelay_tapOut(&f1Delay3, f1Taps[3]);
+        f1_sample -= _tTapeDelay_tapOut(&f2Delay1, f1Taps[4]);
+        f1_sample -= _tTapeDelay_tapOut(&f2Delay2, f1Taps[5]);
+        f1_sample -= _tTapeDelay_tapOut(&f2Delay3, f1Taps[6]);
+        f1_sample *= 0.14f;
+        
+        // TAP OUT 2
+        f2_sample =  _tTapeDelay_tapOut(&f2Delay1, f2Taps[0]) + _tTapeDelay_tapOut(&f2Delay1, f2Taps[1]);
+        f2_sample -= _tTapeDelay_tapOut(&f2Delay2, f2Taps[2]);
+        f2_sample += _tTapeDelay_tapOut(&f2Delay3, f2Taps[3]);
+        f2_sample -= _tTapeDelay_tapOut(&f1Delay1, f2Taps[4]);
+        f2_sample -= _tTapeDelay_tapOut(&f1Delay2, f2Taps[5]);
+        f2_sample -= _tTapeDelay_tapOut(&f1Delay3, f2Taps[6]);
+        f2_sample *= 0.14f;
+        
+        float sample = (f1_sample + f2_sample) * 0.5f;
+        
+        // same as dattorroCheckQuiet
+        if (frozen || (fabsf(x) > threshold) || (fabsf(f1Last) > threshold) || (fabsf(f2Last) > threshold))
+        {
+            quietCount = 0;
+        }
+        else if (++quietCount >= quietLength)
+        {
+            active = 0;
+        }
+        
+        output[i] = x * (1.0f - mix) + sample * mix;
+    }
+    
+    *r->in_delay = inDelay;
+    *r->f1_delay_1 = f1Delay1;
+    *r->f1_delay_2 = f1Delay2;
+    *r->f1_delay_3 = f1Delay3;
+    *r->f2_delay_1 = f2Delay1;
+    *r->f2_delay_2 = f2Delay2;
+    *r->f2_delay_3 = f2Delay3;
+    for (int k = 0; k < 4; k++)
+    {
+        *r->in_allpass[k] = inAllpass[k];
+        *inAllpass[k].delay = inAllpassDelay[k];
+    }
+    *r->f1_allpass = f1Allpass;
+    *f1Allpass.delay = f1AllpassDelay;
+    *r->f2_allpass = f2Allpass;
+    *f2Allpass.delay = f2AllpassDelay;
+    *r->in_filter = inFilter;
+    *r->f1_filter = f1Filter;
+    *r->f2_filter = f2Filter;
+    *r->f1_hp = f1hp;
+    *r->f2_hp = f2hp;
+    *r->f1_lfo = f1Lfo;
+    *r->f2_lfo = f2Lfo;
+    r->active = active;
+    r->quietCount = quietCount;
+    r->f1_last = f1Last;
+    r->f2_last = f2Last;
+    r->f1_delay_2_last = f1Delay2Last;
+    r->f2_delay_2_last = f2Delay2Last;
+}
+
 void   tDattorroReverb_tickStereo              (tDattorroReverb* const rev, float input, float* output)
 {
     _tDattorroReverb* r = *rev;
     float in_sample, f1_sample,f1_delay_2_sample,  f2_sample, f2_delay_2_sample;
 
+    if (dattorroSleeping(r, input))
+    {
+        output[0] = output[1] = input * (1.0f - r->mix);
+        return;
+    }
+
     if (r->frozen)
     {
     	input = 0.0f;
@@ -710,6 +1007,8 @@ void   tDattorroReverb_tickStereo              (tDattorroReverb* const rev, floa
 
     f2_sample *=    0.14f;
 
+    dattorroCheckQuiet(r, input);
+
     output[0] = input * (1.0f - r->mix) + f1_sample  * r->mix;
     output[1] = input * (1.0f - r->mix) + f2_sample * r->mix;
 
@@ -790,6 +1089,8 @@ void    tDattorroReverb_setSize           (tDattorroReverb* const rev, float siz
     tTapeDelay_setDelay(&r->f2_delay_1, SAMP(149.62f));
     tTapeDelay_setDelay(&r->f2_delay_2, SAMP(60.48f));
     tTapeDelay_setDelay(&r->f2_delay_3, SAMP(106.28f));
+    
+    dattorroUpdateQuietLength(r);
 }
 
 void    tDattorroReverb_setInputDelay     (tDattorroReverb* const rev, float preDelay)
@@ -801,6 +1102,12 @@ void    tDattorroReverb_setInputDelay     (tDattorroReverb* const rev, float pre
     tTapeDelay_setDelay(&r->in_delay, SAMP(r->predelay));
 }
 
+int     tDattorroReverb_isActive          (tDattorroReverb* const rev)
+{
+    _tDattorroReverb* r = *rev;
+    return r->active;
+}
+
 void    tDattorroReverb_setInputFilter    (tDattorroReverb* const rev, float freq)
 {
     _tDattorroReverb* r = *rev;
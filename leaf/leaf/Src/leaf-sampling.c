@@ -26,16 +26,36 @@
 
 void  tBuffer_init (tBuffer* const sb, uint32_t length)
 {
-    tBuffer_initToPool(sb, length, &leaf.mempool);
+    tBuffer_initWithFormatToPool(sb, length, BufferFloat, &leaf.mempool);
 }
 
 void  tBuffer_initToPool (tBuffer* const sb, uint32_t length, tMempool* const mp)
+{
+    tBuffer_initWithFormatToPool(sb, length, BufferFloat, mp);
+}
+
+void  tBuffer_initWithFormat (tBuffer* const sb, uint32_t length, BufferFormat format)
+{
+    tBuffer_initWithFormatToPool(sb, length, format, &leaf.mempool);
+}
+
+void  tBuffer_initWithFormatToPool (tBuffer* const sb, uint32_t length, BufferFormat format, tMempool* const mp)
 {
     _tMempool* m = *mp;
     _tBuffer* s = *sb = (_tBuffer*) mpool_alloc(sizeof(_tBuffer), m);
     s->mempool = m;
     
-    s->buff = (float*) mpool_alloc( sizeof(float) * length, m);
+    s->format = format;
+    s->buff = NULL;
+    s->buff16 = NULL;
+    s->buff24 = NULL;
+    if (format == BufferInt16)      s->buff16 = (int16_t*) mpool_alloc( sizeof(int16_t) * length, m);
+    else if (format == BufferInt24) s->buff24 = (uint8_t*) mpool_alloc( 3 * length, m);
+    else
+    {
+        s->format = BufferFloat;
+        s->buff = (float*) mpool_alloc( sizeof(float) * length, m);
+    }
     
     s->bufferLength = length;
     s->recordedLength = 0;
@@ -48,17 +68,44 @@ void  tBuffer_free (tBuffer* const sb)
 {
     _tBuffer* s = *sb;
     
-    mpool_free((char*)s->buff, s->mempool);
+    if (s->buff != NULL)    mpool_free((char*)s->buff, s->mempool);
+    if (s->buff16 != NULL)  mpool_free((char*)s->buff16, s->mempool);
+    if (s->buff24 != NULL)  mpool_free((char*)s->buff24, s->mempool);
     mpool_free((char*)s, s->mempool);
 }
 
+// Packed samples are rounded and clipped on the way in. 24 bit samples are read into the top three
+// bytes of an int32_t so the sign comes for free, which is why they scale by 2^-31.
+static void bufferSet (_tBuffer* s, uint32_t i, float sample)
+{
+    if (s->format == BufferInt16)
+    {
+        s->buff16[i] = (int16_t) roundf(LEAF_clip(-32768.0f, sample * 32768.0f, 32767.0f));
+    }
+    else if (s->format == BufferInt24)
+    {
+        int32_t x = (int32_t) roundf(LEAF_clip(-8388608.0f, sample * 8388608.0f, 8388607.0f));
+        uint8_t* b = &s->buff24[3 * i];
+        b[0] = (uint8_t) x;
+        b[1] = (uint8_t) (x >> 8);
+        b[2] = (uint8_t) (x >> 16);
+    }
+    else s->buff[i] = sample;
+}
+
+static inline int32_t bufferGet24 (const uint8_t* buff24, int i)
+{
+    const uint8_t* b = &buff24[3 * i];
+    return (int32_t) (((uint32_t) b[0] << 8) | ((uint32_t) b[1] << 16) | ((uint32_t) b[2] << 24));
+}
+
 void tBuffer_tick (tBuffer* const sb, float sample)
 {
     _tBuffer* s = *sb;
     
     if (s->active == 1)
     {
-        s->buff[s->idx] = sample;
+        bufferSet(s, s->idx, sample);
         
         s->idx += 1;
         
@@ -82,8 +129,8 @@ void  tBuffer_read(tBuffer* const sb, float* buff, uint32_t len)
     _tBuffer* s = *sb;
     for (int i = 0; i < s->bufferLength; i++)
     {
-        if (i < len)    s->buff[i] = buff[i];
-        else            s->buff[i] = 0.f;
+        if (i < len)    bufferSet(s, i, buff[i]);
+        else            bufferSet(s, i, 0.f);
     }
     s->recordedLength = len;
 }
@@ -92,6 +139,8 @@ float tBuffer_get (tBuffer* const sb, int idx)
 {
     _tBuffer* s = *sb;
     if ((idx < 0) || (idx >= s->bufferLength)) return 0.f;
+    if (s->format == BufferInt16)   return s->buff16[idx] * (1.0f / 32768.0f);
+    if (s->format == BufferInt24)   return bufferGet24(s->buff24, idx) * (1.0f / 2147483648.0f);
     return s->buff[idx];
 }
 
@@ -131,7 +180,7 @@ void  tBuffer_clear (tBuffer* const sb)
     _tBuffer* s = *sb;
     for (int i = 0; i < s->bufferLength; i++)
     {
-        s->buff[i] = 0.f;
+        bufferSet(s, i, 0.f);
     }
 
 }
@@ -160,12 +209,79 @@ int tBuffer_isActive(tBuffer* const sb)
     return s->active;
 }
 
+BufferFormat tBuffer_getFormat(tBuffer* const sb)
+{
+    _tBuffer* s = *sb;
+    return s->format;
+}
+
 //================================tSampler=====================================
 
 static void handleStartEndChange(tSampler* const sp);
 
 static void attemptStartEndChange(tSampler* const sp);
 
+static inline int wrapIndex (int i, int length)
+{
+    if (i < 0)              return i + length;
+    else if (i >= length)   return i - length;
+    return i;
+}
+
+// Reads n samples starting at i and stepping by dir, as they are stored. Packed formats are scaled to
+// float by the caller once the interpolation is done, which works because every kind is linear in the
+// samples.
+static inline void bufferTaps (const _tBuffer* s, int i, int dir, int n, int length, float* taps)
+{
+    if (s->format == BufferInt16)
+    {
+        for (int k = 0; k < n; k++) taps[k] = s->buff16[wrapIndex(i + (k * dir), length)];
+    }
+    else if (s->format == BufferInt24)
+    {
+        for (int k = 0; k < n; k++) taps[k] = bufferGet24(s->buff24, wrapIndex(i + (k * dir), length));
+    }
+    else
+    {
+        for (int k = 0; k < n; k++) taps[k] = s->buff[wrapIndex(i + (k * dir), length)];
+    }
+}
+
+// Interpolates alpha of the way from sample i to the next one in direction dir
+static inline float samplerRead (_tSampler* p, int i, int dir, float alpha, int length)
+{
+    _tBuffer* s = p->samp;
+    float taps[SINC_TAPS];
+    float y;
+    
+    if (p->quality == InterpolationLinear)
+    {
+        bufferTaps(s, i, dir, 2, length, taps);
+        y = taps[0] + ((taps[1] - taps[0]) * alpha);
+    }
+    else if ((p->quality == InterpolationSinc) && (length >= SINC_TAPS))
+    {
+        bufferTaps(s, i - (3 * dir), dir, SINC_TAPS, length, taps);
+        float phase = alpha * SINC_PHASES;
+        int row = (int) phase;
+        if (row >= SINC_PHASES) row = SINC_PHASES - 1;
+        float frac = phase - row;
+        const float* h0 = __leaf_table_sinc[row];
+        const float* h1 = __leaf_table_sinc[row + 1];
+        y = 0.0f;
+        for (int k = 0; k < SINC_TAPS; k++) y += taps[k] * (h0[k] + ((h1[k] - h0[k]) * frac));
+    }
+    else
+    {
+        bufferTaps(s, i - dir, dir, 4, length, taps);
+        y = LEAF_interpolate_hermite_x(taps[0], taps[1], taps[2], taps[3], alpha);
+    }
+    
+    if (s->format == BufferInt16)   return y * (1.0f / 32768.0f);
+    if (s->format == BufferInt24)   return y * (1.0f / 2147483648.0f);
+    return y;
+}
+
 void tSampler_init(tSampler* const sp, tBuffer* const b)
 {
     tSampler_initToPool(sp, b, &leaf.mempool);
@@ -197,6 +313,7 @@ void tSampler_initToPool(tSampler* const sp, tBuffer* const b, tMempool* const m
     p->bnf = 1;
     
     p->mode = PlayNormal;
+    p->quality = InterpolationCubic;
     
     p->cfxlen = 500; // default 300 sample crossfade
     
@@ -256,8 +373,6 @@ float tSampler_tick        (tSampler* const sp)
     float flipsample = 0.0f;
     float flipMix = 0.0f;
     
-    float* buff = p->samp->buff;
-    
     // Variables so start is also before end
     int myStart = p->start;
     int myEnd = p->end;
@@ -277,25 +392,9 @@ float tSampler_tick        (tSampler* const sp)
     float alpha = rev + (p->idx - idx) * dir;
     idx += rev;
     
-    // Get the indexes for interpolation
-    int i1 = idx-(1*dir);
-    int i2 = idx;
-    int i3 = idx+(1*dir);
-    int i4 = idx+(2*dir);
-    
     int length = p->samp->recordedLength;
     
-    // Wrap as needed
-    i1 = (i1 < length*rev) ? i1 + (length * (1-rev)) : i1 - (length * rev);
-    i2 = (i2 < length*rev) ? i2 + (length * (1-rev)) : i2 - (length * rev);
-    i3 = (i3 < length*(1-rev)) ? i3 + (length * rev) : i3 - (length * (1-rev));
-    i4 = (i4 < length*(1-rev)) ? i4 + (length * rev) : i4 - (length * (1-rev));
-    
-    sample = LEAF_interpolate_hermite_x (buff[i1],
-                                         buff[i2],
-                                         buff[i3],
-                                         buff[i4],
-                                         alpha);
+    sample = samplerRead(p, idx, dir, alpha, length);
     
     int32_t cfxlen = p->cfxlen;
     if (p->len * 0.25f < cfxlen) cfxlen = p->len * 0.25f;
@@ -333,22 +432,7 @@ float tSampler_tick        (tSampler* const sp)
         
         if (p->inCrossfade)
         {
-            int c1 = cdx-(1*dir);
-            int c2 = cdx;
-            int c3 = cdx+(1*dir);
-            int c4 = cdx+(2*dir);
-            
-            // Wrap as needed
-            c1 = (c1 < length * rev) ? c1 + (length * (1-rev)) : c1 - (length * rev);
-            c2 = (c2 < length * rev) ? c2 + (length * (1-rev)) : c2 - (length * rev);
-            c3 = (c3 < length * (1-rev)) ? c3 + (length * rev) : c3 - (length * (1-rev));
-            c4 = (c4 < length * (1-rev)) ? c4 + (length * rev) : c4 - (length * (1-rev));
-            
-            cfxsample = LEAF_interpolate_hermite_x (buff[c1],
-                                                    buff[c2],
-                                                    buff[c3],
-                                                    buff[c4],
-                                                    alpha);
+            cfxsample = samplerRead(p, cdx, dir, alpha, length);
             crossfadeMix = (float) offset / (float) cfxlen;
         }
         
@@ -371,23 +455,7 @@ float tSampler_tick        (tSampler* const sp)
             float falpha = (1-rev) - (p->flipIdx - fdx) * dir;
             idx += (1-rev);
             
-            // Get the indexes for interpolation
-            int f1 = fdx+(1*dir);
-            int f2 = fdx;
-            int f3 = fdx-(1*dir);
-            int f4 = fdx-(2*dir);
-            
-            // Wrap as needed
-            f1 = (f1 < length*(1-rev)) ? f1 + (length * rev) : f1 - (length * (1-rev));
-            f2 = (f2 < length*(1-rev)) ? f2 + (length * rev) : f2 - (length * (1-rev));
-            f3 = (f3 < length*rev) ? f3 + (length * (1-rev)) : f3 - (length * rev);
-            f4 = (f4 < length*rev) ? f4 + (length * (1-rev)) : f4 - (length * rev);
-            
-            flipsample = LEAF_interpolate_hermite_x (buff[f1],
-                                                     buff[f2],
-                                                     buff[f3],
-                                                     buff[f4],
-                                                     falpha);
+            flipsample = samplerRead(p, fdx, -dir, falpha, length);
             flipMix = (float) (cfxlen - flipLength) / (float) cfxlen;
         }
     }
@@ -499,6 +567,164 @@ float tSampler_tick        (tSampler* const sp)
     return p->last;
 }
 
+// The run's loop, one per interpolation quality and storage format so neither is decided per sample.
+// The run's bounds keep every tap inside the buffer, so they're read straight, without wrapping.
+// The arithmetic is samplerRead's, so a run matches tick exactly.
+typedef int (*SamplerRunLoop) (_tSampler* p, float* out, int n, float* pos, float step, int lo, int hi, int rev, int dir);
+
+#define SAMPLER_GET(j)      ((float) buff[j])
+#define SAMPLER_GET24(j)    ((float) bufferGet24(buff, j))
+
+#define SAMPLER_LINEAR(GET) \
+    float t0 = GET(j); \
+    float t1 = GET(j + dir); \
+    y = t0 + ((t1 - t0) * alpha);
+
+#define SAMPLER_CUBIC(GET) \
+    y = LEAF_interpolate_hermite_x(GET(j - dir), GET(j), GET(j + dir), GET(j + (2 * dir)), alpha);
+
+#define SAMPLER_SINC(GET) \
+    float phase = alpha * SINC_PHASES; \
+    int row = (int) phase; \
+    if (row >= SINC_PHASES) row = SINC_PHASES - 1; \
+    float frac = phase - row; \
+    const float* h0 = __leaf_table_sinc[row]; \
+    const float* h1 = __leaf_table_sinc[row + 1]; \
+    y = 0.0f; \
+    for (int t = 0; t < SINC_TAPS; t++) y += GET(j + ((t - 3) * dir)) * (h0[t] + ((h1[t] - h0[t]) * frac));
+
+#define SAMPLER_RUN_LOOP(NAME, TYPE, BUFF, GET, SCALE, INTERP) \
+static int NAME (_tSampler* p, float* out, int n, float* pos, float step, int lo, int hi, int rev, int dir) \
+{ \
+    const TYPE* buff = p->samp->BUFF; \
+    _tRamp* gain = p->gain; \
+    float x = *pos; \
+    int k = 0; \
+    for (; k < n; k++) \
+    { \
+        int i = (int) x; \
+        float next = x + step; \
+        int inext = (int) next; \
+        if ((i < lo) || (i > hi) || (inext < lo) || (inext > hi)) break; \
+        float alpha = rev + (x - i) * dir; \
+        int j = i + rev; \
+        float y; \
+        INTERP(GET) \
+        /* an idle ramp would just hand back curr */ \
+        out[k] = (y SCALE) * ((gain->inc == 0.0f) ? gain->curr : tRamp_tick(&p->gain)); \
+        x = next; \
+    } \
+    *pos = x; \
+    return k; \
+}
+
+SAMPLER_RUN_LOOP(samplerRunLinear,      float,      buff,   SAMPLER_GET,    , SAMPLER_LINEAR)
+SAMPLER_RUN_LOOP(samplerRunLinear16,    int16_t,    buff16, SAMPLER_GET,    * (1.0f / 32768.0f), SAMPLER_LINEAR)
+SAMPLER_RUN_LOOP(samplerRunLinear24,    uint8_t,    buff24, SAMPLER_GET24,  * (1.0f / 2147483648.0f), SAMPLER_LINEAR)
+SAMPLER_RUN_LOOP(samplerRunCubic,       float,      buff,   SAMPLER_GET,    , SAMPLER_CUBIC)
+SAMPLER_RUN_LOOP(samplerRunCubic16,     int16_t,    buff16, SAMPLER_GET,    * (1.0f / 32768.0f), SAMPLER_CUBIC)
+SAMPLER_RUN_LOOP(samplerRunCubic24,     uint8_t,    buff24, SAMPLER_GET24,  * (1.0f / 2147483648.0f), SAMPLER_CUBIC)
+SAMPLER_RUN_LOOP(samplerRunSinc,        float,      buff,   SAMPLER_GET,    , SAMPLER_SINC)
+SAMPLER_RUN_LOOP(samplerRunSinc16,      int16_t,    buff16, SAMPLER_GET,    * (1.0f / 32768.0f), SAMPLER_SINC)
+SAMPLER_RUN_LOOP(samplerRunSinc24,      uint8_t,    buff24, SAMPLER_GET24,  * (1.0f / 2147483648.0f), SAMPLER_SINC)
+
+// by InterpolationQuality, then BufferFormat
+static const SamplerRunLoop samplerRunLoops[InterpolationQualityNil][BufferFormatNil] =
+{
+    { samplerRunLinear, samplerRunLinear16, samplerRunLinear24 },
+    { samplerRunCubic,  samplerRunCubic16,  samplerRunCubic24 },
+    { samplerRunSinc,   samplerRunSinc16,   samplerRunSinc24 }
+};
+
+// Renders samples for as long as none of tick's boundary handling would come into play: no pending
+// start or end change, no flip, clear of the crossfades, the end fade and the buffer's edges.
+// Returns how many it rendered, which is 0 when tick has to take the next one.
+static int samplerRun (_tSampler* p, float* out, int n)
+{
+    if ((p->active != 1) || (p->targetstart >= 0) || (p->targetend >= 0)) return 0;
+    if ((p->flipIdx >= 0) || (p->flipStart >= 0)) return 0;
+    if ((p->inc == 0.0f) || (p->len < 2)) return 0;
+    
+    int myStart = p->start;
+    int myEnd = p->end;
+    if (p->flip < 0)
+    {
+        myStart = p->end;
+        myEnd = p->start;
+    }
+    
+    int dir = p->bnf * p->dir * p->flip;
+    int rev = 0;
+    if (dir < 0) rev = 1;
+    
+    int length = p->samp->recordedLength;
+    
+    // The range (int) p->idx can be in, before and after the step, for a sample to be plain. Every
+    // quality's taps stay inside the buffer without wrapping.
+    int lo = 3;
+    int hi = length - 5;
+    
+    if (p->mode == PlayLoop)
+    {
+        int32_t cfxlen = p->cfxlen;
+        if (p->len * 0.25f < cfxlen) cfxlen = p->len * 0.25f;
+        
+        int32_t fadeLeftStart = 0;
+        if (myStart >= cfxlen) fadeLeftStart = myStart - cfxlen;
+        int32_t fadeLeftEnd = fadeLeftStart + cfxlen;
+        int32_t fadeRightStart = myEnd - cfxlen;
+        
+        if (lo < fadeLeftEnd + 1 - rev)     lo = fadeLeftEnd + 1 - rev;
+        if (hi > fadeRightStart - 1 - rev)  hi = fadeRightStart - 1 - rev;
+    }
+    else
+    {
+        if (lo < myStart)   lo = myStart;
+        if (hi > myEnd - 1) hi = myEnd - 1;
+        
+        if (p->mode == PlayNormal)
+        {
+            // stop short of where tick starts the end fade, with a couple of samples to spare
+            int fade = (int) (0.007f * leaf.sampleRate * p->inc) + 2;
+            if (rev)    { if (lo < myStart + fade - 1) lo = myStart + fade - 1; }
+            else        { if (hi > myEnd - fade) hi = myEnd - fade; }
+        }
+    }
+    
+    // samplerRead falls back to cubic when the buffer is too short for sinc
+    InterpolationQuality quality = p->quality;
+    if ((quality == InterpolationSinc) && (length < SINC_TAPS)) quality = InterpolationCubic;
+    
+    float x = p->idx;
+    float step = dir * fmodf(p->inc, (float)p->len);
+    int k = samplerRunLoops[quality][p->samp->format](p, out, n, &x, step, lo, hi, rev, dir);
+    
+    if (k > 0)
+    {
+        p->idx = x;
+        p->last = out[k - 1];
+        if (p->mode == PlayLoop) p->inCrossfade = 0;
+    }
+    return k;
+}
+
+void tSampler_process (tSampler* const sp, float* out, int n)
+{
+    _tSampler* p = *sp;
+    
+    int i = 0;
+    while (i < n)
+    {
+        int run = samplerRun(p, &out[i], n - i);
+        if (run == 0)
+        {
+            out[i] = tSampler_tick(sp);
+            run = 1;
+        }
+        i += run;
+    }
+}
+
 void tSampler_setMode      (tSampler* const sp, PlayMode mode)
 {
     _tSampler* p = *sp;
@@ -753,6 +979,12 @@ void tSampler_setRate      (tSampler* const sp, float rate)
     p->iinc = 1.f / p->inc;
 }
 
+void tSampler_setQuality   (tSampler* const sp, InterpolationQuality quality)
+{
+    _tSampler* p = *sp;
+    p->quality = quality;
+}
+
 //==============================================================================
 
 void    tAutoSampler_init   (tAutoSampler* const as, tBuffer* const b)
@@ -875,3 +1107,263 @@ void    tAutoSampler_setRate    (tAutoSampler* const as, float rate)
 {
     ;
 }
+
+//==============================================================================
+
+void    tMultiSampler_init  (tMultiSampler* const msp, int numKeys, int maxZones, int numVoices)
+{
+    tMultiSampler_initToPool(msp, numKeys, maxZones, numVoices, &leaf.mempool);
+}
+
+void    tMultiSampler_initToPool    (tMultiSampler* const msp, int numKeys, int maxZones, int numVoices, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tMultiSampler* ms = *msp = (_tMultiSampler*) mpool_alloc(sizeof(_tMultiSampler), m);
+    ms->mempool = m;
+    
+    ms->numKeys = numKeys;
+    ms->maxZones = maxZones;
+    ms->numZones = 0;
+    ms->zones = (tMultiSamplerZone*) mpool_alloc(sizeof(tMultiSamplerZone) * maxZones, m);
+    ms->numGroups = 0;
+    ms->groups = (tMultiSamplerGroup*) mpool_alloc(sizeof(tMultiSamplerGroup) * maxZones, m);
+    ms->lookup = (int16_t*) mpool_alloc(sizeof(int16_t) * numKeys * MULTISAMPLER_VELOCITY_STEPS, m);
+    for (int i = 0; i < numKeys * MULTISAMPLER_VELOCITY_STEPS; i++) ms->lookup[i] = -1;
+    
+    tBuffer_initToPool(&ms->silence, 4, mp);
+    tBuffer_clear(&ms->silence);
+    
+    ms->numVoices = numVoices;
+    ms->voices = (tMultiSamplerVoice*) mpool_alloc(sizeof(tMultiSamplerVoice) * (numVoices + 1), m);
+    for (int i = 0; i <= numVoices; i++)
+    {
+        tMultiSamplerVoice* v = &ms->voices[i];
+        tSampler_initToPool(&v->sampler, &ms->silence, mp);
+        v->zone = -1;
+        v->key = -1;
+        v->gain = 0.0f;
+        v->startTime = 0;
+    }
+    
+    ms->time = 0;
+    ms->numSteals = 0;
+}
+
+void    tMultiSampler_free  (tMultiSampler* const msp)
+{
+    _tMultiSampler* ms = *msp;
+    
+    for (int i = 0; i <= ms->numVoices; i++) tSampler_free(&ms->voices[i].sampler);
+    mpool_free((char*)ms->voices, ms->mempool);
+    tBuffer_free(&ms->silence);
+    mpool_free((char*)ms->lookup, ms->mempool);
+    mpool_free((char*)ms->groups, ms->mempool);
+    mpool_free((char*)ms->zones, ms->mempool);
+    mpool_free((char*)ms, ms->mempool);
+}
+
+static int velocityStep (float velocity)
+{
+    return (int) (LEAF_clip(0.0f, velocity, 1.0f) * (MULTISAMPLER_VELOCITY_STEPS - 1) + 0.5f);
+}
+
+int     tMultiSampler_addZone   (tMultiSampler* const msp, tBuffer* const b, int key, float velocityLow, float velocityHigh)
+{
+    _tMultiSampler* ms = *msp;
+    
+    if ((ms->numZones >= ms->maxZones) || (key < 0) || (key >= ms->numKeys)) return -1;
+    
+    // join the group with the same key and range, or start a new one
+    int g = 0;
+    for (; g < ms->numGroups; g++)
+    {
+        tMultiSamplerGroup* group = &ms->groups[g];
+        if ((group->key == key) && (group->velocityLow == velocityLow) && (group->velocityHigh == velocityHigh)) break;
+    }
+    if ((g < ms->numGroups) && (ms->groups[g].numZones >= MULTISAMPLER_MAX_ROUND_ROBIN)) return -1;
+    if (g == ms->numGroups)
+    {
+        tMultiSamplerGroup* group = &ms->groups[g];
+        group->key = key;
+        group->velocityLow = velocityLow;
+        group->velocityHigh = velocityHigh;
+        group->numZones = 0;
+        group->next = 0;
+        ms->numGroups++;
+        
+        // where ranges overlap, the group added last wins
+        for (int i = velocityStep(velocityLow); i <= velocityStep(velocityHigh); i++)
+        {
+            ms->lookup[(key * MULTISAMPLER_VELOCITY_STEPS) + i] = g;
+        }
+    }
+    
+    int z = ms->numZones++;
+    tMultiSamplerZone* zone = &ms->zones[z];
+    zone->buffer = (b != NULL) ? *b : NULL;
+    zone->key = key;
+    zone->velocityLow = velocityLow;
+    zone->velocityHigh = velocityHigh;
+    zone->gain = 1.0f;
+    zone->rate = 1.0f;
+    zone->group = g;
+    
+    tMultiSamplerGroup* group = &ms->groups[g];
+    group->zones[group->numZones++] = z;
+    
+    return z;
+}
+
+// Leaves a voice idle at once, without the sampler's fade
+static void multiSamplerCut (_tMultiSampler* ms, tMultiSamplerVoice* v)
+{
+    _tSampler* p = v->sampler;
+    p->active = 0;
+    tRamp_setVal(&p->gain, 0.0f);
+    tSampler_setSample(&v->sampler, &ms->silence);
+    v->zone = -1;
+    v->key = -1;
+}
+
+void    tMultiSampler_setZoneBuffer (tMultiSampler* const msp, int zone, tBuffer* const b)
+{
+    _tMultiSampler* ms = *msp;
+    if ((zone < 0) || (zone >= ms->numZones)) return;
+    
+    for (int i = 0; i <= ms->numVoices; i++)
+    {
+        if (ms->voices[i].zone == zone) multiSamplerCut(ms, &ms->voices[i]);
+    }
+    ms->zones[zone].buffer = (b != NULL) ? *b : NULL;
+}
+
+void    tMultiSampler_setZoneGain   (tMultiSampler* const msp, int zone, float gain)
+{
+    _tMultiSampler* ms = *msp;
+    if ((zone < 0) || (zone >= ms->numZones)) return;
+    ms->zones[zone].gain = gain;
+}
+
+void    tMultiSampler_setZoneTuning (tMultiSampler* const msp, int zone, float semitones)
+{
+    _tMultiSampler* ms = *msp;
+    if ((zone < 0) || (zone >= ms->numZones)) return;
+    ms->zones[zone].rate = powf(2.0f, semitones * (1.0f / 12.0f));
+}
+
+void    tMultiSampler_setQuality    (tMultiSampler* const msp, InterpolationQuality quality)
+{
+    _tMultiSampler* ms = *msp;
+    for (int i = 0; i <= ms->numVoices; i++) tSampler_setQuality(&ms->voices[i].sampler, quality);
+}
+
+void    tMultiSampler_trigger   (tMultiSampler* const msp, int key, float velocity)
+{
+    _tMultiSampler* ms = *msp;
+    if ((key < 0) || (key >= ms->numKeys)) return;
+    
+    int g = ms->lookup[(key * MULTISAMPLER_VELOCITY_STEPS) + velocityStep(velocity)];
+    if (g < 0) return;
+    
+    // next in the round robin, passing over zones that have no sample yet
+    tMultiSamplerGroup* group = &ms->groups[g];
+    int z = -1;
+    for (int i = 0; i < group->numZones; i++)
+    {
+        int candidate = group->zones[group->next];
+        group->next = (group->next + 1 < group->numZones) ? group->next + 1 : 0;
+        if (ms->zones[candidate].buffer != NULL)
+        {
+            z = candidate;
+            break;
+        }
+    }
+    if (z < 0) return;
+    tMultiSamplerZone* zone = &ms->zones[z];
+    
+    // a free voice, or else the quietest one already fading out, or else the oldest
+    tMultiSamplerVoice* v = NULL;
+    tMultiSamplerVoice* fading = NULL;
+    tMultiSamplerVoice* oldest = &ms->voices[0];
+    for (int i = 0; i < ms->numVoices; i++)
+    {
+        tMultiSamplerVoice* candidate = &ms->voices[i];
+        if (candidate->sampler->active == 0)
+        {
+            v = candidate;
+            break;
+        }
+        if ((candidate->sampler->active < 0) &&
+            ((fading == NULL) || (tRamp_sample(&candidate->sampler->gain) * candidate->gain < tRamp_sample(&fading->sampler->gain) * fading->gain)))
+        {
+            fading = candidate;
+        }
+        if ((ms->time - candidate->startTime) > (ms->time - oldest->startTime)) oldest = candidate;
+    }
+    if (v == NULL)
+    {
+        // The stolen voice swaps places with the spare one after the last, and fades out there while
+        // the hit starts on the spare's idle sampler. A tail still fading in the spare is cut.
+        v = (fading != NULL) ? fading : oldest;
+        tMultiSamplerVoice* tail = &ms->voices[ms->numVoices];
+        multiSamplerCut(ms, tail);
+        tMultiSamplerVoice stolen = *v;
+        *v = *tail;
+        *tail = stolen;
+        if (tail->sampler->active > 0) tSampler_stop(&tail->sampler);
+        ms->numSteals++;
+    }
+    
+    tSampler_setSample(&v->sampler, &zone->buffer);
+    tSampler_setMode(&v->sampler, PlayNormal);
+    tSampler_setRate(&v->sampler, zone->rate);
+    tSampler_play(&v->sampler);
+    // a drum hit starts at full level, not with the sampler's fade in
+    tRamp_setVal(&v->sampler->gain, 1.0f);
+    v->zone = z;
+    v->key = key;
+    v->gain = zone->gain * velocity;
+    v->startTime = ms->time++;
+}
+
+void    tMultiSampler_stop  (tMultiSampler* const msp, int key)
+{
+    _tMultiSampler* ms = *msp;
+    for (int i = 0; i <= ms->numVoices; i++)
+    {
+        tMultiSamplerVoice* v = &ms->voices[i];
+        if ((v->key == key) && (v->sampler->active != 0)) tSampler_stop(&v->sampler);
+    }
+}
+
+float   tMultiSampler_tick  (tMultiSampler* const msp)
+{
+    _tMultiSampler* ms = *msp;
+    
+    float sample = 0.0f;
+    for (int i = 0; i <= ms->numVoices; i++)
+    {
+        tMultiSamplerVoice* v = &ms->voices[i];
+        if (v->sampler->active != 0) sample += tSampler_tick(&v->sampler) * v->gain;
+    }
+    return sample;
+}
+
+void    tMultiSampler_process   (tMultiSampler* const msp, float* out, int n)
+{
+    _tMultiSampler* ms = *msp;
+    
+    for (int i = 0; i < n; i++) out[i] = 0.0f;
+    
+    float voiceOut[MULTISAMPLER_BLOCK_SIZE];
+    for (int i = 0; i <= ms->numVoices; i++)
+    {
+        tMultiSamplerVoice* v = &ms->voices[i];
+        for (int start = 0; (start < n) && (v->sampler->active != 0); start += MULTISAMPLER_BLOCK_SIZE)
+        {
+            int size = (n - start < MULTISAMPLER_BLOCK_SIZE) ? n - start : MULTISAMPLER_BLOCK_SIZE;
+            tSampler_process(&v->sampler, voiceOut, size);
+            for (int k = 0; k < size; k++) out[start + k] += voiceOut[k] * v->gain;
+        }
+    }
+}
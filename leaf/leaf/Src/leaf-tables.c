@@ -15820,3 +15820,74 @@ slope_dd_table [MINBLEP_PHASES * SLOPE_DD_PULSE_LENGTH + 1] =
     0.000000e+00, 0.000000e+00, 0.000000e+00, 0.000000e+00, 0.000000e+00, 0.000000e+00, 0.000000e+00, 0.000000e+00,
     0.000000e+00
 };
+
+// Blackman windowed sinc for tSampler's InterpolationSinc, one row of SINC_TAPS taps per fraction of
+// a sample from 0 to 1 in SINC_PHASES steps. Tap k weighs the sample k - 3 away. Each row sums to 1.
+const float __leaf_table_sinc[SINC_PHASES + 1][SINC_TAPS] =
+{
+    { 0.000000000e+00, 0.000000000e+00, 0.000000000e+00, 1.000000000e+00, 0.000000000e+00, 0.000000000e+00, 0.000000000e+00, 0.000000000e+00 },
+    { -3.319792968e-04, 2.587236499e-03, -1.179869288e-02, 9.995345028e-01, 1.237323544e-02, -2.724567651e-03, 3.603182065e-04, -5.313373756e-08 },
+    { -6.361041780e-04, 5.035331350e-03, -2.301868549e-02, 9.981391373e-01, 2.531548487e-02, -5.584097606e-03, 7.493600696e-04, -4.262961341e-07 },
+    { -9.129517565e-04, 7.343018369e-03, -3.365718776e-02, 9.958169585e-01, 3.881985132e-02, -8.575650409e-03, 1.167403617e-03, -1.441912437e-06 },
+    { -1.163184211e-03, 9.509557407e-03, -4.371275695e-02, 9.925728328e-01, 5.287806346e-02, -1.169570247e-02, 1.614612944e-03, -3.423030449e-06 },
+    { -1.387541204e-03, 1.153471466e-02, -5.318527234e-02, 9.884134207e-01, 6.748047189e-02, -1.494013371e-02, 2.091031093e-03, -6.691096822e-06 },
+    { -1.586832352e-03, 1.341874195e-02, -6.207590671e-02, 9.833471554e-01, 8.261604907e-02, -1.830421669e-02, 2.596573087e-03, -1.156370313e-05 },
+    { -1.761929772e-03, 1.516235512e-02, -7.038709456e-02, 9.773842169e-01, 9.827239289e-02, -2.178260739e-02, 3.131019160e-03, -1.835230784e-05 },
+    { -1.913760727e-03, 1.676671164e-02, -7.812249739e-02, 9.705365018e-01, 1.144357340e-01, -2.536933758e-02, 3.694008223e-03, -2.735994040e-05 },
+    { -2.043300426e-03, 1.823338755e-02, -8.528696618e-02, 9.628175889e-01, 1.310909464e-01, -2.905780900e-02, 4.285031599e-03, -3.887889398e-05 },
+    { -2.151564961e-03, 1.956435380e-02, -9.188650118e-02, 9.542427004e-01, 1.482215626e-01, -3.284078932e-02, 4.903427066e-03, -5.318841335e-05 },
+    { -2.239604448e-03, 2.076195223e-02, -9.792820940e-02, 9.448286593e-01, 1.658097915e-01, -3.671040998e-02, 5.548373250e-03, -7.055238497e-05 },
+    { -2.308496361e-03, 2.182887107e-02, -1.034202598e-01, 9.345938436e-01, 1.838365401e-01, -4.065816596e-02, 6.218884411e-03, -9.121703613e-05 },
+    { -2.359339094e-03, 2.276812037e-02, -1.083718365e-01, 9.235581361e-01, 2.022814397e-01, -4.467491754e-02, 6.913805648e-03, -1.154086506e-04 },
+    { -2.393245764e-03, 2.358300716e-02, -1.127930901e-01, 9.117428708e-01, 2.211228747e-01, -4.875089413e-02, 7.631808581e-03, -1.433313086e-04 },
+    { -2.411338273e-03, 2.427711061e-02, -1.166950874e-01, 8.991707770e-01, 2.403380153e-01, -5.287570014e-02, 8.371387532e-03, -1.751646583e-04 },
+    { -2.414741631e-03, 2.485425731e-02, -1.200897599e-01, 8.858659188e-01, 2.599028539e-01, -5.703832301e-02, 9.130856261e-03, -2.110617277e-04 },
+    { -2.404578574e-03, 2.531849659e-02, -1.229898507e-01, 8.718536328e-01, 2.797922449e-01, -6.122714342e-02, 9.908345280e-03, -2.511467851e-04 },
+    { -2.381964455e-03, 2.567407614e-02, -1.254088606e-01, 8.571604628e-01, 2.999799472e-01, -6.542994762e-02, 1.070179979e-02, -2.955132569e-04 },
+    { -2.348002444e-03, 2.592541797e-02, -1.273609933e-01, 8.418140919e-01, 3.204386714e-01, -6.963394209e-02, 1.150897831e-02, -3.442217109e-04 },
+    { -2.303779025e-03, 2.607709466e-02, -1.288611001e-01, 8.258432721e-01, 3.411401286e-01, -7.382577029e-02, 1.232745191e-02, -3.972979169e-04 },
+    { -2.250359803e-03, 2.613380620e-02, -1.299246238e-01, 8.092777521e-01, 3.620550837e-01, -7.799153177e-02, 1.315460432e-02, -4.547309905e-04 },
+    { -2.188785614e-03, 2.610035725e-02, -1.305675425e-01, 7.921482028e-01, 3.831534105e-01, -8.211680346e-02, 1.398763269e-02, -5.164716336e-04 },
+    { -2.120068952e-03, 2.598163507e-02, -1.308063137e-01, 7.744861417e-01, 4.044041505e-01, -8.618666321e-02, 1.482354915e-02, -5.824304795e-04 },
+    { -2.045190699e-03, 2.578258810e-02, -1.306578175e-01, 7.563238550e-01, 4.257755740e-01, -9.018571553e-02, 1.565918328e-02, -6.524765535e-04 },
+    { -1.965097168e-03, 2.550820517e-02, -1.301393011e-01, 7.376943189e-01, 4.472352443e-01, -9.409811961e-02, 1.649118538e-02, -7.264358602e-04 },
+    { -1.880697440e-03, 2.516349557e-02, -1.292683228e-01, 7.186311201e-01, 4.687500835e-01, -9.790761942e-02, 1.731603060e-02, -8.040901075e-04 },
+    { -1.792861017e-03, 2.475346985e-02, -1.280626973e-01, 6.991683744e-01, 4.902864417e-01, -1.015975760e-01, 1.813002399e-02, -8.851755788e-04 },
+    { -1.702415749e-03, 2.428312147e-02, -1.265404413e-01, 6.793406459e-01, 5.118101672e-01, -1.051510019e-01, 1.892930656e-02, -9.693821639e-04 },
+    { -1.610146070e-03, 2.375740933e-02, -1.247197199e-01, 6.591828649e-01, 5.332866798e-01, -1.085505976e-01, 1.970986210e-02, -1.056352561e-03 },
+    { -1.516791497e-03, 2.318124122e-02, -1.226187941e-01, 6.387302459e-01, 5.546810449e-01, -1.117787899e-01, 2.046752514e-02, -1.145681658e-03 },
+    { -1.423045414e-03, 2.255945812e-02, -1.202559697e-01, 6.180182058e-01, 5.759580498e-01, -1.148177722e-01, 2.119798979e-02, -1.236916110e-03 },
+    { -1.329554116e-03, 2.189681955e-02, -1.176495471e-01, 5.970822816e-01, 5.970822816e-01, -1.176495471e-01, 2.189681955e-02, -1.329554116e-03 },
+    { -1.236916110e-03, 2.119798979e-02, -1.148177722e-01, 5.759580498e-01, 6.180182058e-01, -1.202559697e-01, 2.255945812e-02, -1.423045414e-03 },
+    { -1.145681658e-03, 2.046752514e-02, -1.117787899e-01, 5.546810449e-01, 6.387302459e-01, -1.226187941e-01, 2.318124122e-02, -1.516791497e-03 },
+    { -1.056352561e-03, 1.970986210e-02, -1.085505976e-01, 5.332866798e-01, 6.591828649e-01, -1.247197199e-01, 2.375740933e-02, -1.610146070e-03 },
+    { -9.693821639e-04, 1.892930656e-02, -1.051510019e-01, 5.118101672e-01, 6.793406459e-01, -1.265404413e-01, 2.428312147e-02, -1.702415749e-03 },
+    { -8.851755788e-04, 1.813002399e-02, -1.015975760e-01, 4.902864417e-01, 6.991683744e-01, -1.280626973e-01, 2.475346985e-02, -1.792861017e-03 },
+    { -8.040901075e-04, 1.731603060e-02, -9.790761942e-02, 4.687500835e-01, 7.186311201e-01, -1.292683228e-01, 2.516349557e-02, -1.880697440e-03 },
+    { -7.264358602e-04, 1.649118538e-02, -9.409811961e-02, 4.472352443e-01, 7.376943189e-01, -1.301393011e-01, 2.550820517e-02, -1.965097168e-03 },
+    { -6.524765535e-04, 1.565918328e-02, -9.018571553e-02, 4.257755740e-01, 7.563238550e-01, -1.306578175e-01, 2.578258810e-02, -2.045190699e-03 },
+    { -5.824304795e-04, 1.482354915e-02, -8.618666321e-02, 4.044041505e-01, 7.744861417e-01, -1.308063137e-01, 2.598163507e-02, -2.120068952e-03 },
+    { -5.164716336e-04, 1.398763269e-02, -8.211680346e-02, 3.831534105e-01, 7.921482028e-01, -1.305675425e-01, 2.610035725e-02, -2.188785614e-03 },
+    { -4.547309905e-04, 1.315460432e-02, -7.799153177e-02, 3.620550837e-01, 8.092777521e-01, -1.299246238e-01, 2.613380620e-02, -2.250359803e-03 },
+    { -3.972979169e-04, 1.232745191e-02, -7.382577029e-02, 3.411401286e-01, 8.258432721e-01, -1.288611001e-01, 2.607709466e-02, -2.303779025e-03 },
+    { -3.442217109e-04, 1.150897831e-02, -6.963394209e-02, 3.204386714e-01, 8.418140919e-01, -1.273609933e-01, 2.592541797e-02, -2.348002444e-03 },
+    { -2.955132569e-04, 1.070179979e-02, -6.542994762e-02, 2.999799472e-01, 8.571604628e-01, -1.254088606e-01, 2.567407614e-02, -2.381964455e-03 },
+    { -2.511467851e-04, 9.908345280e-03, -6.122714342e-02, 2.797922449e-01, 8.718536328e-01, -1.229898507e-01, 2.531849659e-02, -2.404578574e-03 },
+    { -2.110617277e-04, 9.130856261e-03, -5.703832301e-02, 2.599028539e-01, 8.858659188e-01, -1.200897599e-01, 2.485425731e-02, -2.414741631e-03 },
+    { -1.751646583e-04, 8.371387532e-03, -5.287570014e-02, 2.403380153e-01, 8.991707770e-01, -1.166950874e-01, 2.427711061e-02, -2.411338273e-03 },
+    { -1.433313086e-04, 7.631808581e-03, -4.875089413e-02, 2.211228747e-01, 9.117428708e-01, -1.127930901e-01, 2.358300716e-02, -2.393245764e-03 },
+    { -1.154086506e-04, 6.913805648e-03, -4.467491754e-02, 2.022814397e-01, 9.235581361e-01, -1.083718365e-01, 2.276812037e-02, -2.359339094e-03 },
+    { -9.121703613e-05, 6.218884411e-03, -4.065816596e-02, 1.838365401e-01, 9.345938436e-01, -1.034202598e-01, 2.182887107e-02, -2.308496361e-03 },
+    { -7.055238497e-05, 5.548373250e-03, -3.671040998e-02, 1.658097915e-01, 9.448286593e-01, -9.792820940e-02, 2.076195223e-02, -2.239604448e-03 },
+    { -5.318841335e-05, 4.903427066e-03, -3.284078932e-02, 1.482215626e-01, 9.542427004e-01, -9.188650118e-02, 1.956435380e-02, -2.151564961e-03 },
+    { -3.887889398e-05, 4.285031599e-03, -2.905780900e-02, 1.310909464e-01, 9.628175889e-01, -8.528696618e-02, 1.823338755e-02, -2.043300426e-03 },
+    { -2.735994040e-05, 3.694008223e-03, -2.536933758e-02, 1.144357340e-01, 9.705365018e-01, -7.812249739e-02, 1.676671164e-02, -1.913760727e-03 },
+    { -1.835230784e-05, 3.131019160e-03, -2.178260739e-02, 9.827239289e-02, 9.773842169e-01, -7.038709456e-02, 1.516235512e-02, -1.761929772e-03 },
+    { -1.156370313e-05, 2.596573087e-03, -1.830421669e-02, 8.261604907e-02, 9.833471554e-01, -6.207590671e-02, 1.341874195e-02, -1.586832352e-03 },
+    { -6.691096822e-06, 2.091031093e-03, -1.494013371e-02, 6.748047189e-02, 9.884134207e-01, -5.318527234e-02, 1.153471466e-02, -1.387541204e-03 },
+    { -3.423030449e-06, 1.614612944e-03, -1.169570247e-02, 5.287806346e-02, 9.925728328e-01, -4.371275695e-02, 9.509557407e-03, -1.163184211e-03 },
+    { -1.441912437e-06, 1.167403617e-03, -8.575650409e-03, 3.881985132e-02, 9.958169585e-01, -3.365718776e-02, 7.343018369e-03, -9.129517565e-04 },
+    { -4.262961341e-07, 7.493600696e-04, -5.584097606e-03, 2.531548487e-02, 9.981391373e-01, -2.301868549e-02, 5.035331350e-03, -6.361041780e-04 },
+    { -5.313373756e-08, 3.603182065e-04, -2.724567651e-03, 1.237323544e-02, 9.995345028e-01, -1.179869288e-02, 2.587236499e-03, -3.319792968e-04 },
+    { 0.000000000e+00, 0.000000000e+00, 0.000000000e+00, 0.000000000e+00, 1.000000000e+00, 0.000000000e+00, 0.000000000e+00, 0.000000000e+00 }
+};
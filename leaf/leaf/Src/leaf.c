@@ -18,6 +18,11 @@
 
 #endif
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#define LEAF_FTZ_SSE
+#endif
+
 LEAF leaf;
 
 void LEAF_init(float sr, int blocksize, char* memory, size_t memorysize, float(*random)(void))
@@ -36,6 +41,33 @@ void LEAF_init(float sr, int blocksize, char* memory, size_t memorysize, float(*
     leaf.random = random;
     
     leaf.clearOnAllocation = 0;
+    
+    leaf.silenceThreshold = 0.00001f;
+    
+#ifndef LEAF_NO_FLUSH_TO_ZERO
+    LEAF_enableFlushToZero();
+#endif
+}
+
+void LEAF_enableFlushToZero(void)
+{
+#if defined(LEAF_FTZ_SSE)
+    // FTZ (bit 15) flushes denormal results, DAZ (bit 6) reads denormal inputs as zero
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    __asm__ __volatile__ ("mrs %0, fpcr" : "=r" (fpcr));
+    __asm__ __volatile__ ("msr fpcr, %0" : : "r" (fpcr | (1 << 24)));
+#elif defined(__ARM_FP) && defined(__GNUC__)
+    // FZ (bit 24) covers both inputs and results
+    uint32_t fpscr;
+    __asm__ __volatile__ ("vmrs %0, fpscr" : "=r" (fpscr));
+    __asm__ __volatile__ ("vmsr fpscr, %0" : : "r" (fpscr | (1 << 24)));
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+    // Exception entry loads FPSCR from FPDSCR, so set FZ there too for audio running in interrupts
+    *((volatile uint32_t*) 0xE000EF3C) |= (1u << 24);
+#endif
+#endif
 }
 
 
@@ -4,6 +4,7 @@
 #include ".\Src\leaf-math.c"
 #include ".\Src\leaf-mempool.c"
 #include ".\Src\leaf-tables.c"
+#include ".\Src\leaf-fft.c"
 #include ".\Src\leaf-distortion.c"
 #include ".\Src\leaf-oscillators.c"
 #include ".\Src\leaf-filters.c"
@@ -28,6 +29,7 @@
 #include "./Src/leaf-math.c"
 #include "./Src/leaf-mempool.c"
 #include "./Src/leaf-tables.c"
+#include "./Src/leaf-fft.c"
 #include "./Src/leaf-distortion.c"
 #include "./Src/leaf-dynamics.c"
 #include "./Src/leaf-oscillators.c"
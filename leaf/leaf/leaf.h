@@ -37,6 +37,7 @@
 #include ".\Inc\leaf-math.h"
 #include ".\Inc\leaf-mempool.h"
 #include ".\Inc\leaf-tables.h"
+#include ".\Inc\leaf-fft.h"
 #include ".\Inc\leaf-distortion.h"
 #include ".\Inc\leaf-oscillators.h"
 #include ".\Inc\leaf-filters.h"
@@ -58,6 +59,7 @@
 #include "./Inc/leaf-math.h"
 #include "./Inc/leaf-mempool.h"
 #include "./Inc/leaf-tables.h"
+#include "./Inc/leaf-fft.h"
 #include "./Inc/leaf-distortion.h"
 #include "./Inc/leaf-dynamics.h"
 #include "./Inc/leaf-oscillators.h"
@@ -124,9 +126,18 @@ extern "C" {
      @param memory A pointer to the memory that will make up the default LEAF mempool.
      @param memorySize The size of the memory that will make up the default LEAF mempool.
      @param random A pointer to a random number function. Should return a float >= 0 and < 1.
+     
+     Also turns on flush to zero for the calling thread with LEAF_enableFlushToZero(), unless LEAF_NO_FLUSH_TO_ZERO is defined.
      */
     void        LEAF_init            (float sampleRate, int blockSize, char* memory, size_t memorySize, float(*random)(void));
     
+    //! Make the FPU treat denormal numbers as zero, so decaying filters and reverb tails can't stall on them.
+    /*!
+     Sets FTZ and DAZ on x86 and FZ on ARM. The mode belongs to the thread that calls this, so on a host call it from the audio thread as well as (or instead of) wherever LEAF_init runs.
+     On Cortex-M it also sets the default for interrupt handlers, which don't inherit the mode from the code they interrupt.
+     */
+    void        LEAF_enableFlushToZero (void);
+    
     //! Set the sample rate of LEAF.
     /*!
      @param sampleRate The new audio sample rate.
@@ -0,0 +1,329 @@
+/*
+  ==============================================================================
+
+    wtbuilder.c
+    Host-side builder for tWaveTable files.
+
+    Build with the Makefile in this folder, then:
+
+        ./wtbuilder [-s size] [-n frames] SHAPE out.lwt
+        ./wtbuilder [-s size] [-f frameLength] in.wav out.lwt
+        ./wtbuilder -i file.lwt
+
+    SHAPE is one of sine, saw, square, triangle, pwm (a pulse narrowing from
+    50% to 5% across the frames) or harmonics (frame i is a sum of the first
+    i + 1 harmonics at 1/k amplitude). A WAV file is cut into frames of
+    frameLength samples (default: size), the layout most wavetable synths
+    export, and each frame is resampled to size by its harmonics. Only the
+    first channel is used.
+
+    Every frame has its DC removed and the whole table is normalized to a
+    peak of 1, then written as a tWaveTableFileHeader followed by int16
+    samples (see leaf-oscillators.h). Copy the file to the SD card, read it
+    into memory and pass it to tWaveTable_initFromData, which builds the
+    band-limited mipmaps on the target. -i prints a file's header and the
+    peak and RMS of each frame.
+
+  ==============================================================================
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "leaf.h"
+
+#define WT_DEFAULT_SIZE 2048
+#define WT_DEFAULT_FRAMES 1
+#define WT_MAX_SIZE 65536
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: wtbuilder [-s size] [-n frames] sine|saw|square|triangle|pwm|harmonics out.lwt\n"
+                    "       wtbuilder [-s size] [-f frameLength] in.wav out.lwt\n"
+                    "       wtbuilder -i file.lwt\n");
+    exit(1);
+}
+
+//==============================================================================
+// Shapes, phase from 0 to 1. Naive, the mipmaps do the band-limiting.
+
+static float shapeSample(const char* shape, float phase, int frame, int numFrames)
+{
+    float pos = (numFrames > 1) ? (float)frame / (float)(numFrames - 1) : 0.0f;
+
+    if (!strcmp(shape, "sine")) return sinf(2.0f * (float)M_PI * phase);
+    if (!strcmp(shape, "saw")) return (2.0f * phase) - 1.0f;
+    if (!strcmp(shape, "square")) return (phase < 0.5f) ? 1.0f : -1.0f;
+    if (!strcmp(shape, "triangle")) return (phase < 0.5f) ? ((4.0f * phase) - 1.0f) : (3.0f - (4.0f * phase));
+    if (!strcmp(shape, "pwm")) return (phase < (0.5f - (0.45f * pos))) ? 1.0f : -1.0f;
+    if (!strcmp(shape, "harmonics"))
+    {
+        float sum = 0.0f;
+        for (int k = 1; k <= frame + 1; k++) sum += sinf(2.0f * (float)M_PI * phase * (float)k) / (float)k;
+        return sum;
+    }
+    fprintf(stderr, "unknown shape %s\n", shape);
+    usage();
+    return 0.0f;
+}
+
+//==============================================================================
+// Minimal WAV reader: PCM 16, 24 or 32 bit, or 32 bit float. Returns the first
+// channel as floats, or NULL.
+
+static uint32_t readLE(const unsigned char* p, int bytes)
+{
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static float* readWav(const char* path, int* numSamples)
+{
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char* data = (unsigned char*) malloc(length);
+    if (data == NULL || fread(data, 1, length, f) != (size_t)length || length < 12 ||
+        memcmp(data, "RIFF", 4) || memcmp(data + 8, "WAVE", 4))
+    {
+        fclose(f);
+        free(data);
+        return NULL;
+    }
+    fclose(f);
+
+    int format = 0, channels = 0, bits = 0;
+    float* out = NULL;
+    long pos = 12;
+    while (pos + 8 <= length)
+    {
+        uint32_t chunkSize = readLE(data + pos + 4, 4);
+        const unsigned char* chunk = data + pos + 8;
+        if (pos + 8 + (long)chunkSize > length) chunkSize = (uint32_t)(length - pos - 8);
+
+        if (!memcmp(data + pos, "fmt ", 4) && chunkSize >= 16)
+        {
+            format = (int)readLE(chunk, 2);
+            channels = (int)readLE(chunk + 2, 2);
+            bits = (int)readLE(chunk + 14, 2);
+            if (format == 0xFFFE && chunkSize >= 26) format = (int)readLE(chunk + 24, 2); // WAVE_FORMAT_EXTENSIBLE
+        }
+        else if (!memcmp(data + pos, "data", 4) && channels > 0)
+        {
+            int bytes = bits / 8;
+            if (!((format == 1 && (bits == 16 || bits == 24 || bits == 32)) || (format == 3 && bits == 32))) break;
+            int n = (int)(chunkSize / (uint32_t)(bytes * channels));
+            out = (float*) malloc(sizeof(float) * (n > 0 ? n : 1));
+            for (int i = 0; i < n; i++)
+            {
+                const unsigned char* s = chunk + ((long)i * bytes * channels);
+                uint32_t v = readLE(s, bytes);
+                if (format == 3)
+                {
+                    float x;
+                    memcpy(&x, &v, sizeof(float));
+                    out[i] = x;
+                }
+                else
+                {
+                    v <<= 32 - bits; // sign extend through the top bit
+                    out[i] = (float)(int32_t)v * (1.0f / 2147483648.0f);
+                }
+            }
+            *numSamples = n;
+            break;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    free(data);
+    return out;
+}
+
+// Resample one periodic frame to size samples by summing its harmonics, so
+// nothing above the shorter length's Nyquist is created or folded back.
+static void resampleFrame(const float* in, int length, float* out, int size)
+{
+    if (length == size)
+    {
+        memcpy(out, in, sizeof(float) * size);
+        return;
+    }
+
+    int harmonics = ((length < size) ? length : size) / 2 - 1;
+    for (int i = 0; i < size; i++) out[i] = 0.0f;
+    for (int k = 1; k <= harmonics; k++)
+    {
+        double re = 0.0, im = 0.0;
+        for (int i = 0; i < length; i++)
+        {
+            double w = 2.0 * M_PI * (double)k * (double)i / (double)length;
+            re += in[i] * cos(w);
+            im += in[i] * sin(w);
+        }
+        re *= 2.0 / length;
+        im *= 2.0 / length;
+        for (int i = 0; i < size; i++)
+        {
+            double w = 2.0 * M_PI * (double)k * (double)i / (double)size;
+            out[i] += (float)((re * cos(w)) + (im * sin(w)));
+        }
+    }
+}
+
+//==============================================================================
+
+static int writeTable(const char* path, const float* frames, int size, int numFrames)
+{
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) return 0;
+
+    unsigned char header[sizeof(tWaveTableFileHeader)] = { 'L', 'W', 'T', '1' };
+    for (int i = 0; i < 4; i++)
+    {
+        header[4 + i] = (unsigned char)((uint32_t)size >> (8 * i));
+        header[8 + i] = (unsigned char)((uint32_t)numFrames >> (8 * i));
+    }
+    fwrite(header, 1, sizeof(header), f);
+
+    for (long i = 0; i < (long)size * numFrames; i++)
+    {
+        long v = lrintf(frames[i] * 32767.0f);
+        if (v > 32767) v = 32767;
+        if (v < -32767) v = -32767;
+        unsigned char s[2] = { (unsigned char)(v & 0xFF), (unsigned char)((v >> 8) & 0xFF) };
+        fwrite(s, 1, 2, f);
+    }
+
+    return fclose(f) == 0;
+}
+
+static int printInfo(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return 0;
+    unsigned char header[sizeof(tWaveTableFileHeader)];
+    if (fread(header, 1, sizeof(header), f) != sizeof(header) || memcmp(header, "LWT1", 4))
+    {
+        fprintf(stderr, "%s is not a wavetable file\n", path);
+        fclose(f);
+        return 0;
+    }
+    uint32_t size = readLE(header + 4, 4);
+    uint32_t numFrames = readLE(header + 8, 4);
+    printf("%s: %u frames of %u samples\n", path, numFrames, size);
+
+    for (uint32_t fr = 0; fr < numFrames; fr++)
+    {
+        double peak = 0.0, sum = 0.0;
+        for (uint32_t i = 0; i < size; i++)
+        {
+            unsigned char s[2];
+            if (fread(s, 1, 2, f) != 2)
+            {
+                fprintf(stderr, "file ends in frame %u\n", fr);
+                fclose(f);
+                return 0;
+            }
+            double x = (int16_t)(s[0] | (s[1] << 8)) / 32767.0;
+            if (fabs(x) > peak) peak = fabs(x);
+            sum += x * x;
+        }
+        printf("  frame %3u peak %.3f rms %.3f\n", fr, peak, sqrt(sum / size));
+    }
+    fclose(f);
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    int size = WT_DEFAULT_SIZE;
+    int numFrames = WT_DEFAULT_FRAMES;
+    int frameLength = 0;
+
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; arg++)
+    {
+        if (!strcmp(argv[arg], "-i") && arg + 1 < argc) return printInfo(argv[arg + 1]) ? 0 : 1;
+        else if (!strcmp(argv[arg], "-s") && arg + 1 < argc) size = atoi(argv[++arg]);
+        else if (!strcmp(argv[arg], "-n") && arg + 1 < argc) numFrames = atoi(argv[++arg]);
+        else if (!strcmp(argv[arg], "-f") && arg + 1 < argc) frameLength = atoi(argv[++arg]);
+        else usage();
+    }
+    if (argc - arg != 2) usage();
+    if (size < 4 || size > WT_MAX_SIZE || (size & (size - 1)))
+    {
+        fprintf(stderr, "size must be a power of two from 4 to %d\n", WT_MAX_SIZE);
+        return 1;
+    }
+    const char* source = argv[arg];
+    const char* outPath = argv[arg + 1];
+
+    float* frames;
+    const char* ext = strrchr(source, '.');
+    if (ext != NULL && (!strcmp(ext, ".wav") || !strcmp(ext, ".WAV")))
+    {
+        int numSamples = 0;
+        float* wav = readWav(source, &numSamples);
+        if (wav == NULL)
+        {
+            fprintf(stderr, "can't read %s\n", source);
+            return 1;
+        }
+        if (frameLength <= 0) frameLength = size;
+        numFrames = numSamples / frameLength;
+        if (numFrames < 1)
+        {
+            fprintf(stderr, "%s is shorter than one %d sample frame\n", source, frameLength);
+            return 1;
+        }
+        frames = (float*) malloc(sizeof(float) * size * numFrames);
+        for (int f = 0; f < numFrames; f++) resampleFrame(wav + ((long)f * frameLength), frameLength, frames + ((long)f * size), size);
+        free(wav);
+    }
+    else
+    {
+        if (numFrames < 1) usage();
+        frames = (float*) malloc(sizeof(float) * size * numFrames);
+        for (int f = 0; f < numFrames; f++)
+            for (int i = 0; i < size; i++)
+                frames[((long)f * size) + i] = shapeSample(source, (float)i / (float)size, f, numFrames);
+    }
+
+    // Remove DC per frame, then normalize the whole table so frames keep their relative levels
+    float peak = 0.0f;
+    for (int f = 0; f < numFrames; f++)
+    {
+        float* frame = frames + ((long)f * size);
+        double mean = 0.0;
+        for (int i = 0; i < size; i++) mean += frame[i];
+        mean /= size;
+        for (int i = 0; i < size; i++)
+        {
+            frame[i] -= (float)mean;
+            if (fabsf(frame[i]) > peak) peak = fabsf(frame[i]);
+        }
+    }
+    if (peak > 0.0f)
+        for (long i = 0; i < (long)size * numFrames; i++) frames[i] /= peak;
+
+    if (!writeTable(outPath, frames, size, numFrames))
+    {
+        fprintf(stderr, "can't write %s\n", outPath);
+        return 1;
+    }
+    printf("wrote %s: %d frames of %d samples, %ld bytes\n", outPath, numFrames, size,
+           (long)sizeof(tWaveTableFileHeader) + (2L * size * numFrames));
+
+    free(frames);
+    return 0;
+}